@@ -0,0 +1,102 @@
+// Throughput and latency of Forth channels (forth_channel.c) between threads
+//
+//   forth_compiler benchmarks/runtime/channel.fth -c -o /tmp/channel
+//   cc -O2 -pthread -I/tmp/channel /tmp/channel/forth_*.c benchmarks/runtime/channel_bench.c -o channel_bench
+//   ./channel_bench
+//
+// Throughput streams MESSAGES cells from producer threads to one consumer
+// through a 1024-cell ring: PIPE (SPSC) and SHARED (MPSC, 1 to 4
+// producers). Latency is half the round trip of one cell bounced between
+// two threads over PING and PONG. Run it on at least two idle cores; on
+// one core every handoff waits for the scheduler.
+
+#include "forth_runtime.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+#define MESSAGES   10000000
+#define ROUNDTRIPS 1000000
+#define MAX_PRODUCERS 4
+
+typedef struct {
+    forth_cell_t channel;
+    forth_cell_t first;
+    forth_cell_t count;
+} producer_args_t;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void* producer(void* arg) {
+    const producer_args_t* args = arg;
+    for (forth_cell_t i = 0; i < args->count; i++) {
+        forth_channel_send(args->channel, args->first + i);
+    }
+    return NULL;
+}
+
+static void measure_throughput(const char* label, forth_cell_t channel, int producers) {
+    pthread_t threads[MAX_PRODUCERS];
+    producer_args_t args[MAX_PRODUCERS];
+    const forth_cell_t share = MESSAGES / producers;
+
+    const double start = now_ns();
+    for (int p = 0; p < producers; p++) {
+        args[p] = (producer_args_t){channel, p * share, share};
+        pthread_create(&threads[p], NULL, producer, &args[p]);
+    }
+
+    // Values are 0 .. n-1 in some interleaving: check the sum
+    long long sum = 0;
+    const forth_cell_t total = share * producers;
+    for (forth_cell_t i = 0; i < total; i++) {
+        sum += forth_channel_recv(channel);
+    }
+    const double elapsed = now_ns() - start;
+    for (int p = 0; p < producers; p++) {
+        pthread_join(threads[p], NULL);
+    }
+
+    const long long expected = (long long)total * (total - 1) / 2;
+    printf("%-5s %d producer%s  %7.1f M msgs/s  %6.1f ns/msg%s\n", label, producers,
+           producers == 1 ? " " : "s", total / elapsed * 1e3, elapsed / total,
+           sum == expected ? "" : "  CHECKSUM MISMATCH");
+}
+
+static void* echo(void* arg) {
+    (void)arg;
+    for (int i = 0; i < ROUNDTRIPS; i++) {
+        forth_channel_send(FORTH_CHANNEL_PONG, forth_channel_recv(FORTH_CHANNEL_PING));
+    }
+    return NULL;
+}
+
+static void measure_latency(void) {
+    pthread_t thread;
+    pthread_create(&thread, NULL, echo, NULL);
+
+    const double start = now_ns();
+    for (int i = 0; i < ROUNDTRIPS; i++) {
+        forth_channel_send(FORTH_CHANNEL_PING, i);
+        forth_channel_recv(FORTH_CHANNEL_PONG);
+    }
+    const double elapsed = now_ns() - start;
+    pthread_join(thread, NULL);
+
+    printf("latency (SPSC ping-pong)     %6.1f ns one way\n", elapsed / ROUNDTRIPS / 2);
+}
+
+int main(void) {
+    forth_init();
+
+    measure_throughput("SPSC", FORTH_CHANNEL_PIPE, 1);
+    for (int producers = 1; producers <= MAX_PRODUCERS; producers *= 2) {
+        measure_throughput("MPSC", FORTH_CHANNEL_SHARED, producers);
+    }
+    measure_latency();
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Context-switch cost and memory of Forth tasks (forth_task.c) on the host
+//
+//   forth_compiler benchmarks/runtime/task_switch.fth -c -o /tmp/task_switch
+//   cc -O2 -DFORTH_TASK_MAX=4096 -I/tmp/task_switch /tmp/task_switch/forth_*.c benchmarks/runtime/task_switch_bench.c -o task_switch_bench
+//   ./task_switch_bench
+//
+// Add -DFORTH_TASK_USE_UCONTEXT to measure the ucontext fallback. One PAUSE
+// is a task switching out to the scheduler and the next task switching in.
+
+#include "forth_runtime.h"
+#include <stdio.h>
+#include <time.h>
+
+#define SWITCHES 2000000
+
+static volatile int running;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Yields with an empty data stack straight from the task's word
+static void spin(void) {
+    while (running) {
+        forth_pause();
+    }
+}
+
+// Yields from four nested calls with four cells on the data stack
+static void nest(int depth) {
+    if (depth == 0) {
+        spin();
+        return;
+    }
+    forth_push(depth);
+    nest(depth - 1);
+    forth_pop();
+}
+
+static void spin_nested(void) {
+    nest(4);
+}
+
+static void measure(const char* label, forth_cell_t tasks, void (*entry)(void)) {
+    running = 1;
+    for (forth_cell_t i = 0; i < tasks; i++) {
+        forth_task_start(i, entry);
+    }
+    forth_pause();  // First turn: every task reaches its loop
+
+    const int rounds = SWITCHES / tasks;
+    const double start = now_ns();
+    for (int round = 0; round < rounds; round++) {
+        forth_pause();
+    }
+    const double elapsed = now_ns() - start;
+    const size_t bytes = forth_tasks_memory();
+
+    running = 0;
+    forth_tasks_join();
+
+    printf("%-8s %5d tasks  %7.1f ns/PAUSE  %5zu bytes/task\n", label, (int)tasks,
+           elapsed / ((double)rounds * (double)tasks), bytes / (size_t)tasks);
+}
+
+int main(void) {
+    forth_init();
+
+    const forth_cell_t counts[] = {1, 16, 256, FORTH_TASK_MAX};
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        measure("flat", counts[i], spin);
+    }
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        measure("nested", counts[i], spin_nested);
+    }
+    return 0;
+}
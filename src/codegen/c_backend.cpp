@@ -1,9 +1,16 @@
 #include "codegen/c_backend.h"
 #include "common/utils.h"
+#include "common/thread_pool.h"
+#include "common/trace.h"
 #include <filesystem>
 #include <fstream>
 #include <algorithm>
+#include <bit>
+#include <charconv>
+#include <climits>
+#include <functional>
 #include <iomanip>
+#include <optional>
 #include <set>
 
 namespace fs = std::filesystem;
@@ -13,10 +20,9 @@ namespace fs = std::filesystem;
 // ============================================================================
 
 ForthCCodegen::ForthCCodegen(const std::string& name) 
-    : moduleName(name), targetPlatform("esp32"), indentLevel(0), 
-      tempVarCounter(0), labelCounter(0), stringCounter(0),
-      currentFileIndex(0), semanticAnalyzer(nullptr), 
-      dictionary(nullptr) {
+    : moduleName(name), targetPlatform("esp32"), currentFileIndex(0),
+      parallelEmission(false), emissionThreads(0), shardCount(1),
+      semanticAnalyzer(nullptr), dictionary(nullptr) {
     
     // Initialize ESP32 optimization defaults
     esp32Config.useTasking = true;
@@ -41,41 +47,77 @@ bool ForthCCodegen::generateCode(const ProgramNode& program) {
     
     try {
         // Validate input
-        if (program.getChildren().empty()) {
+        if (program.getChildren().empty() && program.getModules().empty()) {
             addWarning("Empty program provided");
         }
         
         // PASS 1: Collect all word definitions first
-        collectWordDefinitions(program);
+        {
+            ForthTrace::Span span("codegen", "collect words");
+            collectWordDefinitions(program);
+        }
         
         // PASS 2: Analyze program for optimization opportunities  
-        analyzeProgram(program);
+        {
+            ForthTrace::Span span("codegen", "feature analysis");
+            analyzeProgram(program);
+        }
+        {
+            ForthTrace::Span span("codegen", "data space layout");
+            layoutDataSpace(program);
+            classifyChannels(program);
+        }
+        {
+            ForthTrace::Span span("codegen", "pure words");
+            collectPureWords(program);
+        }
+        {
+            ForthTrace::Span span("codegen", "specialization");
+            planSpecializations(program);
+        }
+        {
+            ForthTrace::Span span("codegen", "shard planning");
+            planShards(program);
+        }
         
         // PASS 3: Generate modular runtime components
-        generateModularRuntime();
+        {
+            ForthTrace::Span span("codegen", "runtime generation");
+            generateModularRuntime();
+        }
         
         // Validate that program file was created
         bool foundProgramFile = false;
         for (const auto& [filename, _] : generatedFiles) {
-            if (filename == "forth_program.c") {
+            if (filename == programFileName) {
                 foundProgramFile = true;
                 break;
             }
         }
         
         if (!foundProgramFile) {
-            addError("Failed to create forth_program.c file");
+            addError("Failed to create " + programFileName + " file");
             return false;
         }
         
         // PASS 4: Process AST and generate code
-        const_cast<ProgramNode&>(program).accept(*this);
+        {
+            ForthTrace::Span span("codegen", "program emission");
+            const_cast<ProgramNode&>(program).accept(*this);
+            emitState.buffer = nullptr;  // generatedFiles may grow from here on
+        }
         
         // PASS 5: Apply optimizations based on analysis
-        applyOptimizations();
+        {
+            ForthTrace::Span span("codegen", "optimizations");
+            applyOptimizations();
+        }
         
         // PASS 6: Finalize code generation
-        finalizeGeneration();
+        if (!isModuleMode()) {
+            ForthTrace::Span span("codegen", "finalize");
+            finalizeGeneration();
+        }
         
         // Validate generation results
         if (generatedFiles.empty()) {
@@ -85,13 +127,13 @@ bool ForthCCodegen::generateCode(const ProgramNode& program) {
         
         // Check that program file has content
         for (const auto& [filename, content] : generatedFiles) {
-            if (filename == "forth_program.c") {
-                if (content.str().empty()) {
+            if (filename == programFileName) {
+                if (content.empty()) {
                     addError("Generated program file is empty");
                     return false;
                 }
                 // Check for main function
-                if (content.str().find("forth_program_main") == std::string::npos) {
+                if (!isModuleMode() && !content.contains("forth_program_main")) {
                     addError("Generated program missing main function");
                     return false;
                 }
@@ -113,14 +155,20 @@ bool ForthCCodegen::generateCode(const ProgramNode& program) {
 
 void ForthCCodegen::collectWordDefinitions(const ProgramNode& program) {
     // First pass: collect all word names and map to function names
-    for (const auto& child : program.getChildren()) {
-        if (child->getType() == ASTNode::NodeType::WORD_DEFINITION) {
-            auto* wordDef = static_cast<WordDefinitionNode*>(child.get());
-            const std::string& wordName = wordDef->getWordName();
-            const std::string funcName = generateFunctionName(wordName);
+    for (const auto* statements : program.getStatementLists()) {
+        for (const auto& child : *statements) {
+            if (child->getType() == ASTNode::NodeType::WORD_DEFINITION) {
+                auto* wordDef = static_cast<WordDefinitionNode*>(child.get());
+                const std::string& wordName = wordDef->getWordName();
+                const std::string funcName = generateFunctionName(wordName);
             
-            wordFunctionNames[ForthUtils::toUpper(wordName)] = funcName;
-            generatedWords.insert(ForthUtils::toUpper(wordName));
+                const std::string upperName = ForthUtils::toUpper(wordName);
+                if (!generatedWords.contains(upperName)) {
+                    wordOrder.push_back(upperName);
+                }
+                wordFunctionNames[upperName] = funcName;
+                generatedWords.insert(upperName);
+            }
         }
     }
 }
@@ -173,9 +221,23 @@ void ForthCCodegen::analyzeProgram(const ProgramNode& program) {
                           word == ">" || word == "<=" || word == ">=" ||
                           word == "0=" || word == "0<" || word == "0>") {
                     codegen->usedFeatures.insert("COMPARE");
-                } else if (word == "!" || word == "@") {
+                } else if (word == "!" || word == "@" || word == "C!" || word == "C@" || word == "MOVE" ||
+                          word == "CMOVE" || word == "CMOVE>" || word == "FILL" ||
+                          word == "ERASE") {
                     codegen->usedFeatures.insert("MEMORY");
-                } else if (word == "EMIT" || word == "TYPE" || word == "CR") {
+                } else if (word == "HERE" || word == "ALLOT" || word == "," ||
+                          word == "CELLS" || word == "CELL+") {
+                    codegen->usedFeatures.insert("DATA_SPACE");
+                } else if (word == "SUM" || word == "DOT" || word == "MAP+" ||
+                          word == "SCALE" || word == "MIN-REDUCE" || word == "MAX-REDUCE") {
+                    codegen->usedFeatures.insert("ARRAY");
+                } else if (word == "START" || word == "PAUSE" || word == "STOP") {
+                    codegen->usedFeatures.insert("TASK");
+                } else if (word == "SEND" || word == "RECV" || word == "TRY-RECV") {
+                    codegen->usedFeatures.insert("CHANNEL");
+                } else if (word == "EMIT" || word == "TYPE" || word == "CR" ||
+                          word == "." || word == "SPACE" || word == "SPACES" ||
+                          word == "FLUSH") {
                     codegen->usedFeatures.insert("IO");
                 }
             }
@@ -183,6 +245,9 @@ void ForthCCodegen::analyzeProgram(const ProgramNode& program) {
             // Build call graph
             if (!currentPath.empty()) {
                 codegen->callGraph[*currentPath.begin()].insert(word);
+                if (!node.getParsedName().empty()) {
+                    codegen->callGraph[*currentPath.begin()].insert(node.getParsedName());
+                }
             }
         }
         
@@ -195,6 +260,7 @@ void ForthCCodegen::analyzeProgram(const ProgramNode& program) {
         
         void visit(StringLiteralNode& node) override {
             codegen->usedFeatures.insert("STRING");
+            codegen->internString(node.getValue());
             if (node.isPrint()) {
                 codegen->usedFeatures.insert("IO");
             }
@@ -230,14 +296,34 @@ void ForthCCodegen::analyzeProgram(const ProgramNode& program) {
         }
         
         void visit(VariableDeclarationNode& node) override {
+            if (node.isTask()) {
+                codegen->usedFeatures.insert("TASK");
+                return;
+            }
+            if (node.isChannel()) {
+                codegen->usedFeatures.insert("CHANNEL");
+                return;
+            }
             codegen->usedFeatures.insert("VARIABLE");
+            if (!node.isConst()) {
+                codegen->usedFeatures.insert("DATA_SPACE");
+            }
         }
     };
     
     FeatureAnalyzer analyzer;
     analyzer.codegen = this;
+    for (const auto& module : program.getModules()) {
+        module->accept(analyzer);
+    }
     const_cast<ProgramNode&>(program).accept(analyzer);
     
+    // The runtime must also provide what imported fragments use
+    for (const auto& interface : interfaces) {
+        usedFeatures.insert(interface->features.begin(), interface->features.end());
+        usedBuiltins.insert(interface->builtins.begin(), interface->builtins.end());
+    }
+    
     // Force COMPARE feature if any comparison operators are used
     bool hasComparisons = false;
     for (const auto& builtin : usedBuiltins) {
@@ -278,6 +364,501 @@ void ForthCCodegen::determineOptimizationStrategy() {
                                   !usedFeatures.contains("RECURSIVE");
 }
 
+namespace {
+
+// Compile-time value of a decimal integer literal
+std::optional<int64_t> literalValue(const ASTNode* node) {
+    if (!node || node->getType() != ASTNode::NodeType::NUMBER_LITERAL) return std::nullopt;
+    const auto* number = static_cast<const NumberLiteralNode*>(node);
+    if (number->isFloatingPoint()) return std::nullopt;
+    
+    const std::string& text = number->getValue();
+    int64_t value = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || end != text.data() + text.size()) return std::nullopt;
+    return value;
+}
+
+// Multiplier and post-shift that turn signed 32-bit division by d into a
+// multiply-high (Hacker's Delight, 10-1). Valid for |d| >= 2.
+struct DivisionMagic {
+    int32_t multiplier;
+    int shift;
+};
+
+DivisionMagic signedDivisionMagic(int32_t d) {
+    const uint32_t two31 = 0x80000000u;
+    const uint32_t ad = d < 0 ? 0u - static_cast<uint32_t>(d) : static_cast<uint32_t>(d);
+    const uint32_t t = two31 + (static_cast<uint32_t>(d) >> 31);
+    const uint32_t anc = t - 1 - t % ad;
+    
+    int p = 31;
+    uint32_t q1 = two31 / anc, r1 = two31 - q1 * anc;
+    uint32_t q2 = two31 / ad, r2 = two31 - q2 * ad;
+    uint32_t delta = 0;
+    do {
+        p++;
+        q1 *= 2; r1 *= 2;
+        if (r1 >= anc) { q1++; r1 -= anc; }
+        q2 *= 2; r2 *= 2;
+        if (r2 >= ad) { q2++; r2 -= ad; }
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+    
+    const auto magic = static_cast<int32_t>(q2 + 1);
+    return {d < 0 ? static_cast<int32_t>(0u - static_cast<uint32_t>(magic)) : magic, p - 32};
+}
+
+// Word call or math operation with the given upper-case name
+bool isWord(const ASTNode* node, std::string_view upperName) {
+    if (!node) return false;
+    if (node->getType() == ASTNode::NodeType::WORD_CALL) {
+        return ForthUtils::toUpper(static_cast<const WordCallNode*>(node)->getWordName()) == upperName;
+    }
+    if (node->getType() == ASTNode::NodeType::MATH_OPERATION) {
+        return ForthUtils::toUpper(static_cast<const MathOperationNode*>(node)->getOperation()) == upperName;
+    }
+    return false;
+}
+
+} // namespace
+
+void ForthCCodegen::layoutDataSpace(const ProgramNode& program) {
+    dataSpaceWords.clear();
+    constantValues.clear();
+    constantSlots.clear();
+    dataSpaceImage.clear();
+    dataSpaceLabels.clear();
+    dataSpaceHere = 0;
+    foldedNodes.clear();
+    taskHandles.clear();
+    channels.clear();
+    
+    constexpr uint32_t cellSize = sizeof(int32_t);
+    
+    // Abstract data stack of the top-level code. Known entries remember the
+    // nodes that produced them so a consuming "," or CONSTANT can remove
+    // the whole computation from the run-time code. Anything the pass does
+    // not model clears the stack; entries below are then unknown.
+    struct Entry {
+        std::optional<int64_t> value;
+        std::vector<const ASTNode*> sources;
+    };
+    std::vector<Entry> stack;
+    auto pop = [&stack]() {
+        if (stack.empty()) return Entry{};
+        Entry top = std::move(stack.back());
+        stack.pop_back();
+        return top;
+    };
+    auto fold = [this](const Entry& entry, const ASTNode* consumer) {
+        foldedNodes.insert(entry.sources.begin(), entry.sources.end());
+        foldedNodes.insert(consumer);
+    };
+    auto alignHere = [&]() {
+        dataSpaceHere = (dataSpaceHere + cellSize - 1) & ~(cellSize - 1);
+        dataSpaceImage.resize(dataSpaceHere / cellSize, 0);
+    };
+    
+    // Once a "," or ALLOT depends on a run-time value - or anything that may
+    // observe or move HERE at run time has executed - the rest of the data
+    // space is allocated at run time, in program order
+    bool dynamic = false;
+    
+    for (const auto* statements : program.getStatementLists()) {
+        for (const auto& child : *statements) {
+            const ASTNode* node = child.get();
+        
+            switch (node->getType()) {
+                case ASTNode::NodeType::WORD_DEFINITION:
+                    continue;
+                
+                case ASTNode::NodeType::NUMBER_LITERAL: {
+                    auto value = literalValue(node);
+                    stack.push_back(Entry{value, value ? std::vector<const ASTNode*>{node}
+                                                       : std::vector<const ASTNode*>{}});
+                    continue;
+                }
+            
+                case ASTNode::NodeType::VARIABLE_DECLARATION:
+                case ASTNode::NodeType::CONSTANT_DECLARATION: {
+                    const auto* decl = static_cast<const VariableDeclarationNode*>(node);
+                    const std::string& name = decl->getVarName();
+                
+                    if (decl->isTask()) {
+                        taskHandles.try_emplace(name, taskHandles.size());
+                        continue;
+                    }
+                    if (decl->isChannel()) {
+                        // Rings are static, so the capacity must be known here
+                        Entry capacity = pop();
+                        if (!capacity.value || *capacity.value < 1 || *capacity.value > 65536) {
+                            addError("CHANNEL needs a literal capacity from 1 to 65536: " + name,
+                                     const_cast<ASTNode*>(node));
+                            foldedNodes.insert(node);  // Reported once
+                            continue;
+                        }
+                        fold(capacity, node);
+                        if (!channels.contains(name)) {
+                            ChannelInfo channel;
+                            channel.name = name;
+                            channel.macro = "FORTH_CHANNEL_" + ForthUtils::toUpper(sanitizeIdentifier(name));
+                            channel.handle = channels.size();
+                            channel.capacity = std::bit_ceil(std::max<uint32_t>(
+                                static_cast<uint32_t>(*capacity.value), 2));
+                            channels.emplace(name, std::move(channel));
+                        }
+                        continue;
+                    }
+                    if (decl->isConst()) {
+                        Entry value = pop();
+                        if (value.value) {
+                            constantValues[name] = static_cast<int32_t>(*value.value);
+                            fold(value, node);
+                        } else {
+                            constantSlots[name] = "forth_constant_" + sanitizeIdentifier(name);
+                        }
+                        continue;
+                    }
+                
+                    DataSpaceWord word;
+                    word.name = name;
+                    if (dynamic) {
+                        word.isStatic = false;
+                        word.slot = "forth_data_word_" + sanitizeIdentifier(name);
+                    } else {
+                        alignHere();
+                        word.offset = dataSpaceHere;
+                        dataSpaceLabels.emplace_back(dataSpaceHere, name);
+                        if (!decl->isCreate()) {
+                            dataSpaceImage.push_back(0);
+                            dataSpaceHere += cellSize;
+                        }
+                    }
+                    dataSpaceWords[name] = std::move(word);
+                    continue;
+                }
+            
+                case ASTNode::NodeType::MATH_OPERATION: {
+                    const std::string op = static_cast<const MathOperationNode*>(node)->getOperation();
+                    if (op == "+" || op == "-" || op == "*") {
+                        Entry b = pop();
+                        Entry a = pop();
+                        Entry result;
+                        if (a.value && b.value) {
+                            result.value = op == "+" ? *a.value + *b.value
+                                         : op == "-" ? *a.value - *b.value
+                                                     : *a.value * *b.value;
+                            result.sources = std::move(a.sources);
+                            result.sources.insert(result.sources.end(), b.sources.begin(), b.sources.end());
+                            result.sources.push_back(node);
+                        }
+                        stack.push_back(std::move(result));
+                    } else {
+                        stack.clear();
+                    }
+                    continue;
+                }
+            
+                case ASTNode::NodeType::WORD_CALL:
+                    break;
+                
+                default:
+                    // Control structures may allocate at run time
+                    stack.clear();
+                    dynamic = true;
+                    continue;
+            }
+        
+            const std::string word = ForthUtils::toUpper(static_cast<const WordCallNode*>(node)->getWordName());
+        
+            if (word == "CELLS" || word == "CELL+") {
+                Entry entry = pop();
+                if (entry.value) {
+                    entry.value = word == "CELLS" ? *entry.value * cellSize : *entry.value + cellSize;
+                    entry.sources.push_back(node);
+                }
+                stack.push_back(std::move(entry));
+            } else if (word == ",") {
+                Entry entry = pop();
+                if (!dynamic && entry.value) {
+                    alignHere();
+                    dataSpaceImage.push_back(static_cast<int32_t>(*entry.value));
+                    dataSpaceHere += cellSize;
+                    fold(entry, node);
+                } else {
+                    dynamic = true;
+                }
+            } else if (word == "ALLOT") {
+                Entry entry = pop();
+                if (!dynamic && entry.value) {
+                    const int64_t next = static_cast<int64_t>(dataSpaceHere) + *entry.value;
+                    if (next < 0 || next > INT32_MAX) {
+                        addError("ALLOT moves HERE outside the data space", const_cast<ASTNode*>(node));
+                        continue;
+                    }
+                    dataSpaceHere = static_cast<uint32_t>(next);
+                    dataSpaceImage.resize((dataSpaceHere + cellSize - 1) / cellSize, 0);
+                    fold(entry, node);
+                } else {
+                    dynamic = true;
+                }
+            } else if (word == "HERE") {
+                stack.push_back(Entry{});
+                dynamic = true;
+            } else if (dataSpaceWords.contains(word) || constantSlots.contains(word) ||
+                       taskHandles.contains(word) || channels.contains(word)) {
+                stack.push_back(Entry{});
+            } else if (auto constant = constantValues.find(word); constant != constantValues.end()) {
+                stack.push_back(Entry{constant->second, {node}});
+            } else {
+                stack.clear();
+                if (!isBuiltinWord(word) || word == "PAUSE" || word == "SEND" || word == "RECV") {
+                    dynamic = true;  // User words (and tasks) may use HERE, "," or ALLOT
+                }
+            }
+        }
+    }
+    
+    alignHere();
+}
+
+// The program runs on one thread, so all of its SENDs are one producer. A
+// channel is single-producer when the program sends to it and its name is
+// only ever used directly before SEND, RECV or TRY-RECV: C code then has
+// no handle to send on it concurrently. The rest stay multi-producer.
+void ForthCCodegen::classifyChannels(const ProgramNode& program) {
+    if (channels.empty()) return;
+    
+    std::unordered_set<std::string> sent;
+    std::unordered_set<std::string> escaped;
+    std::function<void(const NodeList&)> scan = [&](const NodeList& nodes) {
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const ASTNode* node = nodes[i].get();
+            switch (node->getType()) {
+                case ASTNode::NodeType::WORD_DEFINITION:
+                    scan(node->getChildren());
+                    break;
+                case ASTNode::NodeType::IF_STATEMENT: {
+                    const auto* ifNode = static_cast<const IfStatementNode*>(node);
+                    if (ifNode->getThenBranch()) scan(ifNode->getThenBranch()->getChildren());
+                    if (ifNode->getElseBranch()) scan(ifNode->getElseBranch()->getChildren());
+                    break;
+                }
+                case ASTNode::NodeType::BEGIN_UNTIL_LOOP: {
+                    const auto* loop = static_cast<const BeginUntilLoopNode*>(node);
+                    if (loop->getBody()) scan(loop->getBody()->getChildren());
+                    break;
+                }
+                case ASTNode::NodeType::WORD_CALL: {
+                    const std::string name = ForthUtils::toUpper(
+                        static_cast<const WordCallNode*>(node)->getWordName());
+                    if (!channels.contains(name)) break;
+                    const ASTNode* next = i + 1 < nodes.size() ? nodes[i + 1].get() : nullptr;
+                    if (isBuiltinCall(next, "SEND")) {
+                        sent.insert(name);
+                    } else if (!isBuiltinCall(next, "RECV") && !isBuiltinCall(next, "TRY-RECV")) {
+                        escaped.insert(name);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    };
+    for (const auto* statements : program.getStatementLists()) {
+        scan(*statements);
+    }
+    
+    for (auto& [name, channel] : channels) {
+        channel.multiProducer = !sent.contains(name) || escaped.contains(name);
+    }
+}
+
+namespace {
+
+// Rough size of a word body, used to balance shards
+size_t countNodes(const ASTNode* node) {
+    if (!node) return 0;
+    size_t count = 1;
+    for (const auto& child : node->getChildren()) {
+        count += countNodes(child.get());
+    }
+    if (node->getType() == ASTNode::NodeType::IF_STATEMENT) {
+        const auto* ifNode = static_cast<const IfStatementNode*>(node);
+        count += countNodes(ifNode->getThenBranch()) + countNodes(ifNode->getElseBranch());
+    } else if (node->getType() == ASTNode::NodeType::BEGIN_UNTIL_LOOP) {
+        count += countNodes(static_cast<const BeginUntilLoopNode*>(node)->getBody());
+    }
+    return count;
+}
+
+// Word cache key: the node texts in tree order. Source positions are left
+// out, so a word moved by an edit elsewhere in the file keeps its key.
+void appendNodeKey(std::string& key, const ASTNode* node) {
+    if (!node) {
+        key += "-";
+        return;
+    }
+    key += node->toString();
+    key += "(";
+    for (const auto& child : node->getChildren()) {
+        appendNodeKey(key, child.get());
+    }
+    if (node->getType() == ASTNode::NodeType::IF_STATEMENT) {
+        const auto* ifNode = static_cast<const IfStatementNode*>(node);
+        appendNodeKey(key, ifNode->getCondition());
+        appendNodeKey(key, ifNode->getThenBranch());
+        appendNodeKey(key, ifNode->getElseBranch());
+    } else if (node->getType() == ASTNode::NodeType::BEGIN_UNTIL_LOOP) {
+        const auto* loop = static_cast<const BeginUntilLoopNode*>(node);
+        appendNodeKey(key, loop->getBody());
+        appendNodeKey(key, loop->getCondition());
+    } else if (const auto* decl = dynamic_cast<const VariableDeclarationNode*>(node)) {
+        appendNodeKey(key, decl->getInitialValue());
+    }
+    key += ")";
+}
+
+} // namespace
+
+void ForthCCodegen::planShards(const ProgramNode& program) {
+    wordShard.clear();
+    crossShardCallCount = 0;
+    if (shardCount <= 1) return;
+    
+    // Words in source order with their weights
+    std::vector<std::string> names;
+    std::vector<size_t> weights;
+    std::unordered_map<std::string, size_t> indexOf;
+    for (const auto* statements : program.getStatementLists()) {
+        for (const auto& child : *statements) {
+            if (child->getType() != ASTNode::NodeType::WORD_DEFINITION) continue;
+            const auto* wordDef = static_cast<const WordDefinitionNode*>(child.get());
+            const std::string upperName = ForthUtils::toUpper(wordDef->getWordName());
+            auto [it, inserted] = indexOf.try_emplace(upperName, names.size());
+            if (inserted) {
+                names.push_back(upperName);
+                weights.push_back(0);
+            }
+            weights[it->second] += countNodes(wordDef);
+        }
+    }
+    
+    const size_t n = names.size();
+    if (n < 2) return;
+    
+    // Undirected call graph between user words
+    std::vector<std::vector<size_t>> adjacent(n);
+    std::vector<size_t> parent(n);
+    for (size_t i = 0; i < n; i++) parent[i] = i;
+    auto find = [&parent](size_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    };
+    
+    for (const auto& [caller, callees] : callGraph) {
+        auto from = indexOf.find(ForthUtils::toUpper(caller));
+        if (from == indexOf.end()) continue;
+        for (const auto& callee : callees) {
+            auto to = indexOf.find(ForthUtils::toUpper(callee));
+            if (to == indexOf.end() || to->second == from->second) continue;
+            adjacent[from->second].push_back(to->second);
+            adjacent[to->second].push_back(from->second);
+            parent[find(from->second)] = find(to->second);
+        }
+    }
+    
+    // Connected components, ordered by their first word in the source
+    std::vector<std::vector<size_t>> components;
+    std::unordered_map<size_t, size_t> componentOf;
+    for (size_t i = 0; i < n; i++) {
+        auto [it, inserted] = componentOf.try_emplace(find(i), components.size());
+        if (inserted) components.emplace_back();
+        components[it->second].push_back(i);
+    }
+    
+    size_t total = 0;
+    for (size_t w : weights) total += w;
+    const size_t target = std::max<size_t>(1, (total + shardCount - 1) / shardCount);
+    
+    // Oversized components are cut into BFS-ordered pieces so that callers
+    // and callees still tend to land in the same translation unit
+    std::vector<std::vector<size_t>> pieces;
+    std::vector<size_t> pieceWeights;
+    std::vector<bool> visited(n, false);
+    for (const auto& component : components) {
+        size_t componentWeight = 0;
+        for (size_t i : component) componentWeight += weights[i];
+        
+        if (componentWeight <= target + target / 4) {
+            pieces.push_back(component);
+            pieceWeights.push_back(componentWeight);
+            continue;
+        }
+        
+        std::vector<size_t> queue{component.front()};
+        visited[component.front()] = true;
+        pieces.emplace_back();
+        pieceWeights.push_back(0);
+        for (size_t head = 0; head < queue.size(); head++) {
+            const size_t word = queue[head];
+            if (pieceWeights.back() >= target) {
+                pieces.emplace_back();
+                pieceWeights.push_back(0);
+            }
+            pieces.back().push_back(word);
+            pieceWeights.back() += weights[word];
+            for (size_t next : adjacent[word]) {
+                if (!visited[next]) {
+                    visited[next] = true;
+                    queue.push_back(next);
+                }
+            }
+        }
+    }
+    
+    // Greedy bin packing: heaviest piece into the lightest shard
+    std::vector<size_t> order(pieces.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&pieceWeights](size_t a, size_t b) {
+        return pieceWeights[a] > pieceWeights[b];
+    });
+    
+    std::vector<size_t> load(std::min(shardCount, n), 0);
+    std::vector<size_t> pieceShard(pieces.size());
+    for (size_t piece : order) {
+        const size_t shard = static_cast<size_t>(
+            std::min_element(load.begin(), load.end()) - load.begin());
+        pieceShard[piece] = shard;
+        load[shard] += pieceWeights[piece];
+    }
+    
+    // Drop empty shards and number the rest densely
+    std::vector<size_t> renumber(load.size(), 0);
+    size_t used = 0;
+    for (size_t shard = 0; shard < load.size(); shard++) {
+        if (load[shard] > 0) renumber[shard] = used++;
+    }
+    for (size_t piece = 0; piece < pieces.size(); piece++) {
+        for (size_t word : pieces[piece]) {
+            wordShard[names[word]] = renumber[pieceShard[piece]];
+        }
+    }
+    
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j : adjacent[i]) {
+            if (i < j && wordShard[names[i]] != wordShard[names[j]]) {
+                crossShardCallCount++;
+            }
+        }
+    }
+}
+
 // ============================================================================
 // Modular Runtime Generation
 // ============================================================================
@@ -285,41 +866,110 @@ void ForthCCodegen::determineOptimizationStrategy() {
 void ForthCCodegen::generateModularRuntime() {
     // Clear any existing files first
     generatedFiles.clear();
+    
+    // A separately compiled module is linked into programs that bring the
+    // runtime along; it gets its fragment only
+    if (isModuleMode()) {
+        generatedFiles.emplace_back(programFileName, ChunkedBuffer());
+        currentFileIndex = 0;
+        emitState = EmitState{};
+        emitState.buffer = &generatedFiles.back().second;
+        return;
+    }
 
     // Generate only the runtime components that are actually needed
+    auto runtimeFile = [this](const std::string& filename, const auto& generate) {
+        ForthTrace::Span span("runtime", filename);
+        generateFile(filename, generate());
+    };
     
     // 1. Core runtime header (always needed)
-    generateFile("forth_runtime.h", generateCoreRuntimeHeader());
+    runtimeFile("forth_runtime.h", [this] { return generateCoreRuntimeHeader(); });
 
     // 2. Stack operations (always needed)  
-    generateFile("forth_stack.c", generateStackImplementation());
+    runtimeFile("forth_stack.c", [this] { return generateStackImplementation(); });
     
     // 3. Math operations (conditional)
     if (usedFeatures.contains("MATH") || !usedBuiltins.empty()) {
-        generateFile("forth_math.c", generateMathImplementation());
+        runtimeFile("forth_math.c", [this] { return generateMathImplementation(); });
     }
     
     // 4. Comparison operations (FIXED: Generate if ANY comparison might be used)
-    generateFile("forth_compare.c", generateCompareImplementation());
+    runtimeFile("forth_compare.c", [this] { return generateCompareImplementation(); });
     
     // 5. Memory operations (conditional)
     if (usedFeatures.contains("MEMORY")) {
-        generateFile("forth_memory.c", generateMemoryImplementation());
+        runtimeFile("forth_memory.c", [this] { return generateMemoryImplementation(); });
     }
     
-    // 6. I/O operations (conditional)
+    // 6. Array reductions and maps (conditional)
+    if (usedFeatures.contains("ARRAY")) {
+        runtimeFile("forth_array.c", [this] { return generateArrayImplementation(); });
+    }
+    
+    // 7. Cooperative tasks (conditional)
+    if (usedFeatures.contains("TASK")) {
+        runtimeFile("forth_task.c", [this] { return generateTaskImplementation(); });
+    }
+    
+    // 8. Channels between tasks, threads and cores (conditional)
+    if (usedFeatures.contains("CHANNEL")) {
+        runtimeFile("forth_channel.c", [this] { return generateChannelImplementation(); });
+    }
+    
+    // 9. I/O operations (conditional)
     if (usedFeatures.contains("IO")) {
-        generateFile("forth_io.c", generateIOImplementation());
+        runtimeFile("forth_io.c", [this] { return generateIOImplementation(); });
     }
     
-    // 7. ESP32-specific (conditional)
+    // 10. ESP32-specific (conditional)
     if (targetPlatform.starts_with("esp32")) {
-        generateFile("forth_esp32.c", generateESP32Implementation());
+        runtimeFile("forth_esp32.c", [this] { return generateESP32Implementation(); });
+    }
+    
+    // 11. Deduplicated string literal pool
+    if (!stringPoolOrder.empty()) {
+        runtimeFile("forth_strings.c", [this] { return generateStringPool(); });
     }
     
-    // 8. CRITICAL FIX: Create the main program file and set current index
-    generatedFiles.emplace_back("forth_program.c", std::ostringstream());
+    // 12. Data space image and allocator
+    if (usedFeatures.contains("DATA_SPACE") || !constantSlots.empty()) {
+        runtimeFile("forth_data.c", [this] { return generateDataSpaceImplementation(); });
+    }
+    
+    // 13. Sharded word translation units with a shared prototype header
+    shardFileIndices.clear();
+    if (!wordShard.empty()) {
+        generateFile("forth_words.h", generateWordPrototypes());
+        
+        size_t shards = 0;
+        for (const auto& [word, shard] : wordShard) {
+            shards = std::max(shards, shard + 1);
+        }
+        for (size_t shard = 0; shard < shards; shard++) {
+            generatedFiles.emplace_back("forth_words_" + std::to_string(shard) + ".c", ChunkedBuffer());
+            generatedFiles.back().second
+                << "// Generated FORTH words: shard " << std::to_string(shard + 1)
+                << " of " << std::to_string(shards) << "\n"
+                << "#include \"forth_runtime.h\"\n"
+                << "#include \"forth_words.h\"\n";
+            shardFileIndices.push_back(generatedFiles.size() - 1);
+        }
+    }
+    
+    // 14. Fragments of imported modules, each once
+    std::set<std::string> fragments;
+    for (const auto& interface : interfaces) {
+        if (fragments.insert(interface->fragment).second) {
+            generateFile(interface->fragment, interface->fragmentSource);
+        }
+    }
+    
+    // 15. CRITICAL FIX: Create the main program file and set current index
+    generatedFiles.emplace_back(programFileName, ChunkedBuffer());
     currentFileIndex = generatedFiles.size() - 1;  // Set to the program file
+    emitState = EmitState{};
+    emitState.buffer = &generatedFiles.back().second;
     
     // Add program file header
     emitLine("// Generated FORTH Program");
@@ -347,6 +997,7 @@ extern "C" {
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>  // FIXED: Add stdio.h for printf/fflush
+#include <string.h>  // memmove/memset of fused block operations in word code
 
 // ============================================================================
 // Configuration Macros
@@ -360,6 +1011,28 @@ extern "C" {
     #define FORTH_USE_FLOAT )" << (optimizationFlags.needsFloat ? "1" : "0") << R"(
 #endif
 
+// Console output is buffered (forth_io.c). Flush policy is a bit mask;
+// the buffer is always drained when full, by FLUSH and at cleanup.
+#define FORTH_HAS_OUTPUT )" << (usedFeatures.contains("IO") ? "1" : "0") << R"(
+#define FORTH_FLUSH_ON_NEWLINE 1
+#define FORTH_FLUSH_ON_IDLE    2
+
+#ifndef FORTH_FLUSH_POLICY
+    #ifdef ESP32_PLATFORM
+        #define FORTH_FLUSH_POLICY (FORTH_FLUSH_ON_NEWLINE | FORTH_FLUSH_ON_IDLE)
+    #else
+        #define FORTH_FLUSH_POLICY FORTH_FLUSH_ON_IDLE
+    #endif
+#endif
+
+#ifndef FORTH_OUTPUT_BUFFER_SIZE
+    #ifdef ESP32_PLATFORM
+        #define FORTH_OUTPUT_BUFFER_SIZE 256
+    #else
+        #define FORTH_OUTPUT_BUFFER_SIZE 4096
+    #endif
+#endif
+
 #ifdef ESP32_PLATFORM
     #include "esp_attr.h"
     #include "esp_log.h"
@@ -367,7 +1040,9 @@ extern "C" {
     #include "freertos/portmacro.h"
     
     // Performance-critical functions in IRAM
-    #define FORTH_IRAM_ATTR IRAM_ATTR
+    #ifndef FORTH_IRAM_ATTR
+        #define FORTH_IRAM_ATTR IRAM_ATTR
+    #endif
     
     // DMA-safe memory alignment
     #define FORTH_DMA_ATTR WORD_ALIGNED_ATTR
@@ -375,7 +1050,10 @@ extern "C" {
     // FIXED: Don't redefine ESP32 macros - they're already defined
     // Use the existing FreeRTOS definitions
 #else
-    #define FORTH_IRAM_ATTR
+    // Overridable so size reports can place IRAM code in its own section
+    #ifndef FORTH_IRAM_ATTR
+        #define FORTH_IRAM_ATTR
+    #endif
     #define FORTH_DMA_ATTR
         
     #ifndef portENTER_CRITICAL
@@ -485,6 +1163,92 @@ void forth_fetch(void);
 void forth_store(void);
 void forth_byte_fetch(void);
 void forth_byte_store(void);
+void forth_move(void);
+void forth_cmove(void);
+void forth_cmove_up(void);
+void forth_fill(void);
+void forth_erase(void);
+
+)";
+    }
+
+    if (usedFeatures.contains("ARRAY")) {
+        header << R"(// Array operations (forth_array.c)
+forth_cell_t forth_cells_sum(const forth_cell_t* restrict cells, forth_cell_t n);
+forth_cell_t forth_cells_dot(const forth_cell_t* restrict a, const forth_cell_t* restrict b, forth_cell_t n);
+forth_cell_t forth_cells_min(const forth_cell_t* restrict cells, forth_cell_t n);
+forth_cell_t forth_cells_max(const forth_cell_t* restrict cells, forth_cell_t n);
+void forth_cells_add(forth_cell_t* restrict cells, forth_cell_t n, forth_cell_t k);
+void forth_cells_scale(forth_cell_t* restrict cells, forth_cell_t n, forth_cell_t k);
+void forth_sum(void);
+void forth_dot(void);
+void forth_min_reduce(void);
+void forth_max_reduce(void);
+void forth_map_add(void);
+void forth_scale(void);
+
+)";
+    }
+
+    if (usedFeatures.contains("TASK")) {
+        header << R"(// Cooperative tasks (forth_task.c). Tasks switch only at PAUSE; the
+// program gives ready tasks a turn at its own PAUSEs and waits for all of
+// them before it ends.
+#ifndef FORTH_TASK_MAX
+    #define FORTH_TASK_MAX )" << std::max<size_t>(taskHandles.size(), 1) << R"(
+#endif
+
+// Shared stack all tasks run on. Known gap: Xtensa (ESP32, ESP32-S3) has no
+// stack switch yet (it needs xthal_window_spill and an SP/PC swap), so there
+// every started task is a FreeRTOS task that owns a stack of this size plus
+// its TCB - 4 KB of RAM per task by default instead of the few hundred bytes
+// a paused task keeps elsewhere.
+#ifndef FORTH_TASK_STACK_SIZE
+    #ifdef ESP32_PLATFORM
+        #define FORTH_TASK_STACK_SIZE 4096
+    #else
+        #define FORTH_TASK_STACK_SIZE 65536
+    #endif
+#endif
+
+void forth_task_start(forth_cell_t task, void (*entry)(void));
+void forth_pause(void);
+void forth_stop(void);
+void forth_tasks_join(void);
+size_t forth_tasks_memory(void);
+
+)";
+    }
+
+    if (usedFeatures.contains("CHANNEL")) {
+        header << R"(// Channels (forth_channel.c): bounded lock-free rings of cells. The
+// program is the only consumer. C code on other threads, cores or in ISRs
+// may send on the MPSC channels; SPSC channels are fed by the program alone.
+#define FORTH_CHANNEL_COUNT )" << channels.size() << "\n";
+        std::vector<const ChannelInfo*> ordered;
+        for (const auto& [name, channel] : channels) {
+            ordered.push_back(&channel);
+        }
+        std::sort(ordered.begin(), ordered.end(),
+                  [](const ChannelInfo* a, const ChannelInfo* b) { return a->handle < b->handle; });
+        for (const ChannelInfo* channel : ordered) {
+            header << "#define " << channel->macro << " " << channel->handle << "  // "
+                   << (channel->multiProducer ? "MPSC" : "SPSC") << ", "
+                   << channel->capacity << " cells\n";
+        }
+        header << R"(
+// Any thread (try_send also from ISRs); the blocking calls spin, then yield
+bool forth_channel_try_send(forth_cell_t channel, forth_cell_t value);
+bool forth_channel_try_recv(forth_cell_t channel, forth_cell_t* value);
+void forth_channel_send(forth_cell_t channel, forth_cell_t value);
+forth_cell_t forth_channel_recv(forth_cell_t channel);
+
+// The program's SEND and RECV: give tasks a turn while waiting
+void forth_channel_put(forth_cell_t channel, forth_cell_t value);
+forth_cell_t forth_channel_take(forth_cell_t channel);
+void forth_send(void);
+void forth_recv(void);
+void forth_try_recv(void);
 
 )";
     }
@@ -497,6 +1261,73 @@ void forth_cr(void);
 void forth_space(void);
 void forth_spaces(void);
 void forth_print_number(forth_cell_t value);
+void forth_write(const char* data, size_t length);
+void forth_flush(void);
+void forth_output_idle(void);
+
+)";
+    }
+
+    if (!stringPoolOrder.empty()) {
+        header << R"(// String literal pool (forth_strings.c)
+extern const char forth_string_pool[];
+
+)";
+    }
+
+    if (usedFeatures.contains("DATA_SPACE") || !constantSlots.empty()) {
+        header << R"(// Data space (forth_data.c). The compiler lays out the static image;
+// run-time "," and ALLOT continue after it in the reserve.
+#define FORTH_DATA_SPACE_IMAGE )" << dataSpaceHere << R"(
+
+#ifndef FORTH_DATA_SPACE_RESERVE
+    #ifdef ESP32_PLATFORM
+        #define FORTH_DATA_SPACE_RESERVE 1024
+    #else
+        #define FORTH_DATA_SPACE_RESERVE 65536
+    #endif
+#endif
+
+#define FORTH_DATA_SPACE_SIZE (FORTH_DATA_SPACE_IMAGE + FORTH_DATA_SPACE_RESERVE)
+#define FORTH_DATA_ALIGN(offset) \
+    (((offset) + sizeof(forth_cell_t) - 1) & ~(forth_ucell_t)(sizeof(forth_cell_t) - 1))
+// Data-space addresses are byte offsets, so they fit a cell on every host;
+// values above the data space are machine addresses (registers, strings)
+#define FORTH_DATA_ADDR(offset) ((forth_cell_t)(offset))
+#define FORTH_DATA_PTR(addr) \
+    ((forth_ucell_t)(addr) <= FORTH_DATA_SPACE_SIZE \
+         ? (void*)((forth_byte_t*)forth_data_space + (forth_ucell_t)(addr)) \
+         : (void*)(uintptr_t)(forth_ucell_t)(addr))
+
+extern forth_cell_t forth_data_space[];
+extern forth_ucell_t forth_data_here;
+
+void forth_here(void);
+void forth_allot(void);
+void forth_comma(void);
+void forth_cells(void);
+void forth_cell_plus(void);
+forth_ucell_t forth_data_create(forth_ucell_t bytes);
+
+)";
+        // Words whose address or value is only known at run time
+        std::vector<std::string> slots;
+        for (const auto& [name, word] : dataSpaceWords) {
+            if (!word.isStatic) slots.push_back("extern forth_ucell_t " + word.slot + ";");
+        }
+        for (const auto& [name, slot] : constantSlots) {
+            slots.push_back("extern forth_cell_t " + slot + ";");
+        }
+        std::sort(slots.begin(), slots.end());
+        for (const auto& slot : slots) {
+            header << slot << "\n";
+        }
+        if (!slots.empty()) {
+            header << "\n";
+        }
+    } else {
+        header << R"(// No data space: addresses are machine addresses
+#define FORTH_DATA_PTR(addr) ((void*)(uintptr_t)(forth_ucell_t)(addr))
 
 )";
     }
@@ -551,35 +1382,193 @@ void forth_pwm_write(forth_cell_t channel, forth_cell_t duty);
 
 
 // Fixed stack implementation - Remove inline functions from header
-std::string ForthCCodegen::generateStackImplementation() {
+std::string ForthCCodegen::generateWordPrototypes() const {
+    std::ostringstream header;
+    
+    header << "#ifndef FORTH_WORDS_H\n";
+    header << "#define FORTH_WORDS_H\n\n";
+    header << "// Prototypes of user-defined words shared by all shards\n";
+    for (const auto& word : wordOrder) {
+        header << "void " << wordFunctionNames.at(word) << "(void);\n";
+    }
+    for (const auto& interface : interfaces) {
+        for (const auto& word : interface->words) {
+            header << "void " << word.function << "(void);  // " << interface->module << "\n";
+        }
+    }
+    for (const auto& clone : specializations) {
+        header << "void " << clone->function << "(void);  // " << clone->word << " specialized\n";
+    }
+    header << "\n#endif // FORTH_WORDS_H\n";
+    
+    return header.str();
+}
+
+void ForthCCodegen::internString(const std::string& value) {
+    auto [it, inserted] = stringPool.try_emplace(value, PooledString{stringPoolSize, value.size()});
+    if (inserted) {
+        stringPoolOrder.push_back(value);
+        stringPoolSize += value.size();
+    }
+}
+
+std::string ForthCCodegen::generateStringPool() const {
+    std::ostringstream pool;
+    
+    pool << "// Generated string literal pool: each distinct literal is stored once\n";
+    pool << "// and referenced by (offset, length) from the program code\n";
+    pool << "#include \"forth_runtime.h\"\n\n";
+    pool << "const char " << stringPoolSymbol << "[] =\n";
+    for (size_t i = 0; i < stringPoolOrder.size(); i++) {
+        const auto& value = stringPoolOrder[i];
+        pool << "    \"" << escapeCString(value) << "\""
+             << (i + 1 == stringPoolOrder.size() ? ";" : "")
+             << "  // " << stringPool.at(value).offset << "\n";
+    }
+    
+    return pool.str();
+}
+
+std::string ForthCCodegen::generateDataSpaceImplementation() const {
     std::ostringstream impl;
     
-    impl << R"(#include "forth_runtime.h"
+    impl << R"(// Generated data space: top-level VARIABLE, CREATE, "," and ALLOT are
+// resolved at compile time into the initial image below
+#include "forth_runtime.h"
 #include <string.h>
-#include <stdio.h>
-#include <stdlib.h>
-
-// ============================================================================
-// Stack Implementation - Proper global scope and non-inline functions
-// ============================================================================
 
-// Global stack instance - properly exposed (not static)
-forth_stack_t forth_data_stack = {
-    .data = {0},
-    .ptr = 0,
-    .size = FORTH_STACK_SIZE,
+)";
+    
+    // Sparse initializer: only non-zero cells are spelled out
+    impl << "FORTH_DMA_ATTR forth_cell_t forth_data_space[FORTH_DATA_SPACE_SIZE / sizeof(forth_cell_t)] = {\n";
+    size_t label = 0;
+    bool anyCell = false;
+    for (size_t cell = 0; cell < dataSpaceImage.size(); cell++) {
+        while (label < dataSpaceLabels.size() && dataSpaceLabels[label].first <= cell * sizeof(int32_t)) {
+            impl << "    // " << dataSpaceLabels[label].second << ": offset "
+                 << dataSpaceLabels[label].first << "\n";
+            label++;
+        }
+        if (dataSpaceImage[cell] != 0) {
+            impl << "    [" << cell << "] = " << dataSpaceImage[cell] << ",\n";
+            anyCell = true;
+        }
+    }
+    while (label < dataSpaceLabels.size()) {
+        impl << "    // " << dataSpaceLabels[label].second << ": offset "
+             << dataSpaceLabels[label].first << "\n";
+        label++;
+    }
+    if (!anyCell) {
+        impl << "    0\n";
+    }
+    impl << "};\n\n";
+    impl << "forth_ucell_t forth_data_here = FORTH_DATA_SPACE_IMAGE;\n";
+    
+    std::vector<std::string> slots;
+    for (const auto& [name, word] : dataSpaceWords) {
+        if (!word.isStatic) slots.push_back("forth_ucell_t " + word.slot + ";");
+    }
+    for (const auto& [name, slot] : constantSlots) {
+        slots.push_back("forth_cell_t " + slot + ";");
+    }
+    std::sort(slots.begin(), slots.end());
+    for (const auto& slot : slots) {
+        impl << slot << "\n";
+    }
+    
+    impl << R"(
+static void forth_data_error(const char* message) {
     #ifdef ESP32_PLATFORM
-    .lock = portMUX_INITIALIZER_UNLOCKED,
+    ESP_LOGE("FORTH", "%s", message);
+    #else
+    fprintf(stderr, "FORTH: %s\n", message);
     #endif
-};
+}
 
 // ============================================================================
-// Core Operations - All non-inline for proper linking
+// Linear Allocator
 // ============================================================================
 
-void forth_init(void) {
-    forth_data_stack.ptr = 0;
-    forth_data_stack.size = FORTH_STACK_SIZE;
+// Align HERE, reserve bytes and return the offset of the reservation.
+// Offset 0 is returned when the data space is exhausted.
+forth_ucell_t forth_data_create(forth_ucell_t bytes) {
+    forth_ucell_t offset = FORTH_DATA_ALIGN(forth_data_here);
+    if (offset > FORTH_DATA_SPACE_SIZE || bytes > FORTH_DATA_SPACE_SIZE - offset) {
+        forth_data_error("Data space exhausted!");
+        return 0;
+    }
+    memset((forth_byte_t*)forth_data_space + offset, 0, bytes);
+    forth_data_here = offset + bytes;
+    return offset;
+}
+
+void forth_here(void) {
+    forth_push(FORTH_DATA_ADDR(forth_data_here));
+}
+
+void forth_allot(void) {
+    forth_cell_t bytes = forth_pop();
+    if (bytes < 0 ? (forth_ucell_t)-bytes > forth_data_here
+                  : (forth_ucell_t)bytes > FORTH_DATA_SPACE_SIZE - forth_data_here) {
+        forth_data_error("ALLOT outside data space!");
+        return;
+    }
+    forth_data_here += (forth_ucell_t)bytes;
+}
+
+void forth_comma(void) {
+    forth_cell_t value = forth_pop();
+    forth_ucell_t offset = FORTH_DATA_ALIGN(forth_data_here);
+    if (offset + sizeof(forth_cell_t) > FORTH_DATA_SPACE_SIZE) {
+        forth_data_error("Data space exhausted!");
+        return;
+    }
+    forth_data_space[offset / sizeof(forth_cell_t)] = value;
+    forth_data_here = offset + sizeof(forth_cell_t);
+}
+
+void forth_cells(void) {
+    forth_push(forth_pop() * (forth_cell_t)sizeof(forth_cell_t));
+}
+
+void forth_cell_plus(void) {
+    forth_push(forth_pop() + (forth_cell_t)sizeof(forth_cell_t));
+}
+)";
+    
+    return impl.str();
+}
+
+std::string ForthCCodegen::generateStackImplementation() {
+    std::ostringstream impl;
+    
+    impl << R"(#include "forth_runtime.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// ============================================================================
+// Stack Implementation - Proper global scope and non-inline functions
+// ============================================================================
+
+// Global stack instance - properly exposed (not static)
+forth_stack_t forth_data_stack = {
+    .data = {0},
+    .ptr = 0,
+    .size = FORTH_STACK_SIZE,
+    #ifdef ESP32_PLATFORM
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+    #endif
+};
+
+// ============================================================================
+// Core Operations - All non-inline for proper linking
+// ============================================================================
+
+void forth_init(void) {
+    forth_data_stack.ptr = 0;
+    forth_data_stack.size = FORTH_STACK_SIZE;
     memset(forth_data_stack.data, 0, sizeof(forth_data_stack.data));
     
     #ifdef ESP32_PLATFORM
@@ -590,7 +1579,10 @@ void forth_init(void) {
 }
 
 void forth_cleanup(void) {
-    // Cleanup if needed
+    #if FORTH_HAS_OUTPUT
+    forth_flush();
+    #endif
+    fflush(stdout);
 }
 
 // All functions are now non-inline to prevent linker issues
@@ -842,6 +1834,24 @@ std::string ForthCCodegen::generateMathImplementation() {
     forth_push(a % b);
 }
 
+)";
+    }
+
+    if (usedBuiltins.contains("NEGATE")) {
+        impl << R"(FORTH_IRAM_ATTR void forth_negate(void) {
+    forth_cell_t a = forth_pop();
+    forth_push((forth_cell_t)(0u - (uint32_t)a));
+}
+
+)";
+    }
+
+    if (usedBuiltins.contains("ABS")) {
+        impl << R"(FORTH_IRAM_ATTR void forth_abs(void) {
+    forth_cell_t a = forth_pop();
+    forth_push(a < 0 ? (forth_cell_t)(0u - (uint32_t)a) : a);
+}
+
 )";
     }
     return impl.str();
@@ -852,55 +1862,178 @@ std::string ForthCCodegen::generateIOImplementation() {
     
     impl << R"(#include "forth_runtime.h"
 #include <stdio.h>
+#include <string.h>
+
+#if defined(ESP32_PLATFORM) || defined(__unix__) || defined(__APPLE__)
+    #include <errno.h>
+    #include <unistd.h>
+    #define FORTH_OUTPUT_USE_WRITE 1
+#endif
+
+#if (FORTH_OUTPUT_BUFFER_SIZE & (FORTH_OUTPUT_BUFFER_SIZE - 1)) != 0
+    #error "FORTH_OUTPUT_BUFFER_SIZE must be a power of two"
+#endif
+
+// ============================================================================
+// Buffered Output Layer
+// ============================================================================
+// All console output goes through a ring buffer that is drained to the
+// device in large writes. The buffer is always drained when full, by
+// FLUSH and at cleanup; FORTH_FLUSH_POLICY adds newline and idle flushes.
+
+#define FORTH_OUT_MASK (FORTH_OUTPUT_BUFFER_SIZE - 1)
+
+static char forth_out_buf[FORTH_OUTPUT_BUFFER_SIZE];
+static size_t forth_out_head;   // Total bytes buffered (wraps via mask)
+static size_t forth_out_tail;   // Total bytes drained
+
+static void forth_output_sink(const char* data, size_t length) {
+#ifdef FORTH_OUTPUT_USE_WRITE
+    while (length > 0) {
+        ssize_t written = write(STDOUT_FILENO, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+#else
+    fwrite(data, 1, length, stdout);
+    fflush(stdout);
+#endif
+}
+
+void forth_flush(void) {
+    while (forth_out_tail != forth_out_head) {
+        size_t start = forth_out_tail & FORTH_OUT_MASK;
+        size_t pending = forth_out_head - forth_out_tail;
+        size_t contiguous = FORTH_OUTPUT_BUFFER_SIZE - start;
+        size_t chunk = pending < contiguous ? pending : contiguous;
+        forth_output_sink(forth_out_buf + start, chunk);
+        forth_out_tail += chunk;
+    }
+}
+
+// Called from points where the program waits (delays, end of a task slice)
+void forth_output_idle(void) {
+    #if FORTH_FLUSH_POLICY & FORTH_FLUSH_ON_IDLE
+    forth_flush();
+    #endif
+}
+
+static inline void forth_out_char(char c) {
+    if (forth_out_head - forth_out_tail == FORTH_OUTPUT_BUFFER_SIZE) {
+        forth_flush();
+    }
+    forth_out_buf[forth_out_head++ & FORTH_OUT_MASK] = c;
+    #if FORTH_FLUSH_POLICY & FORTH_FLUSH_ON_NEWLINE
+    if (c == '\n') {
+        forth_flush();
+    }
+    #endif
+}
+
+// Length-known write for string literals (no format parsing)
+void forth_write(const char* data, size_t length) {
+    if (length >= FORTH_OUTPUT_BUFFER_SIZE) {
+        // Large writes bypass the buffer
+        forth_flush();
+        forth_output_sink(data, length);
+        return;
+    }
+    
+    #if FORTH_FLUSH_POLICY & FORTH_FLUSH_ON_NEWLINE
+    bool newline = memchr(data, '\n', length) != NULL;
+    #endif
+    
+    while (length > 0) {
+        size_t space = FORTH_OUTPUT_BUFFER_SIZE - (forth_out_head - forth_out_tail);
+        if (space == 0) {
+            forth_flush();
+            continue;
+        }
+        size_t start = forth_out_head & FORTH_OUT_MASK;
+        size_t chunk = FORTH_OUTPUT_BUFFER_SIZE - start;
+        if (chunk > space) chunk = space;
+        if (chunk > length) chunk = length;
+        memcpy(forth_out_buf + start, data, chunk);
+        forth_out_head += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+    
+    #if FORTH_FLUSH_POLICY & FORTH_FLUSH_ON_NEWLINE
+    if (newline) {
+        forth_flush();
+    }
+    #endif
+}
 
 // ============================================================================
 // I/O Operations
 // ============================================================================
 
 void forth_emit(void) {
-    forth_cell_t c = forth_pop();
-    putchar((int)c);
-    #ifdef ESP32_PLATFORM
-    fflush(stdout);
-    #endif
+    forth_out_char((char)forth_pop());
 }
 
 void forth_type(void) {
     forth_cell_t len = forth_pop();
     forth_cell_t addr = forth_pop();
-    const char* str = (const char*)addr;
-    for (int i = 0; i < len; i++) {
-        putchar(str[i]);
+    if (len > 0) {
+        forth_write((const char*)FORTH_DATA_PTR(addr), (size_t)len);
     }
-    #ifdef ESP32_PLATFORM
-    fflush(stdout);
-    #endif
 }
 
 void forth_cr(void) {
-    putchar('\n');
-    #ifdef ESP32_PLATFORM
-    fflush(stdout);
-    #endif
+    forth_out_char('\n');
 }
 
 void forth_space(void) {
-    putchar(' ');
+    forth_out_char(' ');
 }
 
 void forth_spaces(void) {
     forth_cell_t n = forth_pop();
-    for (int i = 0; i < n; i++) {
-        putchar(' ');
+    for (forth_cell_t i = 0; i < n; i++) {
+        forth_out_char(' ');
     }
 }
 
-// Helper function to print numbers
+// Two digits per division step
+static const char forth_digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
+
+// Print a number followed by a space, like the standard "."
 void forth_print_number(forth_cell_t value) {
-    printf("%d", (int)value);
-    #ifdef ESP32_PLATFORM
-    fflush(stdout);
-    #endif
+    char text[12];  // "-2147483648 "
+    char* p = text + sizeof(text);
+    forth_ucell_t magnitude = value < 0 ? (forth_ucell_t)0 - (forth_ucell_t)value
+                                        : (forth_ucell_t)value;
+    
+    *--p = ' ';
+    while (magnitude >= 100) {
+        const char* pair = forth_digit_pairs + (magnitude % 100) * 2;
+        magnitude /= 100;
+        *--p = pair[1];
+        *--p = pair[0];
+    }
+    if (magnitude >= 10) {
+        const char* pair = forth_digit_pairs + magnitude * 2;
+        *--p = pair[1];
+        *--p = pair[0];
+    } else {
+        *--p = (char)('0' + magnitude);
+    }
+    if (value < 0) {
+        *--p = '-';
+    }
+    
+    forth_write(p, (size_t)(text + sizeof(text) - p));
 }
 )";
 
@@ -922,10 +2055,10 @@ void forth_fetch(void) {
     // Ensure aligned access on ESP32
     if (addr & 3) {
         forth_cell_t value;
-        memcpy(&value, (void*)addr, sizeof(forth_cell_t));
+        memcpy(&value, FORTH_DATA_PTR(addr), sizeof(forth_cell_t));
         forth_push(value);
     } else {
-        forth_push(*(forth_cell_t*)addr);
+        forth_push(*(forth_cell_t*)FORTH_DATA_PTR(addr));
     }
 }
 
@@ -934,477 +2067,2764 @@ void forth_store(void) {
     forth_cell_t value = forth_pop();
     // Ensure aligned access on ESP32
     if (addr & 3) {
-        memcpy((void*)addr, &value, sizeof(forth_cell_t));
+        memcpy(FORTH_DATA_PTR(addr), &value, sizeof(forth_cell_t));
     } else {
-        *(forth_cell_t*)addr = value;
+        *(forth_cell_t*)FORTH_DATA_PTR(addr) = value;
     }
 }
 
 void forth_byte_fetch(void) {
     forth_cell_t addr = forth_pop();
-    forth_push(*(forth_byte_t*)addr);
+    forth_push(*(forth_byte_t*)FORTH_DATA_PTR(addr));
 }
 
 void forth_byte_store(void) {
     forth_cell_t addr = forth_pop();
     forth_cell_t value = forth_pop();
-    *(forth_byte_t*)addr = (forth_byte_t)value;
+    *(forth_byte_t*)FORTH_DATA_PTR(addr) = (forth_byte_t)value;
+}
+
+// ============================================================================
+// Block Memory Operations (memmove/memset run at memory bandwidth)
+// ============================================================================
+
+// MOVE ( src dst u -- ) copies u bytes as if through a temporary buffer
+void forth_move(void) {
+    forth_cell_t count = forth_pop();
+    forth_cell_t dst = forth_pop();
+    forth_cell_t src = forth_pop();
+    if (count > 0) {
+        memmove(FORTH_DATA_PTR(dst), FORTH_DATA_PTR(src), (size_t)count);
+    }
+}
+
+// CMOVE ( src dst u -- ) copies from low to high addresses, so an
+// overlapping destination above the source repeats the leading bytes
+void forth_cmove(void) {
+    forth_cell_t count = forth_pop();
+    forth_cell_t to = forth_pop();
+    forth_cell_t from = forth_pop();
+    forth_byte_t* dst = (forth_byte_t*)FORTH_DATA_PTR(to);
+    const forth_byte_t* src = (const forth_byte_t*)FORTH_DATA_PTR(from);
+    if (count <= 0) return;
+    if (dst <= src || dst >= src + count) {
+        memmove(dst, src, (size_t)count);
+    } else {
+        for (forth_cell_t i = 0; i < count; i++) dst[i] = src[i];
+    }
+}
+
+// CMOVE> ( src dst u -- ) copies from high to low addresses
+void forth_cmove_up(void) {
+    forth_cell_t count = forth_pop();
+    forth_cell_t to = forth_pop();
+    forth_cell_t from = forth_pop();
+    forth_byte_t* dst = (forth_byte_t*)FORTH_DATA_PTR(to);
+    const forth_byte_t* src = (const forth_byte_t*)FORTH_DATA_PTR(from);
+    if (count <= 0) return;
+    if (dst >= src || dst + count <= src) {
+        memmove(dst, src, (size_t)count);
+    } else {
+        for (forth_cell_t i = count; i > 0; i--) dst[i - 1] = src[i - 1];
+    }
+}
+
+// FILL ( addr u char -- )
+void forth_fill(void) {
+    forth_cell_t value = forth_pop();
+    forth_cell_t count = forth_pop();
+    forth_cell_t addr = forth_pop();
+    if (count > 0) {
+        memset(FORTH_DATA_PTR(addr), (forth_byte_t)value, (size_t)count);
+    }
+}
+
+// ERASE ( addr u -- )
+void forth_erase(void) {
+    forth_cell_t count = forth_pop();
+    forth_cell_t addr = forth_pop();
+    if (count > 0) {
+        memset(FORTH_DATA_PTR(addr), 0, (size_t)count);
+    }
 }
 )";
 
     return impl.str();
 }
 
-std::string ForthCCodegen::generateESP32Implementation() {
+std::string ForthCCodegen::generateArrayImplementation() const {
     std::ostringstream impl;
     
     impl << R"(#include "forth_runtime.h"
 
-#ifdef ESP32_PLATFORM
+// ============================================================================
+// Array Operations over Cells
+// ============================================================================
+//
+// Each word is a stack wrapper around a kernel on restrict-qualified cell
+// pointers. The portable kernels are plain counted loops that GCC
+// auto-vectorizes; with NEON or SSE4.1 the four-lane versions are used.
+// Cell arithmetic wraps, so sums and products are done in unsigned cells.
+//
+// ESP32-S3 builds use the portable loops: PIE's 32-bit adds saturate and it
+// has no 32-bit lane multiply, so it cannot reproduce cell arithmetic.
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define FORTH_SIMD_LANES 4
+    typedef int32x4_t forth_vec_t;
+    #define forth_vec_load(p)     vld1q_s32(p)
+    #define forth_vec_store(p, v) vst1q_s32((p), (v))
+    #define forth_vec_splat(x)    vdupq_n_s32(x)
+    #define forth_vec_add(a, b)   vaddq_s32((a), (b))
+    #define forth_vec_mul(a, b)   vmulq_s32((a), (b))
+    #define forth_vec_min(a, b)   vminq_s32((a), (b))
+    #define forth_vec_max(a, b)   vmaxq_s32((a), (b))
+#elif defined(__SSE4_1__)
+    #include <smmintrin.h>
+    #define FORTH_SIMD_LANES 4
+    typedef __m128i forth_vec_t;
+    #define forth_vec_load(p)     _mm_loadu_si128((const __m128i*)(p))
+    #define forth_vec_store(p, v) _mm_storeu_si128((__m128i*)(p), (v))
+    #define forth_vec_splat(x)    _mm_set1_epi32(x)
+    #define forth_vec_add(a, b)   _mm_add_epi32((a), (b))
+    #define forth_vec_mul(a, b)   _mm_mullo_epi32((a), (b))
+    #define forth_vec_min(a, b)   _mm_min_epi32((a), (b))
+    #define forth_vec_max(a, b)   _mm_max_epi32((a), (b))
+#else
+    #define FORTH_SIMD_LANES 1
+#endif
 
-#include "driver/gpio.h"
-#include "driver/adc.h"
-#include "driver/ledc.h"
-#include "esp_timer.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
+#if FORTH_SIMD_LANES > 1
+// Vector loops consume whole groups of lanes; the scalar loops finish the tail
+#define FORTH_VEC_LOOP(i, n) for (; (n) - (i) >= FORTH_SIMD_LANES; (i) += FORTH_SIMD_LANES)
+
+static inline forth_ucell_t forth_vec_sum_lanes(forth_vec_t v) {
+    forth_cell_t lanes[FORTH_SIMD_LANES];
+    forth_vec_store(lanes, v);
+    return (forth_ucell_t)lanes[0] + (forth_ucell_t)lanes[1] +
+           (forth_ucell_t)lanes[2] + (forth_ucell_t)lanes[3];
+}
+#endif
 
 // ============================================================================
-// ESP32-Specific Hardware Operations
+// Kernels
 // ============================================================================
 
-static bool gpio_initialized = false;
+FORTH_IRAM_ATTR forth_cell_t forth_cells_sum(const forth_cell_t* restrict cells, forth_cell_t n) {
+    forth_ucell_t sum = 0;
+    forth_cell_t i = 0;
+#if FORTH_SIMD_LANES > 1
+    forth_vec_t acc = forth_vec_splat(0);
+    FORTH_VEC_LOOP(i, n) {
+        acc = forth_vec_add(acc, forth_vec_load(cells + i));
+    }
+    sum = forth_vec_sum_lanes(acc);
+#endif
+    for (; i < n; i++) {
+        sum += (forth_ucell_t)cells[i];
+    }
+    return (forth_cell_t)sum;
+}
 
-void forth_esp32_init(void) {
-    if (!gpio_initialized) {
-        gpio_initialized = true;
+FORTH_IRAM_ATTR forth_cell_t forth_cells_dot(const forth_cell_t* restrict a,
+                                             const forth_cell_t* restrict b, forth_cell_t n) {
+    forth_ucell_t sum = 0;
+    forth_cell_t i = 0;
+#if FORTH_SIMD_LANES > 1
+    forth_vec_t acc = forth_vec_splat(0);
+    FORTH_VEC_LOOP(i, n) {
+        acc = forth_vec_add(acc, forth_vec_mul(forth_vec_load(a + i), forth_vec_load(b + i)));
+    }
+    sum = forth_vec_sum_lanes(acc);
+#endif
+    for (; i < n; i++) {
+        sum += (forth_ucell_t)a[i] * (forth_ucell_t)b[i];
     }
+    return (forth_cell_t)sum;
 }
 
-// GPIO Operations (IRAM for interrupt handling)
-void forth_gpio_init(forth_cell_t pin, forth_cell_t mode) {
-    gpio_config_t io_conf = {
-        .pin_bit_mask = (1ULL << pin),
-        .mode = (mode == 0) ? GPIO_MODE_INPUT : GPIO_MODE_OUTPUT,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE,
-    };
-    gpio_config(&io_conf);
+FORTH_IRAM_ATTR forth_cell_t forth_cells_min(const forth_cell_t* restrict cells, forth_cell_t n) {
+    forth_cell_t result = INT32_MAX;
+    forth_cell_t i = 0;
+#if FORTH_SIMD_LANES > 1
+    if (n >= FORTH_SIMD_LANES) {
+        forth_vec_t acc = forth_vec_splat(INT32_MAX);
+        FORTH_VEC_LOOP(i, n) {
+            acc = forth_vec_min(acc, forth_vec_load(cells + i));
+        }
+        forth_cell_t lanes[FORTH_SIMD_LANES];
+        forth_vec_store(lanes, acc);
+        for (int lane = 0; lane < FORTH_SIMD_LANES; lane++) {
+            result = lanes[lane] < result ? lanes[lane] : result;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        result = cells[i] < result ? cells[i] : result;
+    }
+    return result;
 }
 
-FORTH_IRAM_ATTR void forth_gpio_write(forth_cell_t pin, forth_cell_t value) {
-    gpio_set_level((gpio_num_t)pin, value ? 1 : 0);
+FORTH_IRAM_ATTR forth_cell_t forth_cells_max(const forth_cell_t* restrict cells, forth_cell_t n) {
+    forth_cell_t result = INT32_MIN;
+    forth_cell_t i = 0;
+#if FORTH_SIMD_LANES > 1
+    if (n >= FORTH_SIMD_LANES) {
+        forth_vec_t acc = forth_vec_splat(INT32_MIN);
+        FORTH_VEC_LOOP(i, n) {
+            acc = forth_vec_max(acc, forth_vec_load(cells + i));
+        }
+        forth_cell_t lanes[FORTH_SIMD_LANES];
+        forth_vec_store(lanes, acc);
+        for (int lane = 0; lane < FORTH_SIMD_LANES; lane++) {
+            result = lanes[lane] > result ? lanes[lane] : result;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        result = cells[i] > result ? cells[i] : result;
+    }
+    return result;
 }
 
-FORTH_IRAM_ATTR forth_cell_t forth_gpio_read(forth_cell_t pin) {
-    return gpio_get_level((gpio_num_t)pin);
+FORTH_IRAM_ATTR void forth_cells_add(forth_cell_t* restrict cells, forth_cell_t n, forth_cell_t k) {
+    forth_cell_t i = 0;
+#if FORTH_SIMD_LANES > 1
+    forth_vec_t kv = forth_vec_splat(k);
+    FORTH_VEC_LOOP(i, n) {
+        forth_vec_store(cells + i, forth_vec_add(forth_vec_load(cells + i), kv));
+    }
+#endif
+    for (; i < n; i++) {
+        cells[i] = (forth_cell_t)((forth_ucell_t)cells[i] + (forth_ucell_t)k);
+    }
 }
 
-FORTH_IRAM_ATTR void forth_gpio_toggle(forth_cell_t pin) {
-    gpio_set_level((gpio_num_t)pin, !gpio_get_level((gpio_num_t)pin));
+FORTH_IRAM_ATTR void forth_cells_scale(forth_cell_t* restrict cells, forth_cell_t n, forth_cell_t k) {
+    forth_cell_t i = 0;
+#if FORTH_SIMD_LANES > 1
+    forth_vec_t kv = forth_vec_splat(k);
+    FORTH_VEC_LOOP(i, n) {
+        forth_vec_store(cells + i, forth_vec_mul(forth_vec_load(cells + i), kv));
+    }
+#endif
+    for (; i < n; i++) {
+        cells[i] = (forth_cell_t)((forth_ucell_t)cells[i] * (forth_ucell_t)k);
+    }
 }
 
-// Timing Functions
-void forth_delay_ms(forth_cell_t ms) {
-    vTaskDelay(ms / portTICK_PERIOD_MS);
+// ============================================================================
+// Stack Words (counts are in cells)
+// ============================================================================
+
+// SUM ( addr n -- sum )
+void forth_sum(void) {
+    forth_cell_t n = forth_pop();
+    forth_cell_t addr = forth_pop();
+    forth_push(forth_cells_sum((const forth_cell_t*)FORTH_DATA_PTR(addr), n));
 }
 
-void forth_delay_us(forth_cell_t us) {
-    ets_delay_us(us);
+// DOT ( addr1 addr2 n -- dot )
+void forth_dot(void) {
+    forth_cell_t n = forth_pop();
+    forth_cell_t b = forth_pop();
+    forth_cell_t a = forth_pop();
+    forth_push(forth_cells_dot((const forth_cell_t*)FORTH_DATA_PTR(a), (const forth_cell_t*)FORTH_DATA_PTR(b), n));
 }
 
-uint32_t forth_millis(void) {
-    return (uint32_t)(esp_timer_get_time() / 1000);
+// MIN-REDUCE ( addr n -- min ), INT32_MAX for an empty array
+void forth_min_reduce(void) {
+    forth_cell_t n = forth_pop();
+    forth_cell_t addr = forth_pop();
+    forth_push(forth_cells_min((const forth_cell_t*)FORTH_DATA_PTR(addr), n));
 }
 
-uint32_t forth_micros(void) {
-    return (uint32_t)esp_timer_get_time();
-} 
+// MAX-REDUCE ( addr n -- max ), INT32_MIN for an empty array
+void forth_max_reduce(void) {
+    forth_cell_t n = forth_pop();
+    forth_cell_t addr = forth_pop();
+    forth_push(forth_cells_max((const forth_cell_t*)FORTH_DATA_PTR(addr), n));
+}
 
-// ESP32_PLATFORM
-// ADC Functions
-forth_cell_t forth_adc_read(forth_cell_t channel) {
-    if (channel < 0 || channel > 7) return 0;
-    
-    // Configure attenuation for full range
-    adc1_config_channel_atten((adc1_channel_t)channel, ADC_ATTEN_DB_11);
-    
-    // Multi-sample for stability
-    int val = 0;
-    for (int i = 0; i < 4; i++) {
-        val += adc1_get_raw((adc1_channel_t)channel);
-    }
-    return val / 4;
+// MAP+ ( addr n k -- ) adds k to every element
+void forth_map_add(void) {
+    forth_cell_t k = forth_pop();
+    forth_cell_t n = forth_pop();
+    forth_cell_t addr = forth_pop();
+    forth_cells_add((forth_cell_t*)FORTH_DATA_PTR(addr), n, k);
 }
 
-// DAC Functions (ESP32 has 2 DAC channels)
-void forth_dac_write(forth_cell_t channel, forth_cell_t value) {
-    if (channel == 0 || channel == 1) {
-        dac_output_voltage((dac_channel_t)channel, value & 0xFF);
-    }
+// SCALE ( addr n k -- ) multiplies every element by k
+void forth_scale(void) {
+    forth_cell_t k = forth_pop();
+    forth_cell_t n = forth_pop();
+    forth_cell_t addr = forth_pop();
+    forth_cells_scale((forth_cell_t*)FORTH_DATA_PTR(addr), n, k);
 }
+)";
 
-// PWM Functions using LEDC
-static ledc_channel_t pwm_channels[8] = {
-    LEDC_CHANNEL_0, LEDC_CHANNEL_1, LEDC_CHANNEL_2, LEDC_CHANNEL_3,
-    LEDC_CHANNEL_4, LEDC_CHANNEL_5, LEDC_CHANNEL_6, LEDC_CHANNEL_7
+    return impl.str();
+}
+
+std::string ForthCCodegen::generateTaskImplementation() const {
+    std::ostringstream impl;
+    
+    impl << R"(#if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+    #define _XOPEN_SOURCE 700  // ucontext
+#endif
+
+#include "forth_runtime.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Cooperative Tasks
+// ============================================================================
+//
+// "TASK name" declares a task and "name START word" makes it run word.
+// Tasks only switch at PAUSE, at STOP and when their word returns. The
+// top-level program is the scheduler: each PAUSE it executes gives every
+// ready task one turn, up to that task's next PAUSE, and the program ends
+// once all tasks have stopped.
+//
+// Tasks are stackful coroutines taking turns on one shared C stack. When a
+// task switches out, the live part of that stack (its return stack) and its
+// data stack are copied into the task, and copied back when it resumes. A
+// paused task costs only the stack it is using at its PAUSE - typically a
+// few hundred bytes - so thousands of tasks fit in the RAM of one FreeRTOS
+// task.
+//
+// The switch itself is a handful of instructions on x86-64 and on RV32
+// without an FPU (ESP32-C3/C6), and ucontext on other hosts. Xtensa
+// (ESP32, ESP32-S3) has no portable stack switch because of its register
+// windows: there every task is a FreeRTOS task with a stack of
+// FORTH_TASK_STACK_SIZE bytes, and PAUSE hands the CPU over explicitly.
+// That costs a whole stack per task, so far fewer tasks fit; it is a known
+// gap until an Xtensa switch lands.
+
+#if defined(FORTH_TASK_USE_UCONTEXT)
+    #define FORTH_TASK_UCONTEXT 1
+#elif defined(__x86_64__) && defined(__ELF__)
+    #define FORTH_TASK_ASM 1
+#elif defined(__riscv) && __riscv_xlen == 32 && !defined(__riscv_flen)
+    #define FORTH_TASK_ASM 1
+#elif defined(ESP32_PLATFORM)
+    #define FORTH_TASK_RTOS 1
+#else
+    #define FORTH_TASK_UCONTEXT 1
+#endif
+
+#ifdef FORTH_TASK_UCONTEXT
+    #include <ucontext.h>
+#endif
+#ifdef FORTH_TASK_RTOS
+    #include "freertos/task.h"
+#endif
+
+#define FORTH_TASK_IDLE  0  // Not started, finished or stopped
+#define FORTH_TASK_READY 1  // Runs at the program's next PAUSE
+
+typedef struct {
+    void (*entry)(void);     // Word the task runs
+    uint8_t state;
+    bool queued;             // In forth_ready[]
+    bool live;               // Paused inside entry: resume rather than start
+    forth_cell_t* cells;     // Data stack while switched out
+    size_t depth;
+    size_t cell_capacity;
+#ifdef FORTH_TASK_RTOS
+    TaskHandle_t thread;
+#else
+    forth_byte_t* stack;     // Return stack (slice of the shared stack) while switched out
+    size_t stack_used;
+    size_t stack_capacity;
+    void* sp;                // Stack pointer inside the shared stack
+    #ifdef FORTH_TASK_UCONTEXT
+    ucontext_t context;
+    #endif
+#endif
+} forth_task_t;
+
+static forth_task_t forth_tasks[FORTH_TASK_MAX];
+static forth_task_t* forth_ready[FORTH_TASK_MAX];  // Ready tasks in turn order
+static size_t forth_ready_count = 0;
+static forth_task_t forth_program_task;          // Program's data stack during a task's turn
+static forth_task_t* forth_current_task = NULL;  // NULL while the program itself runs
+
+static void forth_task_error(const char* message) {
+    #ifdef ESP32_PLATFORM
+    ESP_LOGE("FORTH", "%s", message);
+    #else
+    fprintf(stderr, "FORTH: %s\n", message);
+    #endif
+}
+
+static void forth_task_main(void);
+
+// ============================================================================
+// Context Switch
+// ============================================================================
+//
+// forth_task_enter() starts or resumes a task on the program's behalf and
+// returns when the task calls forth_task_leave().
+
+#ifdef FORTH_TASK_RTOS
+
+static TaskHandle_t forth_program_thread;
+
+static void forth_task_thread(void* arg) {
+    (void)arg;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);  // First turn
+    forth_task_main();
+}
+
+static void forth_task_enter(forth_task_t* task) {
+    forth_program_thread = xTaskGetCurrentTaskHandle();
+    if (!task->live) {
+        if (xTaskCreatePinnedToCore(forth_task_thread, "forth_task", FORTH_TASK_STACK_SIZE, NULL,
+                                    uxTaskPriorityGet(NULL), &task->thread, xPortGetCoreID()) != pdPASS) {
+            forth_task_error("Cannot create task");
+            task->state = FORTH_TASK_IDLE;
+            return;
+        }
+        task->live = true;
+    }
+    xTaskNotifyGive(task->thread);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+static void forth_task_leave(forth_task_t* task) {
+    (void)task;
+    xTaskNotifyGive(forth_program_thread);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+#else
+
+// Stack the running task uses; paused tasks keep a copy of their part
+static forth_byte_t forth_task_stack[FORTH_TASK_STACK_SIZE] __attribute__((aligned(16)));
+#define FORTH_TASK_STACK_TOP (forth_task_stack + sizeof(forth_task_stack))
+
+// Kept at the far end of the shared stack: a task that reached it has
+// overwritten memory it does not own
+static const uint32_t forth_task_canary = 0x5441534Bu;  // "TASK"
+
+#ifdef FORTH_TASK_ASM
+
+// forth_task_switch(&save, load): push the callee-saved registers, store the
+// stack pointer in *save, load the other stack and pop the registers saved
+// there. A new task's first switch returns into forth_task_main.
+void forth_task_switch(void** save, void* load);
+
+#if defined(__x86_64__)
+__asm__(
+    ".text\n"
+    ".globl forth_task_switch\n"
+    ".type forth_task_switch, @function\n"
+    "forth_task_switch:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size forth_task_switch, .-forth_task_switch\n");
+#else
+__asm__(
+    ".text\n"
+    ".globl forth_task_switch\n"
+    ".type forth_task_switch, @function\n"
+    "forth_task_switch:\n"
+    "    addi sp, sp, -64\n"
+    "    sw ra, 0(sp)\n"
+    "    sw s0, 4(sp)\n"
+    "    sw s1, 8(sp)\n"
+    "    sw s2, 12(sp)\n"
+    "    sw s3, 16(sp)\n"
+    "    sw s4, 20(sp)\n"
+    "    sw s5, 24(sp)\n"
+    "    sw s6, 28(sp)\n"
+    "    sw s7, 32(sp)\n"
+    "    sw s8, 36(sp)\n"
+    "    sw s9, 40(sp)\n"
+    "    sw s10, 44(sp)\n"
+    "    sw s11, 48(sp)\n"
+    "    sw sp, 0(a0)\n"
+    "    mv sp, a1\n"
+    "    lw ra, 0(sp)\n"
+    "    lw s0, 4(sp)\n"
+    "    lw s1, 8(sp)\n"
+    "    lw s2, 12(sp)\n"
+    "    lw s3, 16(sp)\n"
+    "    lw s4, 20(sp)\n"
+    "    lw s5, 24(sp)\n"
+    "    lw s6, 28(sp)\n"
+    "    lw s7, 32(sp)\n"
+    "    lw s8, 36(sp)\n"
+    "    lw s9, 40(sp)\n"
+    "    lw s10, 44(sp)\n"
+    "    lw s11, 48(sp)\n"
+    "    addi sp, sp, 64\n"
+    "    ret\n"
+    ".size forth_task_switch, .-forth_task_switch\n");
+#endif
+
+static void* forth_program_sp;
+
+static void forth_task_enter(forth_task_t* task) {
+    if (!task->live) {
+        // Saved registers of a fresh task: zeros, returning into forth_task_main
+        void** sp = (void**)FORTH_TASK_STACK_TOP;
+        #if defined(__x86_64__)
+        *--sp = NULL;                    // Keeps forth_task_main's frame aligned
+        *--sp = (void*)forth_task_main;
+        for (int i = 0; i < 6; i++) *--sp = NULL;
+        #else
+        sp -= 16;
+        memset(sp, 0, 16 * sizeof(void*));
+        sp[0] = (void*)forth_task_main;  // ra
+        #endif
+        task->sp = sp;
+        task->live = true;
+    } else {
+        memcpy(task->sp, task->stack, task->stack_used);
+    }
+    forth_task_switch(&forth_program_sp, task->sp);
+}
+
+static void forth_task_leave(forth_task_t* task) {
+    forth_task_switch(&task->sp, forth_program_sp);
+}
+
+#else  // FORTH_TASK_UCONTEXT
+
+// swapcontext keeps the registers in the task; the frames below this one
+// it still needs on the way back lie within the slack
+#define FORTH_TASK_STACK_SLACK 512
+
+static ucontext_t forth_program_context;
+
+static void forth_task_enter(forth_task_t* task) {
+    if (!task->live) {
+        getcontext(&task->context);
+        task->context.uc_stack.ss_sp = forth_task_stack;
+        task->context.uc_stack.ss_size = sizeof(forth_task_stack);
+        task->context.uc_link = NULL;
+        makecontext(&task->context, forth_task_main, 0);
+        task->live = true;
+    } else {
+        memcpy(task->sp, task->stack, task->stack_used);
+    }
+    swapcontext(&forth_program_context, &task->context);
+}
+
+static void forth_task_leave(forth_task_t* task) {
+    forth_byte_t marker = 0;
+    uintptr_t sp = (uintptr_t)&marker - FORTH_TASK_STACK_SLACK;
+    task->sp = sp < (uintptr_t)forth_task_stack ? (void*)forth_task_stack : (void*)sp;
+    swapcontext(&task->context, &forth_program_context);
+}
+
+#endif
+
+// Copy a paused task's part of the shared stack out
+static bool forth_task_park(forth_task_t* task) {
+    const size_t used = (size_t)(FORTH_TASK_STACK_TOP - (forth_byte_t*)task->sp);
+    if (used > task->stack_capacity) {
+        const size_t capacity = (used + 63) & ~(size_t)63;
+        forth_byte_t* stack = (forth_byte_t*)realloc(task->stack, capacity);
+        if (!stack) return false;
+        task->stack = stack;
+        task->stack_capacity = capacity;
+    }
+    memcpy(task->stack, task->sp, used);
+    task->stack_used = used;
+    return true;
+}
+
+#endif  // FORTH_TASK_RTOS
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+static void forth_task_main(void) {
+    forth_task_t* task = forth_current_task;
+    task->entry();
+    task->state = FORTH_TASK_IDLE;
+    forth_task_leave(task);  // Never resumed
+}
+
+// Drop a task's paused execution; it starts over when next started
+static void forth_task_discard(forth_task_t* task) {
+    task->state = FORTH_TASK_IDLE;
+    #ifdef FORTH_TASK_RTOS
+    if (task->live) {
+        vTaskDelete(task->thread);
+        task->thread = NULL;
+    }
+    #endif
+    task->live = false;
+}
+
+static bool forth_task_save_cells(forth_task_t* task) {
+    const size_t depth = forth_data_stack.ptr;
+    if (depth > task->cell_capacity) {
+        forth_cell_t* cells = (forth_cell_t*)realloc(task->cells, depth * sizeof(forth_cell_t));
+        if (!cells) return false;
+        task->cells = cells;
+        task->cell_capacity = depth;
+    }
+    if (depth > 0) {
+        memcpy(task->cells, forth_data_stack.data, depth * sizeof(forth_cell_t));
+    }
+    task->depth = depth;
+    return true;
+}
+
+static void forth_task_load_cells(const forth_task_t* task) {
+    if (task->depth > 0) {
+        memcpy(forth_data_stack.data, task->cells, task->depth * sizeof(forth_cell_t));
+    }
+    forth_data_stack.ptr = task->depth;
+}
+
+// One turn of a task: returns when it pauses or stops
+static void forth_task_run(forth_task_t* task) {
+    if (!forth_task_save_cells(&forth_program_task)) {
+        forth_task_error("Out of memory switching tasks");
+        return;
+    }
+    forth_task_load_cells(task);
+    
+    forth_current_task = task;
+    forth_task_enter(task);
+    forth_current_task = NULL;
+    
+    bool kept = forth_task_save_cells(task);
+    #ifndef FORTH_TASK_RTOS
+    if (memcmp(forth_task_stack, &forth_task_canary, sizeof(forth_task_canary)) != 0) {
+        forth_task_error("Task stack overflow: raise FORTH_TASK_STACK_SIZE");
+        abort();
+    }
+    kept = kept && (task->state != FORTH_TASK_READY || forth_task_park(task));
+    #endif
+    if (!kept) {
+        forth_task_error("Out of memory switching tasks");
+    }
+    if (!kept || task->state != FORTH_TASK_READY) {
+        forth_task_discard(task);
+    }
+    
+    forth_task_load_cells(&forth_program_task);
+}
+
+// Gives every ready task one turn. Tasks started during the round get
+// their turn in it too; stopped tasks leave the queue.
+static void forth_tasks_round(void) {
+    size_t kept = 0;
+    for (size_t i = 0; i < forth_ready_count; i++) {
+        forth_task_t* task = forth_ready[i];
+        if (task->state == FORTH_TASK_READY) {
+            forth_task_run(task);
+        }
+        if (task->state == FORTH_TASK_READY) {
+            forth_ready[kept++] = task;
+        } else {
+            task->queued = false;
+        }
+    }
+    forth_ready_count = kept;
+}
+
+// ============================================================================
+// Task Words
+// ============================================================================
+
+// START ( task -- ) with the word to run compiled in; a paused task starts over
+void forth_task_start(forth_cell_t handle, void (*entry)(void)) {
+    if (handle < 0 || handle >= FORTH_TASK_MAX) {
+        forth_task_error("START: not a task");
+        return;
+    }
+    forth_task_t* task = &forth_tasks[handle];
+    if (task == forth_current_task) {
+        forth_task_error("START: a task cannot restart itself");
+        return;
+    }
+    
+    forth_task_discard(task);
+    task->entry = entry;
+    task->depth = 0;
+    task->state = FORTH_TASK_READY;
+    if (!task->queued) {
+        task->queued = true;
+        forth_ready[forth_ready_count++] = task;
+    }
+    #ifndef FORTH_TASK_RTOS
+    memcpy(forth_task_stack, &forth_task_canary, sizeof(forth_task_canary));
+    #endif
+}
+
+// PAUSE ( -- ) in a task: switch back to the program. In the program: give
+// every ready task a turn.
+void forth_pause(void) {
+    forth_task_t* task = forth_current_task;
+    if (task) {
+        forth_task_leave(task);
+    } else {
+        forth_tasks_round();
+    }
+}
+
+// STOP ( -- ) ends the calling task; the program itself is not a task
+void forth_stop(void) {
+    forth_task_t* task = forth_current_task;
+    if (task) {
+        task->state = FORTH_TASK_IDLE;
+        forth_task_leave(task);  // Never resumed
+    }
+}
+
+// Run tasks until all have stopped (end of forth_program_main)
+void forth_tasks_join(void) {
+    if (forth_current_task) return;
+    while (forth_ready_count > 0) {
+        forth_tasks_round();
+    }
+}
+
+// Bytes held by ready tasks: control blocks and saved stacks, excluding
+// the shared stack
+size_t forth_tasks_memory(void) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < forth_ready_count; i++) {
+        const forth_task_t* task = forth_ready[i];
+        bytes += sizeof(forth_task_t) + sizeof(forth_task_t*) +
+                 task->cell_capacity * sizeof(forth_cell_t);
+        #ifdef FORTH_TASK_RTOS
+        bytes += task->live ? FORTH_TASK_STACK_SIZE : 0;
+        #else
+        bytes += task->stack_capacity;
+        #endif
+    }
+    return bytes;
+}
+)";
+
+    return impl.str();
+}
+
+std::string ForthCCodegen::generateChannelImplementation() const {
+    std::ostringstream impl;
+    
+    impl << R"(#include "forth_runtime.h"
+#include <stdatomic.h>
+
+#ifdef ESP32_PLATFORM
+    #include "freertos/task.h"
+#else
+    #include <sched.h>
+#endif
+
+// ============================================================================
+// Channels
+// ============================================================================
+//
+// "n CHANNEL name" declares a ring of n cells (rounded up to a power of
+// two) that the program RECVs from. Producers may be the program itself,
+// its tasks, or C code on other threads and cores - a sensor ISR or a
+// driver task pinned to the other ESP32 core.
+//
+// SPSC rings publish a slot with a release store of the tail index. Each
+// side keeps a private copy of the other side's index and reloads it only
+// when the ring looks full or empty, so the indices' cache lines bounce
+// only then.
+//
+// MPSC rings are Vyukov's bounded queue: a producer claims a slot by CAS on
+// the tail and publishes it through the slot's sequence number, so a
+// producer interrupted between claiming and publishing stalls nobody but
+// the consumer of that slot. Sequence numbers are stored minus the slot
+// index, which makes a zeroed ring an empty one.
+
+#define FORTH_CHANNEL_PAUSE )" << (usedFeatures.contains("TASK") ? "1" : "0") << R"(  // Waiting runs tasks
+
+#ifdef ESP32_PLATFORM
+    #define FORTH_CHANNEL_ALIGN sizeof(void*)  // No data cache on internal SRAM
+#else
+    #define FORTH_CHANNEL_ALIGN 64   // Producer and consumer indices on separate cache lines
+#endif
+
+typedef struct {
+    atomic_uint turn;      // MPSC: sequence number minus slot index
+    forth_cell_t value;
+} forth_channel_slot_t;
+
+typedef struct {
+    _Alignas(FORTH_CHANNEL_ALIGN) atomic_uint tail;  // Next slot to write
+    unsigned head_cache;                              // SPSC producer's copy of head
+    _Alignas(FORTH_CHANNEL_ALIGN) atomic_uint head;  // Next slot to read
+    unsigned tail_cache;                              // SPSC consumer's copy of tail
+    _Alignas(FORTH_CHANNEL_ALIGN) forth_channel_slot_t* slots;
+    unsigned mask;
+    bool mpsc;
+} forth_channel_t;
+
+)";
+
+    std::vector<const ChannelInfo*> ordered;
+    for (const auto& [name, channel] : channels) {
+        ordered.push_back(&channel);
+    }
+    std::sort(ordered.begin(), ordered.end(),
+              [](const ChannelInfo* a, const ChannelInfo* b) { return a->handle < b->handle; });
+    
+    for (const ChannelInfo* channel : ordered) {
+        impl << "static forth_channel_slot_t forth_channel_slots_" << channel->handle << "["
+             << channel->capacity << "];  // " << channel->name << "\n";
+    }
+    impl << "\nstatic forth_channel_t forth_channels[FORTH_CHANNEL_COUNT > 0 ? FORTH_CHANNEL_COUNT : 1] = {\n";
+    for (const ChannelInfo* channel : ordered) {
+        impl << "    { .slots = forth_channel_slots_" << channel->handle << ", .mask = "
+             << channel->capacity - 1 << ", .mpsc = " << (channel->multiProducer ? "true" : "false")
+             << " },  // " << channel->name << "\n";
+    }
+    impl << "};\n";
+
+    impl << R"(
+static void forth_channel_error(const char* message) {
+    #ifdef ESP32_PLATFORM
+    ESP_LOGE("FORTH", "%s", message);
+    #else
+    fprintf(stderr, "FORTH: %s\n", message);
+    #endif
+}
+
+static inline void forth_channel_relax(void) {
+    #if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+    #endif
+}
+
+// Spin briefly, then give the CPU to other threads. The program also gives
+// its tasks a turn, since one of them may be the other end of the channel.
+static void forth_channel_wait(unsigned* spins, bool run_tasks) {
+    #if FORTH_CHANNEL_PAUSE
+    if (run_tasks) {
+        forth_pause();
+    }
+    #else
+    (void)run_tasks;
+    #endif
+    
+    ++*spins;
+    if (*spins < 64) {
+        forth_channel_relax();
+        return;
+    }
+    #ifdef ESP32_PLATFORM
+    // taskYIELD only reaches equal priorities; a delay lets lower ones run too
+    if (*spins < 1024) {
+        taskYIELD();
+    } else {
+        vTaskDelay(1);
+    }
+    #else
+    sched_yield();
+    #endif
+}
+
+// ============================================================================
+// Ring Operations
+// ============================================================================
+
+FORTH_IRAM_ATTR
+bool forth_channel_try_send(forth_cell_t channel, forth_cell_t value) {
+    if (channel < 0 || channel >= FORTH_CHANNEL_COUNT) return false;
+    forth_channel_t* ch = &forth_channels[channel];
+    
+    if (!ch->mpsc) {
+        const unsigned tail = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+        if (tail - ch->head_cache > ch->mask) {
+            ch->head_cache = atomic_load_explicit(&ch->head, memory_order_acquire);
+            if (tail - ch->head_cache > ch->mask) return false;  // Full
+        }
+        ch->slots[tail & ch->mask].value = value;
+        atomic_store_explicit(&ch->tail, tail + 1, memory_order_release);
+        return true;
+    }
+    
+    unsigned pos = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+    for (;;) {
+        const unsigned index = pos & ch->mask;
+        forth_channel_slot_t* slot = &ch->slots[index];
+        const unsigned seq = atomic_load_explicit(&slot->turn, memory_order_acquire) + index;
+        const int diff = (int)(seq - pos);
+        if (diff == 0) {
+            // Free for this lap: claim it
+            if (atomic_compare_exchange_weak_explicit(&ch->tail, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                slot->value = value;
+                atomic_store_explicit(&slot->turn, pos + 1 - index, memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // Full: the consumer has not freed the slot yet
+        } else {
+            pos = atomic_load_explicit(&ch->tail, memory_order_relaxed);  // Another producer won
+        }
+    }
+}
+
+FORTH_IRAM_ATTR
+bool forth_channel_try_recv(forth_cell_t channel, forth_cell_t* value) {
+    if (channel < 0 || channel >= FORTH_CHANNEL_COUNT) return false;
+    forth_channel_t* ch = &forth_channels[channel];
+    const unsigned head = atomic_load_explicit(&ch->head, memory_order_relaxed);
+    const unsigned index = head & ch->mask;
+    
+    if (!ch->mpsc) {
+        if (head == ch->tail_cache) {
+            ch->tail_cache = atomic_load_explicit(&ch->tail, memory_order_acquire);
+            if (head == ch->tail_cache) return false;  // Empty
+        }
+        *value = ch->slots[index].value;
+    } else {
+        forth_channel_slot_t* slot = &ch->slots[index];
+        const unsigned seq = atomic_load_explicit(&slot->turn, memory_order_acquire) + index;
+        if (seq != head + 1) return false;  // Empty, or claimed but not yet written
+        *value = slot->value;
+        // Hand the slot to the producers' next lap
+        atomic_store_explicit(&slot->turn, head + ch->mask + 1 - index, memory_order_release);
+    }
+    atomic_store_explicit(&ch->head, head + 1, memory_order_release);
+    return true;
+}
+
+void forth_channel_send(forth_cell_t channel, forth_cell_t value) {
+    unsigned spins = 0;
+    while (!forth_channel_try_send(channel, value)) {
+        forth_channel_wait(&spins, false);
+    }
+}
+
+forth_cell_t forth_channel_recv(forth_cell_t channel) {
+    forth_cell_t value = 0;
+    unsigned spins = 0;
+    while (!forth_channel_try_recv(channel, &value)) {
+        forth_channel_wait(&spins, false);
+    }
+    return value;
+}
+
+// ============================================================================
+// Channel Words
+// ============================================================================
+
+static bool forth_channel_check(forth_cell_t channel, const char* word) {
+    if (channel >= 0 && channel < FORTH_CHANNEL_COUNT) return true;
+    forth_channel_error(word);
+    return false;
+}
+
+// SEND waits while the ring is full
+void forth_channel_put(forth_cell_t channel, forth_cell_t value) {
+    if (!forth_channel_check(channel, "SEND: not a channel")) return;
+    unsigned spins = 0;
+    while (!forth_channel_try_send(channel, value)) {
+        forth_channel_wait(&spins, true);
+    }
+}
+
+// RECV waits while the ring is empty
+forth_cell_t forth_channel_take(forth_cell_t channel) {
+    if (!forth_channel_check(channel, "RECV: not a channel")) return 0;
+    forth_cell_t value = 0;
+    unsigned spins = 0;
+    while (!forth_channel_try_recv(channel, &value)) {
+        forth_channel_wait(&spins, true);
+    }
+    return value;
+}
+
+// SEND ( x channel -- )
+void forth_send(void) {
+    forth_cell_t channel = forth_pop();
+    forth_cell_t value = forth_pop();
+    forth_channel_put(channel, value);
+}
+
+// RECV ( channel -- x )
+void forth_recv(void) {
+    forth_push(forth_channel_take(forth_pop()));
+}
+
+// TRY-RECV ( channel -- x flag ) never waits; x is 0 when flag is false
+void forth_try_recv(void) {
+    forth_cell_t channel = forth_pop();
+    forth_cell_t value = 0;
+    const bool received = forth_channel_check(channel, "TRY-RECV: not a channel") &&
+                          forth_channel_try_recv(channel, &value);
+    forth_push(value);
+    forth_push(received ? -1 : 0);
+}
+)";
+
+    return impl.str();
+}
+
+std::string ForthCCodegen::generateESP32Implementation() {
+    std::ostringstream impl;
+    
+    impl << R"(#include "forth_runtime.h"
+
+#ifdef ESP32_PLATFORM
+
+#include "driver/gpio.h"
+#include "driver/adc.h"
+#include "driver/ledc.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// ============================================================================
+// ESP32-Specific Hardware Operations
+// ============================================================================
+
+static bool gpio_initialized = false;
+
+void forth_esp32_init(void) {
+    if (!gpio_initialized) {
+        gpio_initialized = true;
+    }
+}
+
+// GPIO Operations (IRAM for interrupt handling)
+void forth_gpio_init(forth_cell_t pin, forth_cell_t mode) {
+    gpio_config_t io_conf = {
+        .pin_bit_mask = (1ULL << pin),
+        .mode = (mode == 0) ? GPIO_MODE_INPUT : GPIO_MODE_OUTPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+    gpio_config(&io_conf);
+}
+
+FORTH_IRAM_ATTR void forth_gpio_write(forth_cell_t pin, forth_cell_t value) {
+    gpio_set_level((gpio_num_t)pin, value ? 1 : 0);
+}
+
+FORTH_IRAM_ATTR forth_cell_t forth_gpio_read(forth_cell_t pin) {
+    return gpio_get_level((gpio_num_t)pin);
+}
+
+FORTH_IRAM_ATTR void forth_gpio_toggle(forth_cell_t pin) {
+    gpio_set_level((gpio_num_t)pin, !gpio_get_level((gpio_num_t)pin));
+}
+
+// Timing Functions
+void forth_delay_ms(forth_cell_t ms) {
+    #if FORTH_HAS_OUTPUT
+    forth_output_idle();
+    #endif
+    vTaskDelay(ms / portTICK_PERIOD_MS);
+}
+
+void forth_delay_us(forth_cell_t us) {
+    #if FORTH_HAS_OUTPUT
+    forth_output_idle();
+    #endif
+    ets_delay_us(us);
+}
+
+uint32_t forth_millis(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+uint32_t forth_micros(void) {
+    return (uint32_t)esp_timer_get_time();
+} 
+
+// ESP32_PLATFORM
+// ADC Functions
+forth_cell_t forth_adc_read(forth_cell_t channel) {
+    if (channel < 0 || channel > 7) return 0;
+    
+    // Configure attenuation for full range
+    adc1_config_channel_atten((adc1_channel_t)channel, ADC_ATTEN_DB_11);
+    
+    // Multi-sample for stability
+    int val = 0;
+    for (int i = 0; i < 4; i++) {
+        val += adc1_get_raw((adc1_channel_t)channel);
+    }
+    return val / 4;
+}
+
+// DAC Functions (ESP32 has 2 DAC channels)
+void forth_dac_write(forth_cell_t channel, forth_cell_t value) {
+    if (channel == 0 || channel == 1) {
+        dac_output_voltage((dac_channel_t)channel, value & 0xFF);
+    }
+}
+
+// PWM Functions using LEDC
+static ledc_channel_t pwm_channels[8] = {
+    LEDC_CHANNEL_0, LEDC_CHANNEL_1, LEDC_CHANNEL_2, LEDC_CHANNEL_3,
+    LEDC_CHANNEL_4, LEDC_CHANNEL_5, LEDC_CHANNEL_6, LEDC_CHANNEL_7
 };
 
-void forth_pwm_init(forth_cell_t channel, forth_cell_t freq) {
-    if (channel >= 8) return;
+void forth_pwm_init(forth_cell_t channel, forth_cell_t freq) {
+    if (channel >= 8) return;
+    
+    ledc_channel_config_t ledc_channel = {
+        .speed_mode = LEDC_HIGH_SPEED_MODE,
+        .channel = pwm_channels[channel],
+        .timer_sel = LEDC_TIMER_0,
+        .intr_type = LEDC_INTR_DISABLE,
+        .gpio_num = channel + 2,  // Map to GPIO2-9 by default
+        .duty = 0,
+        .hpoint = 0
+    };
+    ledc_channel_config(&ledc_channel);
+}
+
+void forth_pwm_write(forth_cell_t channel, forth_cell_t duty) {
+    if (channel >= 8) return;
+    
+    ledc_set_duty(LEDC_HIGH_SPEED_MODE, pwm_channels[channel], duty & 0x1FFF);
+    ledc_update_duty(LEDC_HIGH_SPEED_MODE, pwm_channels[channel]);
+}
+
+#endif // ESP32_PLATFORM
+)";
+
+    return impl.str();
+}
+
+// ============================================================================
+// AST Visitor Methods for Code Generation
+// ============================================================================
+
+void ForthCCodegen::visit(ProgramNode& node) {
+    // Ensure we're writing to the correct file
+    if (generatedFiles.empty() || currentFileIndex >= generatedFiles.size()) {
+        addError("No program file available for writing");
+        return;
+    }
+    
+    // Switch to main program file (should be the last one created)
+    for (size_t i = 0; i < generatedFiles.size(); i++) {
+        if (generatedFiles[i].first == programFileName) {
+            currentFileIndex = i;
+            break;
+        }
+    }
+    
+    if (currentFileIndex >= generatedFiles.size()) {
+        addError("Could not find " + programFileName + " file");
+        return;
+    }
+    
+    // Generate program header
+    emitLine(std::string(isModuleMode() ? "// Separately compiled FORTH module: " : "// Generated FORTH program: ") +
+             moduleName);
+    emitLine("// Target: " + targetPlatform);
+    emitLine("// Optimization level: " + getOptimizationLevel());
+    emitLine("");
+    
+
+    emitLine("#include <stdio.h>");
+    emitLine("#include \"forth_runtime.h\"");
+    emitLine("");
+    
+    // A module holds words and folded constants only; everything else needs
+    // the program's data space, tasks or entry point
+    if (isModuleMode()) {
+        for (const auto* statements : node.getStatementLists()) {
+            for (const auto& child : *statements) {
+                if (child->getType() == ASTNode::NodeType::WORD_DEFINITION) continue;
+                const auto* declaration = dynamic_cast<const VariableDeclarationNode*>(child.get());
+                if (declaration && !(declaration->isConst() &&
+                                     constantValues.contains(ForthUtils::toUpper(declaration->getVarName())))) {
+                    addError("A separately compiled module can only declare constants with a value known "
+                             "at compile time: " + declaration->getVarName(), child.get());
+                } else if (!declaration && !foldedNodes.contains(child.get())) {
+                    addError("Top-level code is not allowed in a separately compiled module", child.get());
+                }
+            }
+        }
+        if (!stringPoolOrder.empty()) {
+            emitLine("static const char " + stringPoolSymbol + "[] =");
+            for (size_t i = 0; i < stringPoolOrder.size(); i++) {
+                emitLine("    \"" + escapeCString(stringPoolOrder[i]) + "\"" +
+                         (i + 1 == stringPoolOrder.size() ? ";" : ""));
+            }
+            emitLine("");
+        }
+    }
+    
+    // Forward declare all user-defined words first
+    emitLine("// Forward declarations of user-defined words");
+    if (!shardFileIndices.empty()) {
+        emitLine("#include \"forth_words.h\"");
+    } else {
+        for (const auto* statements : node.getStatementLists()) {
+            for (const auto& child : *statements) {
+                if (child->getType() == ASTNode::NodeType::WORD_DEFINITION) {
+                    auto* wordDef = static_cast<WordDefinitionNode*>(child.get());
+                    const std::string funcName = generateFunctionName(wordDef->getWordName());
+                    emitLine("void " + funcName + "(void);");
+                }
+            }
+        }
+        for (const auto& interface : interfaces) {
+            for (const auto& word : interface->words) {
+                emitLine("void " + word.function + "(void);  // " + interface->module);
+            }
+        }
+        for (const auto& clone : specializations) {
+            emitLine("void " + clone->function + "(void);  // " + clone->word + " specialized");
+        }
+    }
+    emitLine("");
+    
+    // Generate all word definitions
+    emitLine("// User-defined word implementations");
+    std::vector<WordDefinitionNode*> words;
+    for (const auto* statements : node.getStatementLists()) {
+        for (const auto& child : *statements) {
+            if (child->getType() == ASTNode::NodeType::WORD_DEFINITION) {
+                words.push_back(static_cast<WordDefinitionNode*>(child.get()));
+            }
+        }
+    }
+    if (shardFileIndices.empty()) {
+        emitWordDefinitions(words);
+    } else {
+        // Each word goes to its shard; source order is kept within a shard
+        auto results = emitWords(words);
+        for (size_t i = 0; i < words.size(); i++) {
+            const size_t shard = wordShard.at(ForthUtils::toUpper(words[i]->getWordName()));
+            mergeWordEmission(results[i], generatedFiles[shardFileIndices[shard]].second);
+        }
+        emitLine("// (emitted into forth_words_0.c .. forth_words_" +
+                 std::to_string(shardFileIndices.size() - 1) + ".c)");
+    }
+    emitSpecializations();
+    
+    if (isModuleMode()) {
+        emitLine("");
+        emitLine("// End of module " + moduleName);
+        return;
+    }
+    
+    // Generate main entry point
+    emitLine("");
+    emitLine("// Main program entry point");
+    emitLine("void forth_program_main(void) {");
+    increaseIndent();
+    
+    emitIndented("forth_init();");
+    emitLine("");
+    
+    // Top-level code runs in program order, set-up that was folded into the
+    // data-space image excepted; MAIN, if defined, runs after it
+    const bool hasMain = wordFunctionNames.contains("MAIN");
+    auto callsMain = [](const ASTNode* child) {
+        return child->getType() == ASTNode::NodeType::WORD_CALL &&
+               ForthUtils::toUpper(static_cast<const WordCallNode*>(child)->getWordName()) == "MAIN";
+    };
+    emitLine("");
+    emitIndented("// Execute top-level code");
+    for (const auto* statements : node.getStatementLists()) {
+        const auto& children = *statements;
+        for (size_t i = 0; i < children.size();) {
+            if (children[i]->getType() == ASTNode::NodeType::WORD_DEFINITION ||
+                foldedNodes.contains(children[i].get()) || (hasMain && callsMain(children[i].get()))) {
+                i++;
+                continue;
+            }
+            try {
+                i += emitStatement(children, i);
+            } catch (const std::exception& e) {
+                addError(std::string("Error generating top-level code: ") + e.what());
+                i++;
+            }
+        }
+    }
+    if (hasMain) {
+        emitLine("");
+        emitIndented("// Call main program word");
+        emitIndented(wordFunctionNames["MAIN"] + "();");
+    }
+    
+    if (usedFeatures.contains("TASK")) {
+        emitLine("");
+        emitIndented("forth_tasks_join();  // Run tasks until all have stopped");
+    }
+    
+    emitLine("");
+    emitIndented("forth_cleanup();");
+    decreaseIndent();
+    emitLine("}");
+    
+    // Ensure we completed successfully
+    emitLine("");
+    emitLine("// End of generated program");
+}
+
+// ============================================================================
+// Per-word Output Cache
+// ============================================================================
+
+std::shared_ptr<const ForthWordCodeCache::Entry> ForthWordCodeCache::find(const std::string& key) {
+    std::lock_guard lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    return it->second;
+}
+
+void ForthWordCodeCache::store(const std::string& key, std::shared_ptr<const Entry> entry) {
+    std::lock_guard lock(mutex);
+    if (capacity == 0) return;
+    if (entries.insert_or_assign(key, std::move(entry)).second) {
+        insertionOrder.push_back(key);
+    }
+    while (entries.size() > capacity) {
+        entries.erase(insertionOrder.front());
+        insertionOrder.pop_front();
+    }
+}
+
+void ForthWordCodeCache::clear() {
+    std::lock_guard lock(mutex);
+    entries.clear();
+    insertionOrder.clear();
+    hits = misses = 0;
+}
+
+size_t ForthWordCodeCache::size() const {
+    std::lock_guard lock(mutex);
+    return entries.size();
+}
+
+size_t ForthWordCodeCache::getHits() const {
+    std::lock_guard lock(mutex);
+    return hits;
+}
+
+size_t ForthWordCodeCache::getMisses() const {
+    std::lock_guard lock(mutex);
+    return misses;
+}
+
+void ForthCCodegen::emitWordDefinitions(const std::vector<WordDefinitionNode*>& words) {
+    auto results = emitWords(words);
+    
+    // Merge in source order so the output does not depend on scheduling
+    for (auto& result : results) {
+        if (emitState.buffer) {
+            mergeWordEmission(result, *emitState.buffer);
+        }
+    }
+}
+
+std::vector<ForthCCodegen::WordEmission> ForthCCodegen::emitWords(
+    const std::vector<WordDefinitionNode*>& words) {
+    std::vector<WordEmission> results(words.size());
+    
+    // Words already in the cache are copied; only the rest are emitted
+    std::vector<size_t> pending;
+    std::vector<std::string> keys;
+    if (wordCache) {
+        const std::string context = emissionContextKey();
+        keys.resize(words.size());
+        for (size_t i = 0; i < words.size(); i++) {
+            keys[i] = context;
+            appendNodeKey(keys[i], words[i]);
+            appendWordContext(keys[i], *words[i]);
+            if (auto part = specializationKeys.find(words[i]); part != specializationKeys.end()) {
+                keys[i] += part->second;
+            }
+            if (auto entry = wordCache->find(keys[i])) {
+                results[i].code.append(entry->code);
+                results[i].errors = entry->errors;
+                results[i].warnings = entry->warnings;
+                results[i].forwardReferences = entry->forwardReferences;
+                wordCacheHitCount++;
+            } else {
+                pending.push_back(i);
+            }
+        }
+    } else {
+        for (size_t i = 0; i < words.size(); i++) {
+            pending.push_back(i);
+        }
+    }
+    
+    if (parallelEmission && pending.size() > 1) {
+        // One forked generator per worker; workers only read shared tables
+        std::vector<std::unique_ptr<ForthCCodegen>> workers(
+            std::min(pending.size(), emissionThreads > 0 ? emissionThreads
+                                                         : ForthThreadPool::defaultThreadCount()));
+        ForthThreadPool::parallelFor(pending.size(), workers.size(),
+            [&](size_t index, size_t worker) {
+                if (!workers[worker]) {
+                    workers[worker] = forkWorker();
+                }
+                workers[worker]->emitWordInto(*words[pending[index]], results[pending[index]]);
+            });
+    } else {
+        for (size_t index : pending) {
+            emitWordInto(*words[index], results[index]);
+        }
+    }
+    
+    if (wordCache) {
+        for (size_t index : pending) {
+            // Error messages carry source positions, which the key leaves out
+            if (!results[index].errors.empty()) continue;
+            auto entry = std::make_shared<ForthWordCodeCache::Entry>();
+            entry->code = results[index].code.str();
+            entry->errors = results[index].errors;
+            entry->warnings = results[index].warnings;
+            entry->forwardReferences = results[index].forwardReferences;
+            wordCache->store(keys[index], std::move(entry));
+        }
+    }
+    
+    return results;
+}
+
+void ForthCCodegen::mergeWordEmission(WordEmission& result, ChunkedBuffer& target) {
+    target.splice(std::move(result.code));
+    errors.insert(errors.end(), result.errors.begin(), result.errors.end());
+    warnings.insert(warnings.end(), result.warnings.begin(), result.warnings.end());
+    forwardReferences.insert(result.forwardReferences.begin(), result.forwardReferences.end());
+}
+
+void ForthCCodegen::emitWordInto(WordDefinitionNode& node, WordEmission& out) {
+    ForthTrace::Span span("word", node.getWordName());
+    EmitState saved = emitState;
+    emitState = EmitState{};
+    emitState.buffer = &out.code;
+    errors.swap(out.errors);
+    warnings.swap(out.warnings);
+    forwardReferences.swap(out.forwardReferences);
+    
+    try {
+        node.accept(*this);
+    } catch (const std::exception& e) {
+        addError(std::string("Error generating word definition: ") + e.what());
+    }
+    
+    errors.swap(out.errors);
+    warnings.swap(out.warnings);
+    forwardReferences.swap(out.forwardReferences);
+    emitState = saved;
+}
+
+// The table entries a word's emission reads, for its cache key: for every
+// name the word refers to - and the pure words evaluated into it refer to,
+// whose bodies are part of the key too - what each table says about that
+// name, and the pool entries of its strings. Words that do not refer to an
+// edited word or constant keep their key.
+void ForthCCodegen::appendWordContext(std::string& key, const WordDefinitionNode& word) const {
+    const std::string self = ForthUtils::toUpper(word.getWordName());
+    std::set<std::string> names{self};
+    std::set<std::string> strings;
+    std::function<void(const ASTNode*)> collect = [&](const ASTNode* node) {
+        if (!node) return;
+        switch (node->getType()) {
+            case ASTNode::NodeType::WORD_CALL: {
+                const auto* call = static_cast<const WordCallNode*>(node);
+                names.insert(ForthUtils::toUpper(call->getWordName()));
+                if (!call->getParsedName().empty()) names.insert(call->getParsedName());
+                break;
+            }
+            case ASTNode::NodeType::MATH_OPERATION:
+                names.insert(ForthUtils::toUpper(static_cast<const MathOperationNode*>(node)->getOperation()));
+                break;
+            case ASTNode::NodeType::STRING_LITERAL:
+                strings.insert(static_cast<const StringLiteralNode*>(node)->getValue());
+                break;
+            case ASTNode::NodeType::IF_STATEMENT: {
+                const auto* ifNode = static_cast<const IfStatementNode*>(node);
+                collect(ifNode->getCondition());
+                collect(ifNode->getThenBranch());
+                collect(ifNode->getElseBranch());
+                break;
+            }
+            case ASTNode::NodeType::BEGIN_UNTIL_LOOP: {
+                const auto* loop = static_cast<const BeginUntilLoopNode*>(node);
+                collect(loop->getBody());
+                collect(loop->getCondition());
+                break;
+            }
+            default:
+                if (const auto* decl = dynamic_cast<const VariableDeclarationNode*>(node)) {
+                    names.insert(ForthUtils::toUpper(decl->getVarName()));
+                    collect(decl->getInitialValue());
+                }
+                break;
+        }
+        for (const auto& child : node->getChildren()) collect(child.get());
+    };
+    collect(&word);
+    
+    // Pure words a word calls are evaluated into it, so their bodies - and
+    // those of the pure words they call in turn - are part of its key
+    std::set<std::string> reached;
+    std::vector<std::string> pending{self};
+    while (!pending.empty()) {
+        auto callees = callGraph.find(pending.back());
+        pending.pop_back();
+        if (callees == callGraph.end()) continue;
+        for (const auto& callee : callees->second) {
+            if (pureWords.contains(callee) && reached.insert(callee).second) {
+                pending.push_back(callee);
+                collect(pureWords.at(callee));
+            }
+        }
+    }
+    for (const auto& callee : reached) {
+        key += "|" + callee + "=";
+        appendNodeKey(key, pureWords.at(callee));
+    }
+    for (const auto& name : names) {
+        if (auto imported = importedWords.find(name);
+            imported != importedWords.end() && imported->second.inlineBody) {
+            collect(imported->second.inlineBody);
+        }
+    }
+    
+    // What each table says about the names
+    key += "|IRAM" + std::to_string(optimizationFlags.useIRAM && isPerformanceCritical(word.getWordName()));
+    key += generatedWords.contains(self) ? "+" : "-";
+    for (const auto& name : names) {
+        key += "|" + name + ":";
+        if (auto task = taskHandles.find(name); task != taskHandles.end()) {
+            key += "T" + std::to_string(task->second);
+        }
+        if (auto channel = channels.find(name); channel != channels.end()) {
+            key += "C" + channel->second.macro + (channel->second.multiProducer ? "/M" : "/S");
+        }
+        if (auto data = dataSpaceWords.find(name); data != dataSpaceWords.end()) {
+            const auto& entry = data->second;
+            key += "D" + entry.name + "@" + (entry.isStatic ? std::to_string(entry.offset) : entry.slot) + "/" +
+                   std::to_string(dataSpaceHere) + "/" + std::to_string(dataSpaceImage.size());
+        }
+        if (auto value = constantValues.find(name); value != constantValues.end()) {
+            key += "K" + std::to_string(value->second);
+        }
+        if (auto slot = constantSlots.find(name); slot != constantSlots.end()) key += "S" + slot->second;
+        if (auto function = wordFunctionNames.find(name); function != wordFunctionNames.end()) {
+            key += "F" + function->second;
+        }
+        if (auto variable = variableMap.find(name); variable != variableMap.end()) key += "V" + variable->second;
+        if (auto value = importedConstants.find(name); value != importedConstants.end()) {
+            key += "k" + std::to_string(value->second);
+        }
+        if (auto imported = importedWords.find(name); imported != importedWords.end()) {
+            key += "I" + imported->second.function;
+            if (imported->second.inlineBody) appendNodeKey(key, imported->second.inlineBody);
+        }
+        if (pureWords.contains(name)) key += "P";
+        if (isBuiltinWord(name)) key += "B";
+        if (semanticAnalyzer) {
+            const auto effect = semanticAnalyzer->getStackEffect(name);
+            if (effect.isKnown) key += "E" + std::to_string(effect.consumed) + "," + std::to_string(effect.produced);
+        }
+        if (dictionary) {
+            if (const WordEntry* entry = dictionary->lookupWord(name)) {
+                key += "W" + std::to_string(static_cast<int>(entry->type)) + "," +
+                       std::to_string(entry->stackEffect.consumed) + "," +
+                       std::to_string(entry->stackEffect.produced) + (entry->stackEffect.isKnown ? "" : "?");
+            }
+        }
+    }
+    for (const auto& text : strings) {
+        if (auto pooled = stringPool.find(text); pooled != stringPool.end()) {
+            key += "|\"" + text + "\"" + std::to_string(pooled->second.offset) + "+" +
+                   std::to_string(pooled->second.length);
+        }
+    }
+}
+
+// The settings every word's emission depends on; the tables each word
+// reads are added per word by appendWordContext()
+std::string ForthCCodegen::emissionContextKey() const {
+    std::string context;
+    auto add = [&context](std::string_view text) {
+        context += text;
+        context += '\x1f';
+    };
+    
+    add(moduleName);
+    add(modulePrefix);
+    add(targetPlatform);
+    add(stringPoolSymbol);
+    add(esp32Config.architecture);
+    add(std::string{char('0' + esp32Config.useIRAM), char('0' + optimizationFlags.useIRAM),
+                    char('0' + optimizationFlags.canInline), char('0' + optimizationFlags.smallStack),
+                    char('0' + optimizationFlags.needsFloat), char('0' + optimizationFlags.ioHeavy),
+                    char('0' + optimizationFlags.evaluatePure), char('0' + optimizationFlags.specialize)});
+    
+    // Hash the settings; keys stay short and the word text is appended as is
+    char prefix[32];
+    std::snprintf(prefix, sizeof(prefix), "%016llx:",
+                  static_cast<unsigned long long>(ChunkedBuffer::hashBytes(context)));
+    return prefix;
+}
+
+std::unique_ptr<ForthCCodegen> ForthCCodegen::forkWorker() const {
+    auto worker = std::make_unique<ForthCCodegen>(moduleName);
+    worker->targetPlatform = targetPlatform;
+    worker->modulePrefix = modulePrefix;
+    worker->programFileName = programFileName;
+    worker->stringPoolSymbol = stringPoolSymbol;
+    worker->interfaces = interfaces;
+    worker->importedWords = importedWords;
+    worker->importedConstants = importedConstants;
+    worker->pureWords = pureWords;
+    worker->specializedCalls = specializedCalls;
+    worker->semanticAnalyzer = semanticAnalyzer;
+    worker->dictionary = dictionary;
+    worker->esp32Config = esp32Config;
+    worker->optimizationFlags = optimizationFlags;
+    worker->generatedWords = generatedWords;
+    worker->wordFunctionNames = wordFunctionNames;
+    worker->variableMap = variableMap;
+    worker->usedFeatures = usedFeatures;
+    worker->usedBuiltins = usedBuiltins;
+    worker->callGraph = callGraph;
+    worker->stringPool = stringPool;
+    worker->dataSpaceWords = dataSpaceWords;
+    worker->constantValues = constantValues;
+    worker->constantSlots = constantSlots;
+    worker->dataSpaceImage = dataSpaceImage;
+    worker->dataSpaceLabels = dataSpaceLabels;
+    worker->dataSpaceHere = dataSpaceHere;
+    worker->foldedNodes = foldedNodes;
+    worker->taskHandles = taskHandles;
+    worker->channels = channels;
+    return worker;
+}
+
+void ForthCCodegen::visit(WordDefinitionNode& node) {
+    const std::string& wordName = node.getWordName();
+    const std::string funcName = generateFunctionName(wordName);
+    
+    // Validate word name
+    if (wordName.empty()) {
+        addError("Empty word name in word definition");
+        return;
+    }
+    
+    // Check for redefinition
+    if (generatedWords.contains(ForthUtils::toUpper(wordName))) {
+        addWarning("Word '" + wordName + "' redefined");
+    }
+    
+    generatedWords.insert(ForthUtils::toUpper(wordName));
+    wordFunctionNames[ForthUtils::toUpper(wordName)] = funcName;
+    
+    // Check if this word should be in IRAM
+    bool useIRAM = optimizationFlags.useIRAM && isPerformanceCritical(wordName);
+    
+    emitLine("");
+    emitLine("// FORTH word: " + wordName);
+    if (useIRAM) {
+        emitLine("FORTH_IRAM_ATTR");
+    }
+    emitLine("void " + funcName + "(void) {");
+    increaseIndent();
+    
+    // Generate function body - with error handling for each statement
+    bool hasBody = false;
+    const auto& children = node.getChildren();
+    for (size_t i = 0; i < children.size();) {
+        try {
+            i += emitStatement(children, i);
+            hasBody = true;
+        } catch (const std::exception& e) {
+            addError("Error in word '" + wordName + "': " + std::string(e.what()));
+            i++;
+        }
+    }
+    
+    if (!hasBody) {
+        emitIndented("// Empty word body");
+    }
+    
+    decreaseIndent();
+    emitLine("}");
+}
+
+void ForthCCodegen::visit(WordCallNode& node) {
+    const std::string& wordName = node.getWordName();
+    const std::string upperWord = ForthUtils::toUpper(wordName);
+    
+    // Special handling for print word "."
+    if (upperWord == ".") {
+        emitIndented("forth_print_number(forth_pop());");
+        return;
+    }
+    
+    // task START name: the entry word is bound at compile time
+    if (upperWord == "START" && !node.getParsedName().empty()) {
+        auto entry = wordFunctionNames.find(node.getParsedName());
+        if (entry == wordFunctionNames.end()) {
+            addError("START needs a word defined with ':' - " + node.getParsedName(), &node);
+            return;
+        }
+        emitIndented("forth_task_start(forth_pop(), " + entry->second + ");  // START " +
+                     node.getParsedName());
+        return;
+    }
+    
+    // User definitions shadow builtins of the same name
+    if (auto task = taskHandles.find(upperWord); task != taskHandles.end()) {
+        emitIndented("forth_push(" + std::to_string(task->second) + ");  // TASK " + upperWord);
+    } else if (auto channel = channels.find(upperWord); channel != channels.end()) {
+        emitIndented("forth_push(" + channel->second.macro + ");");
+    } else if (auto data = dataSpaceWords.find(upperWord); data != dataSpaceWords.end()) {
+        // Data-space address resolved at compile time where possible
+        const auto& word = data->second;
+        if (word.isStatic) {
+            emitIndented("forth_push(FORTH_DATA_ADDR(" + std::to_string(word.offset) + "));  // " + word.name);
+        } else {
+            emitIndented("forth_push(FORTH_DATA_ADDR(" + word.slot + "));");
+        }
+    } else if (auto constant = constantValues.find(upperWord); constant != constantValues.end()) {
+        emitIndented("forth_push(" + std::to_string(constant->second) + ");  // " + upperWord);
+    } else if (auto slot = constantSlots.find(upperWord); slot != constantSlots.end()) {
+        emitIndented("forth_push(" + slot->second + ");");
+    } else if (wordFunctionNames.contains(upperWord)) {
+        // Direct call to generated function
+        emitIndented(wordFunctionNames[upperWord] + "();");
+    } else if (auto imported = importedConstants.find(upperWord); imported != importedConstants.end()) {
+        emitIndented("forth_push(" + std::to_string(imported->second) + ");  // " + upperWord);
+    } else if (auto word = importedWords.find(upperWord); word != importedWords.end()) {
+        // Small pure words of separately compiled modules are expanded in place
+        if (word->second.inlineBody && optimizationFlags.canInline) {
+            emitIndented("// " + upperWord + " (inlined)");
+            emitSequence(word->second.inlineBody->getChildren());
+        } else {
+            emitIndented(word->second.function + "();");
+        }
+    } else if (isBuiltinWord(upperWord)) {
+        generateOptimizedBuiltin(upperWord);
+    } else if (dictionary && dictionary->isWordDefined(upperWord)) {
+        // Forward reference - need to defer resolution
+        std::string callFunc = "forth_call_word_" + sanitizeIdentifier(upperWord);
+        emitIndented(callFunc + "();");
+        forwardReferences.insert(upperWord);
+    } else {
+        // wordFunctionNames is keyed by upper-case name, so the lookup above
+        // already covered every generated word
+        addError("Unknown word: " + wordName, &node);
+    }
+}
+
+void ForthCCodegen::visit(NumberLiteralNode& node) {
+    const std::string& value = node.getValue();
     
-    ledc_channel_config_t ledc_channel = {
-        .speed_mode = LEDC_HIGH_SPEED_MODE,
-        .channel = pwm_channels[channel],
-        .timer_sel = LEDC_TIMER_0,
-        .intr_type = LEDC_INTR_DISABLE,
-        .gpio_num = channel + 2,  // Map to GPIO2-9 by default
-        .duty = 0,
-        .hpoint = 0
-    };
-    ledc_channel_config(&ledc_channel);
+    if (node.isFloatingPoint() && optimizationFlags.needsFloat) {
+        emitIndented("forth_push((forth_cell_t)(forth_float_t)" + value + "f);");
+    } else {
+        // Use immediate push for small constants (optimization)
+        try {
+            int intVal = std::stoi(value);
+            if (intVal >= -128 && intVal <= 127) {
+                emitIndented("forth_push(" + value + ");  // Small constant");
+            } else {
+                emitIndented("forth_push(" + value + ");");
+            }
+        } catch (const std::exception&) {
+            emitIndented("forth_push(" + value + ");");
+        }
+    }
 }
 
-void forth_pwm_write(forth_cell_t channel, forth_cell_t duty) {
-    if (channel >= 8) return;
+void ForthCCodegen::visit(StringLiteralNode& node) {
+    const std::string& value = node.getValue();
     
-    ledc_set_duty(LEDC_HIGH_SPEED_MODE, pwm_channels[channel], duty & 0x1FFF);
-    ledc_update_duty(LEDC_HIGH_SPEED_MODE, pwm_channels[channel]);
+    auto pooled = stringPool.find(value);
+    if (pooled != stringPool.end()) {
+        const std::string address = stringPoolSymbol + " + " + std::to_string(pooled->second.offset);
+        const std::string length = std::to_string(pooled->second.length);
+        std::string preview = escapeCString(value.substr(0, 40));
+        
+        if (node.isPrint()) {
+            // Length is known at compile time - no format string parsing;
+            // flushing is left to the runtime output layer
+            emitIndented("forth_write(" + address + ", " + length + ");  // \"" + preview + "\"");
+        } else {
+            emitIndented("forth_push((forth_cell_t)(" + address + "));  // \"" + preview + "\"");
+            emitIndented("forth_push(" + length + ");");
+        }
+    } else if (node.isPrint()) {
+        emitIndented("forth_write(\"" + escapeCString(value) + "\", " +
+                     std::to_string(value.size()) + ");");
+    } else {
+        // Store string in RODATA section
+        std::string strVar = "str_" + std::to_string(++emitState.stringCounter);
+        emitIndented("static const char " + strVar + "[] = \"" + escapeCString(value) + "\";");
+        emitIndented("forth_push((forth_cell_t)" + strVar + ");");
+        emitIndented("forth_push(" + std::to_string(value.length()) + ");");
+    }
 }
 
-#endif // ESP32_PLATFORM
-)";
+void ForthCCodegen::visit(IfStatementNode& node) {
+    if (optimizationFlags.canInline && isSimpleCondition(node)) {
+        // Generate optimized ternary for simple if-then-else
+        generateOptimizedIf(node);
+    } else {
+        // Standard if-then-else generation
+        emitIndented("{  // IF block");
+        increaseIndent();
+        emitIndented("forth_cell_t condition = forth_pop();");
+        emitIndented("if (condition) {");
+        increaseIndent();
+        
+        if (node.getThenBranch()) {
+            emitSequence(node.getThenBranch()->getChildren());
+        }
+        
+        decreaseIndent();
+        
+        if (node.hasElse() && node.getElseBranch()) {
+            emitIndented("} else {");
+            increaseIndent();
+            
+            emitSequence(node.getElseBranch()->getChildren());
+            
+            decreaseIndent();
+        }
+        
+        emitIndented("}");
+        decreaseIndent();
+        emitIndented("}  // End IF block");
+    }
+}
 
-    return impl.str();
+void ForthCCodegen::visit(BeginUntilLoopNode& node) {
+    std::string loopLabel = generateLabel("loop");
+    
+    if (optimizationFlags.useIRAM) {
+        emitIndented("// Loop in hot path - consider IRAM placement");
+    }
+    
+    emitIndented("{  // BEGIN-UNTIL loop");
+    increaseIndent();
+    
+    // Check for common loop patterns for optimization
+    if (isCountedLoop(node)) {
+        generateOptimizedCountedLoop(node);
+    } else {
+        emitIndented("do {");
+        increaseIndent();
+        
+        if (node.getBody()) {
+            emitSequence(node.getBody()->getChildren());
+        }
+        
+        decreaseIndent();
+        emitIndented("} while (!forth_pop());");
+    }
+    
+    decreaseIndent();
+    emitIndented("}  // End loop");
 }
 
-// ============================================================================
-// AST Visitor Methods for Code Generation
-// ============================================================================
+void ForthCCodegen::visit(MathOperationNode& node) {
+    const std::string& op = node.getOperation();
+    generateOptimizedBuiltin(op);
+}
 
-void ForthCCodegen::visit(ProgramNode& node) {
-    // Ensure we're writing to the correct file
-    if (generatedFiles.empty() || currentFileIndex >= generatedFiles.size()) {
-        addError("No program file available for writing");
-        return;
+void ForthCCodegen::visit(VariableDeclarationNode& node) {
+    const std::string& varName = node.getVarName();
+    
+    if (foldedNodes.contains(&node)) {
+        return;  // CONSTANT with a compile-time value
     }
     
-    // Switch to main program file (should be the last one created)
-    for (size_t i = 0; i < generatedFiles.size(); i++) {
-        if (generatedFiles[i].first == "forth_program.c") {
-            currentFileIndex = i;
-            break;
+    if (node.isTask()) {
+        if (!taskHandles.contains(varName)) {
+            addError("TASK is only supported at the top level: " + varName, &node);
         }
+        return;  // Task control blocks are static
     }
     
-    if (currentFileIndex >= generatedFiles.size()) {
-        addError("Could not find forth_program.c file");
+    if (node.isChannel()) {
+        addError("CHANNEL is only supported at the top level: " + varName, &node);
+        return;  // Top-level channels are folded into static rings
+    }
+    
+    if (node.isConst()) {
+        auto slot = constantSlots.find(varName);
+        if (slot == constantSlots.end()) {
+            addError("CONSTANT is only supported at the top level: " + varName, &node);
+            return;
+        }
+        emitIndented(slot->second + " = forth_pop();  // CONSTANT " + varName);
         return;
     }
     
-    // Generate program header
-    emitLine("// Generated FORTH program: " + moduleName);
-    emitLine("// Target: " + targetPlatform);
-    emitLine("// Optimization level: " + getOptimizationLevel());
-    emitLine("");
+    auto data = dataSpaceWords.find(varName);
+    if (data == dataSpaceWords.end()) {
+        addError(std::string(node.isCreate() ? "CREATE" : "VARIABLE") +
+                 " is only supported at the top level: " + varName, &node);
+        return;
+    }
     
+    const auto& word = data->second;
+    if (word.isStatic) {
+        variableMap[varName] = "forth_data_space[" + std::to_string(word.offset / sizeof(int32_t)) + "]";
+        return;  // Part of the static image
+    }
+    
+    // Follows a run-time sized allocation: take the next aligned offset
+    emitIndented(word.slot + " = forth_data_create(" +
+                 (node.isCreate() ? "0" : "sizeof(forth_cell_t)") + ");  // " +
+                 (node.isCreate() ? "CREATE " : "VARIABLE ") + varName);
+    variableMap[varName] = word.slot;
+}
 
-    emitLine("#include <stdio.h>");
-    emitLine("#include \"forth_runtime.h\"");
-    emitLine("");
+// ============================================================================
+// Data-Space Access Fusion
+// ============================================================================
+
+void ForthCCodegen::emitSequence(const NodeList& nodes) {
+    for (size_t i = 0; i < nodes.size();) {
+        i += emitStatement(nodes, i);
+    }
+}
+
+size_t ForthCCodegen::emitStatement(const NodeList& nodes, size_t index) {
+    if (size_t specialized = emitSpecializedCall(nodes, index)) {
+        return specialized;
+    }
+    if (size_t fused = emitFusedDataAccess(nodes, index)) {
+        return fused;
+    }
+    if (size_t fused = emitFusedBlockOp(nodes, index)) {
+        return fused;
+    }
+    if (size_t fused = emitFusedArrayOp(nodes, index)) {
+        return fused;
+    }
+    if (size_t fused = emitFusedChannelOp(nodes, index)) {
+        return fused;
+    }
+    if (size_t evaluated = emitEvaluated(nodes, index)) {
+        return evaluated;
+    }
+    if (size_t reduced = emitStrengthReduced(nodes, index)) {
+        return reduced;
+    }
+    nodes[index]->accept(*this);
+    return 1;
+}
+
+const ForthCCodegen::DataSpaceWord* ForthCCodegen::staticDataWord(const ASTNode* node) const {
+    if (!node || node->getType() != ASTNode::NodeType::WORD_CALL) return nullptr;
+    auto it = dataSpaceWords.find(ForthUtils::toUpper(static_cast<const WordCallNode*>(node)->getWordName()));
+    return it != dataSpaceWords.end() && it->second.isStatic ? &it->second : nullptr;
+}
+
+// A call of the builtin with that name. Words the program or an imported
+// module defines under the same name shadow the builtin, so the fused
+// forms below must leave them to the ordinary call.
+bool ForthCCodegen::isBuiltinCall(const ASTNode* node, std::string_view upperName) const {
+    if (!isWord(node, upperName)) return false;
+    const std::string name{upperName};
+    if (wordFunctionNames.contains(name) || importedWords.contains(name)) return false;
+    const WordEntry* entry = dictionary ? dictionary->lookupWord(name) : nullptr;
+    return !entry || entry->type != WordEntry::WordType::USER_DEFINED;
+}
+
+// Addresses of static data-space words are compile-time constants, so
+// "NAME @", "NAME n CELLS + !" and "CELLS NAME + @" become direct indexed
+// loads and stores on forth_data_space[] instead of pointer round trips
+// through the stack. Returns the number of nodes consumed (0 = no match).
+size_t ForthCCodegen::emitFusedDataAccess(const NodeList& nodes, size_t index) {
+    auto at = [&](size_t k) -> const ASTNode* {
+        return index + k < nodes.size() ? nodes[index + k].get() : nullptr;
+    };
     
-    // Forward declare all user-defined words first
-    emitLine("// Forward declarations of user-defined words");
-    for (const auto& child : node.getChildren()) {
-        if (child->getType() == ASTNode::NodeType::WORD_DEFINITION) {
-            auto* wordDef = static_cast<WordDefinitionNode*>(child.get());
-            const std::string funcName = generateFunctionName(wordDef->getWordName());
-            emitLine("void " + funcName + "(void);");
+    // Index taken from the stack: CELLS NAME + @|!
+    if (isBuiltinCall(at(0), "CELLS")) {
+        const DataSpaceWord* word = staticDataWord(at(1));
+        if (!word || !isBuiltinCall(at(2), "+")) return 0;
+        
+        const std::string base = std::to_string(word->offset / sizeof(int32_t));
+        if (isBuiltinCall(at(3), "@")) {
+            emitIndented("forth_push(forth_data_space[" + base + " + forth_pop()]);  // " + word->name + " @");
+            return 4;
+        }
+        if (isBuiltinCall(at(3), "!")) {
+            emitIndented("{  // " + word->name + " !");
+            increaseIndent();
+            emitIndented("forth_cell_t index = forth_pop();");
+            emitIndented("forth_data_space[" + base + " + index] = forth_pop();");
+            decreaseIndent();
+            emitIndented("}");
+            return 4;
         }
+        return 0;
     }
-    emitLine("");
     
-    // Generate all word definitions
-    emitLine("// User-defined word implementations");
-    for (const auto& child : node.getChildren()) {
-        if (child->getType() == ASTNode::NodeType::WORD_DEFINITION) {
-            try {
-                child->accept(*this);
-            } catch (const std::exception& e) {
-                addError(std::string("Error generating word definition: ") + e.what());
-                // Continue with other definitions
-            }
+    const DataSpaceWord* word = staticDataWord(at(0));
+    if (!word) return 0;
+    
+    // Constant index: NAME @, NAME CELL+ @, NAME n CELLS + @, NAME n + @
+    int64_t cell = word->offset / sizeof(int32_t);
+    size_t used = 1;
+    if (auto n = literalValue(at(1))) {
+        if (isBuiltinCall(at(2), "CELLS") && isBuiltinCall(at(3), "+")) {
+            cell += *n;
+            used = 4;
+        } else if (isBuiltinCall(at(2), "+") && *n % static_cast<int64_t>(sizeof(int32_t)) == 0) {
+            cell += *n / static_cast<int64_t>(sizeof(int32_t));
+            used = 3;
+        } else {
+            return 0;
         }
+    } else if (isBuiltinCall(at(1), "CELL+")) {
+        cell += 1;
+        used = 2;
     }
     
-    // Generate main entry point
-    emitLine("");
-    emitLine("// Main program entry point");
-    emitLine("void forth_program_main(void) {");
-    increaseIndent();
+    // Out-of-image accesses keep the generic (checked) path
+    if (cell < 0 || cell >= static_cast<int64_t>(dataSpaceImage.size())) return 0;
     
-    emitIndented("forth_init();");
-    emitLine("");
+    const std::string slot = "forth_data_space[" + std::to_string(cell) + "]";
+    if (isBuiltinCall(at(used), "@")) {
+        emitIndented("forth_push(" + slot + ");  // " + word->name + " @");
+        return used + 1;
+    }
+    if (isBuiltinCall(at(used), "!")) {
+        emitIndented(slot + " = forth_pop();  // " + word->name + " !");
+        return used + 1;
+    }
+    return 0;
+}
+
+// Block operations whose operands are all compile-time constants inside
+// the static image become a single memmove/memset on forth_data_space[]:
+//   SRC DST n MOVE|CMOVE|CMOVE>,  NAME n ERASE,  NAME n c FILL
+size_t ForthCCodegen::emitFusedBlockOp(const NodeList& nodes, size_t index) {
+    auto at = [&](size_t k) -> const ASTNode* {
+        return index + k < nodes.size() ? nodes[index + k].get() : nullptr;
+    };
+    auto inImage = [this](const DataSpaceWord* word, int64_t bytes) {
+        return bytes > 0 && word->offset + bytes <= dataSpaceHere;
+    };
+    auto address = [](const DataSpaceWord* word) {
+        return "(forth_byte_t*)forth_data_space + " + std::to_string(word->offset);
+    };
     
-    // Process variable declarations
-    emitIndented("// Variable declarations");
-    for (const auto& child : node.getChildren()) {
-        if (child->getType() == ASTNode::NodeType::VARIABLE_DECLARATION) {
-            try {
-                child->accept(*this);
-            } catch (const std::exception& e) {
-                addError(std::string("Error generating variable declaration: ") + e.what());
-            }
+    const DataSpaceWord* first = staticDataWord(at(0));
+    if (!first) return 0;
+    
+    if (const DataSpaceWord* second = staticDataWord(at(1))) {
+        auto count = literalValue(at(2));
+        if (!count || !inImage(first, *count) || !inImage(second, *count)) return 0;
+        
+        // CMOVE/CMOVE> only match memmove when the overlap is harmless
+        const bool forward = second->offset <= first->offset ||
+                             second->offset >= first->offset + *count;
+        const bool backward = second->offset >= first->offset ||
+                              second->offset + *count <= first->offset;
+        if (!(isBuiltinCall(at(3), "MOVE") || (isBuiltinCall(at(3), "CMOVE") && forward) ||
+              (isBuiltinCall(at(3), "CMOVE>") && backward))) {
+            return 0;
         }
+        emitIndented("memmove(" + address(second) + ", " + address(first) + ", " +
+                     std::to_string(*count) + ");  // " + first->name + " " + second->name + " " +
+                     ForthUtils::toUpper(static_cast<const WordCallNode*>(at(3))->getWordName()));
+        return 4;
     }
     
-    // Call MAIN word if it exists
-    if (wordFunctionNames.contains("MAIN")) {
-        emitLine("");
-        emitIndented("// Call main program word");
-        emitIndented(wordFunctionNames["MAIN"] + "();");
-    } else {
-        // If no MAIN word, process any top-level executable code
-        emitLine("");
-        emitIndented("// Execute top-level code");
-        for (const auto& child : node.getChildren()) {
-            if (child->getType() != ASTNode::NodeType::WORD_DEFINITION &&
-                child->getType() != ASTNode::NodeType::VARIABLE_DECLARATION) {
-                try {
-                    child->accept(*this);
-                } catch (const std::exception& e) {
-                    addError(std::string("Error generating top-level code: ") + e.what());
-                }
-            }
+    auto count = literalValue(at(1));
+    if (!count || !inImage(first, *count)) return 0;
+    
+    if (isBuiltinCall(at(2), "ERASE")) {
+        emitIndented("memset(" + address(first) + ", 0, " + std::to_string(*count) + ");  // " +
+                     first->name + " ERASE");
+        return 3;
+    }
+    if (auto fill = literalValue(at(2)); fill && isBuiltinCall(at(3), "FILL")) {
+        emitIndented("memset(" + address(first) + ", " + std::to_string(*fill & 0xFF) + ", " +
+                     std::to_string(*count) + ");  // " + first->name + " FILL");
+        return 4;
+    }
+    return 0;
+}
+
+// Array words over static data-space words with a literal cell count call
+// the kernels directly, skipping the stack round trip:
+//   NAME n SUM|MIN-REDUCE|MAX-REDUCE,  A B n DOT,  NAME n k MAP+|SCALE
+size_t ForthCCodegen::emitFusedArrayOp(const NodeList& nodes, size_t index) {
+    auto at = [&](size_t k) -> const ASTNode* {
+        return index + k < nodes.size() ? nodes[index + k].get() : nullptr;
+    };
+    auto cells = [](const DataSpaceWord* word) {
+        return "forth_data_space + " + std::to_string(word->offset / sizeof(int32_t));
+    };
+    
+    const DataSpaceWord* first = staticDataWord(at(0));
+    if (!first || first->offset % sizeof(int32_t) != 0) return 0;
+    auto fits = [this](const DataSpaceWord* word, int64_t count) {
+        return count >= 0 && word->offset + count * static_cast<int64_t>(sizeof(int32_t)) <= dataSpaceHere;
+    };
+    
+    if (const DataSpaceWord* second = staticDataWord(at(1))) {
+        auto count = literalValue(at(2));
+        if (!count || second->offset % sizeof(int32_t) != 0 || !isBuiltinCall(at(3), "DOT") ||
+            !fits(first, *count) || !fits(second, *count)) {
+            return 0;
         }
+        emitIndented("forth_push(forth_cells_dot(" + cells(first) + ", " + cells(second) + ", " +
+                     std::to_string(*count) + "));  // " + first->name + " " + second->name + " DOT");
+        return 4;
     }
     
-    emitLine("");
-    emitIndented("forth_cleanup();");
-    decreaseIndent();
-    emitLine("}");
+    auto count = literalValue(at(1));
+    if (!count || !fits(first, *count)) return 0;
     
-    // Ensure we completed successfully
-    emitLine("");
-    emitLine("// End of generated program");
+    static const std::unordered_map<std::string, std::string> reductions = {
+        {"SUM", "forth_cells_sum"}, {"MIN-REDUCE", "forth_cells_min"}, {"MAX-REDUCE", "forth_cells_max"}
+    };
+    static const std::unordered_map<std::string, std::string> maps = {
+        {"MAP+", "forth_cells_add"}, {"SCALE", "forth_cells_scale"}
+    };
+    
+    for (const auto& [word, kernel] : reductions) {
+        if (isBuiltinCall(at(2), word)) {
+            emitIndented("forth_push(" + kernel + "(" + cells(first) + ", " + std::to_string(*count) +
+                         "));  // " + first->name + " " + word);
+            return 3;
+        }
+    }
+    if (auto k = literalValue(at(2))) {
+        for (const auto& [word, kernel] : maps) {
+            if (isBuiltinCall(at(3), word)) {
+                emitIndented(kernel + "(" + cells(first) + ", " + std::to_string(*count) + ", " +
+                             std::to_string(*k) + ");  // " + first->name + " " + word);
+                return 4;
+            }
+        }
+    }
+    return 0;
 }
 
-void ForthCCodegen::visit(WordDefinitionNode& node) {
-    const std::string& wordName = node.getWordName();
-    const std::string funcName = generateFunctionName(wordName);
+// A channel named right before SEND, RECV or TRY-RECV has a compile-time
+// handle, so the word goes straight to the ring without the handle's trip
+// through the stack and the handle check
+size_t ForthCCodegen::emitFusedChannelOp(const NodeList& nodes, size_t index) {
+    if (index + 1 >= nodes.size() || nodes[index]->getType() != ASTNode::NodeType::WORD_CALL) return 0;
+    auto it = channels.find(ForthUtils::toUpper(static_cast<const WordCallNode*>(nodes[index].get())->getWordName()));
+    if (it == channels.end()) return 0;
+    const ChannelInfo& channel = it->second;
+    const ASTNode* op = nodes[index + 1].get();
     
-    // Validate word name
-    if (wordName.empty()) {
-        addError("Empty word name in word definition");
-        return;
+    if (isBuiltinCall(op, "SEND")) {
+        emitIndented("forth_channel_put(" + channel.macro + ", forth_pop());  // " + channel.name + " SEND");
+        return 2;
     }
-    
-    // Check for redefinition
-    if (generatedWords.contains(ForthUtils::toUpper(wordName))) {
-        addWarning("Word '" + wordName + "' redefined");
+    if (isBuiltinCall(op, "RECV")) {
+        emitIndented("forth_push(forth_channel_take(" + channel.macro + "));  // " + channel.name + " RECV");
+        return 2;
     }
+    if (isBuiltinCall(op, "TRY-RECV")) {
+        emitIndented("{  // " + channel.name + " TRY-RECV");
+        increaseIndent();
+        emitIndented("forth_cell_t value = 0;");
+        emitIndented("const bool received = forth_channel_try_recv(" + channel.macro + ", &value);");
+        emitIndented("forth_push(value);");
+        emitIndented("forth_push(received ? -1 : 0);");
+        decreaseIndent();
+        emitIndented("}");
+        return 2;
+    }
+    return 0;
+}
+
+// ============================================================================
+// Strength Reduction of Constant Operands
+// ============================================================================
+//
+// "<literal> *", "<literal> /" and "<literal> MOD" are emitted inline as
+// shifts, masks and multiply-high sequences instead of calls to forth_mul,
+// forth_div and forth_mod. The results match C's truncating division, and
+// the zero check is dropped because the divisor is a known nonzero constant
+// (a literal zero divisor keeps the run-time call). Writing the sequences
+// out keeps them independent of the C compiler's -Os choice of a hardware
+// divide.
+
+size_t ForthCCodegen::emitStrengthReduced(const NodeList& nodes, size_t index) {
+    if (index + 1 >= nodes.size()) return 0;
+    const ASTNode* operand = nodes[index + 1].get();
+    if (operand->getType() != ASTNode::NodeType::MATH_OPERATION) return 0;
+    if (foldedNodes.contains(nodes[index].get()) || foldedNodes.contains(operand)) return 0;
     
-    generatedWords.insert(ForthUtils::toUpper(wordName));
-    wordFunctionNames[ForthUtils::toUpper(wordName)] = funcName;
+    auto literal = literalValue(nodes[index].get());
+    if (!literal || *literal < INT32_MIN || *literal > INT32_MAX) return 0;
     
-    // Check if this word should be in IRAM
-    bool useIRAM = optimizationFlags.useIRAM && isPerformanceCritical(wordName);
+    const std::string op = ForthUtils::toUpper(static_cast<const MathOperationNode*>(operand)->getOperation());
+    if (op != "*" && op != "/" && op != "MOD") return 0;
     
-    emitLine("");
-    emitLine("// FORTH word: " + wordName);
-    if (useIRAM) {
-        emitLine("FORTH_IRAM_ATTR");
+    const auto d = static_cast<int32_t>(*literal);
+    const std::string comment = "  // " + std::to_string(d) + " " + op;
+    const uint32_t magnitude = d < 0 ? 0u - static_cast<uint32_t>(d) : static_cast<uint32_t>(d);
+    const bool powerOfTwo = magnitude != 0 && (magnitude & (magnitude - 1)) == 0;
+    const int k = powerOfTwo ? std::countr_zero(magnitude) : 0;
+    const std::string negate = "(forth_cell_t)(0u - (forth_ucell_t)";
+    
+    // Results that do not depend on the popped value
+    if ((op == "*" && d == 0) || (op == "MOD" && (d == 1 || d == -1))) {
+        emitIndented("(void)forth_pop();" + comment);
+        emitIndented("forth_push(0);");
+        return 2;
+    }
+    if ((op == "*" || op == "/") && d == 1) {
+        emitIndented("// " + std::to_string(d) + " " + op + " (identity)");
+        return 2;
+    }
+    if ((op == "*" || op == "/") && d == -1) {
+        emitIndented("forth_push(" + negate + "forth_pop()));" + comment);
+        return 2;
     }
-    emitLine("void " + funcName + "(void) {");
-    increaseIndent();
     
-    // Generate function body - with error handling for each child
-    bool hasBody = false;
-    for (const auto& child : node.getChildren()) {
-        try {
-            child->accept(*this);
-            hasBody = true;
-        } catch (const std::exception& e) {
-            addError("Error in word '" + wordName + "': " + std::string(e.what()));
+    if (op == "*") {
+        if (powerOfTwo && k < 31) {
+            const std::string shifted = "(forth_cell_t)((forth_ucell_t)forth_pop() << " + std::to_string(k) + ")";
+            emitIndented("forth_push(" + (d < 0 ? negate + shifted + ")" : shifted) + ");" + comment);
+        } else {
+            // A single hardware multiply, without the call and stack round trip
+            emitIndented("forth_push((forth_cell_t)((forth_ucell_t)forth_pop() * (forth_ucell_t)" +
+                         std::to_string(d) + "));" + comment);
         }
+        return 2;
     }
     
-    if (!hasBody) {
-        emitIndented("// Empty word body");
+    if (d == 0) {
+        return 0;  // Keep the run-time zero check
+    }
+    
+    emitIndented("{");
+    increaseIndent();
+    emitIndented("forth_cell_t a = forth_pop();" + comment);
+    
+    if (d == INT32_MIN) {
+        emitIndented(op == "/" ? "forth_push(a == INT32_MIN);" : "forth_push(a == INT32_MIN ? 0 : a);");
+    } else if (powerOfTwo) {
+        const std::string mask = std::to_string(magnitude - 1);
+        if (op == "/") {
+            // Bias negative dividends so the shift rounds toward zero
+            const std::string quotient = "(a + (forth_cell_t)((forth_ucell_t)(a >> 31) >> " +
+                                         std::to_string(32 - k) + ")) >> " + std::to_string(k);
+            emitIndented("forth_push(" + (d < 0 ? negate + "(" + quotient + "))" : quotient) + ");");
+        } else {
+            // The remainder takes the sign of the dividend
+            emitIndented("forth_cell_t bias = (a >> 31) & " + mask + ";");
+            emitIndented("forth_push(((a + bias) & " + mask + ") - bias);");
+        }
+    } else {
+        const DivisionMagic magic = signedDivisionMagic(d);
+        emitIndented("forth_cell_t q = (forth_cell_t)(((int64_t)a * (" +
+                     std::to_string(magic.multiplier) + ")) >> 32);");
+        if (d > 0 && magic.multiplier < 0) emitIndented("q += a;");
+        if (d < 0 && magic.multiplier > 0) emitIndented("q -= a;");
+        if (magic.shift > 0) emitIndented("q >>= " + std::to_string(magic.shift) + ";");
+        emitIndented("q += (forth_cell_t)((forth_ucell_t)q >> 31);");
+        emitIndented(op == "/" ? "forth_push(q);" : "forth_push(a - q * " + std::to_string(d) + ");");
     }
     
     decreaseIndent();
-    emitLine("}");
+    emitIndented("}");
+    return 2;
 }
 
-void ForthCCodegen::visit(WordCallNode& node) {
-    const std::string& wordName = node.getWordName();
-    const std::string upperWord = ForthUtils::toUpper(wordName);
-    
-    // Special handling for print word "."
-    if (upperWord == ".") {
-        emitIndented("forth_print_number(forth_pop());");
-        return;
-    }
+// ============================================================================
+// Compile-time Evaluation
+// ============================================================================
+
+void ForthCCodegen::collectPureWords(const ProgramNode& program) {
+    pureWords.clear();
+    evaluator.reset();
+    evaluatedCalls.clear();
+    if (!semanticAnalyzer) return;
     
-    if (isBuiltinWord(upperWord)) {
-        generateOptimizedBuiltin(upperWord);
-    } else if (wordFunctionNames.contains(upperWord)) {
-        // Direct call to generated function
-        emitIndented(wordFunctionNames[upperWord] + "();");
-    } else if (dictionary && dictionary->isWordDefined(upperWord)) {
-        // Forward reference - need to defer resolution
-        std::string callFunc = "forth_call_word_" + sanitizeIdentifier(upperWord);
-        emitIndented(callFunc + "();");
-        forwardReferences.insert(upperWord);
-    } else {
-        // Try to find in current generation context
-        bool found = false;
-        for (const auto& [name, func] : wordFunctionNames) {
-            if (ForthUtils::toUpper(name) == upperWord) {
-                emitIndented(func + "();");
-                found = true;
-                break;
+    const auto pure = semanticAnalyzer->findPureWords(program);
+    for (const auto* statements : program.getStatementLists()) {
+        for (const auto& child : *statements) {
+            if (child->getType() != ASTNode::NodeType::WORD_DEFINITION) continue;
+            const auto* definition = static_cast<const WordDefinitionNode*>(child.get());
+            const std::string name = ForthUtils::toUpper(definition->getWordName());
+            if (pure.contains(name)) {
+                pureWords[name] = definition;  // The last definition wins
             }
         }
-        
-        if (!found) {
-            addError("Unknown word: " + wordName, &node);
+    }
+}
+
+ForthInterpreter& ForthCCodegen::getEvaluator() {
+    if (!evaluator) {
+        ForthInterpreter::Options options;
+        options.stackSize = esp32Config.stackSize;
+        options.maxSteps = 10000;  // A pure word that runs longer stays a call
+        options.strictStack = true;  // The values below the run are not known here
+        evaluator = std::make_unique<ForthInterpreter>(options);
+        for (const auto& [name, value] : importedConstants) evaluator->defineConstant(name, value);
+        for (const auto& [name, value] : constantValues) evaluator->defineConstant(name, value);
+        for (const auto& [name, word] : importedWords) {
+            if (word.inlineBody) evaluator->defineWord(name, *word.inlineBody);
         }
+        for (const auto& [name, definition] : pureWords) evaluator->defineWord(name, *definition);
     }
+    return *evaluator;
 }
 
-void ForthCCodegen::visit(NumberLiteralNode& node) {
-    const std::string& value = node.getValue();
+// Runs one evaluable node on the evaluator's stack. A word runs only when
+// the known values cover its analyzed inputs - otherwise it would run until
+// it underflows somewhere deep in its callees - and runs once per distinct
+// stack. Returns false, with the stack unchanged, when the node fails.
+bool ForthCCodegen::evaluateNode(const ASTNode& node) {
+    ForthInterpreter& machine = getEvaluator();
+    const auto before = machine.getStack();
+    auto restore = [&machine, &before]() {
+        machine.clearStack();
+        for (auto value : before) machine.push(value);
+    };
     
-    if (node.isFloatingPoint() && optimizationFlags.needsFloat) {
-        emitIndented("forth_push((forth_cell_t)(forth_float_t)" + value + "f);");
-    } else {
-        // Use immediate push for small constants (optimization)
-        try {
-            int intVal = std::stoi(value);
-            if (intVal >= -128 && intVal <= 127) {
-                emitIndented("forth_push(" + value + ");  // Small constant");
-            } else {
-                emitIndented("forth_push(" + value + ");");
+    std::string key;
+    if (node.getType() == ASTNode::NodeType::WORD_CALL || node.getType() == ASTNode::NodeType::MATH_OPERATION) {
+        const std::string name = ForthUtils::toUpper(
+            node.getType() == ASTNode::NodeType::WORD_CALL ? static_cast<const WordCallNode&>(node).getWordName()
+                                                           : static_cast<const MathOperationNode&>(node).getOperation());
+        const bool userWord = pureWords.contains(name) || importedWords.contains(name);
+        int inputs = 0;
+        if (userWord) {
+            inputs = semanticAnalyzer ? semanticAnalyzer->getStackEffect(name).consumed : 0;
+        } else if (const WordEntry* entry = dictionary ? dictionary->lookupWord(name) : nullptr;
+                   entry && entry->type != WordEntry::WordType::USER_DEFINED && entry->stackEffect.isKnown) {
+            inputs = entry->stackEffect.consumed;  // Builtins: no throw on a stack that is too short
+        }
+        if (before.size() < static_cast<size_t>(std::max(inputs, 0))) return false;
+        if (userWord) {
+            key = name;
+            for (auto value : before) key += ' ' + std::to_string(value);
+            if (auto cached = evaluatedCalls.find(key); cached != evaluatedCalls.end()) {
+                if (!cached->second) return false;
+                machine.clearStack();
+                for (auto value : *cached->second) machine.push(value);
+                return true;
             }
-        } catch (const std::exception&) {
-            emitIndented("forth_push(" + value + ");");
         }
     }
+    
+    machine.resetSteps();
+    try {
+        machine.execute(node);
+    } catch (const ForthInterpreter::Error&) {
+        restore();
+        if (!key.empty()) evaluatedCalls.emplace(std::move(key), std::nullopt);
+        return false;
+    }
+    if (!key.empty()) evaluatedCalls.emplace(std::move(key), machine.getStack());
+    return true;
 }
 
-void ForthCCodegen::visit(StringLiteralNode& node) {
-    const std::string& value = node.getValue();
+// Literals, folded constants, pure builtins and words whose only effect is
+// on the data stack, resolved the way visit(WordCallNode) resolves them
+bool ForthCCodegen::isEvaluable(const ASTNode* node) const {
+    if (foldedNodes.contains(node)) return false;
+    switch (node->getType()) {
+        case ASTNode::NodeType::NUMBER_LITERAL:
+            return literalValue(node).has_value();
+        case ASTNode::NodeType::MATH_OPERATION:
+            return SemanticAnalyzer::isPureBuiltin(
+                ForthUtils::toUpper(static_cast<const MathOperationNode*>(node)->getOperation()));
+        case ASTNode::NodeType::WORD_CALL:
+            break;
+        default:
+            return false;
+    }
+    
+    const auto* call = static_cast<const WordCallNode*>(node);
+    if (!call->getParsedName().empty()) return false;
+    const std::string name = ForthUtils::toUpper(call->getWordName());
+    if (taskHandles.contains(name) || channels.contains(name) || dataSpaceWords.contains(name) ||
+        constantSlots.contains(name)) {
+        return false;
+    }
+    if (constantValues.contains(name)) return !pureWords.contains(name);
+    if (wordFunctionNames.contains(name)) return pureWords.contains(name);
+    if (importedConstants.contains(name)) return true;
+    if (auto word = importedWords.find(name); word != importedWords.end()) {
+        return word->second.inlineBody != nullptr;  // Only pure words carry one
+    }
+    return SemanticAnalyzer::isPureBuiltin(name);
+}
+
+// A run of literals and pure words computes the same values every time it
+// executes, so the reference interpreter runs it once here and the code
+// only pushes the results: "7 SQUARE" becomes forth_push(49). The run stops
+// before anything that needs a value from below it on the stack, and a word
+// that fails or runs too long is left as a call. Returns the number of
+// nodes replaced (0 = nothing to evaluate).
+size_t ForthCCodegen::emitEvaluated(const NodeList& nodes, size_t index) {
+    constexpr size_t MAX_RESULTS = 8;
+    if (!optimizationFlags.evaluatePure || !isEvaluable(nodes[index].get())) return 0;
     
-    if (node.isPrint()) {
-        // Direct print optimization
-        emitIndented("printf(\"" + escapeCString(value) + "\");");
-        if (targetPlatform.starts_with("esp32")) {
-            emitIndented("fflush(stdout);  // ESP32 serial flush");
+    ForthInterpreter& machine = getEvaluator();
+    machine.clearStack();
+    
+    size_t end = index;
+    bool computes = false;  // Literals and constants alone are left as they are
+    std::vector<ForthInterpreter::Cell> results;
+    for (size_t i = index; i < nodes.size() && isEvaluable(nodes[i].get()); i++) {
+        if (i > index && specializedCalls.contains(nodes[i].get())) break;  // Arguments of a clone
+        if (!evaluateNode(*nodes[i])) break;
+        const ASTNode* node = nodes[i].get();
+        if (node->getType() == ASTNode::NodeType::MATH_OPERATION) {
+            computes = true;
+        } else if (node->getType() == ASTNode::NodeType::WORD_CALL) {
+            const std::string name = ForthUtils::toUpper(static_cast<const WordCallNode*>(node)->getWordName());
+            computes = computes || !(constantValues.contains(name) || importedConstants.contains(name));
         }
-    } else {
-        // Store string in RODATA section
-        std::string strVar = "str_" + std::to_string(++stringCounter);
-        emitIndented("static const char " + strVar + "[] = \"" + escapeCString(value) + "\";");
-        emitIndented("forth_push((forth_cell_t)" + strVar + ");");
-        emitIndented("forth_push(" + std::to_string(value.length()) + ");");
+        if (computes && machine.getStack().size() <= MAX_RESULTS) {
+            end = i + 1;
+            results = machine.getStack();
+        }
+    }
+    if (end == index) return 0;
+    
+    std::string source;
+    for (size_t i = index; i < end; i++) {
+        const ASTNode* node = nodes[i].get();
+        if (i > index) source += ' ';
+        if (node->getType() == ASTNode::NodeType::NUMBER_LITERAL) {
+            source += static_cast<const NumberLiteralNode*>(node)->getValue();
+        } else if (node->getType() == ASTNode::NodeType::MATH_OPERATION) {
+            source += static_cast<const MathOperationNode*>(node)->getOperation();
+        } else {
+            source += ForthUtils::toUpper(static_cast<const WordCallNode*>(node)->getWordName());
+        }
+    }
+    if (source.size() > 48) source = source.substr(0, 45) + "...";
+    
+    emitIndented("// " + source + " (evaluated at compile time)");
+    for (ForthInterpreter::Cell value : results) {
+        emitIndented(value == INT32_MIN ? "forth_push(INT32_MIN);" : "forth_push(" + std::to_string(value) + ");");
     }
+    return end - index;
 }
 
-void ForthCCodegen::visit(IfStatementNode& node) {
-    if (optimizationFlags.canInline && isSimpleCondition(node)) {
-        // Generate optimized ternary for simple if-then-else
-        generateOptimizedIf(node);
-    } else {
-        // Standard if-then-else generation
-        emitIndented("{  // IF block");
-        increaseIndent();
-        emitIndented("forth_cell_t condition = forth_pop();");
-        emitIndented("if (condition) {");
-        increaseIndent();
-        
-        if (node.getThenBranch()) {
-            for (const auto& child : node.getThenBranch()->getChildren()) {
-                child->accept(*this);
+// ============================================================================
+// Specialization on Constant Arguments
+// ============================================================================
+
+// A call whose leading arguments are literals - "13 PIN-HIGH", "100 MS" -
+// gets a clone of the word that starts from those values: the part of the
+// body they determine is evaluated here (arithmetic, comparisons, IF on a
+// known flag, stores and output of known values) and only the rest is
+// emitted. A clone is made only when it runs fewer operations than the
+// literals and body it replaces. Small words are specialized at
+// any call site, larger ones only inside a loop, where the call repeats.
+// Clones are shared by (word, constants) and limited by a budget on the
+// nodes they add, so specialization cannot blow up the program.
+void ForthCCodegen::planSpecializations(const ProgramNode& program) {
+    constexpr size_t MAX_ARGUMENTS = 4;
+    constexpr size_t SMALL_WORD = 24;   // Body nodes; specialized at any call site
+    constexpr size_t LOOP_WORD = 96;    // Body nodes; specialized inside a loop
+    
+    specializations.clear();
+    specializedCalls.clear();
+    specializationKeys.clear();
+    if (!optimizationFlags.specialize || !optimizationFlags.evaluatePure) return;
+    
+    std::unordered_map<std::string, const WordDefinitionNode*> definitions;
+    size_t programNodes = 0;
+    for (const auto* statements : program.getStatementLists()) {
+        for (const auto& child : *statements) {
+            programNodes += countNodes(child.get());
+            if (child->getType() == ASTNode::NodeType::WORD_DEFINITION) {
+                const auto* definition = static_cast<const WordDefinitionNode*>(child.get());
+                definitions[ForthUtils::toUpper(definition->getWordName())] = definition;  // The last wins
             }
         }
+    }
+    size_t budget = std::max<size_t>(64, programNodes / 5);
+    
+    std::unordered_set<std::string> functionNames;
+    for (const auto& [name, function] : wordFunctionNames) functionNames.insert(function);
+    std::map<std::pair<std::string, std::vector<int32_t>>, std::shared_ptr<const Specialization>> clones;
+    
+    auto consider = [&](const NodeList& nodes, size_t index, bool inLoop, std::string& key) {
+        const auto* call = static_cast<const WordCallNode*>(nodes[index].get());
+        if (!call->getParsedName().empty()) return;
+        const std::string name = ForthUtils::toUpper(call->getWordName());
+        auto definition = definitions.find(name);
+        if (definition == definitions.end() || !wordFunctionNames.contains(name)) return;
         
-        decreaseIndent();
+        size_t first = index;
+        while (first > 0 && index - first < MAX_ARGUMENTS && !foldedNodes.contains(nodes[first - 1].get())) {
+            auto value = literalValue(nodes[first - 1].get());
+            if (!value || *value < INT32_MIN || *value > UINT32_MAX) break;
+            first--;
+        }
+        if (first == index) return;
         
-        if (node.hasElse() && node.getElseBranch()) {
-            emitIndented("} else {");
-            increaseIndent();
-            
-            for (const auto& child : node.getElseBranch()->getChildren()) {
-                child->accept(*this);
+        // A pure word whose run evaluates completely is folded by emitEvaluated
+        if (pureWords.contains(name)) {
+            size_t start = first;
+            while (start > 0 && isEvaluable(nodes[start - 1].get())) start--;
+            getEvaluator().clearStack();
+            bool evaluated = true;
+            for (size_t i = start; i <= index && evaluated; i++) evaluated = evaluateNode(*nodes[i]);
+            if (evaluated) return;
+        }
+        
+        const size_t size = countNodes(definition->second) - 1;
+        if (size > (inLoop ? LOOP_WORD : SMALL_WORD)) return;
+        
+        std::vector<int32_t> constants;
+        for (size_t i = first; i < index; i++) {
+            constants.push_back(static_cast<int32_t>(static_cast<uint32_t>(*literalValue(nodes[i].get()))));
+        }
+        auto [clone, added] = clones.try_emplace({name, constants});
+        if (added) {
+            auto specialization = partiallyEvaluate(*definition->second, constants);
+            if (specialization && specialization->nodes <= budget) {
+                budget -= specialization->nodes;
+                std::string function = wordFunctionNames.at(name) + "__k";
+                for (size_t i = 0; i < constants.size(); i++) {
+                    if (i > 0) function += '_';
+                    function += constants[i] < 0 ? "m" + std::to_string(-int64_t{constants[i]})
+                                                 : std::to_string(constants[i]);
+                }
+                while (!functionNames.insert(function).second) function += '_';
+                specialization->function = std::move(function);
+                specializations.push_back(specialization);
+                clone->second = std::move(specialization);
             }
-            
-            decreaseIndent();
         }
+        if (!clone->second) return;
         
-        emitIndented("}");
-        decreaseIndent();
-        emitIndented("}  // End IF block");
+        specializedCalls[nodes[first].get()] = {index - first, clone->second};
+        key += "|" + clone->second->function + "/" + std::to_string(index - first);
+    };
+    
+    std::function<void(const NodeList&, bool, std::string&)> walk =
+        [&](const NodeList& nodes, bool inLoop, std::string& key) {
+            for (size_t i = 0; i < nodes.size(); i++) {
+                const ASTNode* node = nodes[i].get();
+                switch (node->getType()) {
+                    case ASTNode::NodeType::WORD_CALL:
+                        consider(nodes, i, inLoop, key);
+                        break;
+                    case ASTNode::NodeType::IF_STATEMENT: {
+                        const auto* ifNode = static_cast<const IfStatementNode*>(node);
+                        if (ifNode->getThenBranch()) walk(ifNode->getThenBranch()->getChildren(), inLoop, key);
+                        if (ifNode->getElseBranch()) walk(ifNode->getElseBranch()->getChildren(), inLoop, key);
+                        break;
+                    }
+                    case ASTNode::NodeType::BEGIN_UNTIL_LOOP: {
+                        const auto* body = static_cast<const BeginUntilLoopNode*>(node)->getBody();
+                        if (body) walk(body->getChildren(), true, key);
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
+        };
+    
+    for (const auto* statements : program.getStatementLists()) {
+        std::string topLevel;
+        walk(*statements, false, topLevel);
+        for (const auto& child : *statements) {
+            if (child->getType() != ASTNode::NodeType::WORD_DEFINITION) continue;
+            std::string key;
+            walk(child->getChildren(), false, key);
+            if (!key.empty()) specializationKeys[child.get()] = std::move(key);
+        }
     }
 }
 
-void ForthCCodegen::visit(BeginUntilLoopNode& node) {
-    std::string loopLabel = generateLabel("loop");
-    
-    if (optimizationFlags.useIRAM) {
-        emitIndented("// Loop in hot path - consider IRAM placement");
-    }
+// Runs the body on the known arguments for as long as each node's effect
+// is known: evaluable nodes execute, static data-space words push their
+// offset, an IF on a known flag continues into the taken branch, and "!",
+// "C!" and "." on known values, CR and ." become direct stores and output
+// in the clone. Null unless the clone runs fewer operations than the
+// literals and body it replaces.
+std::shared_ptr<ForthCCodegen::Specialization> ForthCCodegen::partiallyEvaluate(
+    const WordDefinitionNode& word, const std::vector<int32_t>& constants) {
+    ForthInterpreter& machine = getEvaluator();
+    machine.clearStack();
+    for (int32_t value : constants) machine.push(value);
     
-    emitIndented("{  // BEGIN-UNTIL loop");
-    increaseIndent();
+    auto specialization = std::make_shared<Specialization>();
+    auto dataWordAt = [this](int32_t offset) -> std::string {
+        for (const auto& [labelOffset, name] : dataSpaceLabels) {
+            if (labelOffset == static_cast<uint32_t>(offset)) return " " + name;
+        }
+        return "";
+    };
+    auto known = [&machine](size_t count) { return machine.getStack().size() >= count; };
     
-    // Check for common loop patterns for optimization
-    if (isCountedLoop(node)) {
-        generateOptimizedCountedLoop(node);
-    } else {
-        emitIndented("do {");
-        increaseIndent();
+    std::vector<std::pair<const NodeList*, size_t>> frames{{&word.getChildren(), 0}};
+    size_t work = constants.size();  // Operations the call site and body run
+    size_t pushes = 0;               // Literals and data words just before the stop
+    while (!frames.empty()) {
+        auto& [nodes, index] = frames.back();
+        if (index == nodes->size()) {
+            frames.pop_back();
+            pushes = 0;
+            continue;
+        }
+        const ASTNode* node = (*nodes)[index].get();
+        if (foldedNodes.contains(node)) break;
+        const auto* call = node->getType() == ASTNode::NodeType::WORD_CALL
+                               ? static_cast<const WordCallNode*>(node) : nullptr;
+        const std::string name = call && call->getParsedName().empty() ? ForthUtils::toUpper(call->getWordName()) : "";
+        const auto data = dataSpaceWords.find(name);
         
-        if (node.getBody()) {
-            for (const auto& child : node.getBody()->getChildren()) {
-                child->accept(*this);
+        if (node->getType() == ASTNode::NodeType::IF_STATEMENT && known(1)) {
+            const auto* ifNode = static_cast<const IfStatementNode*>(node);
+            const ASTNode* branch = machine.pop() ? ifNode->getThenBranch() : ifNode->getElseBranch();
+            index++;
+            work++;
+            if (branch) frames.emplace_back(&branch->getChildren(), 0);
+            pushes = 0;
+            continue;
+        }
+        const bool push = node->getType() == ASTNode::NodeType::NUMBER_LITERAL ||
+                          (data != dataSpaceWords.end() && data->second.isStatic);
+        if (data != dataSpaceWords.end() && data->second.isStatic) {
+            machine.push(static_cast<int32_t>(data->second.offset));
+        } else if ((name == "!" || name == "C!") && isBuiltinCall(node, name) && known(2)) {
+            const int32_t address = machine.getStack().back();
+            const int32_t value = machine.getStack()[machine.getStack().size() - 2];
+            const bool cell = name == "!";
+            if (address < 0 || (cell && address % sizeof(int32_t) != 0) ||
+                static_cast<uint32_t>(address) + (cell ? sizeof(int32_t) : 1) > dataSpaceHere) {
+                break;  // Outside the static image: left to the run-time word
             }
+            machine.pop();
+            machine.pop();
+            const std::string comment = "  // " + std::to_string(value) + dataWordAt(address) + " " + name;
+            specialization->effects.push_back(
+                {cell ? "forth_data_space[" + std::to_string(address / sizeof(int32_t)) + "] = " +
+                            std::to_string(value) + ";" + comment
+                      : "((forth_byte_t*)forth_data_space)[" + std::to_string(address) +
+                            "] = (forth_byte_t)" + std::to_string(value) + ";" + comment,
+                 nullptr});
+        } else if (name == "." && known(1)) {
+            specialization->effects.push_back({"forth_print_number(" + std::to_string(machine.pop()) + ");", nullptr});
+        } else if ((name == "CR" && isBuiltinCall(node, name)) ||
+                   (node->getType() == ASTNode::NodeType::STRING_LITERAL &&
+                    static_cast<const StringLiteralNode*>(node)->isPrint())) {
+            specialization->effects.push_back({"", node});  // No stack effect: emitted as it is
+        } else if (!isEvaluable(node) || !evaluateNode(*node)) {
+            break;
         }
-        
-        decreaseIndent();
-        emitIndented("} while (!forth_pop());");
+        index++;
+        work++;
+        pushes = push ? pushes + 1 : 0;
     }
     
-    decreaseIndent();
-    emitIndented("}  // End loop");
+    // Values pushed right before the stop go back to the residual as their
+    // nodes, so "NAME @" and "<literal> /" at the seam still fuse
+    const size_t rewind = frames.empty() ? 0 : std::min(pushes, frames.back().second);
+    if (rewind > 0) {
+        frames.back().second -= rewind;
+        work -= rewind;
+    }
+    
+    specialization->word = ForthUtils::toUpper(word.getWordName());
+    specialization->constants = constants;
+    specialization->prefix.assign(machine.getStack().begin(), machine.getStack().end() - rewind);
+    specialization->residual.assign(frames.rbegin(), frames.rend());
+    if (specialization->effects.size() + specialization->prefix.size() >= work) return nullptr;
+    
+    specialization->nodes = specialization->effects.size() + specialization->prefix.size();
+    for (const auto& [nodes, index] : specialization->residual) {
+        for (size_t i = index; i < nodes->size(); i++) specialization->nodes += countNodes((*nodes)[i].get());
+    }
+    return specialization;
 }
 
-void ForthCCodegen::visit(MathOperationNode& node) {
-    const std::string& op = node.getOperation();
-    generateOptimizedBuiltin(op);
+size_t ForthCCodegen::emitSpecializedCall(const NodeList& nodes, size_t index) {
+    auto site = specializedCalls.find(nodes[index].get());
+    if (site == specializedCalls.end()) return 0;
+    
+    std::string source;
+    for (int32_t value : site->second.clone->constants) source += std::to_string(value) + " ";
+    emitIndented("// " + source + site->second.clone->word + " (specialized)");
+    emitIndented(site->second.clone->function + "();");
+    return site->second.literals + 1;
 }
 
-void ForthCCodegen::visit(VariableDeclarationNode& node) {
-    const std::string& varName = node.getVarName();
-    const std::string cVarName = "var_" + sanitizeIdentifier(varName);
+void ForthCCodegen::emitSpecializations() {
+    if (specializations.empty()) return;
     
-    if (node.isConst()) {
-        // Constants can be optimized
-        emitIndented("static const forth_cell_t " + cVarName + " = forth_pop();");
-        emitIndented("forth_push(" + cVarName + ");");
-    } else {
-        // Variables need proper alignment for ESP32
-        if (targetPlatform.starts_with("esp32")) {
-            emitIndented("static FORTH_DMA_ATTR forth_cell_t " + cVarName + " = 0;");
-        } else {
-            emitIndented("static forth_cell_t " + cVarName + " = 0;");
+    emitLine("");
+    emitLine("// Words specialized on constant arguments");
+    for (const auto& clone : specializations) {
+        std::string source;
+        for (int32_t value : clone->constants) source += std::to_string(value) + " ";
+        emitLine("");
+        emitLine("// FORTH word: " + source + clone->word);
+        emitLine("void " + clone->function + "(void) {");
+        increaseIndent();
+        for (const auto& effect : clone->effects) {
+            if (effect.node) {
+                const_cast<ASTNode*>(effect.node)->accept(*this);
+            } else {
+                emitIndented(effect.code);
+            }
         }
-        emitIndented("forth_push((forth_cell_t)&" + cVarName + ");");
+        for (int32_t value : clone->prefix) {
+            emitIndented(value == INT32_MIN ? "forth_push(INT32_MIN);" : "forth_push(" + std::to_string(value) + ");");
+        }
+        for (const auto& [nodes, start] : clone->residual) {
+            for (size_t i = start; i < nodes->size();) {
+                try {
+                    i += emitStatement(*nodes, i);
+                } catch (const std::exception& e) {
+                    addError("Error generating specialized word " + clone->word + ": " + e.what());
+                    i++;
+                }
+            }
+        }
+        if (clone->nodes == 0) {
+            emitIndented("// Evaluated completely");
+        }
+        decreaseIndent();
+        emitLine("}");
     }
-    
-    variableMap[varName] = cVarName;
 }
 
 // ============================================================================
@@ -1434,9 +4854,35 @@ void ForthCCodegen::generateOptimizedBuiltin(const std::string& word) {
         {"ROT", "forth_rot()"},
         {"!", "forth_store()"},
         {"@", "forth_fetch()"},
+        {"C!", "forth_byte_store()"},
+        {"C@", "forth_byte_fetch()"},
         {"EMIT", "forth_emit()"},
         {"TYPE", "forth_type()"},
-        {"CR", "forth_cr()"}
+        {"CR", "forth_cr()"},
+        {"SPACE", "forth_space()"},
+        {"SPACES", "forth_spaces()"},
+        {"FLUSH", "forth_flush()"},
+        {"HERE", "forth_here()"},
+        {"ALLOT", "forth_allot()"},
+        {",", "forth_comma()"},
+        {"CELLS", "forth_cells()"},
+        {"CELL+", "forth_cell_plus()"},
+        {"MOVE", "forth_move()"},
+        {"CMOVE", "forth_cmove()"},
+        {"CMOVE>", "forth_cmove_up()"},
+        {"FILL", "forth_fill()"},
+        {"ERASE", "forth_erase()"},
+        {"SUM", "forth_sum()"},
+        {"DOT", "forth_dot()"},
+        {"MIN-REDUCE", "forth_min_reduce()"},
+        {"MAX-REDUCE", "forth_max_reduce()"},
+        {"MAP+", "forth_map_add()"},
+        {"SCALE", "forth_scale()"},
+        {"PAUSE", "forth_pause()"},
+        {"STOP", "forth_stop()"},
+        {"SEND", "forth_send()"},
+        {"RECV", "forth_recv()"},
+        {"TRY-RECV", "forth_try_recv()"}
     };
     
     auto it = builtinMap.find(word);
@@ -1476,17 +4922,13 @@ void ForthCCodegen::generateOptimizedIf(const IfStatementNode& node) {
     emitIndented("if (cond) {");
     increaseIndent();
     
-    for (const auto& child : node.getThenBranch()->getChildren()) {
-        child->accept(*this);
-    }
+    emitSequence(node.getThenBranch()->getChildren());
     
     decreaseIndent();
     emitIndented("} else {");
     increaseIndent();
     
-    for (const auto& child : node.getElseBranch()->getChildren()) {
-        child->accept(*this);
-    }
+    emitSequence(node.getElseBranch()->getChildren());
     
     decreaseIndent();
     emitIndented("}");
@@ -1509,18 +4951,22 @@ void ForthCCodegen::applyOptimizations() {
     // Apply various optimization passes
     
     if (optimizationFlags.canInline) {
+        ForthTrace::Span span("optimize", "inline small functions");
         inlineSmallFunctions();
     }
     
     if (optimizationFlags.smallStack) {
+        ForthTrace::Span span("optimize", "stack usage");
         optimizeStackUsage();
     }
     
     if (targetPlatform.starts_with("esp32")) {
+        ForthTrace::Span span("optimize", "esp32");
         applyESP32Optimizations();
     }
     
     // Remove unused code
+    ForthTrace::Span span("optimize", "unused functions");
     removeUnusedFunctions();
 }
 
@@ -1602,7 +5048,11 @@ void ForthCCodegen::generateCMakeLists() {
     
     cmake << ")\n\n";
     cmake << "set(HEADERS\n";
-    cmake << "    forth_runtime.h\n";
+    for (const auto& [filename, _] : generatedFiles) {
+        if (filename.ends_with(".h")) {
+            cmake << "    " << filename << "\n";
+        }
+    }
     cmake << ")\n";
     
     generateFile("CMakeLists.txt", cmake.str());
@@ -1651,18 +5101,24 @@ void app_main(void) {
 bool ForthCCodegen::writeToFiles(const std::string& outputDir) {
     try {
         fs::create_directories(outputDir);
+        unchangedFileCount = 0;
         
         for (const auto& [filename, content] : generatedFiles) {
+            ForthTrace::Span span("write", filename);
             std::string filepath = fs::path(outputDir) / filename;
-            std::ofstream file(filepath);
             
-            if (!file.is_open()) {
-                addError("Cannot create file: " + filepath);
-                return false;
+            // Unchanged files keep their timestamps so ESP-IDF/CMake
+            // does not rebuild translation units that did not change
+            switch (content.writeIfChanged(filepath)) {
+                case ChunkedBuffer::WriteResult::Unchanged:
+                    unchangedFileCount++;
+                    break;
+                case ChunkedBuffer::WriteResult::Written:
+                    break;
+                case ChunkedBuffer::WriteResult::Failed:
+                    addError("Cannot create file: " + filepath);
+                    return false;
             }
-            
-            file << content.str();
-            file.close();
         }
         
         return true;
@@ -1688,7 +5144,7 @@ void ForthCCodegen::debugGenerationState() const {
     printf("\nGenerated files:\n");
     for (size_t i = 0; i < generatedFiles.size(); i++) {
         const auto& [filename, content] = generatedFiles[i];
-        printf("  [%zu] %s (%zu chars)\n", i, filename.c_str(), content.str().length());
+        printf("  [%zu] %s (%zu chars)\n", i, filename.c_str(), content.size());
     }
     
     if (!errors.empty()) {
@@ -1718,10 +5174,33 @@ void ForthCCodegen::resetGenerationState() {
         warnings.clear();
         generatedWords.clear();
         wordFunctionNames.clear();
+        wordOrder.clear();
+        stringPool.clear();
+        stringPoolOrder.clear();
+        stringPoolSize = 0;
+        wordShard.clear();
+        shardFileIndices.clear();
+        crossShardCallCount = 0;
+        wordCacheHitCount = 0;
         usedFeatures.clear();
         usedBuiltins.clear();
         callGraph.clear();
         variableMap.clear();
+        dataSpaceWords.clear();
+        constantValues.clear();
+        constantSlots.clear();
+        dataSpaceImage.clear();
+        dataSpaceLabels.clear();
+        dataSpaceHere = 0;
+        foldedNodes.clear();
+        pureWords.clear();
+        evaluator.reset();
+        evaluatedCalls.clear();
+        specializations.clear();
+        specializedCalls.clear();
+        specializationKeys.clear();
+        taskHandles.clear();
+        channels.clear();
         forwardReferences.clear();
         inlineCandidates.clear();
         iramFunctions.clear();
@@ -1729,10 +5208,7 @@ void ForthCCodegen::resetGenerationState() {
         
         // Reset counters
         currentFileIndex = 0;
-        tempVarCounter = 0;
-        labelCounter = 0;
-        stringCounter = 0;
-        indentLevel = 0;
+        emitState = EmitState{};
         
     } catch (const std::exception& e) {
         // Even reset failed - create a minimal error state
@@ -1743,8 +5219,8 @@ void ForthCCodegen::resetGenerationState() {
 
 void ForthCCodegen::generateFile(const std::string& filename, const std::string& content) {
     try {
-        generatedFiles.emplace_back(filename, std::ostringstream());
-        generatedFiles.back().second << content;
+        generatedFiles.emplace_back(filename, ChunkedBuffer());
+        generatedFiles.back().second.append(content);
         
         // Log for debugging
         if (!content.empty()) {
@@ -1757,37 +5233,36 @@ void ForthCCodegen::generateFile(const std::string& filename, const std::string&
     }
 }
 
-void ForthCCodegen::emit(const std::string& code) {
-    if (currentFileIndex >= generatedFiles.size()) {
-        addError("Invalid file index in emit(): " + std::to_string(currentFileIndex));
+void ForthCCodegen::emit(std::string_view code) {
+    if (!emitState.buffer) {
+        addError("No output buffer in emit()");
         return;
     }
-    
-    try {
-        generatedFiles[currentFileIndex].second << code;
-    } catch (const std::exception& e) {
-        addError(std::string("Failed to emit code: ") + e.what());
-    }
+    emitState.buffer->append(code);
 }
 
-void ForthCCodegen::emitLine(const std::string& line) {
-    emit(line + "\n");
+void ForthCCodegen::emitLine(std::string_view line) {
+    emit(line);
+    emit("\n");
 }
 
-void ForthCCodegen::emitIndented(const std::string& line) {
-    emit(getIndent() + line + "\n");
+void ForthCCodegen::emitIndented(std::string_view line) {
+    if (emitState.buffer) {
+        emitState.buffer->append(static_cast<size_t>(emitState.indentLevel) * 4, ' ');
+    }
+    emitLine(line);
 }
 
 std::string ForthCCodegen::getIndent() const {
-    return std::string(indentLevel * 4, ' ');
+    return std::string(emitState.indentLevel * 4, ' ');
 }
 
 std::string ForthCCodegen::generateTempVar() {
-    return "temp_" + std::to_string(++tempVarCounter);
+    return "temp_" + std::to_string(++emitState.tempVarCounter);
 }
 
 std::string ForthCCodegen::generateLabel(const std::string& prefix) {
-    return prefix + "_" + std::to_string(++labelCounter);
+    return prefix + "_" + std::to_string(++emitState.labelCounter);
 }
 
 std::string ForthCCodegen::sanitizeIdentifier(const std::string& name) {
@@ -1798,10 +5273,10 @@ std::string ForthCCodegen::sanitizeIdentifier(const std::string& name) {
 }
 
 std::string ForthCCodegen::generateFunctionName(const std::string& wordName) {
-    return "forth_word_" + sanitizeIdentifier(wordName);
+    return (isModuleMode() ? modulePrefix : std::string("forth_word_")) + sanitizeIdentifier(wordName);
 }
 
-std::string ForthCCodegen::escapeCString(const std::string& str) {
+std::string ForthCCodegen::escapeCString(const std::string& str) const {
     std::string result;
     result.reserve(str.length() * 2);
     
@@ -1812,13 +5287,15 @@ std::string ForthCCodegen::escapeCString(const std::string& str) {
             case '\n': result += "\\n"; break;
             case '\r': result += "\\r"; break;
             case '\t': result += "\\t"; break;
-            case '\0': result += "\\0"; break;
+            case '\0': result += "\\000"; break;
             default: 
                 if (c >= 32 && c <= 126) {
                     result += c;
                 } else {
+                    // Three-digit octal: unlike \x it cannot swallow a
+                    // following hex digit
                     char buffer[8];
-                    sprintf(buffer, "\\x%02x", (unsigned char)c);
+                    snprintf(buffer, sizeof(buffer), "\\%03o", (unsigned char)c);
                     result += buffer;
                 }
                 break;
@@ -1846,7 +5323,11 @@ bool ForthCCodegen::isBuiltinWord(const std::string& word) const {
         "DUP", "DROP", "SWAP", "OVER", "ROT", "NIP", "TUCK",
         "!", "@", "C!", "C@", "EMIT", "TYPE", "CR", "SPACE", "SPACES",
         "AND", "OR", "XOR", "NOT", "LSHIFT", "RSHIFT",
-        "TRUE", "FALSE", "DEPTH", "CLEAR", "."
+        "TRUE", "FALSE", "DEPTH", "CLEAR", ".", "FLUSH",
+        "HERE", "ALLOT", ",", "CELLS", "CELL+",
+        "MOVE", "CMOVE", "CMOVE>", "FILL", "ERASE",
+        "SUM", "DOT", "MIN-REDUCE", "MAX-REDUCE", "MAP+", "SCALE",
+        "START", "PAUSE", "STOP", "SEND", "RECV", "TRY-RECV"
     };
     return builtins.contains(word);
 }
@@ -1860,14 +5341,18 @@ ForthCCodegen::CodeGenStats ForthCCodegen::getStatistics() const {
     
     // Count generated lines
     for (const auto& [filename, content] : generatedFiles) {
-        std::string str = content.str();
-        stats.linesGenerated += std::count(str.begin(), str.end(), '\n');
+        stats.linesGenerated += content.countLines();
     }
     
     stats.functionsGenerated = generatedWords.size();
     stats.variablesGenerated = variableMap.size();
     stats.filesGenerated = generatedFiles.size();
-    stats.optimizationsApplied = inlineCandidates.size() + iramFunctions.size();
+    stats.filesUnchanged = unchangedFileCount;
+    stats.shardsGenerated = shardFileIndices.size();
+    stats.crossShardCalls = crossShardCallCount;
+    stats.wordsFromCache = wordCacheHitCount;
+    stats.wordsSpecialized = specializations.size();
+    stats.optimizationsApplied = inlineCandidates.size() + iramFunctions.size() + specializations.size();
     stats.usesFloatingPoint = optimizationFlags.needsFloat;
     stats.usesStrings = usedFeatures.contains("STRING");
     stats.estimatedStackDepth = esp32Config.stackSize;
@@ -1899,36 +5384,37 @@ void ForthCCodegen::addError(const std::string& message, ASTNode* node) {
 // ============================================================================
 
 std::string ForthCCodegen::getCompleteCode() const {
-    std::ostringstream complete;
-
+    size_t total = 0;
+    for (const auto& [filename, content] : generatedFiles) {
+        total += content.size() + filename.size() + 16;
+    }
+    
     // Combine all generated files into one string
+    std::string complete;
+    complete.reserve(total);
     for (const auto& [filename, content] : generatedFiles) {
         if (filename.ends_with(".c")) {
-            complete << "// File: " << filename << "\n";
-            complete << content.str() << "\n\n";
+            complete += "// File: ";
+            complete += filename;
+            complete += "\n";
+            content.appendTo(complete);
+            complete += "\n\n";
         }
     }
 
-    return complete.str();
+    return complete;
 }
 
 std::string ForthCCodegen::getHeaderCode() const {
-    std::ostringstream header;
-
     // Find and return the header file content
     for (const auto& [filename, content] : generatedFiles) {
-        if (filename.ends_with(".h")) {
-            header << content.str();
-            break;
+        if (filename.ends_with(".h") && !content.empty()) {
+            return content.str();
         }
     }
 
     // If no header file found, return the runtime header
-    if (header.str().empty()) {
-        return generateCoreRuntimeHeader();
-    }
-
-    return header.str();
+    return generateCoreRuntimeHeader();
 }
 
 void ForthCCodegen::setOptimizationLevel(int level) {
@@ -1937,21 +5423,128 @@ void ForthCCodegen::setOptimizationLevel(int level) {
             optimizationFlags.useIRAM = false;
             optimizationFlags.canInline = false;
             optimizationFlags.smallStack = false;
+            optimizationFlags.evaluatePure = false;
+            optimizationFlags.specialize = false;
             break;
         case 1: // Basic optimization
             optimizationFlags.canInline = true;
+            optimizationFlags.evaluatePure = true;
+            optimizationFlags.specialize = true;
             break;
         case 2: // Full optimization
             optimizationFlags.useIRAM = true;
             optimizationFlags.canInline = true;
             optimizationFlags.smallStack = true;
+            optimizationFlags.evaluatePure = true;
+            optimizationFlags.specialize = true;
             break;
         default:
             optimizationFlags.canInline = true;
+            optimizationFlags.evaluatePure = true;
+            optimizationFlags.specialize = true;
             break;
     }
 }
         
+// ============================================================================
+// Separate Compilation
+// ============================================================================
+
+void ForthCCodegen::setModuleMode(const std::string& name) {
+    moduleName = name;
+    modulePrefix = "forth_" + sanitizeIdentifier(name) + "_";
+    programFileName = "forth_module_" + sanitizeIdentifier(name) + ".c";
+    stringPoolSymbol = modulePrefix + "string_pool";
+    shardCount = 1;
+}
+
+void ForthCCodegen::importInterface(std::shared_ptr<const ForthModuleInterface> interface) {
+    for (const auto& [name, value] : interface->constants) {
+        importedConstants[name] = value;
+    }
+    for (const auto& word : interface->words) {
+        importedWords[word.name] = ImportedWord{word.function, word.inlineBody.get()};
+    }
+    interfaces.push_back(std::move(interface));
+}
+
+ForthModuleInterface ForthCCodegen::getModuleInterface(const ProgramNode& program) const {
+    ForthModuleInterface interface;
+    interface.module = moduleName;
+    interface.fragment = programFileName;
+    interface.features = usedFeatures;
+    interface.builtins = usedBuiltins;
+    
+    std::set<std::string> constants;
+    for (const auto* statements : program.getStatementLists()) {
+        for (const auto& child : *statements) {
+            const auto* declaration = dynamic_cast<const VariableDeclarationNode*>(child.get());
+            if (!declaration || !declaration->isConst()) continue;
+            const std::string name = ForthUtils::toUpper(declaration->getVarName());
+            if (auto value = constantValues.find(name); value != constantValues.end() && constants.insert(name).second) {
+                interface.constants.emplace_back(name, value->second);
+            }
+        }
+    }
+    
+    // Bodies of a few builtins, literals and constants are cheaper to expand
+    // at the call site than to call; they never reach back into the module
+    constexpr size_t MAX_INLINE_NODES = 8;
+    auto inlineSource = [&](const WordDefinitionNode& word) -> std::string {
+        const auto& body = word.getChildren();
+        if (body.empty() || body.size() > MAX_INLINE_NODES) return {};
+        std::string text;
+        for (const auto& child : body) {
+            std::string token;
+            if (const auto* number = dynamic_cast<const NumberLiteralNode*>(child.get())) {
+                token = number->getValue();
+            } else if (const auto* math = dynamic_cast<const MathOperationNode*>(child.get())) {
+                token = math->getOperation();
+            } else if (const auto* call = dynamic_cast<const WordCallNode*>(child.get())) {
+                const std::string name = ForthUtils::toUpper(call->getWordName());
+                if (!call->getParsedName().empty() ||
+                    !(constants.contains(name) || (isBuiltinWord(name) && !wordFunctionNames.contains(name)))) {
+                    return {};
+                }
+                token = name;
+            } else {
+                return {};
+            }
+            text += (text.empty() ? "" : " ") + token;
+        }
+        return text;
+    };
+    
+    const std::set<std::string> pure = semanticAnalyzer ? semanticAnalyzer->findPureWords(program)
+                                                        : std::set<std::string>{};
+    for (const auto* statements : program.getStatementLists()) {
+        for (const auto& child : *statements) {
+            const auto* definition = dynamic_cast<const WordDefinitionNode*>(child.get());
+            if (!definition) continue;
+            const std::string name = ForthUtils::toUpper(definition->getWordName());
+            ForthModuleInterface::Word word;
+            word.name = name;
+            word.function = wordFunctionNames.at(name);
+            if (semanticAnalyzer) {
+                word.effect = semanticAnalyzer->getTypedStackEffect(definition->getWordName());
+            }
+            word.pure = pure.contains(definition->getWordName());
+            if (word.pure) {
+                word.inlineSource = inlineSource(*definition);
+            }
+            // A redefinition replaces the earlier entry
+            auto existing = std::find_if(interface.words.begin(), interface.words.end(),
+                                         [&name](const auto& other) { return other.name == name; });
+            if (existing != interface.words.end()) {
+                *existing = std::move(word);
+            } else {
+                interface.words.push_back(std::move(word));
+            }
+        }
+    }
+    return interface;
+}
+
 // ============================================================================
 // ESP-IDF Project Generation - FIXED IMPLEMENTATION
 // ============================================================================
@@ -1980,12 +5573,21 @@ project(forth_app)
         std::ofstream mainCMake(fs::path(projectPath) / "main" / "CMakeLists.txt");
         if (!mainCMake.is_open()) return false;
 
-        mainCMake << R"(idf_component_register(
-    SRCS "main.c" "forth_program.c"
-    INCLUDE_DIRS "."
-    REQUIRES forth_runtime
-)
-)";
+        // Program sources (and word shards) live in the main component
+        auto isProgramSource = [](const std::string& filename) {
+            return filename == "forth_program.c" || filename.starts_with("forth_words");
+        };
+        
+        mainCMake << "idf_component_register(\n";
+        mainCMake << "    SRCS \"main.c\"";
+        for (const auto& [filename, content] : generatedFiles) {
+            if (filename.ends_with(".c") && isProgramSource(filename)) {
+                mainCMake << " \"" << filename << "\"";
+            }
+        }
+        mainCMake << "\n    INCLUDE_DIRS \".\"\n";
+        mainCMake << "    REQUIRES forth_runtime\n";
+        mainCMake << ")\n";
         mainCMake.close();
 
         // Write main.c
@@ -2008,17 +5610,15 @@ void app_main(void) {
 }
 )";
         mainFile.close();
-        // Write forth_program.c - find the main program file
-        std::ofstream progFile(fs::path(projectPath) / "main" / "forth_program.c");
-        if (!progFile.is_open()) return false;
-        
+        // Write forth_program.c and any word shards
         for (const auto& [filename, content] : generatedFiles) {
-            if (filename == "forth_program.c") {
-                progFile << content.str();
-                break;
+            if (isProgramSource(filename)) {
+                if (content.writeIfChanged(fs::path(projectPath) / "main" / filename) ==
+                    ChunkedBuffer::WriteResult::Failed) {
+                    return false;
+                }
             }
         }
-        progFile.close();
 
         // FIXED: Write component CMakeLists.txt with proper syntax
         std::ofstream compCMake(fs::path(projectPath) / "components" / "forth_runtime" / "CMakeLists.txt");
@@ -2028,7 +5628,7 @@ void app_main(void) {
         std::vector<std::string> sourceFiles;
         for (const auto& [filename, content] : generatedFiles) {
             if (filename.ends_with(".c") && 
-                filename != "forth_program.c" && 
+                !isProgramSource(filename) && 
                 filename != "main.c") {
                 sourceFiles.push_back(filename);
             }
@@ -2056,11 +5656,8 @@ void app_main(void) {
 
         // Write all runtime implementation files to the component directory
         for (const auto& [filename, content] : generatedFiles) {
-            if (filename.ends_with(".c") && filename != "forth_program.c" && filename != "main.c") {
-                std::ofstream runtimeFile(fs::path(projectPath) / "components" / "forth_runtime" / filename);
-                if (!runtimeFile.is_open()) continue;
-                runtimeFile << content.str();
-                runtimeFile.close();
+            if (filename.ends_with(".c") && !isProgramSource(filename) && filename != "main.c") {
+                content.writeIfChanged(fs::path(projectPath) / "components" / "forth_runtime" / filename);
             }
         }
 
@@ -1,7 +1,11 @@
 #ifndef FORTH_C_CODEGEN_H
 #define FORTH_C_CODEGEN_H
 
+#include <cstdint>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -9,15 +13,60 @@
 #include <unordered_set>
 #include <set>
 #include <map>
+#include <string_view>
 #include <utility>
 #include "parser/ast.h"
 #include "semantic/analyzer.h"
+#include "semantic/module_interface.h"
+#include "interpreter/interpreter.h"
 #include "dictionary/dictionary.h"
+#include "codegen/output_buffer.h"
 
 // Forward declarations
 class SemanticAnalyzer;
 class ForthDictionary;
 
+// ============================================================================
+// Per-word output cache
+// ============================================================================
+//
+// Keeps the C text of word definitions across compilations in one process
+// (the compile daemon). A key holds the emission settings, the node texts
+// of the word's AST (without source positions), the bodies of the pure
+// words it evaluates, and what each program-level table says about the
+// names and strings the word references - so an edit elsewhere in the file
+// keeps the key, and a hit is exactly what emitting the word again would
+// produce. Entries are evicted oldest first; the cache may be shared by
+// parallel emission workers.
+
+class ForthWordCodeCache {
+public:
+    struct Entry {
+        std::string code;
+        std::vector<std::string> errors;
+        std::vector<std::string> warnings;
+        std::set<std::string> forwardReferences;
+    };
+    
+    explicit ForthWordCodeCache(size_t capacity = 65536) : capacity(capacity) {}
+    
+    std::shared_ptr<const Entry> find(const std::string& key);
+    void store(const std::string& key, std::shared_ptr<const Entry> entry);
+    void clear();
+    
+    size_t size() const;
+    size_t getHits() const;
+    size_t getMisses() const;
+    
+private:
+    mutable std::mutex mutex;
+    size_t capacity;
+    std::unordered_map<std::string, std::shared_ptr<const Entry>> entries;
+    std::deque<std::string> insertionOrder;
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
 // ============================================================================
 // Main Code Generator Class
 // ============================================================================
@@ -55,10 +104,12 @@ public:
         bool smallStack;      // Optimize for small stack
         bool needsFloat;      // Requires floating point
         bool ioHeavy;         // I/O intensive program
+        bool evaluatePure;    // Run pure words on literal arguments at compile time
+        bool specialize;      // Clone words called on literal arguments, folded
         
         OptimizationFlags() : useIRAM(false), canInline(false), 
                               smallStack(false), needsFloat(false), 
-                              ioHeavy(false) {}
+                              ioHeavy(false), evaluatePure(true), specialize(true) {}
     };
     
     // Code generation statistics
@@ -67,6 +118,11 @@ public:
         size_t functionsGenerated;
         size_t variablesGenerated;
         size_t filesGenerated;
+        size_t filesUnchanged;        // Skipped by the last writeToFiles()
+        size_t shardsGenerated;       // Word translation units (0 = unsharded)
+        size_t crossShardCalls;       // Call edges between different shards
+        size_t wordsFromCache;        // Word definitions reused from the word cache
+        size_t wordsSpecialized;      // Clones of words on constant arguments
         size_t optimizationsApplied;
         bool usesFloatingPoint;
         bool usesStrings;
@@ -95,6 +151,34 @@ public:
     }
     void setOptimizationLevel(int level);
     
+    // Generate word definitions on a thread pool (0 threads = one per core).
+    // Output is byte-identical to serial emission.
+    void setParallelEmission(bool enabled, size_t threads = 0) {
+        parallelEmission = enabled;
+        emissionThreads = threads;
+    }
+    bool isParallelEmission() const { return parallelEmission; }
+    
+    // Split user words into up to N translation units (forth_words_K.c)
+    // along call-graph clusters so downstream builds compile in parallel
+    void setShardCount(size_t shards) { shardCount = shards > 0 ? shards : 1; }
+    
+    // Reuse word definitions emitted by earlier compilations (not owned)
+    void setWordCache(ForthWordCodeCache* cache) { wordCache = cache; }
+    
+    // Compile a library on its own (forth_compiler -c): only its words, named
+    // forth_<name>_*, go into forth_module_<name>.c, with no runtime and no
+    // entry point. Variables, tasks, channels, run-time constants and
+    // top-level code belong to programs and are rejected.
+    void setModuleMode(const std::string& name);
+    bool isModuleMode() const { return !modulePrefix.empty(); }
+    // The interface importers need, after generateCode() in module mode
+    ForthModuleInterface getModuleInterface(const ProgramNode& program) const;
+    
+    // Resolve the words and constants of a separately compiled module; its
+    // fragment is added to the output and small pure words are inlined
+    void importInterface(std::shared_ptr<const ForthModuleInterface> interface);
+    
     // ========================================================================
     // Main Code Generation Interface
     // ========================================================================
@@ -106,7 +190,7 @@ public:
     bool writeToFiles(const std::string& outputDir);
     
     // Get generated content
-    const std::vector<std::pair<std::string, std::ostringstream>>& 
+    const std::vector<std::pair<std::string, ChunkedBuffer>>& 
         getGeneratedFiles() const { return generatedFiles; }
     
     // ========================================================================
@@ -126,6 +210,9 @@ public:
     CodeGenStats getStatistics() const;
     const std::set<std::string>& getUsedFeatures() const { return usedFeatures; }
     const std::set<std::string>& getUsedBuiltins() const { return usedBuiltins; }
+    const std::unordered_map<std::string, std::string>& getWordFunctionNames() const {
+        return wordFunctionNames;
+    }
     
     // ========================================================================
     // ASTVisitor Implementation - Only existing node types
@@ -150,13 +237,52 @@ private:
     // Module information
     std::string moduleName;
     std::string targetPlatform;
+    std::string modulePrefix;                        // forth_<name>_ in module mode, else empty
+    std::string programFileName = "forth_program.c";
+    std::string stringPoolSymbol = "forth_string_pool";
+    
+    // Separately compiled modules the program imports
+    struct ImportedWord {
+        std::string function;
+        const ProgramNode* inlineBody = nullptr;     // Owned by the interface
+    };
+    std::vector<std::shared_ptr<const ForthModuleInterface>> interfaces;
+    std::unordered_map<std::string, ImportedWord> importedWords;
+    std::unordered_map<std::string, int32_t> importedConstants;
+    
+    // Per-task emission context. Each word definition is generated against
+    // a fresh context so serial and parallel emission agree byte for byte.
+    struct EmitState {
+        ChunkedBuffer* buffer = nullptr;
+        int indentLevel = 0;
+        int tempVarCounter = 0;
+        int labelCounter = 0;
+        int stringCounter = 0;
+    };
+    
+    // Result of generating a single word definition
+    struct WordEmission {
+        ChunkedBuffer code;
+        std::vector<std::string> errors;
+        std::vector<std::string> warnings;
+        std::set<std::string> forwardReferences;
+    };
     
     // Generation context
-    int indentLevel;
-    int tempVarCounter;
-    int labelCounter;
-    int stringCounter;
+    EmitState emitState;
     size_t currentFileIndex;
+    bool parallelEmission;
+    size_t emissionThreads;
+    
+    // Sharded output (word -> shard index, file index of each shard)
+    size_t shardCount;
+    std::unordered_map<std::string, size_t> wordShard;
+    std::vector<size_t> shardFileIndices;
+    size_t crossShardCallCount = 0;
+    
+    // Word definitions shared with other compilations
+    ForthWordCodeCache* wordCache = nullptr;
+    size_t wordCacheHitCount = 0;
     
     // External dependencies
     const SemanticAnalyzer* semanticAnalyzer;
@@ -171,7 +297,8 @@ private:
     // ========================================================================
     
     // Output files (filename, content)
-    std::vector<std::pair<std::string, std::ostringstream>> generatedFiles;
+    std::vector<std::pair<std::string, ChunkedBuffer>> generatedFiles;
+    size_t unchangedFileCount = 0;
     
     // Legacy streams (for compatibility - to be removed)
     std::ostringstream headerStream;
@@ -181,8 +308,82 @@ private:
     // Tracking maps
     std::unordered_set<std::string> generatedWords;
     std::unordered_map<std::string, std::string> wordFunctionNames;
+    std::vector<std::string> wordOrder;   // Upper-case word names in source order
     std::unordered_map<std::string, std::string> variableMap;
     
+    // String literal pool: every distinct literal is stored once in
+    // forth_string_pool[] and referenced by offset and length
+    struct PooledString {
+        size_t offset;
+        size_t length;
+    };
+    std::unordered_map<std::string, PooledString> stringPool;
+    std::vector<std::string> stringPoolOrder;
+    size_t stringPoolSize = 0;
+    
+    // Data space. Top-level VARIABLE, CREATE, "," and ALLOT are laid out at
+    // compile time into forth_data_space[]; words declared after a
+    // run-time-sized allocation get their offset from a slot at run time.
+    struct DataSpaceWord {
+        std::string name;
+        uint32_t offset = 0;        // Byte offset (static words)
+        bool isStatic = true;
+        std::string slot;           // forth_data_word_* (dynamic words)
+    };
+    std::unordered_map<std::string, DataSpaceWord> dataSpaceWords;
+    std::unordered_map<std::string, int32_t> constantValues;       // Folded CONSTANTs
+    std::unordered_map<std::string, std::string> constantSlots;   // Run-time CONSTANTs
+    std::vector<int32_t> dataSpaceImage;                          // Initial cell contents
+    std::vector<std::pair<uint32_t, std::string>> dataSpaceLabels; // Offset -> name
+    uint32_t dataSpaceHere = 0;                                   // Bytes in the image
+    std::unordered_set<const ASTNode*> foldedNodes;               // Evaluated at compile time
+    
+    // Compile-time evaluation: a run of literals and pure words is executed
+    // by the reference interpreter and replaced by the values it leaves
+    std::map<std::string, const WordDefinitionNode*> pureWords;
+    std::unique_ptr<ForthInterpreter> evaluator;   // Created on first use, one per worker
+    // Word call on the known stack -> stack it leaves (nullopt = failed)
+    std::unordered_map<std::string, std::optional<std::vector<int32_t>>> evaluatedCalls;
+    
+    // Specialization: a call of a small user word - or of a larger one
+    // inside a loop - on literal arguments calls a clone of the word with
+    // those arguments evaluated into its body. Sites with the same word and
+    // constants share a clone.
+    using NodeList = std::vector<std::unique_ptr<ASTNode>>;
+    struct Specialization {
+        std::string word;                       // Upper-case FORTH name
+        std::string function;                   // C name of the clone
+        std::vector<int32_t> constants;         // The literal arguments
+        struct Effect {
+            std::string code;                   // A store or output on known values
+            const ASTNode* node = nullptr;      // Or a node without stack effect
+        };
+        std::vector<Effect> effects;            // Of the evaluated part, in order
+        std::vector<int32_t> prefix;            // Values left by the evaluated part
+        std::vector<std::pair<const NodeList*, size_t>> residual;  // Rest of the body, innermost list first
+        size_t nodes = 0;                       // Clone size, charged to the growth budget
+    };
+    struct SpecializedCall {
+        size_t literals = 0;                    // Literal nodes before the call
+        std::shared_ptr<const Specialization> clone;
+    };
+    std::vector<std::shared_ptr<const Specialization>> specializations;
+    std::unordered_map<const ASTNode*, SpecializedCall> specializedCalls;  // First literal -> clone
+    std::unordered_map<const ASTNode*, std::string> specializationKeys;   // Caller -> cache key part
+    std::unordered_map<std::string, size_t> taskHandles;          // TASK name -> forth_tasks[] index
+    
+    // Channels: capacity CHANNEL name. The program is the only consumer; a
+    // channel it also sends to (and whose handle never escapes) is SPSC,
+    // others accept producers on other threads and cores as well (MPSC).
+    struct ChannelInfo {
+        std::string name;
+        std::string macro;          // FORTH_CHANNEL_<name> handle for C code
+        size_t handle = 0;          // forth_channels[] index
+        uint32_t capacity = 0;      // Slots, a power of two
+        bool multiProducer = true;
+    };
+    std::unordered_map<std::string, ChannelInfo> channels;
+    
     // Feature detection
     std::set<std::string> usedFeatures;
     std::set<std::string> usedBuiltins;
@@ -207,6 +408,9 @@ private:
     void analyzeProgram(const ProgramNode& program);
     void determineOptimizationStrategy();
     void collectWordDefinitions(const ProgramNode& program);
+    void planShards(const ProgramNode& program);
+    void layoutDataSpace(const ProgramNode& program);
+    void classifyChannels(const ProgramNode& program);
     bool isPerformanceCritical(const std::string& wordName) const;
     bool isBuiltinWord(const std::string& word) const;
     
@@ -220,8 +424,15 @@ private:
     std::string generateMathImplementation();
     std::string generateCompareImplementation();
     std::string generateMemoryImplementation();
+    std::string generateArrayImplementation() const;
+    std::string generateTaskImplementation() const;
+    std::string generateChannelImplementation() const;
     std::string generateIOImplementation();
     std::string generateESP32Implementation();
+    std::string generateWordPrototypes() const;
+    std::string generateStringPool() const;
+    std::string generateDataSpaceImplementation() const;
+    void internString(const std::string& value);
     
     // ========================================================================
     // Code Generation Utilities
@@ -230,19 +441,49 @@ private:
     // Output helpers
     void resetGenerationState();
     void generateFile(const std::string& filename, const std::string& content);
-    void emit(const std::string& code);
-    void emitLine(const std::string& line = "");
-    void emitIndented(const std::string& line);
+    void emit(std::string_view code);
+    void emitLine(std::string_view line = {});
+    void emitIndented(std::string_view line);
     std::string getIndent() const;
-    void increaseIndent() { indentLevel++; }
-    void decreaseIndent() { if (indentLevel > 0) indentLevel--; }
+    void increaseIndent() { emitState.indentLevel++; }
+    void decreaseIndent() { if (emitState.indentLevel > 0) emitState.indentLevel--; }
+    
+    // Statement emission with data-space access fusion
+    void emitSequence(const NodeList& nodes);
+    size_t emitStatement(const NodeList& nodes, size_t index);
+    size_t emitFusedDataAccess(const NodeList& nodes, size_t index);
+    size_t emitFusedBlockOp(const NodeList& nodes, size_t index);
+    size_t emitFusedArrayOp(const NodeList& nodes, size_t index);
+    size_t emitFusedChannelOp(const NodeList& nodes, size_t index);
+    size_t emitStrengthReduced(const NodeList& nodes, size_t index);
+    size_t emitEvaluated(const NodeList& nodes, size_t index);
+    void collectPureWords(const ProgramNode& program);
+    bool isEvaluable(const ASTNode* node) const;
+    ForthInterpreter& getEvaluator();
+    bool evaluateNode(const ASTNode& node);
+    void appendWordContext(std::string& key, const WordDefinitionNode& word) const;
+    void planSpecializations(const ProgramNode& program);
+    std::shared_ptr<Specialization> partiallyEvaluate(const WordDefinitionNode& word,
+                                                      const std::vector<int32_t>& constants);
+    size_t emitSpecializedCall(const NodeList& nodes, size_t index);
+    void emitSpecializations();
+    const DataSpaceWord* staticDataWord(const ASTNode* node) const;
+    bool isBuiltinCall(const ASTNode* node, std::string_view upperName) const;
+    
+    // Word emission (serial or on the thread pool)
+    void emitWordDefinitions(const std::vector<WordDefinitionNode*>& words);
+    std::vector<WordEmission> emitWords(const std::vector<WordDefinitionNode*>& words);
+    void mergeWordEmission(WordEmission& result, ChunkedBuffer& target);
+    void emitWordInto(WordDefinitionNode& node, WordEmission& out);
+    std::string emissionContextKey() const;
+    std::unique_ptr<ForthCCodegen> forkWorker() const;
     
     // Identifier generation
     std::string generateTempVar();
     std::string generateLabel(const std::string& prefix = "L");
     std::string sanitizeIdentifier(const std::string& name);
     std::string generateFunctionName(const std::string& wordName);
-    std::string escapeCString(const std::string& str);
+    std::string escapeCString(const std::string& str) const;
     void debugGenerationState() const;
   
     // ========================================================================
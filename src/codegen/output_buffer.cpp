@@ -0,0 +1,274 @@
+#include "codegen/output_buffer.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <cerrno>
+    #include <climits>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+    #define FORTH_HAVE_WRITEV 1
+    #ifndef IOV_MAX
+        #define IOV_MAX 1024
+    #endif
+#else
+    #define FORTH_HAVE_WRITEV 0
+#endif
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Appending
+// ============================================================================
+
+std::string& ChunkedBuffer::reserveChunk(size_t minimum) {
+    if (chunks.empty() || chunks.back().capacity() - chunks.back().size() < minimum) {
+        // Grow geometrically with the buffer, capped at MAX_CHUNK_SIZE
+        size_t capacity = std::clamp(totalSize, MIN_CHUNK_SIZE, MAX_CHUNK_SIZE);
+        chunks.emplace_back();
+        chunks.back().reserve(std::max(capacity, minimum));
+    }
+    return chunks.back();
+}
+
+void ChunkedBuffer::append(std::string_view text) {
+    if (text.empty()) return;
+
+    if (!chunks.empty()) {
+        std::string& tail = chunks.back();
+        const size_t room = tail.capacity() - tail.size();
+        if (text.size() <= room) {
+            tail.append(text);
+            totalSize += text.size();
+            return;
+        }
+        // Fill the tail chunk before starting a new one
+        tail.append(text.substr(0, room));
+        totalSize += room;
+        text.remove_prefix(room);
+    }
+
+    reserveChunk(text.size()).append(text);
+    totalSize += text.size();
+}
+
+void ChunkedBuffer::append(size_t count, char c) {
+    if (count == 0) return;
+    reserveChunk(count).append(count, c);
+    totalSize += count;
+}
+
+void ChunkedBuffer::splice(ChunkedBuffer&& other) {
+    if (other.empty()) return;
+
+    // Small buffers are cheaper to copy than to fragment the rope
+    if (other.totalSize < MIN_CHUNK_SIZE ||
+        (!chunks.empty() && chunks.back().capacity() - chunks.back().size() >= other.totalSize)) {
+        for (const auto& chunk : other.chunks) {
+            append(chunk);
+        }
+    } else {
+        for (auto& chunk : other.chunks) {
+            chunks.push_back(std::move(chunk));
+        }
+        totalSize += other.totalSize;
+    }
+    other.clear();
+}
+
+void ChunkedBuffer::clear() {
+    chunks.clear();
+    totalSize = 0;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+bool ChunkedBuffer::contains(std::string_view needle) const {
+    if (needle.empty()) return true;
+
+    // Carry the last needle.size()-1 bytes seen so far so matches spanning
+    // a chunk boundary are found
+    const size_t overlap = needle.size() - 1;
+    std::string carry;
+    for (const auto& chunk : chunks) {
+        if (!carry.empty()) {
+            std::string joined = carry;
+            joined.append(chunk, 0, std::min(chunk.size(), overlap));
+            if (joined.find(needle) != std::string::npos) {
+                return true;
+            }
+        }
+        if (chunk.find(needle) != std::string::npos) {
+            return true;
+        }
+        if (chunk.size() >= overlap) {
+            carry.assign(chunk, chunk.size() - overlap, overlap);
+        } else {
+            carry.append(chunk);
+            if (carry.size() > overlap) {
+                carry.erase(0, carry.size() - overlap);
+            }
+        }
+    }
+    return false;
+}
+
+size_t ChunkedBuffer::countLines() const {
+    size_t lines = 0;
+    for (const auto& chunk : chunks) {
+        lines += static_cast<size_t>(std::count(chunk.begin(), chunk.end(), '\n'));
+    }
+    return lines;
+}
+
+uint64_t ChunkedBuffer::hashBytes(std::string_view data, uint64_t seed) {
+    uint64_t h = seed;
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+uint64_t ChunkedBuffer::hash() const {
+    uint64_t h = FNV_OFFSET_BASIS;
+    for (const auto& chunk : chunks) {
+        h = hashBytes(chunk, h);
+    }
+    return h;
+}
+
+std::string ChunkedBuffer::str() const {
+    std::string result;
+    appendTo(result);
+    return result;
+}
+
+void ChunkedBuffer::appendTo(std::string& out) const {
+    out.reserve(out.size() + totalSize);
+    for (const auto& chunk : chunks) {
+        out.append(chunk);
+    }
+}
+
+// ============================================================================
+// File Output
+// ============================================================================
+
+bool ChunkedBuffer::fileMatches(const fs::path& path) const {
+    std::error_code ec;
+    const auto existingSize = fs::file_size(path, ec);
+    if (ec || existingSize != totalSize) {
+        return false;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    // Compare against the chunks directly; much cheaper than hashing both
+    // sides, and it stops at the first difference
+    auto chunk = chunks.begin();
+    size_t offset = 0;
+    char block[64 * 1024];
+    while (in.read(block, sizeof(block)) || in.gcount() > 0) {
+        std::string_view remaining(block, static_cast<size_t>(in.gcount()));
+        while (!remaining.empty()) {
+            while (chunk != chunks.end() && offset == chunk->size()) {
+                ++chunk;
+                offset = 0;
+            }
+            if (chunk == chunks.end()) return false;
+            const size_t count = std::min(remaining.size(), chunk->size() - offset);
+            if (remaining.substr(0, count) != std::string_view(*chunk).substr(offset, count)) {
+                return false;
+            }
+            remaining.remove_prefix(count);
+            offset += count;
+        }
+    }
+    return true;
+}
+
+bool ChunkedBuffer::writeTo(int fd) const {
+#if FORTH_HAVE_WRITEV
+    std::vector<iovec> iov;
+    iov.reserve(std::min<size_t>(chunks.size(), IOV_MAX));
+
+    size_t index = 0;
+    size_t offset = 0;  // Bytes of chunks[index] already written
+    while (index < chunks.size()) {
+        iov.clear();
+        for (size_t i = index; i < chunks.size() && iov.size() < IOV_MAX; i++) {
+            const size_t skip = (i == index) ? offset : 0;
+            iov.push_back({const_cast<char*>(chunks[i].data()) + skip, chunks[i].size() - skip});
+        }
+
+        ssize_t written = ::writev(fd, iov.data(), static_cast<int>(iov.size()));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        // Advance past fully written chunks; resume partial writes
+        size_t remaining = static_cast<size_t>(written);
+        while (index < chunks.size() && remaining >= chunks[index].size() - offset) {
+            remaining -= chunks[index].size() - offset;
+            offset = 0;
+            index++;
+        }
+        offset += remaining;
+    }
+    return true;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+ChunkedBuffer::WriteResult ChunkedBuffer::writeIfChanged(const fs::path& path) const {
+    if (fileMatches(path)) {
+        return WriteResult::Unchanged;
+    }
+
+#if FORTH_HAVE_WRITEV
+    // Write to a temporary file and rename so readers never see a partial file.
+    // Parallel and batch writers share the process, so the name also carries
+    // a per-call counter.
+    static std::atomic<uint64_t> tmpCounter{0};
+    const std::string tmpPath = path.string() + ".tmp." + std::to_string(::getpid()) + "." +
+                                std::to_string(tmpCounter.fetch_add(1, std::memory_order_relaxed));
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        return WriteResult::Failed;
+    }
+
+    // The rename replaces the file, so carry its permissions over
+    struct stat existing;
+    bool ok = ::stat(path.c_str(), &existing) != 0 || ::fchmod(fd, existing.st_mode & 07777) == 0;
+    ok = ok && writeTo(fd);
+    if (::close(fd) != 0 || !ok) {
+        ::unlink(tmpPath.c_str());
+        return WriteResult::Failed;
+    }
+
+    if (::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        ::unlink(tmpPath.c_str());
+        return WriteResult::Failed;
+    }
+    return WriteResult::Written;
+#else
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return WriteResult::Failed;
+    }
+    for (const auto& chunk : chunks) {
+        file.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    }
+    return file.good() ? WriteResult::Written : WriteResult::Failed;
+#endif
+}
@@ -0,0 +1,77 @@
+#ifndef FORTH_OUTPUT_BUFFER_H
+#define FORTH_OUTPUT_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// Append-only chunked buffer (rope) for generated sources
+// ============================================================================
+//
+// Text is appended into a list of chunks that are never reallocated or
+// copied once written, so large generated files are built without the
+// repeated growth copies of std::ostringstream. Whole buffers can be spliced
+// together by moving their chunks, and the result is written to disk with a
+// single writev() call per batch of chunks.
+
+class ChunkedBuffer {
+public:
+    // Upper bound for a chunk that we allocate ourselves. Chunks start small
+    // and grow geometrically so thousands of per-word buffers stay cheap.
+    static constexpr size_t MAX_CHUNK_SIZE = 64 * 1024;
+    static constexpr size_t MIN_CHUNK_SIZE = 256;
+
+    enum class WriteResult {
+        Written,    // File content changed and was rewritten
+        Unchanged,  // Existing file already had identical content
+        Failed      // I/O error
+    };
+
+    ChunkedBuffer() = default;
+    ChunkedBuffer(ChunkedBuffer&&) noexcept = default;
+    ChunkedBuffer& operator=(ChunkedBuffer&&) noexcept = default;
+    ChunkedBuffer(const ChunkedBuffer&) = delete;
+    ChunkedBuffer& operator=(const ChunkedBuffer&) = delete;
+
+    // Appending
+    void append(std::string_view text);
+    void append(size_t count, char c);
+    void splice(ChunkedBuffer&& other);
+    ChunkedBuffer& operator<<(std::string_view text) { append(text); return *this; }
+
+    // Queries
+    size_t size() const { return totalSize; }
+    bool empty() const { return totalSize == 0; }
+    size_t chunkCount() const { return chunks.size(); }
+    bool contains(std::string_view needle) const;
+    size_t countLines() const;
+    uint64_t hash() const;
+    void clear();
+
+    // Materialization (copies - avoid on hot paths)
+    std::string str() const;
+    void appendTo(std::string& out) const;
+
+    // File output. Existing files with identical size and content are
+    // left untouched so their timestamps do not trigger downstream rebuilds.
+    WriteResult writeIfChanged(const std::filesystem::path& path) const;
+    bool writeTo(int fd) const;
+
+    static uint64_t hashBytes(std::string_view data, uint64_t seed = FNV_OFFSET_BASIS);
+
+private:
+    static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+    static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+    std::vector<std::string> chunks;
+    size_t totalSize = 0;
+
+    std::string& reserveChunk(size_t minimum);
+    bool fileMatches(const std::filesystem::path& path) const;
+};
+
+#endif // FORTH_OUTPUT_BUFFER_H
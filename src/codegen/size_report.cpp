@@ -0,0 +1,406 @@
+#include "codegen/size_report.h"
+#include "codegen/c_backend.h"
+#include "common/thread_pool.h"
+#include "common/utils.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// ELF constants used by the reader
+constexpr uint8_t ELFCLASS32 = 1;
+constexpr uint8_t ELFCLASS64 = 2;
+constexpr uint8_t ELFDATA2LSB = 1;
+constexpr uint32_t SHT_SYMTAB = 2;
+constexpr uint64_t SHF_ALLOC = 0x2;
+constexpr uint16_t SHN_UNDEF = 0;
+constexpr uint16_t SHN_LORESERVE = 0xff00;
+constexpr uint16_t SHN_COMMON = 0xfff2;
+constexpr uint8_t STT_OBJECT = 1;
+constexpr uint8_t STT_FUNC = 2;
+
+// Bounds-checked little-endian reads; out-of-range reads mark the view bad
+struct ByteView {
+    const std::vector<uint8_t>& bytes;
+    bool ok = true;
+
+    uint64_t read(uint64_t offset, size_t width) {
+        if (offset > bytes.size() || bytes.size() - offset < width) {
+            ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (size_t i = 0; i < width; i++) {
+            value |= static_cast<uint64_t>(bytes[offset + i]) << (8 * i);
+        }
+        return value;
+    }
+
+    std::string string(uint64_t offset) {
+        if (offset >= bytes.size()) {
+            ok = false;
+            return {};
+        }
+        auto begin = bytes.begin() + static_cast<std::ptrdiff_t>(offset);
+        return std::string(begin, std::find(begin, bytes.end(), uint8_t{0}));
+    }
+};
+
+constexpr ForthSizeReport::Region ALL_REGIONS[] = {
+    ForthSizeReport::Region::IRAM, ForthSizeReport::Region::FLASH_CODE,
+    ForthSizeReport::Region::FLASH_RODATA, ForthSizeReport::Region::DRAM,
+    ForthSizeReport::Region::OTHER
+};
+
+}  // namespace
+
+ForthSizeReport::ForthSizeReport(Options options) : options(std::move(options)) {}
+
+// ============================================================================
+// Section Classification
+// ============================================================================
+
+const char* ForthSizeReport::regionName(Region region) {
+    switch (region) {
+        case Region::IRAM: return "iram";
+        case Region::FLASH_CODE: return "flash_code";
+        case Region::FLASH_RODATA: return "flash_rodata";
+        case Region::DRAM: return "dram";
+        case Region::OTHER: return "other";
+    }
+    return "other";
+}
+
+ForthSizeReport::Region ForthSizeReport::classifySection(const std::string& section) {
+    auto startsWith = [&section](std::string_view prefix) { return section.starts_with(prefix); };
+
+    if (startsWith(".iram")) return Region::IRAM;
+    if (startsWith(".text") || startsWith(".literal")) return Region::FLASH_CODE;
+    if (startsWith(".rodata") || startsWith(".srodata")) return Region::FLASH_RODATA;
+    if (startsWith(".data") || startsWith(".sdata") || startsWith(".dram") ||
+        startsWith(".bss") || startsWith(".sbss") || section == "COMMON") {
+        return Region::DRAM;
+    }
+    return Region::OTHER;
+}
+
+// ============================================================================
+// ELF Object Reading
+// ============================================================================
+
+std::optional<ForthSizeReport::ObjectContents> ForthSizeReport::readObject(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return std::nullopt;
+    const std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+    if (bytes.size() < 16 || bytes[0] != 0x7f || bytes[1] != 'E' || bytes[2] != 'L' || bytes[3] != 'F' ||
+        (bytes[4] != ELFCLASS32 && bytes[4] != ELFCLASS64) || bytes[5] != ELFDATA2LSB) {
+        return std::nullopt;
+    }
+
+    const bool is64 = bytes[4] == ELFCLASS64;
+    const size_t word = is64 ? 8 : 4;
+    ByteView view{bytes};
+
+    const uint64_t shoff = view.read(is64 ? 0x28 : 0x20, word);
+    const uint64_t shentsize = view.read(is64 ? 0x3A : 0x2E, 2);
+    const uint64_t shnum = view.read(is64 ? 0x3C : 0x30, 2);
+    const uint64_t shstrndx = view.read(is64 ? 0x3E : 0x32, 2);
+    if (!view.ok || shnum == 0 || shstrndx >= shnum) return std::nullopt;
+
+    struct Section {
+        uint64_t name, type, flags, offset, size, link, entsize;
+    };
+    std::vector<Section> sections(shnum);
+    for (uint64_t i = 0; i < shnum; i++) {
+        const uint64_t base = shoff + i * shentsize;
+        Section& s = sections[i];
+        s.name = view.read(base, 4);
+        s.type = view.read(base + 4, 4);
+        s.flags = view.read(base + 8, word);
+        s.offset = view.read(base + 8 + 2 * word, word);
+        s.size = view.read(base + 8 + 3 * word, word);
+        s.link = view.read(base + 8 + 4 * word, 4);
+        s.entsize = view.read(base + 16 + 5 * word, word);
+    }
+    if (!view.ok) return std::nullopt;
+
+    std::vector<std::string> names(shnum);
+    for (uint64_t i = 0; i < shnum; i++) {
+        names[i] = view.string(sections[shstrndx].offset + sections[i].name);
+    }
+
+    ObjectContents contents;
+    for (uint64_t i = 0; i < shnum; i++) {
+        if ((sections[i].flags & SHF_ALLOC) && sections[i].size > 0) {
+            contents.sections.emplace_back(names[i], sections[i].size);
+        }
+    }
+
+    for (const Section& symtab : sections) {
+        if (symtab.type != SHT_SYMTAB || symtab.entsize == 0 || symtab.link >= shnum) continue;
+        const uint64_t strtab = sections[symtab.link].offset;
+
+        for (uint64_t offset = 0; offset + symtab.entsize <= symtab.size; offset += symtab.entsize) {
+            const uint64_t base = symtab.offset + offset;
+            uint64_t nameOffset = view.read(base, 4), size = 0, info = 0, shndx = 0;
+            if (is64) {
+                info = view.read(base + 4, 1);
+                shndx = view.read(base + 6, 2);
+                size = view.read(base + 16, 8);
+            } else {
+                size = view.read(base + 8, 4);
+                info = view.read(base + 12, 1);
+                shndx = view.read(base + 14, 2);
+            }
+
+            const auto type = static_cast<uint8_t>(info & 0xf);
+            if (size == 0 || (type != STT_FUNC && type != STT_OBJECT) || shndx == SHN_UNDEF ||
+                (shndx >= SHN_LORESERVE && shndx != SHN_COMMON)) {
+                continue;
+            }
+
+            ObjectSymbol symbol;
+            symbol.name = view.string(strtab + nameOffset);
+            symbol.section = shndx == SHN_COMMON ? "COMMON" : (shndx < shnum ? names[shndx] : "");
+            symbol.size = size;
+            symbol.isFunction = type == STT_FUNC;
+            contents.symbols.push_back(std::move(symbol));
+        }
+    }
+
+    if (!view.ok) return std::nullopt;
+    return contents;
+}
+
+// ============================================================================
+// Measurement
+// ============================================================================
+
+bool ForthSizeReport::measure(const ForthCCodegen& codegen, const fs::path& workDir) {
+    entries.clear();
+    sectionBytes.clear();
+    errors.clear();
+
+    std::error_code ec;
+    fs::create_directories(workDir, ec);
+    if (ec) {
+        errors.push_back("Cannot create " + workDir.string() + ": " + ec.message());
+        return false;
+    }
+
+    // main.c is the ESP-IDF entry point and needs the IDF headers
+    std::vector<std::string> sources;
+    for (const auto& [filename, content] : codegen.getGeneratedFiles()) {
+        if (content.writeIfChanged(workDir / filename) == ChunkedBuffer::WriteResult::Failed) {
+            errors.push_back("Cannot write " + (workDir / filename).string());
+            return false;
+        }
+        if (filename.ends_with(".c") && filename != "main.c") {
+            sources.push_back(filename);
+        }
+    }
+
+    // Words are compiled one file at a time, in parallel
+    std::vector<std::optional<ObjectContents>> objects(sources.size());
+    std::vector<std::string> failures(sources.size());
+    ForthThreadPool::parallelFor(sources.size(), options.jobs, [&](size_t i, size_t) {
+        const fs::path source = workDir / sources[i];
+        fs::path object = source, log = source;
+        object.replace_extension(".o");
+        log.replace_extension(".log");
+
+        const std::string command =
+            options.compiler + " -c " + options.flags + " -w -I" + ForthUtils::shellQuote(workDir.string()) +
+            " " + ForthUtils::shellQuote("-DFORTH_IRAM_ATTR=__attribute__((section(\".iram1\")))") +
+            " " + ForthUtils::shellQuote(source.string()) + " -o " + ForthUtils::shellQuote(object.string()) +
+            " > " + ForthUtils::shellQuote(log.string()) + " 2>&1";
+        if (std::system(command.c_str()) != 0) {
+            failures[i] = "Failed to compile " + sources[i] + " with " + options.compiler +
+                          " (see " + log.string() + ")";
+            return;
+        }
+        objects[i] = readObject(object);
+        if (!objects[i]) {
+            failures[i] = "Cannot read ELF object " + object.string();
+        }
+    });
+
+    for (const auto& failure : failures) {
+        if (!failure.empty()) errors.push_back(failure);
+    }
+
+    // Attribute symbols to the Forth words that produced them
+    std::unordered_map<std::string, std::string> wordOfFunction;
+    for (const auto& [word, function] : codegen.getWordFunctionNames()) {
+        wordOfFunction[function] = word;
+    }
+
+    for (size_t i = 0; i < sources.size(); i++) {
+        if (!objects[i]) continue;
+
+        for (const auto& [section, size] : objects[i]->sections) {
+            sectionBytes.emplace_back(classifySection(section), size);
+        }
+        for (const auto& symbol : objects[i]->symbols) {
+            Entry entry;
+            entry.symbol = symbol.name;
+            entry.file = sources[i];
+            entry.section = symbol.section;
+            entry.region = classifySection(symbol.section);
+            entry.size = symbol.size;
+
+            if (symbol.section == "COMMON") {
+                sectionBytes.emplace_back(Region::DRAM, symbol.size);  // Not in any section
+            }
+
+            if (auto word = wordOfFunction.find(symbol.name); word != wordOfFunction.end()) {
+                entry.owner = word->second;
+                entry.kind = "word";
+            } else if (symbol.name == "forth_program_main") {
+                entry.owner = "(top level)";
+                entry.kind = "program";
+            } else if (!symbol.isFunction) {
+                entry.owner = symbol.name;
+                entry.kind = "data";
+            } else {
+                entry.owner = symbol.name;
+                entry.kind = "runtime";
+            }
+            entries.push_back(std::move(entry));
+        }
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.size > b.size;
+    });
+    return errors.empty();
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+uint64_t ForthSizeReport::regionTotal(Region region) const {
+    uint64_t total = 0;
+    for (const auto& [sectionRegion, size] : sectionBytes) {
+        if (sectionRegion == region) total += size;
+    }
+    return total;
+}
+
+uint64_t ForthSizeReport::unattributedBytes(Region region) const {
+    uint64_t attributed = 0;
+    for (const auto& entry : entries) {
+        if (entry.region == region) attributed += entry.size;
+    }
+    const uint64_t total = regionTotal(region);
+    return total > attributed ? total - attributed : 0;
+}
+
+bool ForthSizeReport::overIRAMBudget() const {
+    return options.iramBudget > 0 && regionTotal(Region::IRAM) > options.iramBudget;
+}
+
+// ============================================================================
+// Output
+// ============================================================================
+
+void ForthSizeReport::printTable(std::ostream& out, size_t limit) const {
+    out << "\n" << std::string(60, '=') << "\n";
+    out << "SIZE REPORT (" << options.compiler << " " << options.flags << ")\n";
+    out << std::string(60, '=') << "\n\n";
+
+    out << std::left << std::setw(6) << "Rank" << std::right << std::setw(8) << "Bytes" << "  "
+        << std::left << std::setw(14) << "Region" << std::setw(9) << "Kind" << "Owner\n";
+    out << std::string(60, '-') << "\n";
+
+    const size_t shown = std::min(limit, entries.size());
+    for (size_t i = 0; i < shown; i++) {
+        const Entry& entry = entries[i];
+        out << std::left << std::setw(6) << (i + 1) << std::right << std::setw(8) << entry.size << "  "
+            << std::left << std::setw(14) << regionName(entry.region) << std::setw(9) << entry.kind
+            << entry.owner;
+        if (entry.owner != entry.symbol) {
+            out << "  (" << entry.symbol << ")";
+        }
+        out << "  [" << entry.file << "]\n";
+    }
+    if (entries.size() > shown) {
+        out << "... " << (entries.size() - shown) << " smaller symbols in the JSON report\n";
+    }
+
+    out << "\nTotals by region:\n";
+    for (Region region : ALL_REGIONS) {
+        const uint64_t total = regionTotal(region);
+        if (total == 0) continue;
+        out << "  " << std::left << std::setw(14) << regionName(region) << std::right << std::setw(8)
+            << total << " bytes";
+        if (const uint64_t loose = unattributedBytes(region)) {
+            out << "  (" << loose << " without a symbol)";
+        }
+        out << "\n";
+    }
+
+    if (options.iramBudget > 0) {
+        const uint64_t iram = regionTotal(Region::IRAM);
+        out << "\nIRAM budget: " << iram << " / " << options.iramBudget << " bytes ("
+            << (iram * 100 / options.iramBudget) << "%)\n";
+        if (overIRAMBudget()) {
+            out << "⚠️  IRAM budget exceeded by " << (iram - options.iramBudget) << " bytes\n";
+        }
+    }
+
+    for (const auto& error : errors) {
+        out << "❌ " << error << "\n";
+    }
+}
+
+std::string ForthSizeReport::toJson() const {
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"compiler\": \"" << ForthUtils::jsonEscape(options.compiler) << "\",\n";
+    json << "  \"flags\": \"" << ForthUtils::jsonEscape(options.flags) << "\",\n";
+
+    json << "  \"totals\": {";
+    for (size_t i = 0; i < std::size(ALL_REGIONS); i++) {
+        json << (i ? ", " : "") << "\"" << regionName(ALL_REGIONS[i]) << "\": " << regionTotal(ALL_REGIONS[i]);
+    }
+    json << "},\n";
+    json << "  \"unattributed\": {";
+    for (size_t i = 0; i < std::size(ALL_REGIONS); i++) {
+        json << (i ? ", " : "") << "\"" << regionName(ALL_REGIONS[i]) << "\": "
+             << unattributedBytes(ALL_REGIONS[i]);
+    }
+    json << "},\n";
+
+    json << "  \"iram_budget\": " << options.iramBudget << ",\n";
+    json << "  \"over_iram_budget\": " << (overIRAMBudget() ? "true" : "false") << ",\n";
+
+    json << "  \"symbols\": [";
+    for (size_t i = 0; i < entries.size(); i++) {
+        const Entry& entry = entries[i];
+        json << (i ? ",\n" : "\n") << "    {\"symbol\": \"" << ForthUtils::jsonEscape(entry.symbol)
+             << "\", \"owner\": \"" << ForthUtils::jsonEscape(entry.owner)
+             << "\", \"kind\": \"" << entry.kind
+             << "\", \"file\": \"" << ForthUtils::jsonEscape(entry.file)
+             << "\", \"section\": \"" << ForthUtils::jsonEscape(entry.section)
+             << "\", \"region\": \"" << regionName(entry.region)
+             << "\", \"size\": " << entry.size << "}";
+    }
+    json << (entries.empty() ? "],\n" : "\n  ],\n");
+
+    json << "  \"errors\": [";
+    for (size_t i = 0; i < errors.size(); i++) {
+        json << (i ? ", " : "") << "\"" << ForthUtils::jsonEscape(errors[i]) << "\"";
+    }
+    json << "]\n}\n";
+    return json.str();
+}
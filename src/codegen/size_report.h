@@ -0,0 +1,100 @@
+#ifndef FORTH_SIZE_REPORT_H
+#define FORTH_SIZE_REPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class ForthCCodegen;
+
+// ============================================================================
+// Measured code size of a generated program
+// ============================================================================
+//
+// CodeGenStats::iramUsage and flashUsage are estimates. This report compiles
+// the generated C files to object files with a real compiler (the host cc or
+// a cross compiler such as xtensa-esp32-elf-gcc), reads the symbol tables of
+// the ELF objects and attributes every function and data object back to the
+// Forth word or runtime primitive it came from.
+//
+// FORTH_IRAM_ATTR is defined to a ".iram1" section attribute while compiling,
+// so words the code generator places in IRAM are reported as IRAM even when
+// the ESP-IDF headers are not available.
+
+class ForthSizeReport {
+public:
+    enum class Region {
+        IRAM,          // .iram1*: executes from internal RAM
+        FLASH_CODE,    // .text*: executes from flash cache
+        FLASH_RODATA,  // .rodata*: constants in flash
+        DRAM,          // .data*, .bss*, common: internal data RAM
+        OTHER          // Unwind tables and other allocated sections
+    };
+
+    // A sized symbol read from an object file
+    struct ObjectSymbol {
+        std::string name;
+        std::string section;
+        uint64_t size = 0;
+        bool isFunction = false;
+    };
+
+    // A symbol attributed to the Forth program
+    struct Entry {
+        std::string symbol;   // C symbol
+        std::string owner;    // Forth word, runtime primitive or data object
+        std::string kind;     // "word", "program", "runtime" or "data"
+        std::string file;     // Generated .c file
+        std::string section;
+        Region region = Region::OTHER;
+        uint64_t size = 0;
+    };
+
+    struct Options {
+        std::string compiler = "cc";
+        std::string flags = "-Os -ffunction-sections -fdata-sections";
+        uint64_t iramBudget = 0;  // 0 = no budget check
+        size_t jobs = 0;          // Parallel compiles (0 = all cores)
+    };
+
+    explicit ForthSizeReport(Options options);
+
+    // Write the generated files into workDir, compile them and read the
+    // objects. Files that fail to compile are reported as errors; the rest
+    // are still measured.
+    bool measure(const ForthCCodegen& codegen, const std::filesystem::path& workDir);
+
+    // Output
+    void printTable(std::ostream& out, size_t limit = 30) const;
+    std::string toJson() const;
+
+    // Queries
+    const std::vector<Entry>& getEntries() const { return entries; }
+    uint64_t regionTotal(Region region) const;
+    uint64_t unattributedBytes(Region region) const;
+    bool overIRAMBudget() const;
+    const std::vector<std::string>& getErrors() const { return errors; }
+
+    static const char* regionName(Region region);
+    static Region classifySection(const std::string& section);
+
+    // Sized FUNC/OBJECT symbols and allocated section sizes of a
+    // little-endian ELF32/ELF64 relocatable object; nullopt if unreadable
+    struct ObjectContents {
+        std::vector<ObjectSymbol> symbols;
+        std::vector<std::pair<std::string, uint64_t>> sections;
+    };
+    static std::optional<ObjectContents> readObject(const std::filesystem::path& path);
+
+private:
+    Options options;
+    std::vector<Entry> entries;                 // Sorted by size, largest first
+    std::vector<std::pair<Region, uint64_t>> sectionBytes;
+    std::vector<std::string> errors;
+};
+
+#endif // FORTH_SIZE_REPORT_H
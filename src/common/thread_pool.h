@@ -0,0 +1,126 @@
+#ifndef FORTH_THREAD_POOL_H
+#define FORTH_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed-size worker pool used by the compiler for embarrassingly parallel
+// work (per-word code generation, batch compilation of many files).
+class ForthThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable allDone;
+    size_t pending = 0;
+    bool stopping = false;
+
+    auto workerLoop() -> void {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mutex);
+                taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+
+            task();
+
+            {
+                std::lock_guard lock(mutex);
+                if (--pending == 0) {
+                    allDone.notify_all();
+                }
+            }
+        }
+    }
+
+public:
+    explicit ForthThreadPool(size_t threadCount = 0) {
+        const size_t count = threadCount > 0 ? threadCount : defaultThreadCount();
+        workers.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ForthThreadPool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        taskAvailable.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ForthThreadPool(const ForthThreadPool&) = delete;
+    ForthThreadPool& operator=(const ForthThreadPool&) = delete;
+
+    [[nodiscard]] auto size() const -> size_t { return workers.size(); }
+
+    // Queue a task. Tasks must not throw; wrap fallible work in try/catch.
+    auto submit(std::function<void()> task) -> void {
+        {
+            std::lock_guard lock(mutex);
+            tasks.push(std::move(task));
+            ++pending;
+        }
+        taskAvailable.notify_one();
+    }
+
+    // Block until every submitted task has finished
+    auto wait() -> void {
+        std::unique_lock lock(mutex);
+        allDone.wait(lock, [this] { return pending == 0; });
+    }
+
+    [[nodiscard]] static auto defaultThreadCount() -> size_t {
+        return std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    // Run body(index, worker) for every index in [0, count) using at most
+    // threadCount threads. Each worker id is stable for the lifetime of the
+    // call so callers can keep per-worker scratch state.
+    static auto parallelFor(size_t count, size_t threadCount,
+                            const std::function<void(size_t index, size_t worker)>& body) -> void {
+        if (count == 0) return;
+
+        const size_t threads = std::min(count, threadCount > 0 ? threadCount : defaultThreadCount());
+        if (threads <= 1) {
+            for (size_t i = 0; i < count; ++i) {
+                body(i, 0);
+            }
+            return;
+        }
+
+        std::atomic<size_t> next{0};
+        std::vector<std::thread> pool;
+        pool.reserve(threads);
+        for (size_t worker = 0; worker < threads; ++worker) {
+            pool.emplace_back([&, worker] {
+                for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                    body(i, worker);
+                }
+            });
+        }
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+};
+
+#endif // FORTH_THREAD_POOL_H
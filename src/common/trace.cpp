@@ -0,0 +1,209 @@
+#include "common/trace.h"
+#include "common/utils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <sstream>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define FORTH_TRACE_LIVE_BYTES 1
+#endif
+
+using namespace std::chrono;
+
+namespace {
+
+// Trivially constructible, so usable from operator new on any thread at any time
+thread_local ForthTrace::Allocations threadCounters;
+thread_local uint64_t threadLive = 0;   // Heap bytes allocated minus freed on this thread
+thread_local uint64_t threadPeak = 0;
+thread_local uint32_t threadIndex = 0;
+std::atomic<uint32_t> nextThreadIndex{1};
+
+std::mutex eventMutex;
+std::vector<ForthTrace::Event> events;
+steady_clock::time_point origin;
+
+auto count(std::size_t size) -> bool {
+    if (!ForthTrace::isCountingAllocations()) return false;
+    threadCounters.count++;
+    threadCounters.bytes += size;
+    return true;
+}
+
+auto countLive(void* memory, bool counted) -> void* {
+#ifdef FORTH_TRACE_LIVE_BYTES
+    if (counted) {
+        threadLive += malloc_usable_size(memory);
+        threadPeak = std::max(threadPeak, threadLive);
+    }
+#endif
+    return memory;
+}
+
+auto release(void* memory) -> void {
+#ifdef FORTH_TRACE_LIVE_BYTES
+    // Blocks freed by another thread than the allocating one, or allocated
+    // before counting started, can take a thread's balance below zero;
+    // clamp rather than wrap
+    if (memory && ForthTrace::isCountingAllocations()) {
+        threadLive -= std::min<uint64_t>(threadLive, malloc_usable_size(memory));
+    }
+#endif
+    std::free(memory);
+}
+
+auto allocate(std::size_t size) -> void* {
+    const bool counted = count(size);
+    for (;;) {
+        if (void* memory = std::malloc(size ? size : 1)) return countLive(memory, counted);
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+auto allocateAligned(std::size_t size, std::align_val_t alignment) -> void* {
+    const bool counted = count(size);
+    const auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants a multiple of the alignment
+    const std::size_t rounded = (std::max<std::size_t>(size, 1) + align - 1) & ~(align - 1);
+    for (;;) {
+        if (void* memory = std::aligned_alloc(align, rounded)) return countLive(memory, counted);
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+auto toMicroseconds(nanoseconds duration) -> double {
+    return static_cast<double>(duration.count()) / 1000.0;
+}
+
+} // namespace
+
+// ============================================================================
+// Counting global allocation functions. The nothrow forms of the standard
+// library forward to these. They only count while isCountingAllocations().
+// ============================================================================
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void operator delete(void* memory) noexcept { release(memory); }
+void operator delete[](void* memory) noexcept { release(memory); }
+void operator delete(void* memory, std::size_t) noexcept { release(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { release(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { release(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { release(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { release(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { release(memory); }
+
+// ============================================================================
+// Trace recording
+// ============================================================================
+
+std::atomic<bool> ForthTrace::enabled{false};
+std::atomic<uint32_t> ForthTrace::countingScopes{0};
+
+ForthTrace::Span::Span(std::string_view category, std::string_view name, std::string_view detail)
+    : active(ForthTrace::isEnabled()) {
+    if (!active) return;
+    this->category = category;
+    this->name = name;
+    this->detail = detail;
+    // Taken last so the span's own strings are not charged to it
+    startAllocations = threadCounters;
+    start = steady_clock::now();
+}
+
+auto ForthTrace::Span::end() -> void {
+    if (!active) return;
+    active = false;
+    const auto finish = steady_clock::now();
+    const Allocations now = threadCounters;
+    Event event{std::move(category), std::move(name), std::move(detail),
+                duration_cast<nanoseconds>(start - origin), duration_cast<nanoseconds>(finish - start),
+                threadId(), {now.count - startAllocations.count, now.bytes - startAllocations.bytes}};
+    record(std::move(event));
+}
+
+auto ForthTrace::enable() -> void {
+    std::lock_guard lock(eventMutex);
+    events.clear();
+    origin = steady_clock::now();
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+auto ForthTrace::disable() -> void {
+    enabled.store(false, std::memory_order_relaxed);
+}
+
+auto ForthTrace::record(Event event) -> void {
+    std::lock_guard lock(eventMutex);
+    events.push_back(std::move(event));
+}
+
+auto ForthTrace::threadId() -> uint32_t {
+    if (threadIndex == 0) {
+        threadIndex = nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+    }
+    return threadIndex;
+}
+
+auto ForthTrace::threadAllocations() -> Allocations {
+    return threadCounters;
+}
+
+auto ForthTrace::resetThreadPeak() -> void {
+    threadPeak = threadLive;
+}
+
+auto ForthTrace::threadPeakBytes() -> uint64_t {
+    return threadPeak;
+}
+
+auto ForthTrace::threadLiveBytes() -> uint64_t {
+    return threadLive;
+}
+
+auto ForthTrace::getEvents() -> std::vector<Event> {
+    std::lock_guard lock(eventMutex);
+    return events;
+}
+
+auto ForthTrace::toJson() -> std::string {
+    const auto recorded = getEvents();
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    json << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, "
+            "\"args\": {\"name\": \"forth_compiler\"}}";
+    for (const auto& event : recorded) {
+        json << ",\n  {\"name\": \"" << ForthUtils::jsonEscape(event.name)
+             << "\", \"cat\": \"" << ForthUtils::jsonEscape(event.category)
+             << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread
+             << ", \"ts\": " << toMicroseconds(event.start)
+             << ", \"dur\": " << toMicroseconds(event.duration)
+             << ", \"args\": {\"allocations\": " << event.allocations.count
+             << ", \"allocated_bytes\": " << event.allocations.bytes;
+        if (!event.detail.empty()) {
+            json << ", \"detail\": \"" << ForthUtils::jsonEscape(event.detail) << "\"";
+        }
+        json << "}}";
+    }
+    json << "\n]}\n";
+    return json.str();
+}
+
+auto ForthTrace::write(const std::filesystem::path& path) -> bool {
+    std::ofstream out(path);
+    out << toJson();
+    return static_cast<bool>(out);
+}
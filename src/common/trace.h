@@ -0,0 +1,106 @@
+#ifndef FORTH_TRACE_H
+#define FORTH_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// Pass tracing in Chrome trace event format
+// ============================================================================
+//
+// Spans mark passes of the compiler. While tracing is enabled each span is
+// recorded with its thread, duration and the heap allocations its thread
+// made inside it (count and bytes, children included), and the whole trace
+// can be written as JSON for chrome://tracing or ui.perfetto.dev. While
+// tracing is disabled a span costs one relaxed atomic load.
+//
+// Allocations are counted per thread by the replacement global operator new
+// in trace.cpp, along with the live heap that --benchmark reports as peak
+// memory - but only while tracing is enabled or an AllocationCounting scope
+// is open. Otherwise an allocation or free costs two relaxed atomic loads
+// on top of malloc/free. The live heap only balances for blocks allocated
+// and freed while counting.
+
+class ForthTrace {
+public:
+    struct Allocations {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+    };
+
+    struct Event {
+        std::string category;
+        std::string name;
+        std::string detail;              // Optional "args.detail"
+        std::chrono::nanoseconds start;  // Since enable()
+        std::chrono::nanoseconds duration;
+        uint32_t thread;
+        Allocations allocations;
+    };
+
+    // RAII span; records nothing unless tracing was enabled when it began
+    class Span {
+    public:
+        Span(std::string_view category, std::string_view name, std::string_view detail = {});
+        ~Span() { end(); }
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+        // Close the span before the end of its scope
+        auto end() -> void;
+
+    private:
+        bool active;
+        std::string category;
+        std::string name;
+        std::string detail;
+        std::chrono::steady_clock::time_point start;
+        Allocations startAllocations;
+    };
+
+    // Counts allocations for as long as it exists, for readers of the
+    // thread counters below that run with tracing disabled
+    class AllocationCounting {
+    public:
+        AllocationCounting() { countingScopes.fetch_add(1, std::memory_order_relaxed); }
+        ~AllocationCounting() { countingScopes.fetch_sub(1, std::memory_order_relaxed); }
+        AllocationCounting(const AllocationCounting&) = delete;
+        AllocationCounting& operator=(const AllocationCounting&) = delete;
+    };
+
+    // Start a new trace, dropping any recorded events
+    static auto enable() -> void;
+    static auto disable() -> void;
+    [[nodiscard]] static auto isEnabled() -> bool { return enabled.load(std::memory_order_relaxed); }
+    [[nodiscard]] static auto isCountingAllocations() -> bool {
+        return isEnabled() || countingScopes.load(std::memory_order_relaxed) != 0;
+    }
+
+    // Recorded spans, in the order they ended
+    [[nodiscard]] static auto getEvents() -> std::vector<Event>;
+    [[nodiscard]] static auto toJson() -> std::string;
+    static auto write(const std::filesystem::path& path) -> bool;
+
+    // Allocations counted on the calling thread since it started
+    [[nodiscard]] static auto threadAllocations() -> Allocations;
+
+    // Heap held by the calling thread (allocated minus freed, in usable
+    // bytes; glibc only) and its high-water mark since resetThreadPeak()
+    [[nodiscard]] static auto threadLiveBytes() -> uint64_t;
+    [[nodiscard]] static auto threadPeakBytes() -> uint64_t;
+    static auto resetThreadPeak() -> void;
+
+private:
+    static std::atomic<bool> enabled;
+    static std::atomic<uint32_t> countingScopes;
+
+    static auto record(Event event) -> void;
+    static auto threadId() -> uint32_t;
+};
+
+#endif // FORTH_TRACE_H
@@ -4,6 +4,7 @@
 #include <string>
 #include <algorithm>
 #include <cctype>
+#include <cstdio>
 #include <filesystem>  
 
 class ForthUtils {
@@ -56,6 +57,41 @@ public:
         return true;
     }
     
+    // Body of a JSON string literal
+    static std::string jsonEscape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            switch (c) {
+                case '"': escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                case '\t': escaped += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buffer[8];
+                        std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                        escaped += buffer;
+                    } else {
+                        escaped += c;
+                    }
+            }
+        }
+        return escaped;
+    }
+    
+    // Single-quoted argument for a POSIX shell command line
+    static std::string shellQuote(const std::string& text) {
+        std::string quoted = "'";
+        for (char c : text) {
+            if (c == '\'') {
+                quoted += "'\\''";
+            } else {
+                quoted += c;
+            }
+        }
+        return quoted + "'";
+    }
+    
     // FORTH word validation
     static bool isValidWordName(const std::string& str) {
         if (str.empty()) return false;
@@ -12,6 +12,12 @@ ForthDictionary::ForthDictionary() {
     initializeMemoryWords();
     initializeComparisonWords();  
     initializeIOWords();
+    initializeTaskWords();
+}
+
+ForthDictionary::ForthDictionary(std::shared_ptr<const ForthDictionary> builtins)
+    : base(std::move(builtins)) {
+    // Builtins come from the shared base; only user definitions live here
 }
 
 auto ForthDictionary::defineWord(const std::string& name, std::unique_ptr<ASTNode> definition) -> void {
@@ -44,6 +50,7 @@ auto ForthDictionary::defineVariable(const std::string& name, std::unique_ptr<AS
     entry->stackEffect = {0, 1, true}; // Variables push their address
     
     variables[normalizedName] = std::move(entry);
+    shadowBuiltin(normalizedName);
 }
 
 auto ForthDictionary::defineConstant(const std::string& name, std::unique_ptr<ASTNode> value) -> void {
@@ -54,6 +61,30 @@ auto ForthDictionary::defineConstant(const std::string& name, std::unique_ptr<AS
     entry->stackEffect = {0, 1, true}; // Constants push their value
     
     constants[normalizedName] = std::move(entry);
+    shadowBuiltin(normalizedName);
+}
+
+auto ForthDictionary::shadowBuiltin(const std::string& normalizedName) -> void {
+    // A later VARIABLE/CONSTANT/CREATE hides a built-in of the same name
+    auto it = words.find(normalizedName);
+    if (it != words.end() && it->second->type == WordEntry::WordType::BUILTIN) {
+        words.erase(it);
+    }
+    if (base && base->isWordDefined(normalizedName)) {
+        shadowedBase.insert(normalizedName);
+    }
+}
+
+auto ForthDictionary::visibleBaseWords() const -> std::vector<const WordEntry*> {
+    std::vector<const WordEntry*> result;
+    if (!base) return result;
+    for (const WordEntry* entry : base->getAllWords()) {
+        if (!shadowedBase.contains(entry->name) && !words.contains(entry->name) &&
+            !variables.contains(entry->name) && !constants.contains(entry->name)) {
+            result.push_back(entry);
+        }
+    }
+    return result;
 }
 
 [[nodiscard]] auto ForthDictionary::lookupWord(const std::string& name) const -> WordEntry* {
@@ -77,6 +108,11 @@ auto ForthDictionary::defineConstant(const std::string& name, std::unique_ptr<AS
         return constIt->second.get();
     }
     
+    // Shared builtins are never modified through an overlay
+    if (base && !shadowedBase.contains(normalizedName)) {
+        return base->lookupWord(normalizedName);
+    }
+    
     return nullptr;
 }
 
@@ -86,12 +122,16 @@ auto ForthDictionary::defineConstant(const std::string& name, std::unique_ptr<AS
 
 [[nodiscard]] auto ForthDictionary::isVariable(const std::string& name) const -> bool {
     const auto normalizedName = normalizeWordName(name);
-    return variables.find(normalizedName) != variables.end();
+    if (variables.find(normalizedName) != variables.end()) return true;
+    return base && !shadowedBase.contains(normalizedName) && !words.contains(normalizedName) &&
+           base->isVariable(normalizedName);
 }
 
 [[nodiscard]] auto ForthDictionary::isConstant(const std::string& name) const -> bool {
     const auto normalizedName = normalizeWordName(name);
-    return constants.find(normalizedName) != constants.end();
+    if (constants.find(normalizedName) != constants.end()) return true;
+    return base && !shadowedBase.contains(normalizedName) && !words.contains(normalizedName) &&
+           base->isConstant(normalizedName);
 }
 
 [[nodiscard]] auto ForthDictionary::getStackEffect(const std::string& wordName) const -> ASTNode::StackEffect {
@@ -242,6 +282,85 @@ auto ForthDictionary::initializeMemoryWords() -> void {
         auto value = forth_stack.pop();
         *reinterpret_cast<char*>(addr) = static_cast<char>(value);
     })", {2, 0, true});
+    
+    // Data space (linear allocator over an aligned cell array)
+    defineBuiltinWord("HERE", "forth_stack.push(data_space_here)", {0, 1, true});
+    defineBuiltinWord("ALLOT", "data_space_here += forth_stack.pop()", {1, 0, true});
+    defineBuiltinWord(",", R"({
+        data_space_here = (data_space_here + sizeof(int32_t) - 1) & ~(sizeof(int32_t) - 1);
+        *reinterpret_cast<int32_t*>(data_space + data_space_here) = forth_stack.pop();
+        data_space_here += sizeof(int32_t);
+    })", {1, 0, true});
+    defineBuiltinWord("CELLS", "forth_stack.push(forth_stack.pop() * sizeof(int32_t))", {1, 1, true});
+    defineBuiltinWord("CELL+", "forth_stack.push(forth_stack.pop() + sizeof(int32_t))", {1, 1, true});
+    
+    // Block memory operations
+    defineBuiltinWord("MOVE", R"({
+        auto count = forth_stack.pop();
+        auto dst = forth_stack.pop();
+        auto src = forth_stack.pop();
+        if (count > 0) std::memmove(reinterpret_cast<void*>(dst), reinterpret_cast<const void*>(src), count);
+    })", {3, 0, true});
+    defineBuiltinWord("CMOVE", R"({
+        auto count = forth_stack.pop();
+        auto dst = reinterpret_cast<char*>(forth_stack.pop());
+        auto src = reinterpret_cast<const char*>(forth_stack.pop());
+        for (int32_t i = 0; i < count; i++) dst[i] = src[i];
+    })", {3, 0, true});
+    defineBuiltinWord("CMOVE>", R"({
+        auto count = forth_stack.pop();
+        auto dst = reinterpret_cast<char*>(forth_stack.pop());
+        auto src = reinterpret_cast<const char*>(forth_stack.pop());
+        for (int32_t i = count; i > 0; i--) dst[i - 1] = src[i - 1];
+    })", {3, 0, true});
+    defineBuiltinWord("FILL", R"({
+        auto value = forth_stack.pop();
+        auto count = forth_stack.pop();
+        auto addr = forth_stack.pop();
+        if (count > 0) std::memset(reinterpret_cast<void*>(addr), static_cast<char>(value), count);
+    })", {3, 0, true});
+    defineBuiltinWord("ERASE", R"({
+        auto count = forth_stack.pop();
+        auto addr = forth_stack.pop();
+        if (count > 0) std::memset(reinterpret_cast<void*>(addr), 0, count);
+    })", {2, 0, true});
+    
+    // Array operations over cells ( addr n -- ... )
+    defineBuiltinWord("SUM", R"({
+        auto count = forth_stack.pop();
+        auto cells = reinterpret_cast<const int32_t*>(forth_stack.pop());
+        forth_stack.push(std::accumulate(cells, cells + count, int32_t{0}));
+    })", {2, 1, true});
+    defineBuiltinWord("DOT", R"({
+        auto count = forth_stack.pop();
+        auto b = reinterpret_cast<const int32_t*>(forth_stack.pop());
+        auto a = reinterpret_cast<const int32_t*>(forth_stack.pop());
+        forth_stack.push(std::inner_product(a, a + count, b, int32_t{0}));
+    })", {3, 1, true});
+    defineBuiltinWord("MIN-REDUCE", R"({
+        auto count = forth_stack.pop();
+        auto cells = reinterpret_cast<const int32_t*>(forth_stack.pop());
+        forth_stack.push(std::accumulate(cells, cells + count, INT32_MAX,
+                                         [](int32_t a, int32_t b) { return std::min(a, b); }));
+    })", {2, 1, true});
+    defineBuiltinWord("MAX-REDUCE", R"({
+        auto count = forth_stack.pop();
+        auto cells = reinterpret_cast<const int32_t*>(forth_stack.pop());
+        forth_stack.push(std::accumulate(cells, cells + count, INT32_MIN,
+                                         [](int32_t a, int32_t b) { return std::max(a, b); }));
+    })", {2, 1, true});
+    defineBuiltinWord("MAP+", R"({
+        auto k = forth_stack.pop();
+        auto count = forth_stack.pop();
+        auto cells = reinterpret_cast<int32_t*>(forth_stack.pop());
+        for (int32_t i = 0; i < count; i++) cells[i] += k;
+    })", {3, 0, true});
+    defineBuiltinWord("SCALE", R"({
+        auto k = forth_stack.pop();
+        auto count = forth_stack.pop();
+        auto cells = reinterpret_cast<int32_t*>(forth_stack.pop());
+        for (int32_t i = 0; i < count; i++) cells[i] *= k;
+    })", {3, 0, true});
 }
 
 auto ForthDictionary::initializeComparisonWords() -> void {
@@ -305,6 +424,20 @@ auto ForthDictionary::initializeIOWords() -> void {
         auto count = forth_stack.pop();
         for (int i = 0; i < count; ++i) std::cout << " ";
     })", {1, 0, true});
+    
+    defineBuiltinWord("FLUSH", "std::cout.flush()", {0, 0, true});
+}
+
+auto ForthDictionary::initializeTaskWords() -> void {
+    // Cooperative multitasking: tasks only switch at PAUSE
+    defineBuiltinWord("START", "/* task START name - handled by parser */", {1, 0, true});
+    defineBuiltinWord("PAUSE", "forth_scheduler.yield()", {0, 0, true});
+    defineBuiltinWord("STOP", "forth_scheduler.stop()", {0, 0, true});
+    
+    // Channels: bounded rings between tasks, threads and cores
+    defineBuiltinWord("SEND", "/* x channel SEND */", {2, 0, true});
+    defineBuiltinWord("RECV", "/* channel RECV -- x */", {1, 1, true});
+    defineBuiltinWord("TRY-RECV", "/* channel TRY-RECV -- x flag */", {1, 2, true});
 }
 
 [[nodiscard]] auto ForthDictionary::normalizeWordName(const std::string& name) const -> std::string {
@@ -314,9 +447,19 @@ auto ForthDictionary::initializeIOWords() -> void {
 auto ForthDictionary::printDictionary() const -> void {
     std::cout << "\n=== FORTH Dictionary ===\n";
     
-    std::cout << "\nWords (" << words.size() << "):\n";
+    std::vector<const WordEntry*> allWords;
     for (const auto& [name, entry] : words) {
-        std::cout << "  " << name << " (";
+        allWords.push_back(entry.get());
+    }
+    for (const WordEntry* entry : visibleBaseWords()) {
+        if (entry->type != WordEntry::WordType::VARIABLE && entry->type != WordEntry::WordType::CONSTANT) {
+            allWords.push_back(entry);
+        }
+    }
+    
+    std::cout << "\nWords (" << allWords.size() << "):\n";
+    for (const WordEntry* entry : allWords) {
+        std::cout << "  " << entry->name << " (";
         switch (entry->type) {
             case WordEntry::WordType::BUILTIN: std::cout << "BUILTIN"; break;
             case WordEntry::WordType::USER_DEFINED: std::cout << "USER"; break;
@@ -343,7 +486,7 @@ auto ForthDictionary::printDictionary() const -> void {
 }
 
 [[nodiscard]] auto ForthDictionary::getDictionarySize() const -> size_t {
-    return words.size() + variables.size() + constants.size();
+    return words.size() + variables.size() + constants.size() + visibleBaseWords().size();
 }
 
 // Dictionary Factory Implementation
@@ -396,6 +539,16 @@ auto ForthDictionary::printDictionary() const -> void {
     return dict;
 }
 
+[[nodiscard]] auto DictionaryFactory::sharedBuiltins() -> std::shared_ptr<const ForthDictionary> {
+    // Built on first use; C++ guarantees the initialization is thread-safe
+    static const std::shared_ptr<const ForthDictionary> builtins = create(Configuration::STANDARD);
+    return builtins;
+}
+
+[[nodiscard]] auto DictionaryFactory::createOverlay() -> std::unique_ptr<ForthDictionary> {
+    return std::make_unique<ForthDictionary>(sharedBuiltins());
+}
+
 [[nodiscard]] auto ForthDictionary::getAllWords() const -> std::vector<const WordEntry*> {
     std::vector<const WordEntry*> result;
     result.reserve(words.size() + variables.size() + constants.size());
@@ -409,6 +562,9 @@ auto ForthDictionary::printDictionary() const -> void {
     for (const auto& [name, entry] : constants) {
         result.push_back(entry.get());
     }
+    for (const WordEntry* entry : visibleBaseWords()) {
+        result.push_back(entry);
+    }
     
     return result;
 }
@@ -434,6 +590,12 @@ auto ForthDictionary::printDictionary() const -> void {
             result.push_back(entry.get());
         }
     }
+    for (const WordEntry* entry : visibleBaseWords()) {
+        if (entry->type == WordEntry::WordType::BUILTIN ||
+            entry->type == WordEntry::WordType::MATH_BUILTIN) {
+            result.push_back(entry);
+        }
+    }
     
     return result;
 }
@@ -443,6 +605,11 @@ auto ForthDictionary::clear() -> void {
     variables.clear();
     constants.clear();
     definitionStack.clear();
+    shadowedBase.clear();
+    
+    if (base) {
+        return;  // Builtins live in the shared base
+    }
     
     // Reinitialize built-in words
     initializeBuiltinWords();
@@ -450,10 +617,12 @@ auto ForthDictionary::clear() -> void {
     initializeControlWords();
     initializeStackWords();
     initializeMemoryWords();
+    initializeTaskWords();
 }
 
 [[nodiscard]] auto ForthDictionary::clone() const -> std::unique_ptr<ForthDictionary> {
-    auto newDict = std::make_unique<ForthDictionary>();
+    auto newDict = base ? std::make_unique<ForthDictionary>(base) : std::make_unique<ForthDictionary>();
+    newDict->shadowedBase = shadowedBase;
     
     // Clear the new dictionary's default initialization
     newDict->words.clear();
@@ -486,6 +655,28 @@ auto ForthDictionary::clear() -> void {
     return newDict;
 }
 
+auto ForthDictionary::importDefinitions(const ForthDictionary& module) -> void {
+    // Definitions are not deep-copied, as in clone()
+    for (const auto& [name, entry] : module.words) {
+        if (entry->type != WordEntry::WordType::USER_DEFINED) continue;
+        auto newEntry = std::make_unique<WordEntry>(entry->name, entry->type, entry->isImmediate);
+        newEntry->stackEffect = entry->stackEffect;
+        words[name] = std::move(newEntry);
+    }
+    for (const auto& [name, entry] : module.variables) {
+        auto newEntry = std::make_unique<WordEntry>(entry->name, entry->type, entry->isImmediate);
+        newEntry->stackEffect = entry->stackEffect;
+        variables[name] = std::move(newEntry);
+        shadowBuiltin(name);
+    }
+    for (const auto& [name, entry] : module.constants) {
+        auto newEntry = std::make_unique<WordEntry>(entry->name, entry->type, entry->isImmediate);
+        newEntry->stackEffect = entry->stackEffect;
+        constants[name] = std::move(newEntry);
+        shadowBuiltin(name);
+    }
+}
+
 // Forward reference handling
 auto ForthDictionary::markForwardReference(const std::string& name) -> void {
     const auto normalizedName = normalizeWordName(name);
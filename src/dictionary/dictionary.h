@@ -3,6 +3,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <memory>
 #include "parser/ast.h"
@@ -50,8 +51,14 @@ private:
     // Stack for nested word definitions (if needed)
     std::vector<std::string> definitionStack;
     
+    // Overlay mode: read-only builtins shared with other dictionaries.
+    // Lookups fall through to the base unless a local definition shadows it.
+    std::shared_ptr<const ForthDictionary> base;
+    std::unordered_set<std::string> shadowedBase;
+    
 public:
     ForthDictionary();
+    explicit ForthDictionary(std::shared_ptr<const ForthDictionary> builtins);
     ~ForthDictionary() = default;
     
     // Core dictionary operations
@@ -75,6 +82,10 @@ public:
     // Dictionary state management
     auto clear() -> void;
     auto clone() const -> std::unique_ptr<ForthDictionary>;
+    // Add the user words, variables and constants defined locally in another
+    // dictionary (an included module's), replacing any of the same name
+    auto importDefinitions(const ForthDictionary& module) -> void;
+    [[nodiscard]] auto getBase() const -> const ForthDictionary* { return base.get(); }
     
     // Stack effect analysis
     [[nodiscard]] auto getStackEffect(const std::string& wordName) const -> ASTNode::StackEffect;
@@ -96,7 +107,10 @@ private:
     auto initializeMemoryWords() -> void;
     auto initializeComparisonWords() -> void;  
     auto initializeIOWords() -> void;          
+    auto initializeTaskWords() -> void;
     
+    auto shadowBuiltin(const std::string& normalizedName) -> void;
+    [[nodiscard]] auto visibleBaseWords() const -> std::vector<const WordEntry*>;
     [[nodiscard]] auto normalizeWordName(const std::string& name) const -> std::string;
 };
 
@@ -111,6 +125,11 @@ public:
     };
     
     [[nodiscard]] static auto create(Configuration config) -> std::unique_ptr<ForthDictionary>;
+    
+    // One immutable STANDARD dictionary per process. Concurrent compiles
+    // share it through overlays instead of each building the builtins.
+    [[nodiscard]] static auto sharedBuiltins() -> std::shared_ptr<const ForthDictionary>;
+    [[nodiscard]] static auto createOverlay() -> std::unique_ptr<ForthDictionary>;
 };
 
 #endif // FORTH_DICTIONARY_H
@@ -0,0 +1,422 @@
+#include "driver/baseline.h"
+#include "common/utils.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* BASELINE_FORMAT = "forth-benchmark-baseline/1";
+
+// Only as much JSON as a baseline file needs: objects, arrays, strings,
+// numbers, booleans and null
+struct JsonValue {
+    enum class Kind { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+    Kind kind = Kind::NUL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    [[nodiscard]] auto get(const std::string& key) const -> const JsonValue* {
+        for (const auto& [name, value] : object) {
+            if (name == key) return &value;
+        }
+        return nullptr;
+    }
+};
+
+class JsonReader {
+public:
+    explicit JsonReader(const std::string& text) : text(text) {}
+
+    auto parse() -> JsonValue {
+        JsonValue value = parseValue();
+        skipSpace();
+        if (pos != text.size()) fail("trailing characters");
+        return value;
+    }
+
+private:
+    const std::string& text;
+    size_t pos = 0;
+
+    [[noreturn]] auto fail(const std::string& message) const -> void {
+        throw std::runtime_error("Malformed baseline JSON at offset " + std::to_string(pos) + ": " + message);
+    }
+
+    auto skipSpace() -> void {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+    }
+
+    auto consume(char expected) -> bool {
+        skipSpace();
+        if (pos < text.size() && text[pos] == expected) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    auto expect(char expected) -> void {
+        if (!consume(expected)) fail(std::string("expected '") + expected + "'");
+    }
+
+    auto parseValue() -> JsonValue {
+        skipSpace();
+        if (pos >= text.size()) fail("unexpected end of input");
+        JsonValue value;
+        const char c = text[pos];
+        if (c == '{') {
+            pos++;
+            value.kind = JsonValue::Kind::OBJECT;
+            if (consume('}')) return value;
+            do {
+                skipSpace();
+                std::string key = parseString();
+                expect(':');
+                value.object.emplace_back(std::move(key), parseValue());
+            } while (consume(','));
+            expect('}');
+        } else if (c == '[') {
+            pos++;
+            value.kind = JsonValue::Kind::ARRAY;
+            if (consume(']')) return value;
+            do {
+                value.array.push_back(parseValue());
+            } while (consume(','));
+            expect(']');
+        } else if (c == '"') {
+            value.kind = JsonValue::Kind::STRING;
+            value.string = parseString();
+        } else if (text.compare(pos, 4, "true") == 0 || text.compare(pos, 5, "false") == 0) {
+            value.kind = JsonValue::Kind::BOOLEAN;
+            value.boolean = c == 't';
+            pos += value.boolean ? 4 : 5;
+        } else if (text.compare(pos, 4, "null") == 0) {
+            pos += 4;
+        } else {
+            value.kind = JsonValue::Kind::NUMBER;
+            const char* begin = text.c_str() + pos;
+            char* end = nullptr;
+            value.number = std::strtod(begin, &end);
+            if (end == begin) fail("unexpected character");
+            pos += static_cast<size_t>(end - begin);
+        }
+        return value;
+    }
+
+    auto parseString() -> std::string {
+        if (pos >= text.size() || text[pos] != '"') fail("expected a string");
+        pos++;
+        std::string result;
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos++];
+            if (c == '\\') {
+                if (pos >= text.size()) break;
+                c = text[pos++];
+                switch (c) {
+                    case 'n': result += '\n'; break;
+                    case 't': result += '\t'; break;
+                    case 'r': result += '\r'; break;
+                    case 'b': result += '\b'; break;
+                    case 'f': result += '\f'; break;
+                    case 'u': {
+                        if (pos + 4 > text.size()) fail("short \\u escape");
+                        const unsigned code = std::stoul(text.substr(pos, 4), nullptr, 16);
+                        pos += 4;
+                        // jsonEscape only writes \u for control characters
+                        if (code < 0x80) {
+                            result += static_cast<char>(code);
+                        } else if (code < 0x800) {
+                            result += static_cast<char>(0xC0 | (code >> 6));
+                            result += static_cast<char>(0x80 | (code & 0x3F));
+                        } else {
+                            result += static_cast<char>(0xE0 | (code >> 12));
+                            result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                            result += static_cast<char>(0x80 | (code & 0x3F));
+                        }
+                        break;
+                    }
+                    default: result += c; break;   // \" \\ \/
+                }
+            } else {
+                result += c;
+            }
+        }
+        if (pos >= text.size()) fail("unterminated string");
+        pos++;
+        return result;
+    }
+};
+
+auto toMilliseconds(std::chrono::nanoseconds duration) -> double {
+    return static_cast<double>(duration.count()) / 1e6;
+}
+
+auto medianOf(std::vector<double> samples) -> double {
+    if (samples.empty()) return 0.0;
+    std::sort(samples.begin(), samples.end());
+    const size_t middle = samples.size() / 2;
+    return samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2.0;
+}
+
+auto varianceOf(const std::vector<double>& samples) -> double {
+    if (samples.size() < 2) return 0.0;
+    double mean = 0.0;
+    for (double sample : samples) mean += sample;
+    mean /= static_cast<double>(samples.size());
+    double sum = 0.0;
+    for (double sample : samples) sum += (sample - mean) * (sample - mean);
+    return sum / static_cast<double>(samples.size() - 1);
+}
+
+auto makePhase(std::vector<double> samples) -> ForthBenchmarkBaseline::Phase {
+    ForthBenchmarkBaseline::Phase phase;
+    phase.median = medianOf(samples);
+    phase.variance = varianceOf(samples);
+    phase.samples = std::move(samples);
+    return phase;
+}
+
+// P(U <= u) for sample sizes m and n without ties, by counting the
+// orderings of the combined sample that give each U
+auto exactLowerTail(size_t m, size_t n, size_t u) -> double {
+    const size_t maxU = m * n;
+    // counts[i][j][k]: orderings of i and j values with U = k
+    std::vector<double> counts((m + 1) * (n + 1) * (maxU + 1), 0.0);
+    auto at = [&](size_t i, size_t j, size_t k) -> double& { return counts[(i * (n + 1) + j) * (maxU + 1) + k]; };
+    for (size_t i = 0; i <= m; i++) {
+        for (size_t j = 0; j <= n; j++) {
+            if (i == 0 || j == 0) {
+                at(i, j, 0) = 1.0;
+                continue;
+            }
+            for (size_t k = 0; k <= i * j; k++) {
+                // The largest value is either from the first sample (beating all j) or the second
+                at(i, j, k) = (k >= j ? at(i - 1, j, k - j) : 0.0) + at(i, j - 1, k);
+            }
+        }
+    }
+    double below = 0.0, total = 0.0;
+    for (size_t k = 0; k <= maxU; k++) {
+        total += at(m, n, k);
+        if (k <= u) below += at(m, n, k);
+    }
+    return below / total;
+}
+
+} // namespace
+
+auto ForthBenchmarkBaseline::Comparison::count(Change::Verdict verdict) const -> size_t {
+    return static_cast<size_t>(std::count_if(changes.begin(), changes.end(),
+                                              [verdict](const Change& change) { return change.verdict == verdict; }));
+}
+
+auto ForthBenchmarkBaseline::fromResults(const std::vector<ForthBenchmark::ProgramResult>& results) -> Programs {
+    Programs programs;
+    for (const auto& result : results) {
+        if (!result.success) continue;
+        auto& phases = programs[result.name];
+        for (const auto& [phase, durations] : result.samples) {
+            std::vector<double> samples;
+            samples.reserve(durations.size());
+            for (const auto duration : durations) samples.push_back(toMilliseconds(duration));
+            phases[phase] = makePhase(std::move(samples));
+        }
+    }
+    return programs;
+}
+
+auto ForthBenchmarkBaseline::toJson(const Programs& programs) -> std::string {
+    std::ostringstream json;
+    json << std::setprecision(6);
+    json << "{\n";
+    json << "  \"format\": \"" << BASELINE_FORMAT << "\",\n";
+    json << "  \"programs\": {";
+    bool firstProgram = true;
+    for (const auto& [name, phases] : programs) {
+        json << (firstProgram ? "\n" : ",\n") << "    \"" << ForthUtils::jsonEscape(name) << "\": {";
+        firstProgram = false;
+        bool firstPhase = true;
+        for (const auto& [phaseName, phase] : phases) {
+            json << (firstPhase ? "\n" : ",\n") << "      \"" << ForthUtils::jsonEscape(phaseName)
+                 << "\": {\"median_ms\": " << phase.median << ", \"variance\": " << phase.variance
+                 << ", \"samples_ms\": [";
+            firstPhase = false;
+            for (size_t i = 0; i < phase.samples.size(); i++) {
+                json << (i ? ", " : "") << phase.samples[i];
+            }
+            json << "]}";
+        }
+        json << (phases.empty() ? "}" : "\n    }");
+    }
+    json << (programs.empty() ? "}\n" : "\n  }\n");
+    json << "}\n";
+    return json.str();
+}
+
+auto ForthBenchmarkBaseline::save(const fs::path& path, const Programs& programs) -> bool {
+    if (path.has_parent_path()) {
+        std::error_code ec;
+        fs::create_directories(path.parent_path(), ec);
+    }
+    std::ofstream out(path);
+    out << toJson(programs);
+    return static_cast<bool>(out);
+}
+
+auto ForthBenchmarkBaseline::load(const fs::path& path) -> Programs {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open baseline: " + path.string());
+    }
+    const std::string text{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    const JsonValue root = JsonReader(text).parse();
+
+    const JsonValue* format = root.get("format");
+    if (!format || format->string != BASELINE_FORMAT) {
+        throw std::runtime_error("Not a benchmark baseline: " + path.string());
+    }
+    const JsonValue* programsValue = root.get("programs");
+    if (!programsValue || programsValue->kind != JsonValue::Kind::OBJECT) {
+        throw std::runtime_error("Baseline has no programs: " + path.string());
+    }
+
+    Programs programs;
+    for (const auto& [name, phasesValue] : programsValue->object) {
+        auto& phases = programs[name];
+        for (const auto& [phaseName, phaseValue] : phasesValue.object) {
+            const JsonValue* samplesValue = phaseValue.get("samples_ms");
+            if (!samplesValue || samplesValue->kind != JsonValue::Kind::ARRAY) {
+                throw std::runtime_error("Baseline " + name + "/" + phaseName + " has no samples");
+            }
+            std::vector<double> samples;
+            for (const auto& sample : samplesValue->array) {
+                samples.push_back(sample.number);
+            }
+            phases[phaseName] = makePhase(std::move(samples));
+        }
+    }
+    return programs;
+}
+
+auto ForthBenchmarkBaseline::mannWhitney(const std::vector<double>& a, const std::vector<double>& b) -> double {
+    const size_t m = a.size(), n = b.size();
+    if (m == 0 || n == 0) return 1.0;
+
+    // Rank the combined sample, averaging the ranks of ties
+    std::vector<std::pair<double, bool>> combined;   // (value, from a)
+    for (double value : a) combined.emplace_back(value, true);
+    for (double value : b) combined.emplace_back(value, false);
+    std::sort(combined.begin(), combined.end());
+
+    double rankSumA = 0.0, tieTerm = 0.0;
+    for (size_t i = 0; i < combined.size();) {
+        size_t j = i;
+        while (j < combined.size() && combined[j].first == combined[i].first) j++;
+        const double rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+        for (size_t k = i; k < j; k++) {
+            if (combined[k].second) rankSumA += rank;
+        }
+        const double tied = static_cast<double>(j - i);
+        tieTerm += tied * tied * tied - tied;
+        i = j;
+    }
+
+    const double uA = rankSumA - static_cast<double>(m * (m + 1)) / 2.0;
+    const double uSmaller = std::min(uA, static_cast<double>(m * n) - uA);
+
+    if (tieTerm == 0.0 && m <= 20 && n <= 20) {
+        return std::min(1.0, 2.0 * exactLowerTail(m, n, static_cast<size_t>(uSmaller)));
+    }
+
+    const double total = static_cast<double>(m + n);
+    const double mean = static_cast<double>(m * n) / 2.0;
+    const double variance = static_cast<double>(m * n) / 12.0 * ((total + 1.0) - tieTerm / (total * (total - 1.0)));
+    if (variance <= 0.0) return 1.0;
+    // Continuity-corrected
+    const double z = std::max(0.0, std::abs(uA - mean) - 0.5) / std::sqrt(variance);
+    return std::erfc(z / std::sqrt(2.0));
+}
+
+auto ForthBenchmarkBaseline::compare(const Programs& baseline, const Programs& current, const Options& options)
+    -> Comparison {
+    Comparison comparison;
+    for (const auto& [name, phases] : current) {
+        const auto base = baseline.find(name);
+        if (base == baseline.end()) {
+            comparison.added.push_back(name);
+            continue;
+        }
+        for (const auto& [phaseName, phase] : phases) {
+            const auto basePhase = base->second.find(phaseName);
+            if (basePhase == base->second.end() || basePhase->second.samples.empty() || phase.samples.empty()) {
+                continue;
+            }
+            Change change;
+            change.program = name;
+            change.phase = phaseName;
+            change.baselineMedian = basePhase->second.median;
+            change.currentMedian = phase.median;
+            change.relativeChange = change.baselineMedian > 0.0
+                                        ? (change.currentMedian - change.baselineMedian) / change.baselineMedian
+                                        : 0.0;
+            change.pValue = mannWhitney(basePhase->second.samples, phase.samples);
+            if (change.pValue < options.alpha && std::abs(change.relativeChange) > options.threshold) {
+                change.verdict = change.relativeChange > 0.0 ? Change::Verdict::SLOWER : Change::Verdict::FASTER;
+            }
+            comparison.changes.push_back(std::move(change));
+        }
+    }
+    for (const auto& [name, phases] : baseline) {
+        if (!current.contains(name)) {
+            comparison.missing.push_back(name);
+        }
+    }
+    return comparison;
+}
+
+auto ForthBenchmarkBaseline::printComparison(std::ostream& out, const Comparison& comparison,
+                                             const Options& options) -> void {
+    out << "\n" << std::string(60, '=') << "\n";
+    out << "BASELINE COMPARISON (p < " << options.alpha << ", change > "
+        << options.threshold * 100.0 << "%)\n";
+    out << std::string(60, '=') << "\n";
+
+    const size_t significant = comparison.changes.size() - comparison.count(Change::Verdict::UNCHANGED);
+    if (significant > 0) {
+        out << std::left << std::setw(30) << "Program" << std::setw(10) << "Phase" << std::right
+            << std::setw(12) << "Base ms" << std::setw(12) << "Now ms" << std::setw(10) << "Change"
+            << std::setw(10) << "p" << "  Verdict\n";
+        out << std::string(96, '-') << "\n";
+        for (const auto& change : comparison.changes) {
+            if (change.verdict == Change::Verdict::UNCHANGED) continue;
+            std::string name = change.program;
+            if (name.size() > 29) name = "..." + name.substr(name.size() - 26);
+            std::ostringstream percent;
+            percent << std::showpos << std::fixed << std::setprecision(1) << change.relativeChange * 100.0 << "%";
+            out << std::left << std::setw(30) << name << std::setw(10) << change.phase << std::right << std::fixed
+                << std::setprecision(3) << std::setw(12) << change.baselineMedian << std::setw(12)
+                << change.currentMedian << std::setw(10) << percent.str() << std::setprecision(4) << std::setw(10)
+                << change.pValue << "  "
+                << (change.verdict == Change::Verdict::SLOWER ? "❌ slower" : "✅ faster") << "\n";
+        }
+        out << std::string(96, '-') << "\n";
+    }
+
+    out << comparison.count(Change::Verdict::SLOWER) << " slower, " << comparison.count(Change::Verdict::FASTER)
+        << " faster, " << comparison.count(Change::Verdict::UNCHANGED) << " unchanged";
+    if (!comparison.added.empty()) out << ", " << comparison.added.size() << " not in baseline";
+    if (!comparison.missing.empty()) out << ", " << comparison.missing.size() << " missing from this run";
+    out << "\n";
+}
@@ -0,0 +1,76 @@
+#ifndef FORTH_BASELINE_H
+#define FORTH_BASELINE_H
+
+#include "driver/benchmark.h"
+#include <filesystem>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Benchmark baselines and regression comparison
+// ============================================================================
+//
+// A baseline is a JSON file that holds, for each benchmark program and phase,
+// the median and variance of its repetitions and the samples themselves.
+// `--benchmark DIR --baseline FILE` re-runs the suite and compares every
+// phase against it with a two-sided Mann-Whitney U test. A change counts
+// only when it is significant (p < alpha) and the medians differ by more
+// than the threshold. Any such slowdown fails the run.
+
+class ForthBenchmarkBaseline {
+public:
+    struct Phase {
+        std::vector<double> samples;   // Milliseconds, one per repetition
+        double median = 0.0;
+        double variance = 0.0;
+    };
+
+    // Program name -> phase name -> measurements
+    using Programs = std::map<std::string, std::map<std::string, Phase>>;
+
+    struct Options {
+        double alpha = 0.05;       // Significance level
+        double threshold = 0.05;   // Smallest relative change of the median that counts
+    };
+
+    struct Change {
+        enum class Verdict { UNCHANGED, FASTER, SLOWER };
+
+        std::string program;
+        std::string phase;
+        double baselineMedian = 0.0;
+        double currentMedian = 0.0;
+        double relativeChange = 0.0;   // (current - baseline) / baseline
+        double pValue = 1.0;
+        Verdict verdict = Verdict::UNCHANGED;
+    };
+
+    struct Comparison {
+        std::vector<Change> changes;   // Every phase measured in both runs
+        std::vector<std::string> added;     // Programs only in the current run
+        std::vector<std::string> missing;   // Programs only in the baseline
+
+        [[nodiscard]] auto count(Change::Verdict verdict) const -> size_t;
+        [[nodiscard]] auto hasRegression() const -> bool { return count(Change::Verdict::SLOWER) > 0; }
+    };
+
+    // Successful results only
+    [[nodiscard]] static auto fromResults(const std::vector<ForthBenchmark::ProgramResult>& results) -> Programs;
+
+    [[nodiscard]] static auto toJson(const Programs& programs) -> std::string;
+    static auto save(const std::filesystem::path& path, const Programs& programs) -> bool;
+    // Throws std::runtime_error for a missing or malformed file
+    [[nodiscard]] static auto load(const std::filesystem::path& path) -> Programs;
+
+    [[nodiscard]] static auto compare(const Programs& baseline, const Programs& current, const Options& options)
+        -> Comparison;
+    static auto printComparison(std::ostream& out, const Comparison& comparison, const Options& options) -> void;
+
+    // Two-sided p-value that the two samples come from the same distribution.
+    // Exact for small samples without ties, normal approximation otherwise.
+    [[nodiscard]] static auto mannWhitney(const std::vector<double>& a, const std::vector<double>& b) -> double;
+};
+
+#endif // FORTH_BASELINE_H
@@ -0,0 +1,416 @@
+#include "driver/batch.h"
+#include "driver/compile_cache.h"
+#include "driver/module_cache.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include "dictionary/dictionary.h"
+#include "semantic/analyzer.h"
+#include "codegen/c_backend.h"
+#include "common/thread_pool.h"
+#include "common/trace.h"
+#include "common/utils.h"
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+using namespace std::chrono;
+
+namespace {
+
+auto codegenTarget(const std::string& target) -> ForthCodegenFactory::TargetType {
+    return target == "esp32c3" ? ForthCodegenFactory::TargetType::ESP32_C3 :
+           target == "esp32s3" ? ForthCodegenFactory::TargetType::ESP32_S3 :
+                                 ForthCodegenFactory::TargetType::ESP32;
+}
+
+auto toMilliseconds(nanoseconds duration) -> double {
+    return duration_cast<microseconds>(duration).count() / 1000.0;
+}
+
+} // namespace
+
+ForthBatchCompiler::ForthBatchCompiler(Options options) : options(std::move(options)) {}
+
+auto ForthBatchCompiler::compile(const std::vector<std::string>& files) -> std::vector<Result> {
+    std::vector<Result> results(files.size());
+    const auto outputDirs = assignOutputDirs(files, options.outputRoot);
+
+    // Build the shared builtins before the workers race for them
+    (void)DictionaryFactory::sharedBuiltins();
+
+    const auto start = steady_clock::now();
+    // Shared modules are parsed here once; the programs only look them up
+    ForthModuleCache modules(options.jobs);
+    modules.preload(files);
+    ForthThreadPool::parallelFor(files.size(), options.jobs, [&](size_t index, size_t) {
+        results[index] = compileFile(files[index], outputDirs[index], options, nullptr, &modules);
+    });
+    wallTime = steady_clock::now() - start;
+
+    return results;
+}
+
+auto ForthBatchCompiler::assignOutputDirs(const std::vector<std::string>& files, const fs::path& root)
+    -> std::vector<fs::path> {
+    std::vector<fs::path> dirs;
+    std::unordered_map<std::string, size_t> uses;
+    for (const auto& file : files) {
+        std::string name = fs::path(file).stem().string();
+        if (name.empty()) name = "program";
+        const size_t use = ++uses[name];
+        dirs.push_back(root / (use == 1 ? name : name + "_" + std::to_string(use)));
+    }
+    return dirs;
+}
+
+auto ForthBatchCompiler::compileFile(const std::string& file, const fs::path& outputDir,
+                                     const Options& options, ForthCompileCache* cache,
+                                     ForthModuleCache* modules) -> Result {
+    ForthTrace::Span fileSpan("file", fs::path(file).filename().string(), file);
+    Result result;
+    result.file = file;
+    result.outputDir = outputDir;
+
+    std::ifstream input(file);
+    if (!input) {
+        result.errors.push_back("read: Cannot open file: " + file);
+        return result;
+    }
+    std::string source{std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}};
+    result.sourceBytes = source.size();
+
+    try {
+        auto mark = steady_clock::now();
+        auto lap = [&mark](nanoseconds& phase) {
+            const auto now = steady_clock::now();
+            phase = now - mark;
+            mark = now;
+        };
+
+        std::unique_ptr<ForthModuleCache> ownModules;
+        if (!modules && cache) {
+            modules = &cache->getModules();
+        } else if (!modules) {
+            ownModules = std::make_unique<ForthModuleCache>();
+            modules = ownModules.get();
+        }
+
+        std::shared_ptr<const ForthCompileCache::FrontEnd> front = cache ? cache->findFrontEnd(source) : nullptr;
+        // The same text is a different program once something it includes changed
+        if (front && !front->includes.empty() && modules->resolve(front->includes, file).key != front->modules.key) {
+            front = nullptr;
+        }
+        result.frontEndCached = front != nullptr;
+        if (!front) {
+            auto built = std::make_shared<ForthCompileCache::FrontEnd>();
+
+            ForthTrace::Span lexSpan("pass", "lex");
+            ForthLexer lexer;
+            const auto tokens = lexer.tokenize(source);
+            built->tokens = tokens.empty() ? 0 : tokens.size() - 1;
+            lexSpan.end();
+            lap(result.lex);
+
+            // Builtins are shared; this program's words go into the overlay,
+            // after those of the modules it includes
+            ForthTrace::Span parseSpan("pass", "parse");
+            built->includes = ForthModuleCache::findIncludes(tokens);
+            built->modules = modules->resolve(built->includes, file);
+            built->errors = built->modules.errors;
+            built->warnings = built->modules.warnings;
+            built->parser = std::make_unique<ForthParser>(DictionaryFactory::createOverlay());
+            if (built->errors.empty()) {
+                built->modules.importDefinitions(built->parser->getDictionary());
+                built->ast = built->parser->parseProgram(tokens);
+                built->modules.attach(*built->ast);
+            }
+            parseSpan.end();
+            lap(result.parse);
+            for (const auto& error : built->parser->getErrors()) {
+                built->errors.push_back("parse: " + error);
+            }
+
+            if (built->errors.empty()) {
+                // As in single-file mode, semantic issues do not stop code generation
+                ForthTrace::Span semanticSpan("pass", "semantic");
+                built->analyzer = std::make_unique<SemanticAnalyzer>(&built->parser->getDictionary());
+                built->modules.importWordEffects(*built->analyzer);
+                built->analyzer->analyze(*built->ast);
+                semanticSpan.end();
+                lap(result.semantic);
+                for (const auto& error : built->analyzer->getErrors()) {
+                    built->warnings.push_back("semantic: " + error);
+                }
+                for (const auto& warning : built->analyzer->getWarnings()) {
+                    built->warnings.push_back("semantic: " + warning);
+                }
+            }
+
+            built->source = std::move(source);
+            front = std::move(built);
+            if (cache) {
+                cache->storeFrontEnd(front);
+            }
+        }
+        result.tokens = front->tokens;
+        result.errors = front->errors;
+        result.warnings = front->warnings;
+        for (const auto& module : front->modules.modules) {
+            result.modules.push_back(module->path);
+        }
+        if (!front->errors.empty()) {
+            return result;
+        }
+
+        auto codegen = ForthCodegenFactory::create(codegenTarget(options.target));
+        codegen->setSemanticAnalyzer(front->analyzer.get());
+        codegen->setDictionary(&front->parser->getDictionary());
+        front->modules.importInterfaces(*codegen);
+        codegen->setShardCount(options.shards);
+        if (cache) {
+            codegen->setWordCache(&cache->getWordCache());
+        }
+        mark = steady_clock::now();
+        ForthTrace::Span codegenSpan("pass", "codegen");
+        const bool generated = codegen->generateCode(*front->ast) && !codegen->hasErrors();
+        codegenSpan.end();
+        lap(result.codegen);
+        for (const auto& error : codegen->getErrors()) {
+            result.errors.push_back("codegen: " + error);
+        }
+        for (const auto& warning : codegen->getWarnings()) {
+            result.warnings.push_back("codegen: " + warning);
+        }
+        if (!generated) {
+            return result;
+        }
+        const auto stats = codegen->getStatistics();
+        result.linesGenerated = stats.linesGenerated;
+        result.wordsFromCache = stats.wordsFromCache;
+
+        ForthTrace::Span writeSpan("pass", "write files");
+        const bool written = codegen->writeToFiles(outputDir.string());
+        writeSpan.end();
+        lap(result.write);
+        if (!written) {
+            result.errors.push_back("write: Cannot write " + outputDir.string());
+            return result;
+        }
+        const auto writeStats = codegen->getStatistics();
+        result.filesGenerated = writeStats.filesGenerated;
+        result.filesUnchanged = writeStats.filesUnchanged;
+        result.success = true;
+    } catch (const std::exception& e) {
+        result.errors.push_back(std::string("internal: ") + e.what());
+    }
+    return result;
+}
+
+auto ForthBatchCompiler::compileModule(const std::string& file, const fs::path& outputDir,
+                                       const Options& options, ForthModuleCache* modules) -> Result {
+    ForthTrace::Span fileSpan("module", fs::path(file).filename().string(), file);
+    Result result;
+    result.file = file;
+    result.outputDir = outputDir;
+
+    std::ifstream input(file);
+    if (!input) {
+        result.errors.push_back("read: Cannot open file: " + file);
+        return result;
+    }
+    const std::string source{std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}};
+    result.sourceBytes = source.size();
+
+    try {
+        ForthLexer lexer;
+        const auto tokens = lexer.tokenize(source);
+        result.tokens = tokens.empty() ? 0 : tokens.size() - 1;
+
+        ForthModuleCache ownModules;
+        const auto resolution = (modules ? *modules : ownModules).resolve(ForthModuleCache::findIncludes(tokens), file);
+        result.errors = resolution.errors;
+        result.warnings = resolution.warnings;
+        for (const auto& module : resolution.modules) {
+            result.modules.push_back(module->path);
+        }
+        if (!result.errors.empty()) {
+            return result;
+        }
+
+        ForthParser parser(DictionaryFactory::createOverlay());
+        resolution.importDefinitions(parser.getDictionary());
+        auto ast = parser.parseProgram(tokens);
+        resolution.attach(*ast);
+        for (const auto& error : parser.getErrors()) {
+            result.errors.push_back("parse: " + error);
+        }
+        if (!result.errors.empty()) {
+            return result;
+        }
+
+        SemanticAnalyzer analyzer(&parser.getDictionary());
+        resolution.importWordEffects(analyzer);
+        analyzer.analyze(*ast);
+        for (const auto& error : analyzer.getErrors()) {
+            result.warnings.push_back("semantic: " + error);
+        }
+        for (const auto& warning : analyzer.getWarnings()) {
+            result.warnings.push_back("semantic: " + warning);
+        }
+
+        auto codegen = ForthCodegenFactory::create(codegenTarget(options.target));
+        codegen->setModuleMode(fs::path(file).stem().string());
+        codegen->setSemanticAnalyzer(&analyzer);
+        codegen->setDictionary(&parser.getDictionary());
+        resolution.importInterfaces(*codegen);
+        const bool generated = codegen->generateCode(*ast) && !codegen->hasErrors();
+        for (const auto& error : codegen->getErrors()) {
+            result.errors.push_back("codegen: " + error);
+        }
+        if (!generated) {
+            return result;
+        }
+        result.linesGenerated = codegen->getStatistics().linesGenerated;
+
+        // Interfaces the fragment calls into, as seen from where it is written
+        auto interface = codegen->getModuleInterface(*ast);
+        interface.sourceHash = ChunkedBuffer::hashBytes(source);
+        fs::create_directories(outputDir);
+        for (const auto& module : resolution.modules) {
+            if (module->interface) {
+                interface.dependencies.push_back(
+                    fs::relative(module->path, fs::absolute(outputDir)).generic_string());
+            }
+        }
+
+        result.interface = outputDir / (fs::path(file).stem().string() + ".fi");
+        std::ofstream fragment(outputDir / interface.fragment);
+        fragment << codegen->getGeneratedFiles().front().second.str();
+        fragment.close();
+        if (!fragment || !interface.save(result.interface)) {
+            result.errors.push_back("write: Cannot write " + outputDir.string());
+            return result;
+        }
+        result.filesGenerated = 2;
+        result.success = true;
+    } catch (const std::exception& e) {
+        result.errors.push_back(std::string("internal: ") + e.what());
+    }
+    return result;
+}
+
+auto ForthBatchCompiler::expandResponseFiles(const std::vector<std::string>& args)
+    -> std::vector<std::string> {
+    std::vector<std::string> files;
+    for (const auto& arg : args) {
+        if (arg.size() < 2 || arg[0] != '@') {
+            files.push_back(arg);
+            continue;
+        }
+        std::ifstream list(arg.substr(1));
+        if (!list) {
+            throw std::runtime_error("Cannot open response file: " + arg.substr(1));
+        }
+        // Relative paths are relative to the response file
+        const fs::path dir = fs::path(arg.substr(1)).parent_path();
+        std::string line;
+        while (std::getline(list, line)) {
+            line = ForthUtils::trim(line);
+            if (line.empty() || line[0] == '#') continue;
+            const fs::path path(line);
+            files.push_back(path.is_absolute() ? line : (dir / path).string());
+        }
+    }
+    return files;
+}
+
+auto ForthBatchCompiler::printReport(std::ostream& out, const std::vector<Result>& results,
+                                     nanoseconds wallTime) -> void {
+    // Diagnostics, grouped by file in input order
+    size_t failed = 0, warned = 0;
+    for (const auto& result : results) {
+        failed += result.success ? 0 : 1;
+        warned += result.warnings.empty() ? 0 : 1;
+        for (const auto& error : result.errors) {
+            out << result.file << ": error: " << error << "\n";
+        }
+        for (const auto& warning : result.warnings) {
+            out << result.file << ": warning: " << warning << "\n";
+        }
+    }
+
+    out << "\n" << std::string(60, '=') << "\n";
+    out << "BATCH COMPILATION REPORT\n";
+    out << std::string(60, '=') << "\n";
+    out << std::left << std::setw(28) << "File" << std::right
+        << std::setw(8) << "Tokens" << std::setw(10) << "Parse ms"
+        << std::setw(10) << "Gen ms" << std::setw(10) << "Total ms" << "  Status\n";
+    out << std::string(72, '-') << "\n";
+
+    nanoseconds cpuTime{0};
+    size_t tokens = 0;
+    for (const auto& result : results) {
+        cpuTime += result.total();
+        tokens += result.tokens;
+        std::string name = fs::path(result.file).filename().string();
+        if (name.size() > 27) name = name.substr(0, 24) + "...";
+        out << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+            << std::setw(8) << result.tokens
+            << std::setw(10) << toMilliseconds(result.lex + result.parse)
+            << std::setw(10) << toMilliseconds(result.semantic + result.codegen)
+            << std::setw(10) << toMilliseconds(result.total())
+            << "  " << (result.success ? "ok" : "FAILED") << "\n";
+    }
+
+    const double wallSeconds = duration<double>(wallTime).count();
+    out << std::string(72, '-') << "\n";
+    out << results.size() << " files: " << (results.size() - failed) << " compiled, " << failed
+        << " failed, " << warned << " with warnings\n";
+    out << std::fixed << std::setprecision(1)
+        << "Wall time " << toMilliseconds(wallTime) << " ms, compile time " << toMilliseconds(cpuTime)
+        << " ms (" << (wallTime.count() > 0 ? static_cast<double>(cpuTime.count()) / wallTime.count() : 0.0)
+        << "x parallel)\n";
+    if (wallSeconds > 0) {
+        out << std::setprecision(0) << results.size() / wallSeconds << " files/s, "
+            << tokens / wallSeconds << " tokens/s\n";
+    }
+}
+
+auto ForthBatchCompiler::toJson(const std::vector<Result>& results, nanoseconds wallTime) -> std::string {
+    auto list = [](const std::vector<std::string>& items) {
+        std::string json = "[";
+        for (size_t i = 0; i < items.size(); i++) {
+            json += (i ? ", \"" : "\"") + ForthUtils::jsonEscape(items[i]) + "\"";
+        }
+        return json + "]";
+    };
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n";
+    json << "  \"wall_ms\": " << toMilliseconds(wallTime) << ",\n";
+    json << "  \"files\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        json << (i ? ",\n" : "\n") << "    {\"file\": \"" << ForthUtils::jsonEscape(result.file)
+             << "\", \"output\": \"" << ForthUtils::jsonEscape(result.outputDir.string())
+             << "\", \"success\": " << (result.success ? "true" : "false")
+             << ", \"source_bytes\": " << result.sourceBytes
+             << ", \"tokens\": " << result.tokens
+             << ", \"lines_generated\": " << result.linesGenerated
+             << ", \"lex_ms\": " << toMilliseconds(result.lex)
+             << ", \"parse_ms\": " << toMilliseconds(result.parse)
+             << ", \"semantic_ms\": " << toMilliseconds(result.semantic)
+             << ", \"codegen_ms\": " << toMilliseconds(result.codegen)
+             << ", \"write_ms\": " << toMilliseconds(result.write)
+             << ", \"errors\": " << list(result.errors)
+             << ", \"warnings\": " << list(result.warnings) << "}";
+    }
+    json << (results.empty() ? "]\n" : "\n  ]\n");
+    json << "}\n";
+    return json.str();
+}
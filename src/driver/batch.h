@@ -0,0 +1,103 @@
+#ifndef FORTH_BATCH_H
+#define FORTH_BATCH_H
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class ForthCompileCache;
+class ForthModuleCache;
+
+// ============================================================================
+// Batch compilation
+// ============================================================================
+//
+// Compiles many programs in one process on a thread pool. Every job parses
+// into an overlay on the process-wide builtin dictionary
+// (DictionaryFactory::sharedBuiltins), so the builtins are built once and
+// only ever read; the lexer, parser, analyzer and code generator are per
+// job. Each program is written to its own directory under the output root.
+// Modules the programs INCLUDE are loaded up front, in parallel, and each is
+// parsed and analyzed once for the whole batch.
+
+class ForthBatchCompiler {
+public:
+    struct Options {
+        std::string target = "esp32";
+        std::filesystem::path outputRoot = "forth_batch";
+        size_t jobs = 0;     // Concurrent compiles (0 = all cores)
+        size_t shards = 1;   // Word translation units per program
+    };
+
+    // Outcome of one program
+    struct Result {
+        std::string file;
+        std::filesystem::path outputDir;
+        bool success = false;
+        std::vector<std::string> errors;    // "phase: message"
+        std::vector<std::string> warnings;
+        std::vector<std::filesystem::path> modules;   // Files included, directly or not
+        std::filesystem::path interface;              // compileModule(): the .fi written
+        size_t sourceBytes = 0;
+        size_t tokens = 0;
+        size_t linesGenerated = 0;
+        bool frontEndCached = false;   // Lex, parse and analysis skipped
+        size_t wordsFromCache = 0;
+        size_t filesGenerated = 0;
+        size_t filesUnchanged = 0;     // Left untouched because their content was the same
+        std::chrono::nanoseconds lex{0};
+        std::chrono::nanoseconds parse{0};
+        std::chrono::nanoseconds semantic{0};
+        std::chrono::nanoseconds codegen{0};
+        std::chrono::nanoseconds write{0};
+
+        [[nodiscard]] auto total() const -> std::chrono::nanoseconds {
+            return lex + parse + semantic + codegen + write;
+        }
+    };
+
+    explicit ForthBatchCompiler(Options options);
+
+    // Compile every file; results come back in input order
+    auto compile(const std::vector<std::string>& files) -> std::vector<Result>;
+    [[nodiscard]] auto getWallTime() const -> std::chrono::nanoseconds { return wallTime; }
+
+    // Compile one program into outputDir on the calling thread, reusing
+    // and filling the caches when given. Without a module cache, the
+    // compile cache's is used, or else one just for this program.
+    [[nodiscard]] static auto compileFile(const std::string& file, const std::filesystem::path& outputDir,
+                                          const Options& options, ForthCompileCache* cache = nullptr,
+                                          ForthModuleCache* modules = nullptr) -> Result;
+
+    // Compile a library on its own (forth_compiler -c) into outputDir: its
+    // words as forth_module_<stem>.c and the interface as <stem>.fi, which
+    // programs REQUIRE in place of the source
+    [[nodiscard]] static auto compileModule(const std::string& file, const std::filesystem::path& outputDir,
+                                            const Options& options, ForthModuleCache* modules = nullptr)
+        -> Result;
+
+    // Replace "@list" arguments by the paths listed in the file, one per
+    // line; blank lines and lines starting with '#' are skipped
+    [[nodiscard]] static auto expandResponseFiles(const std::vector<std::string>& args)
+        -> std::vector<std::string>;
+
+    // root/<stem> per file, with a numeric suffix when two inputs share a stem
+    [[nodiscard]] static auto assignOutputDirs(const std::vector<std::string>& files,
+                                               const std::filesystem::path& root)
+        -> std::vector<std::filesystem::path>;
+
+    // Aggregated diagnostics and timing
+    static auto printReport(std::ostream& out, const std::vector<Result>& results,
+                            std::chrono::nanoseconds wallTime) -> void;
+    [[nodiscard]] static auto toJson(const std::vector<Result>& results, std::chrono::nanoseconds wallTime)
+        -> std::string;
+
+private:
+    Options options;
+    std::chrono::nanoseconds wallTime{0};
+};
+
+#endif // FORTH_BATCH_H
@@ -0,0 +1,425 @@
+#include "driver/benchmark.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include "dictionary/dictionary.h"
+#include "semantic/analyzer.h"
+#include "codegen/c_backend.h"
+#include "common/trace.h"
+#include "common/utils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <sys/resource.h>
+
+namespace fs = std::filesystem;
+using namespace std::chrono;
+
+namespace {
+
+auto countNodes(const ASTNode* node) -> size_t {
+    if (!node) return 0;
+    size_t count = 1;
+    for (const auto& child : node->getChildren()) {
+        count += countNodes(child.get());
+    }
+    if (node->getType() == ASTNode::NodeType::IF_STATEMENT) {
+        const auto* ifNode = static_cast<const IfStatementNode*>(node);
+        count += countNodes(ifNode->getCondition()) + countNodes(ifNode->getThenBranch()) +
+                 countNodes(ifNode->getElseBranch());
+    } else if (node->getType() == ASTNode::NodeType::BEGIN_UNTIL_LOOP) {
+        const auto* loop = static_cast<const BeginUntilLoopNode*>(node);
+        count += countNodes(loop->getBody()) + countNodes(loop->getCondition());
+    }
+    return count;
+}
+
+auto median(std::vector<nanoseconds> samples) -> nanoseconds {
+    if (samples.empty()) return nanoseconds{0};
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+auto perSecond(size_t count, nanoseconds elapsed) -> double {
+    return elapsed.count() > 0 ? count / duration<double>(elapsed).count() : 0.0;
+}
+
+auto toMilliseconds(nanoseconds duration) -> double {
+    return duration_cast<microseconds>(duration).count() / 1000.0;
+}
+
+auto peakResidentKilobytes() -> long {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+auto readFile(const fs::path& path) -> std::string {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open file: " + path.string());
+    }
+    return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+// Host entry point that times one call of the generated program
+constexpr const char* HOST_HARNESS = R"(#include <stdio.h>
+#include <time.h>
+
+void forth_program_main(void);
+
+int main(int argc, char** argv) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    forth_program_main();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    FILE* out = fopen(argv[1], "w");
+    if (!out) return 1;
+    fprintf(out, "%lld\n", (long long)(end.tv_sec - start.tv_sec) * 1000000000LL +
+                           (end.tv_nsec - start.tv_nsec));
+    fclose(out);
+    return 0;
+}
+)";
+
+} // namespace
+
+ForthBenchmark::ForthBenchmark(Options options) : options(std::move(options)) {}
+
+auto ForthBenchmark::synthesize(const std::string& generator, size_t size) -> std::string {
+    std::ostringstream program;
+    program << "\\ Synthetic benchmark program: " << generator << " " << size << "\n";
+    program << "variable acc\n";
+
+    if (generator == "wide") {
+        // Many small independent words, each called once from the top level
+        static const char* bodies[] = {
+            "DUP * 3 +", "2 * 1 -", "DUP 1 + *", "7 MOD 3 +", "3 - DUP *",
+            "9 SWAP -", "DUP 10 > IF 2 / ELSE 3 * THEN", "SWAP DROP 1+",
+        };
+        for (size_t i = 0; i < size; i++) {
+            program << ": w" << i << " " << (i % 97) << " + " << bodies[i % 8] << " 1000 MOD ;\n";
+        }
+        for (size_t i = 0; i < size; i++) {
+            program << i << " " << (i + 1) << " w" << i << " acc @ + acc !\n";
+        }
+    } else if (generator == "deep") {
+        // A call chain as long as the program
+        program << ": d0 1 + ;\n";
+        for (size_t i = 1; i < size; i++) {
+            program << ": d" << i << " d" << (i - 1) << " " << (i % 7) << " + 1000 MOD ;\n";
+        }
+        program << "0 d" << (size > 0 ? size - 1 : 0) << " acc !\n";
+    } else if (generator == "control") {
+        // Nested conditionals and loops in every word
+        for (size_t i = 0; i < size; i++) {
+            program << ": c" << i << "\n"
+                    << "  DUP " << (i % 5) << " > IF\n"
+                    << "    DUP 2 MOD 0= IF 3 * ELSE 1 + THEN\n"
+                    << "  ELSE\n"
+                    << "    BEGIN 1 + DUP " << (i % 9 + 3) << " > UNTIL\n"
+                    << "  THEN 1000 MOD ;\n";
+        }
+        for (size_t i = 0; i < size; i++) {
+            program << (i % 11) << " c" << i << " acc @ + acc !\n";
+        }
+    } else if (generator == "data") {
+        // Variables, constants and initialized tables read back by words
+        for (size_t i = 0; i < size; i++) {
+            switch (i % 3) {
+                case 0:
+                    program << "variable v" << i << " " << i << " v" << i << " !\n"
+                            << ": r" << i << " v" << i << " @ ;\n";
+                    break;
+                case 1:
+                    program << i << " constant k" << i << "\n"
+                            << ": r" << i << " k" << i << " 2 * ;\n";
+                    break;
+                default:
+                    program << "create t" << i << " " << i << " , " << (i + 1) << " , " << (i + 2) << " ,\n"
+                            << ": r" << i << " t" << i << " @ t" << i << " cell+ @ + ;\n";
+                    break;
+            }
+        }
+        for (size_t i = 0; i < size; i++) {
+            program << "r" << i << " acc @ + 1000000 MOD acc !\n";
+        }
+    } else {
+        throw std::runtime_error("Unknown benchmark generator: " + generator);
+    }
+
+    program << "acc @ . cr\n";
+    return program.str();
+}
+
+auto ForthBenchmark::loadProgram(const fs::path& path) -> std::string {
+    const std::string text = readFile(path);
+    if (path.extension() != ".gen") {
+        return text;
+    }
+
+    // "<generator> <size>", with '\' comments
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        line = ForthUtils::trim(line.substr(0, line.find('\\')));
+        if (line.empty()) continue;
+        std::istringstream fields(line);
+        std::string generator;
+        size_t size = 0;
+        if (!(fields >> generator >> size)) {
+            throw std::runtime_error("Expected '<generator> <size>' in " + path.string());
+        }
+        return synthesize(generator, size);
+    }
+    throw std::runtime_error("Empty generator file: " + path.string());
+}
+
+auto ForthBenchmark::run(const fs::path& corpus) -> std::vector<ProgramResult> {
+    std::vector<fs::path> programs;
+    for (const auto& entry : fs::recursive_directory_iterator(corpus)) {
+        const auto extension = entry.path().extension();
+        if (entry.is_regular_file() && (extension == ".fth" || extension == ".forth" || extension == ".gen")) {
+            programs.push_back(entry.path());
+        }
+    }
+    std::sort(programs.begin(), programs.end());
+
+    std::vector<ProgramResult> results;
+    for (const auto& path : programs) {
+        const fs::path relative = fs::relative(path, corpus);
+        const std::string group = std::distance(relative.begin(), relative.end()) > 1
+                                      ? relative.begin()->string() : "corpus";
+        try {
+            results.push_back(runProgram(relative.string(), group, loadProgram(path)));
+        } catch (const std::exception& e) {
+            ProgramResult failed;
+            failed.name = relative.string();
+            failed.group = group;
+            failed.error = e.what();
+            results.push_back(std::move(failed));
+        }
+    }
+    return results;
+}
+
+auto ForthBenchmark::runProgram(const std::string& name, const std::string& group, const std::string& source)
+    -> ProgramResult {
+    ProgramResult result;
+    result.name = name;
+    result.group = group;
+    result.sourceBytes = source.size();
+    const ForthTrace::AllocationCounting counting;  // Read below with tracing off
+
+    std::vector<nanoseconds> lex, parse, semantic, codegen;
+    const auto start = steady_clock::now();
+    for (size_t rep = 0; rep < options.minRepetitions || steady_clock::now() - start < options.minTime; rep++) {
+        // The first repetition also measures memory and keeps the output
+        const bool first = rep == 0;
+        const uint64_t liveBefore = ForthTrace::threadLiveBytes();
+        const uint64_t allocationsBefore = ForthTrace::threadAllocations().count;
+        ForthTrace::resetThreadPeak();
+
+        auto mark = steady_clock::now();
+        auto lap = [&](std::vector<nanoseconds>& samples, const char* phase) {
+            samples.push_back(steady_clock::now() - mark);
+            if (first) {
+                const uint64_t peak = ForthTrace::threadPeakBytes();
+                result.phasePeakBytes[phase] = peak - std::min(liveBefore, peak);
+                result.peakHeapBytes = std::max(result.peakHeapBytes, result.phasePeakBytes[phase]);
+                ForthTrace::resetThreadPeak();
+            }
+            mark = steady_clock::now();
+        };
+
+        ForthLexer lexer;
+        const auto tokens = lexer.tokenize(source);
+        lap(lex, "lex");
+
+        ForthParser parser(DictionaryFactory::createOverlay());
+        auto ast = parser.parseProgram(tokens);
+        lap(parse, "parse");
+        if (parser.hasErrors()) {
+            result.error = "parse: " + parser.getErrors().front();
+            return result;
+        }
+
+        SemanticAnalyzer analyzer(&parser.getDictionary());
+        analyzer.analyze(*ast);
+        lap(semantic, "semantic");
+
+        auto generator = ForthCodegenFactory::create(ForthCodegenFactory::TargetType::ESP32);
+        generator->setSemanticAnalyzer(&analyzer);
+        generator->setDictionary(&parser.getDictionary());
+        const bool generated = generator->generateCode(*ast) && !generator->hasErrors();
+        lap(codegen, "codegen");
+        if (!generated) {
+            result.error = "codegen: " + (generator->getErrors().empty() ? std::string("failed")
+                                                                        : generator->getErrors().front());
+            return result;
+        }
+
+        if (first) {
+            result.allocations = ForthTrace::threadAllocations().count - allocationsBefore;
+            result.tokens = tokens.empty() ? 0 : tokens.size() - 1;
+            result.nodes = countNodes(ast.get());
+            result.linesOfC = generator->getStatistics().linesGenerated;
+            if (options.runGenerated) {
+                const fs::path dir = options.workDir / ForthUtils::toLower(name);
+                if (generator->writeToFiles(dir.string())) {
+                    timeGeneratedProgram(name, dir.string(), result);
+                } else {
+                    result.runError = "Cannot write " + dir.string();
+                }
+            }
+        }
+        result.repetitions = rep + 1;
+    }
+
+    std::vector<nanoseconds> total(lex.size());
+    for (size_t i = 0; i < total.size(); i++) {
+        total[i] = lex[i] + parse[i] + semantic[i] + codegen[i];
+    }
+    result.lex = median(lex);
+    result.parse = median(parse);
+    result.semantic = median(semantic);
+    result.codegen = median(codegen);
+    result.samples["lex"] = std::move(lex);
+    result.samples["parse"] = std::move(parse);
+    result.samples["semantic"] = std::move(semantic);
+    result.samples["codegen"] = std::move(codegen);
+    result.samples["total"] = std::move(total);
+    result.success = true;
+    return result;
+}
+
+auto ForthBenchmark::timeGeneratedProgram(const std::string& name, const std::string& directory,
+                                          ProgramResult& result) -> void {
+    const fs::path dir(directory);
+    std::ofstream(dir / "bench_main.c") << HOST_HARNESS;
+
+    // main.c is the ESP-IDF entry point; the harness replaces it
+    std::string sources;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        const std::string file = entry.path().filename().string();
+        if (file.starts_with("forth_") && file.ends_with(".c")) {
+            sources += " " + ForthUtils::shellQuote(entry.path().string());
+        }
+    }
+    const fs::path binary = dir / "bench";
+    const fs::path log = dir / "build.log";
+    const std::string build = options.compiler + " -O2 -w -I" + ForthUtils::shellQuote(dir.string()) + sources +
+                              " " + ForthUtils::shellQuote((dir / "bench_main.c").string()) + " -o " +
+                              ForthUtils::shellQuote(binary.string()) + " > " +
+                              ForthUtils::shellQuote(log.string()) + " 2>&1";
+    if (std::system(build.c_str()) != 0) {
+        result.runError = "Failed to build " + name + " with " + options.compiler + " (see " + log.string() + ")";
+        return;
+    }
+
+    std::vector<nanoseconds> samples;
+    const fs::path timing = dir / "time.txt";
+    for (size_t i = 0; i < std::max<size_t>(1, options.runRepetitions); i++) {
+        const std::string command = ForthUtils::shellQuote(binary.string()) + " " +
+                                    ForthUtils::shellQuote(timing.string()) + " > /dev/null 2>&1";
+        long long nanos = -1;
+        if (std::system(command.c_str()) == 0) {
+            std::ifstream(timing) >> nanos;
+        }
+        if (nanos < 0) {
+            result.runError = "Generated program failed: " + binary.string();
+            return;
+        }
+        samples.push_back(nanoseconds{nanos});
+    }
+    result.runTime = median(samples);
+    result.samples["run"] = std::move(samples);
+}
+
+auto ForthBenchmark::printReport(std::ostream& out, const std::vector<ProgramResult>& results) -> void {
+    out << "\n" << std::string(60, '=') << "\n";
+    out << "COMPILER BENCHMARK (median per compile)\n";
+    out << std::string(60, '=') << "\n";
+    out << std::left << std::setw(26) << "Program" << std::right
+        << std::setw(9) << "Tokens" << std::setw(9) << "Nodes" << std::setw(9) << "C lines"
+        << std::setw(10) << "Mtok/s" << std::setw(10) << "Mnode/s" << std::setw(10) << "kLoC/s"
+        << std::setw(10) << "Heap KB" << std::setw(10) << "Total ms" << std::setw(10) << "Run ms" << "\n";
+    out << std::string(113, '-') << "\n";
+
+    std::string group;
+    for (const auto& result : results) {
+        if (result.group != group) {
+            group = result.group;
+            out << "[" << group << "]\n";
+        }
+        std::string name = result.name;
+        if (name.size() > 25) name = "..." + name.substr(name.size() - 22);
+        out << std::left << std::setw(26) << name << std::right;
+        if (!result.success) {
+            out << "FAILED: " << result.error << "\n";
+            continue;
+        }
+        out << std::fixed << std::setw(9) << result.tokens << std::setw(9) << result.nodes
+            << std::setw(9) << result.linesOfC << std::setprecision(2)
+            << std::setw(10) << perSecond(result.tokens, result.lex) / 1e6
+            << std::setw(10) << perSecond(result.nodes, result.parse + result.semantic) / 1e6
+            << std::setprecision(0) << std::setw(10) << perSecond(result.linesOfC, result.codegen) / 1e3
+            << std::setw(10) << result.peakHeapBytes / 1024.0 << std::setprecision(2)
+            << std::setw(10) << toMilliseconds(result.total());
+        if (result.runTime) {
+            out << std::setw(10) << toMilliseconds(*result.runTime);
+        } else if (!result.runError.empty()) {
+            out << "  " << result.runError;
+        }
+        out << "\n";
+    }
+
+    out << std::string(113, '-') << "\n";
+    out << "Peak resident set: " << peakResidentKilobytes() / 1024.0 << " MB\n";
+}
+
+auto ForthBenchmark::toJson(const std::vector<ProgramResult>& results) -> std::string {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n";
+    json << "  \"peak_rss_kb\": " << peakResidentKilobytes() << ",\n";
+    json << "  \"programs\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& result = results[i];
+        json << (i ? ",\n" : "\n") << "    {\"name\": \"" << ForthUtils::jsonEscape(result.name)
+             << "\", \"group\": \"" << ForthUtils::jsonEscape(result.group)
+             << "\", \"success\": " << (result.success ? "true" : "false");
+        if (!result.success) {
+            json << ", \"error\": \"" << ForthUtils::jsonEscape(result.error) << "\"}";
+            continue;
+        }
+        json << ", \"source_bytes\": " << result.sourceBytes
+             << ", \"tokens\": " << result.tokens
+             << ", \"nodes\": " << result.nodes
+             << ", \"lines_of_c\": " << result.linesOfC
+             << ", \"repetitions\": " << result.repetitions
+             << ", \"lex_ms\": " << toMilliseconds(result.lex)
+             << ", \"parse_ms\": " << toMilliseconds(result.parse)
+             << ", \"semantic_ms\": " << toMilliseconds(result.semantic)
+             << ", \"codegen_ms\": " << toMilliseconds(result.codegen)
+             << ", \"total_ms\": " << toMilliseconds(result.total())
+             << ", \"tokens_per_s\": " << perSecond(result.tokens, result.lex)
+             << ", \"parse_nodes_per_s\": " << perSecond(result.nodes, result.parse)
+             << ", \"semantic_nodes_per_s\": " << perSecond(result.nodes, result.semantic)
+             << ", \"c_lines_per_s\": " << perSecond(result.linesOfC, result.codegen)
+             << ", \"allocations\": " << result.allocations
+             << ", \"peak_heap_bytes\": " << result.peakHeapBytes;
+        if (result.runTime) {
+            json << ", \"run_ms\": " << toMilliseconds(*result.runTime);
+        } else if (!result.runError.empty()) {
+            json << ", \"run_error\": \"" << ForthUtils::jsonEscape(result.runError) << "\"";
+        }
+        json << "}";
+    }
+    json << (results.empty() ? "]\n" : "\n  ]\n");
+    json << "}\n";
+    return json.str();
+}
@@ -0,0 +1,89 @@
+#ifndef FORTH_BENCHMARK_H
+#define FORTH_BENCHMARK_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Compiler benchmark suite
+// ============================================================================
+//
+// `forth_compiler --benchmark DIR` compiles every program under DIR
+// repeatedly and reports per-phase throughput (tokens/s for the lexer, AST
+// nodes/s for the parser and analyzer, lines of C/s for the code generator)
+// with the median time of each phase, plus the heap high-water mark of one
+// compile. Programs are *.fth / *.forth files, or *.gen files that name a
+// synthetic generator and a size ("wide 20000"), so huge inputs need not be
+// checked in. With runGenerated the generated C is also built with the host
+// compiler and the run time of forth_program_main() is reported.
+
+class ForthBenchmark {
+public:
+    struct Options {
+        size_t minRepetitions = 3;
+        std::chrono::milliseconds minTime{200};   // Per program, across repetitions
+        bool runGenerated = false;
+        std::string compiler = "cc";
+        size_t runRepetitions = 5;
+        std::filesystem::path workDir = std::filesystem::temp_directory_path() / "forth_benchmark";
+    };
+
+    struct ProgramResult {
+        std::string name;     // Path relative to the corpus
+        std::string group;    // First directory below the corpus ("small", "huge", ...)
+        bool success = false;
+        std::string error;
+        size_t sourceBytes = 0;
+        size_t tokens = 0;
+        size_t nodes = 0;
+        size_t linesOfC = 0;
+        size_t repetitions = 0;
+        // Median of the repetitions
+        std::chrono::nanoseconds lex{0};
+        std::chrono::nanoseconds parse{0};
+        std::chrono::nanoseconds semantic{0};
+        std::chrono::nanoseconds codegen{0};
+        uint64_t allocations = 0;      // Per compile
+        uint64_t peakHeapBytes = 0;    // Live heap high-water mark during one compile
+        // The same mark reached within each phase ("lex", "parse", ...),
+        // counted from the heap held when the compile started
+        std::map<std::string, uint64_t> phasePeakBytes;
+        std::optional<std::chrono::nanoseconds> runTime;   // forth_program_main() on the host
+        std::string runError;
+        // Every repetition of each phase ("lex", "parse", "semantic",
+        // "codegen", "total", and "run" for the generated program)
+        std::map<std::string, std::vector<std::chrono::nanoseconds>> samples;
+
+        [[nodiscard]] auto total() const -> std::chrono::nanoseconds { return lex + parse + semantic + codegen; }
+    };
+
+    explicit ForthBenchmark(Options options);
+
+    // Benchmark every program under the corpus directory, in path order
+    auto run(const std::filesystem::path& corpus) -> std::vector<ProgramResult>;
+    auto runProgram(const std::string& name, const std::string& group, const std::string& source)
+        -> ProgramResult;
+
+    // Program text of a *.gen file, or of one generator at one size.
+    // Generators: wide (independent words), deep (call chain), control
+    // (nested IF/BEGIN), data (VARIABLE/CONSTANT/CREATE tables).
+    [[nodiscard]] static auto loadProgram(const std::filesystem::path& path) -> std::string;
+    [[nodiscard]] static auto synthesize(const std::string& generator, size_t size) -> std::string;
+
+    static auto printReport(std::ostream& out, const std::vector<ProgramResult>& results) -> void;
+    [[nodiscard]] static auto toJson(const std::vector<ProgramResult>& results) -> std::string;
+
+private:
+    Options options;
+
+    auto timeGeneratedProgram(const std::string& name, const std::string& directory, ProgramResult& result) -> void;
+};
+
+#endif // FORTH_BENCHMARK_H
@@ -0,0 +1,36 @@
+#include "driver/compile_cache.h"
+#include "codegen/output_buffer.h"
+
+ForthCompileCache::ForthCompileCache(size_t maxPrograms, size_t maxWords)
+    : maxPrograms(maxPrograms), wordCache(maxWords) {}
+
+auto ForthCompileCache::findFrontEnd(const std::string& source) -> std::shared_ptr<const FrontEnd> {
+    auto it = frontEnds.find(ChunkedBuffer::hashBytes(source));
+    // The hash only selects the entry; the text decides
+    if (it == frontEnds.end() || it->second->source != source) {
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    return it->second;
+}
+
+auto ForthCompileCache::storeFrontEnd(std::shared_ptr<const FrontEnd> frontEnd) -> void {
+    if (maxPrograms == 0) return;
+    const uint64_t key = ChunkedBuffer::hashBytes(frontEnd->source);
+    if (frontEnds.insert_or_assign(key, std::move(frontEnd)).second) {
+        insertionOrder.push_back(key);
+    }
+    while (frontEnds.size() > maxPrograms) {
+        frontEnds.erase(insertionOrder.front());
+        insertionOrder.pop_front();
+    }
+}
+
+auto ForthCompileCache::clear() -> void {
+    frontEnds.clear();
+    insertionOrder.clear();
+    wordCache.clear();
+    modules.clear();
+    hits = misses = 0;
+}
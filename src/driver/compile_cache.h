@@ -0,0 +1,64 @@
+#ifndef FORTH_COMPILE_CACHE_H
+#define FORTH_COMPILE_CACHE_H
+
+#include "parser/parser.h"
+#include "parser/ast.h"
+#include "semantic/analyzer.h"
+#include "codegen/c_backend.h"
+#include "driver/module_cache.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// Compilation caches kept by a long-running process
+// ============================================================================
+//
+// Front ends (tokens, AST, dictionary overlay and semantic results) are keyed
+// by source text, so an unchanged file skips lexing, parsing and analysis
+// whatever its path, as long as the modules it includes are unchanged too.
+// Included modules live in a ForthModuleCache. Word definitions are reused
+// through the code generator's ForthWordCodeCache. Front ends are never modified once cached;
+// the cache itself is not thread-safe.
+
+class ForthCompileCache {
+public:
+    struct FrontEnd {
+        std::string source;
+        size_t tokens = 0;
+        std::unique_ptr<ForthParser> parser;          // Owns the dictionary overlay
+        std::unique_ptr<ProgramNode> ast;
+        std::unique_ptr<SemanticAnalyzer> analyzer;   // Null after parse errors
+        std::vector<std::string> includes;            // INCLUDE/REQUIRE file names
+        ForthModuleCache::Resolution modules;         // What they resolved to
+        std::vector<std::string> errors;              // "phase: message"
+        std::vector<std::string> warnings;
+    };
+
+    explicit ForthCompileCache(size_t maxPrograms = 256, size_t maxWords = 65536);
+
+    [[nodiscard]] auto findFrontEnd(const std::string& source) -> std::shared_ptr<const FrontEnd>;
+    auto storeFrontEnd(std::shared_ptr<const FrontEnd> frontEnd) -> void;
+    [[nodiscard]] auto getWordCache() -> ForthWordCodeCache& { return wordCache; }
+    [[nodiscard]] auto getModules() -> ForthModuleCache& { return modules; }
+    auto clear() -> void;
+
+    [[nodiscard]] auto getProgramCount() const -> size_t { return frontEnds.size(); }
+    [[nodiscard]] auto getHits() const -> size_t { return hits; }
+    [[nodiscard]] auto getMisses() const -> size_t { return misses; }
+
+private:
+    size_t maxPrograms;
+    std::unordered_map<uint64_t, std::shared_ptr<const FrontEnd>> frontEnds;
+    std::deque<uint64_t> insertionOrder;
+    ForthWordCodeCache wordCache;
+    ForthModuleCache modules;
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+#endif // FORTH_COMPILE_CACHE_H
@@ -0,0 +1,406 @@
+#include "driver/daemon.h"
+#include "driver/batch.h"
+#include "common/utils.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace std::chrono;
+
+namespace {
+
+constexpr uint32_t MAX_FRAME_SIZE = 64u << 20;
+
+auto sendAll(int fd, const void* data, size_t size) -> bool {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t sent = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+auto receiveAll(int fd, void* data, size_t size) -> bool {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        const ssize_t received = ::recv(fd, bytes, size, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return false;
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+auto sendFrame(int fd, char tag, std::string_view payload) -> bool {
+    const auto size = static_cast<uint32_t>(payload.size());
+    const unsigned char header[5] = {static_cast<unsigned char>(tag),
+                                     static_cast<unsigned char>(size), static_cast<unsigned char>(size >> 8),
+                                     static_cast<unsigned char>(size >> 16), static_cast<unsigned char>(size >> 24)};
+    return sendAll(fd, header, sizeof(header)) && sendAll(fd, payload.data(), payload.size());
+}
+
+auto receiveFrame(int fd, char& tag, std::string& payload) -> bool {
+    unsigned char header[5];
+    if (!receiveAll(fd, header, sizeof(header))) return false;
+    const uint32_t size = header[1] | header[2] << 8 | header[3] << 16 | static_cast<uint32_t>(header[4]) << 24;
+    if (size > MAX_FRAME_SIZE) return false;
+    tag = static_cast<char>(header[0]);
+    payload.resize(size);
+    return receiveAll(fd, payload.data(), size);
+}
+
+auto socketAddress(const fs::path& path, sockaddr_un& address) -> bool {
+    const std::string text = path.string();
+    if (text.empty() || text.size() >= sizeof(address.sun_path)) return false;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, text.c_str(), text.size() + 1);
+    return true;
+}
+
+// Connected stream socket, or -1
+auto connectTo(const fs::path& path) -> int {
+    sockaddr_un address;
+    if (!socketAddress(path, address)) return -1;
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Whether the process at the other end of a connected socket runs as this user
+auto peerIsUser(int fd) -> bool {
+#if defined(SO_PEERCRED)
+    ucred credentials{};
+    socklen_t length = sizeof(credentials);
+    return ::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0 &&
+           credentials.uid == ::getuid();
+#else
+    uid_t uid = 0;
+    gid_t gid = 0;
+    return ::getpeereid(fd, &uid, &gid) == 0 && uid == ::getuid();
+#endif
+}
+
+// A socket path is only used when no other user can have put a file there
+// or replace it: the directory is ours or root's, not writable by others
+// unless sticky (as /tmp), and an existing file at the path is ours
+auto checkSocketPath(const fs::path& path, std::string& error) -> bool {
+    const fs::path directory = path.has_parent_path() ? path.parent_path() : fs::path(".");
+    struct stat info{};
+    if (::stat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+        error = "Socket directory does not exist: " + directory.string();
+        return false;
+    }
+    const bool othersWrite = (info.st_mode & (S_IWGRP | S_IWOTH)) != 0 && (info.st_mode & S_ISVTX) == 0;
+    if ((info.st_uid != ::getuid() && info.st_uid != 0) || othersWrite) {
+        error = "Socket directory " + directory.string() + " is not private to this user";
+        return false;
+    }
+    if (::lstat(path.c_str(), &info) == 0 && info.st_uid != ::getuid()) {
+        error = "Socket path " + path.string() + " is owned by another user";
+        return false;
+    }
+    return true;
+}
+
+auto toMilliseconds(nanoseconds duration) -> double {
+    return duration_cast<microseconds>(duration).count() / 1000.0;
+}
+
+} // namespace
+
+ForthCompileServer::ForthCompileServer(Options options)
+    : options(std::move(options)),
+      cache(this->options.cachedPrograms, this->options.cachedWords),
+      startTime(steady_clock::now()) {}
+
+ForthCompileServer::~ForthCompileServer() {
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        std::error_code ignored;
+        fs::remove(options.socketPath, ignored);
+    }
+}
+
+auto ForthCompileServer::defaultSocketPath() -> fs::path {
+    if (const char* runtimeDir = std::getenv("XDG_RUNTIME_DIR"); runtimeDir && *runtimeDir) {
+        return fs::path(runtimeDir) / "forth_compiler.sock";
+    }
+    return fs::path("/tmp") / ("forth_compiler-" + std::to_string(::getuid())) / "daemon.sock";
+}
+
+auto ForthCompileServer::listen() -> bool {
+    sockaddr_un address;
+    if (!socketAddress(options.socketPath, address)) {
+        error = "Socket path is empty or too long: " + options.socketPath.string();
+        return false;
+    }
+
+    // The /tmp fallback lives in a directory only the user can enter; one
+    // somebody else created first fails the check below
+    if (const fs::path directory = options.socketPath.parent_path(); !directory.empty()) {
+        if (::mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST) {
+            error = "Cannot create " + directory.string() + ": " + std::strerror(errno);
+            return false;
+        }
+    }
+    if (!checkSocketPath(options.socketPath, error)) {
+        return false;
+    }
+
+    // Only a file nobody answers on is ours to replace
+    if (const int live = connectTo(options.socketPath); live >= 0) {
+        ::close(live);
+        error = "A compile daemon is already listening on " + options.socketPath.string();
+        return false;
+    }
+    std::error_code ignored;
+    fs::remove(options.socketPath, ignored);
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        error = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+    // The socket accepts compile requests, so it is private to the user
+    const mode_t savedMask = ::umask(0077);
+    const int bound = ::bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    ::umask(savedMask);
+    if (bound != 0 || ::listen(listenFd, 16) != 0) {
+        error = "Cannot listen on " + options.socketPath.string() + ": " + std::strerror(errno);
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    return true;
+}
+
+auto ForthCompileServer::serve() -> void {
+    while (!stopping && listenFd >= 0) {
+        const int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            error = std::string("accept: ") + std::strerror(errno);
+            return;
+        }
+        // Requests name files to read and write, so only the user may send them
+        if (!peerIsUser(fd)) {
+            ::close(fd);
+            if (options.log) *options.log << "Refused a connection from another user" << std::endl;
+            continue;
+        }
+        serveConnection(fd);
+        ::close(fd);
+    }
+
+    // Stop taking connections as soon as we are asked to shut down
+    if (stopping && listenFd >= 0) {
+        ::close(listenFd);
+        listenFd = -1;
+        std::error_code ignored;
+        fs::remove(options.socketPath, ignored);
+    }
+}
+
+auto ForthCompileServer::serveConnection(int fd) -> void {
+    // A client that stops sending or reading mid-request must not stall
+    // the daemon; once a reply times out the rest of it is dropped
+    timeval timeout{10, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    fs::path cwd;
+    std::vector<std::string> args;
+    for (;;) {
+        char tag = 0;
+        std::string payload;
+        if (!receiveFrame(fd, tag, payload)) return;
+        if (tag == 'C') {
+            cwd = payload;
+        } else if (tag == 'A') {
+            args.push_back(std::move(payload));
+        } else if (tag == 'E') {
+            break;
+        } else {
+            return;
+        }
+    }
+
+    const auto start = steady_clock::now();
+    int status = 1;
+    bool connected = true;
+    auto send = [fd, &connected](char tag, std::string_view text) {
+        connected = connected && sendFrame(fd, tag, text);
+    };
+    try {
+        status = handleRequest(args, cwd, send);
+    } catch (const std::exception& e) {
+        send('R', std::string("internal: ") + e.what() + "\n");
+    }
+    send('X', std::to_string(status));
+
+    if (options.log) {
+        *options.log << "[" << requestCount << "]";
+        for (const auto& arg : args) *options.log << " " << arg;
+        *options.log << " -> " << status << " (" << std::fixed << std::setprecision(2)
+                     << toMilliseconds(steady_clock::now() - start) << " ms)" << std::endl;
+    }
+}
+
+auto ForthCompileServer::handleRequest(const std::vector<std::string>& args, const fs::path& cwd,
+                                       const Reply& reply) -> int {
+    requestCount++;
+    auto resolve = [&cwd](const std::string& path) {
+        return fs::path(path).is_absolute() || cwd.empty() ? fs::path(path) : cwd / path;
+    };
+
+    ForthBatchCompiler::Options batchOptions;
+    batchOptions.outputRoot = resolve(batchOptions.outputRoot.string());
+    std::vector<std::string> inputs;
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        if (arg == "--shutdown") {
+            stopping = true;
+            reply('O', "Compile daemon stopping\n");
+            return 0;
+        } else if (arg == "--status") {
+            auto& words = cache.getWordCache();
+            std::ostringstream status;
+            status << "Compile daemon on " << options.socketPath.string() << ", up "
+                   << duration_cast<seconds>(steady_clock::now() - startTime).count() << " s, "
+                   << requestCount << " requests\n"
+                   << "  Programs cached: " << cache.getProgramCount() << " (" << cache.getHits()
+                   << " hits, " << cache.getMisses() << " misses)\n"
+                   << "  Words cached:    " << words.size() << " (" << words.getHits() << " hits, "
+                   << words.getMisses() << " misses)\n"
+                   << "  Modules cached:  " << cache.getModules().getModuleCount() << " ("
+                   << cache.getModules().getHits() << " hits, " << cache.getModules().getParses()
+                   << " parsed)\n";
+            reply('O', status.str());
+            return 0;
+        } else if ((arg == "-o" || arg == "--output") && i + 1 < args.size()) {
+            batchOptions.outputRoot = resolve(args[++i]);
+        } else if (arg == "--target" && i + 1 < args.size()) {
+            batchOptions.target = args[++i];
+        } else if (arg == "--shards" && i + 1 < args.size()) {
+            batchOptions.shards = static_cast<size_t>(std::max(1, std::atoi(args[++i].c_str())));
+        } else if (arg == "-j" || arg == "--jobs") {
+            // The caches are not thread-safe: requests compile one file at a time
+            reply('R', "The compile daemon compiles one file at a time; " + arg + " is not supported\n");
+            return 2;
+        } else if (arg.size() > 1 && arg[0] == '@') {
+            inputs.push_back(std::string(1, '@').append(resolve(arg.substr(1)).string()));
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            reply('R', "Option not supported by the compile daemon: " + arg + "\n");
+            return 2;
+        } else {
+            inputs.push_back(resolve(arg).string());
+        }
+    }
+
+    const auto files = ForthBatchCompiler::expandResponseFiles(inputs);
+    if (files.empty()) {
+        reply('R', "No input files\n");
+        return 2;
+    }
+
+    // Same output layout as --batch; each file is reported as it finishes
+    const auto outputDirs = ForthBatchCompiler::assignOutputDirs(files, batchOptions.outputRoot);
+    const auto start = steady_clock::now();
+    size_t failed = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        const auto result = ForthBatchCompiler::compileFile(files[i], outputDirs[i], batchOptions, &cache);
+        std::string diagnostics;
+        for (const auto& message : result.errors) {
+            diagnostics += result.file + ": error: " + message + "\n";
+        }
+        for (const auto& message : result.warnings) {
+            diagnostics += result.file + ": warning: " + message + "\n";
+        }
+        if (!diagnostics.empty()) {
+            reply('R', diagnostics);
+        }
+
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2) << result.file;
+        if (result.success) {
+            line << " -> " << result.outputDir.string() << " (" << result.linesGenerated << " lines, "
+                 << toMilliseconds(result.total()) << " ms";
+            if (result.frontEndCached) line << ", front end cached";
+            if (result.wordsFromCache > 0) line << ", " << result.wordsFromCache << " words cached";
+            line << ")\n";
+        } else {
+            line << ": FAILED\n";
+            failed++;
+        }
+        reply('O', line.str());
+    }
+
+    std::ostringstream summary;
+    summary << std::fixed << std::setprecision(2) << files.size() << " files: " << (files.size() - failed)
+            << " compiled, " << failed << " failed in " << toMilliseconds(steady_clock::now() - start)
+            << " ms\n";
+    reply('O', summary.str());
+    return failed == 0 ? 0 : 1;
+}
+
+auto ForthCompileServer::runClient(const fs::path& socketPath, const std::vector<std::string>& args,
+                                   std::ostream& out, std::ostream& err) -> int {
+    std::string refused;
+    if (!checkSocketPath(socketPath, refused)) {
+        err << refused << "\n";
+        return -1;
+    }
+    const int fd = connectTo(socketPath);
+    if (fd < 0) {
+        return -1;
+    }
+    // Source paths and contents only go to a daemon of the same user
+    if (!peerIsUser(fd)) {
+        ::close(fd);
+        err << "Compile daemon on " << socketPath.string() << " runs as another user\n";
+        return -1;
+    }
+
+    std::error_code ignored;
+    bool sent = sendFrame(fd, 'C', fs::current_path(ignored).string());
+    for (const auto& arg : args) {
+        sent = sent && sendFrame(fd, 'A', arg);
+    }
+    sent = sent && sendFrame(fd, 'E', {});
+
+    int status = 1;
+    char tag = 0;
+    std::string payload;
+    while (sent && receiveFrame(fd, tag, payload)) {
+        if (tag == 'O') {
+            out << payload << std::flush;
+        } else if (tag == 'R') {
+            err << payload << std::flush;
+        } else if (tag == 'X') {
+            status = std::atoi(payload.c_str());
+            ::close(fd);
+            return status;
+        }
+    }
+    ::close(fd);
+    err << "Compile daemon closed the connection\n";
+    return status;
+}
@@ -0,0 +1,85 @@
+#ifndef FORTH_DAEMON_H
+#define FORTH_DAEMON_H
+
+#include "driver/compile_cache.h"
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// Compile daemon
+// ============================================================================
+//
+// `forth_compiler --daemon` keeps one process alive on a Unix domain socket,
+// so editor and CI loops skip process start-up and dictionary construction
+// on every compile. Programs whose text has not changed reuse their cached
+// front end, and unchanged word definitions are copied from earlier output
+// (ForthCompileCache). `forth_compiler --client ...` forwards its command
+// line and working directory and prints what the daemon streams back.
+//
+// Wire format: frames of a tag byte, a 32-bit little-endian payload length
+// and the payload. The client sends 'C' (working directory), one 'A' per
+// argument and an empty 'E'. The daemon answers with 'O' (output) and 'R'
+// (diagnostics) frames as each file finishes and ends with 'X' carrying the
+// exit status. Requests are served one at a time, and each compiles its
+// files one after another (-j is refused).
+
+class ForthCompileServer {
+public:
+    struct Options {
+        std::filesystem::path socketPath = defaultSocketPath();
+        size_t cachedPrograms = 256;
+        size_t cachedWords = 65536;
+        std::ostream* log = nullptr;   // One line per request
+    };
+
+    // Sink for one request's output: tag 'O' or 'R' and the text
+    using Reply = std::function<void(char tag, std::string_view text)>;
+
+    explicit ForthCompileServer(Options options);
+    ~ForthCompileServer();
+    ForthCompileServer(const ForthCompileServer&) = delete;
+    ForthCompileServer& operator=(const ForthCompileServer&) = delete;
+
+    // Bind the socket; a stale socket file is replaced, a live daemon is not.
+    // A missing parent directory is created 0700; a directory or socket
+    // file other users control is refused.
+    [[nodiscard]] auto listen() -> bool;
+    // Serve connections until a request asks for --shutdown. Connections
+    // from processes of other users are closed unanswered.
+    auto serve() -> void;
+
+    // Run one forwarded command line: the --batch options and files, or
+    // --status / --shutdown. Relative paths are taken from cwd.
+    auto handleRequest(const std::vector<std::string>& args, const std::filesystem::path& cwd,
+                       const Reply& reply) -> int;
+
+    [[nodiscard]] auto getError() const -> const std::string& { return error; }
+    [[nodiscard]] auto getCache() -> ForthCompileCache& { return cache; }
+
+    // $XDG_RUNTIME_DIR/forth_compiler.sock, else /tmp/forth_compiler-<uid>/daemon.sock
+    [[nodiscard]] static auto defaultSocketPath() -> std::filesystem::path;
+
+    // Client side. Returns the daemon's exit status, or -1 when no daemon
+    // of this user answers on socketPath.
+    static auto runClient(const std::filesystem::path& socketPath, const std::vector<std::string>& args,
+                          std::ostream& out, std::ostream& err) -> int;
+
+private:
+    Options options;
+    ForthCompileCache cache;
+    int listenFd = -1;
+    bool stopping = false;
+    size_t requestCount = 0;
+    std::chrono::steady_clock::time_point startTime;
+    std::string error;
+
+    auto serveConnection(int fd) -> void;
+};
+
+#endif // FORTH_DAEMON_H
@@ -0,0 +1,413 @@
+#include "driver/differential.h"
+#include "driver/program_generator.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include "dictionary/dictionary.h"
+#include "semantic/analyzer.h"
+#include "codegen/c_backend.h"
+#include "interpreter/interpreter.h"
+#include "common/utils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+using namespace std::chrono;
+
+namespace {
+
+auto median(std::vector<nanoseconds> samples) -> nanoseconds {
+    if (samples.empty()) return nanoseconds{0};
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+auto toMilliseconds(nanoseconds duration) -> double {
+    return duration_cast<microseconds>(duration).count() / 1000.0;
+}
+
+auto readFile(const fs::path& path) -> std::string {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open file: " + path.string());
+    }
+    return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+// Host entry point: runs the program once, then writes its wall time,
+// retired instructions (-1 when perf events are unavailable) and the
+// final data stack to argv[1]. The program's own output goes to stdout.
+constexpr const char* HOST_HARNESS = R"(#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "forth_runtime.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+void forth_program_main(void);
+
+static int forth_open_instruction_counter(void) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+int main(int argc, char** argv) {
+    struct timespec start, end;
+    long long instructions = -1;
+    int counter = forth_open_instruction_counter();
+#ifdef __linux__
+    if (counter >= 0) {
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    forth_program_main();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+#ifdef __linux__
+    if (counter >= 0) {
+        ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(counter, &instructions, sizeof(instructions)) != (ssize_t)sizeof(instructions)) {
+            instructions = -1;
+        }
+        close(counter);
+    }
+#endif
+    fflush(stdout);
+    FILE* out = argc > 1 ? fopen(argv[1], "w") : NULL;
+    if (!out) return 1;
+    fprintf(out, "%lld %lld %zu", (long long)(end.tv_sec - start.tv_sec) * 1000000000LL +
+                                  (end.tv_nsec - start.tv_nsec), instructions, forth_data_stack.ptr);
+    for (size_t i = 0; i < forth_data_stack.ptr; i++) {
+        fprintf(out, " %ld", (long)forth_data_stack.data[i]);
+    }
+    fprintf(out, "\n");
+    fclose(out);
+    return 0;
+}
+)";
+
+} // namespace
+
+ForthDifferential::ForthDifferential(Options options) : options(std::move(options)) {}
+
+auto ForthDifferential::configurations() -> const std::vector<Configuration>& {
+    static const std::vector<Configuration> all = {
+        {"interpreter", -1},
+        {"c-O0", 0},
+        {"c-O1", 1},
+        {"c-O2", 2},
+    };
+    return all;
+}
+
+auto ForthDifferential::statusName(Run::Status status) -> const char* {
+    switch (status) {
+        case Run::Status::OK: return "ok";
+        case Run::Status::MISMATCH: return "MISMATCH";
+        case Run::Status::FAILED: return "failed";
+        case Run::Status::UNSUPPORTED: return "unsupported";
+    }
+    return "failed";
+}
+
+auto ForthDifferential::ProgramResult::agrees() const -> bool {
+    return std::none_of(runs.begin(), runs.end(),
+                        [](const Run& run) { return run.status == Run::Status::MISMATCH; });
+}
+
+auto ForthDifferential::run(const std::vector<fs::path>& directories) -> std::vector<ProgramResult> {
+    std::vector<ProgramResult> results;
+    for (const auto& directory : directories) {
+        std::vector<fs::path> programs;
+        for (const auto& entry : fs::recursive_directory_iterator(directory)) {
+            const auto extension = entry.path().extension();
+            if (entry.is_regular_file() && (extension == ".fth" || extension == ".forth")) {
+                programs.push_back(entry.path());
+            }
+        }
+        std::sort(programs.begin(), programs.end());
+        for (const auto& path : programs) {
+            const std::string name = (directory.filename() / fs::relative(path, directory)).string();
+            try {
+                results.push_back(runProgram(name, readFile(path)));
+            } catch (const std::exception& e) {
+                ProgramResult failed;
+                failed.name = name;
+                Run run;
+                run.configuration = configurations().front().name;
+                run.error = e.what();
+                failed.runs.push_back(std::move(run));
+                results.push_back(std::move(failed));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < options.generated; i++) {
+        ForthProgramGenerator::Options generator;
+        generator.seed = options.seed + i;
+        generator.words = 4 + i % 8;
+        generator.recursion = 15;
+        results.push_back(runProgram("generated/seed-" + std::to_string(generator.seed),
+                                     ForthProgramGenerator(generator).generate()));
+    }
+    return results;
+}
+
+auto ForthDifferential::runProgram(const std::string& name, const std::string& source) -> ProgramResult {
+    ProgramResult result;
+    result.name = name;
+    for (const auto& configuration : configurations()) {
+        Run run;
+        run.configuration = configuration.name;
+        if (configuration.optimizationLevel < 0) {
+            interpret(source, run);
+        } else {
+            compileAndRun(name, source, configuration.optimizationLevel, run);
+        }
+        result.runs.push_back(std::move(run));
+    }
+
+    // The first configuration that ran is the reference for the others
+    const auto reference = std::find_if(result.runs.begin(), result.runs.end(),
+                                        [](const Run& run) { return run.status == Run::Status::OK; });
+    if (reference == result.runs.end()) return result;
+    result.reference = reference->configuration;
+    for (auto& run : result.runs) {
+        if (run.status == Run::Status::OK && (run.output != reference->output || run.stack != reference->stack)) {
+            run.status = Run::Status::MISMATCH;
+        }
+    }
+    return result;
+}
+
+auto ForthDifferential::interpret(const std::string& source, Run& run) -> void {
+    ForthLexer lexer;
+    ForthParser parser(DictionaryFactory::createOverlay());
+    auto ast = parser.parseProgram(lexer.tokenize(source));
+    if (parser.hasErrors()) {
+        run.error = "parse: " + parser.getErrors().front();
+        return;
+    }
+
+    ForthInterpreter::Options interpreterOptions;
+    interpreterOptions.maxSteps = options.maxSteps;
+    std::vector<nanoseconds> samples;
+    for (size_t i = 0; i < std::max<size_t>(1, options.runRepetitions); i++) {
+        ForthInterpreter interpreter(interpreterOptions);
+        const auto start = steady_clock::now();
+        try {
+            interpreter.run(*ast);
+        } catch (const ForthInterpreter::Unsupported& e) {
+            run.status = Run::Status::UNSUPPORTED;
+            run.error = e.what();
+            return;
+        } catch (const ForthInterpreter::Error& e) {
+            run.error = e.what();  // The program fails; status stays FAILED
+            return;
+        }
+        samples.push_back(steady_clock::now() - start);
+        if (i == 0) {
+            run.output = interpreter.getOutput();
+            run.stack = interpreter.getStack();
+            run.instructions = interpreter.getSteps();
+        }
+    }
+    run.wallTime = median(samples);
+    run.status = Run::Status::OK;
+}
+
+auto ForthDifferential::compileAndRun(const std::string& name, const std::string& source, int level, Run& run)
+    -> void {
+    ForthLexer lexer;
+    ForthParser parser(DictionaryFactory::createOverlay());
+    auto ast = parser.parseProgram(lexer.tokenize(source));
+    if (parser.hasErrors()) {
+        run.error = "parse: " + parser.getErrors().front();
+        return;
+    }
+    SemanticAnalyzer analyzer(&parser.getDictionary());
+    analyzer.analyze(*ast);
+
+    auto generator = ForthCodegenFactory::create(ForthCodegenFactory::TargetType::ESP32);
+    generator->setSemanticAnalyzer(&analyzer);
+    generator->setDictionary(&parser.getDictionary());
+    generator->setOptimizationLevel(level);
+    if (!generator->generateCode(*ast) || generator->hasErrors()) {
+        run.error = "codegen: " + (generator->getErrors().empty() ? std::string("failed")
+                                                                  : generator->getErrors().front());
+        return;
+    }
+
+    std::string directoryName = ForthUtils::toLower(name);
+    std::replace(directoryName.begin(), directoryName.end(), '/', '_');
+    const fs::path dir = options.workDir / directoryName / run.configuration;
+    std::error_code ignored;
+    fs::remove_all(dir, ignored);
+    if (!generator->writeToFiles(dir.string())) {
+        run.error = "Cannot write " + dir.string();
+        return;
+    }
+    std::ofstream(dir / "differential_main.c") << HOST_HARNESS;
+
+    // main.c is the ESP-IDF entry point; the harness replaces it
+    std::string sources;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        const std::string file = entry.path().filename().string();
+        if (file.starts_with("forth_") && file.ends_with(".c")) {
+            sources += " " + ForthUtils::shellQuote(entry.path().string());
+        }
+    }
+    const fs::path binary = dir / "program";
+    const fs::path log = dir / "build.log";
+    // String addresses are machine addresses in 32-bit cells; a non-PIE
+    // binary keeps its string pool below 4 GiB
+    const std::string build = options.compiler + " -O2 -Wall -Wextra -no-pie -I" + ForthUtils::shellQuote(dir.string()) + sources +
+                              " " + ForthUtils::shellQuote((dir / "differential_main.c").string()) + " -o " +
+                              ForthUtils::shellQuote(binary.string()) + " > " +
+                              ForthUtils::shellQuote(log.string()) + " 2>&1";
+    if (std::system(build.c_str()) != 0) {
+        run.error = "Failed to build with " + options.compiler + " (see " + log.string() + ")";
+        return;
+    }
+    {
+        std::istringstream lines(readFile(log));
+        for (std::string line; std::getline(lines, line);) {
+            if (line.find("warning:") != std::string::npos) run.warnings.push_back(line);
+        }
+    }
+
+    std::vector<nanoseconds> samples;
+    const fs::path report = dir / "result.txt";
+    const fs::path stdoutPath = dir / "stdout.txt";
+    for (size_t i = 0; i < std::max<size_t>(1, options.runRepetitions); i++) {
+        fs::remove(report, ignored);
+        const std::string command = ForthUtils::shellQuote(binary.string()) + " " +
+                                    ForthUtils::shellQuote(report.string()) + " > " +
+                                    ForthUtils::shellQuote(stdoutPath.string()) + " 2> /dev/null";
+        long long nanos = -1, instructions = -1;
+        size_t depth = 0;
+        std::ifstream values;
+        if (std::system(command.c_str()) == 0) {
+            values.open(report);
+            values >> nanos >> instructions >> depth;
+        }
+        if (!values || nanos < 0) {
+            run.error = "Program failed: " + binary.string();
+            return;
+        }
+        samples.push_back(nanoseconds{nanos});
+        if (i == 0) {
+            run.stack.resize(depth);
+            for (auto& value : run.stack) values >> value;
+            run.output = readFile(stdoutPath);
+            if (instructions >= 0) run.instructions = static_cast<uint64_t>(instructions);
+        }
+    }
+    run.wallTime = median(samples);
+    run.status = Run::Status::OK;
+}
+
+auto ForthDifferential::printReport(std::ostream& out, const std::vector<ProgramResult>& results) -> void {
+    out << "\n" << std::string(60, '=') << "\n";
+    out << "DIFFERENTIAL EXECUTION (output and final stack)\n";
+    out << std::string(60, '=') << "\n";
+    out << std::left << std::setw(34) << "Program" << std::setw(13) << "Config" << std::setw(13) << "Status"
+        << std::right << std::setw(10) << "Wall ms" << std::setw(15) << "Instructions" << "\n";
+    out << std::string(85, '-') << "\n";
+
+    size_t mismatches = 0, failures = 0, warnings = 0;
+    std::map<std::string, std::pair<nanoseconds, std::optional<uint64_t>>> totals;
+    for (const auto& result : results) {
+        std::string name = result.name;
+        if (name.size() > 33) name = "..." + name.substr(name.size() - 30);
+        if (!result.agrees()) mismatches++;
+        for (size_t i = 0; i < result.runs.size(); i++) {
+            const auto& run = result.runs[i];
+            const bool isReference = run.configuration == result.reference;
+            out << std::left << std::setw(34) << (i == 0 ? name : "") << std::setw(13) << run.configuration
+                << std::setw(13) << (isReference ? "reference" : statusName(run.status)) << std::right;
+            if (run.status == Run::Status::OK || run.status == Run::Status::MISMATCH) {
+                out << std::fixed << std::setprecision(3) << std::setw(10) << toMilliseconds(*run.wallTime)
+                    << std::setw(15) << (run.instructions ? std::to_string(*run.instructions) : "-");
+                auto& total = totals[run.configuration];
+                total.first += *run.wallTime;
+                if (run.instructions) total.second = total.second.value_or(0) + *run.instructions;
+                if (!run.warnings.empty()) out << "  " << run.warnings.size() << " C warnings";
+            } else {
+                failures += run.status == Run::Status::FAILED;
+                out << "  " << run.error;
+            }
+            warnings += run.warnings.size();
+            out << "\n";
+        }
+    }
+
+    out << std::string(85, '-') << "\n";
+    for (const auto& configuration : configurations()) {
+        auto total = totals.find(configuration.name);
+        if (total == totals.end()) continue;
+        out << std::left << std::setw(34) << "Total" << std::setw(26) << configuration.name << std::right
+            << std::fixed << std::setprecision(3) << std::setw(10) << toMilliseconds(total->second.first)
+            << std::setw(15) << (total->second.second ? std::to_string(*total->second.second) : "-") << "\n";
+    }
+    out << results.size() << " programs, " << mismatches << " with mismatches, " << failures << " failed runs, "
+        << warnings << " C warnings\n";
+}
+
+auto ForthDifferential::toJson(const std::vector<ProgramResult>& results) -> std::string {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n  \"programs\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& result = results[i];
+        json << (i ? ",\n" : "\n") << "    {\"name\": \"" << ForthUtils::jsonEscape(result.name)
+             << "\", \"reference\": \"" << ForthUtils::jsonEscape(result.reference)
+             << "\", \"agrees\": " << (result.agrees() ? "true" : "false") << ", \"runs\": [";
+        for (size_t r = 0; r < result.runs.size(); r++) {
+            const auto& run = result.runs[r];
+            json << (r ? ", " : "") << "{\"config\": \"" << run.configuration << "\", \"status\": \""
+                 << statusName(run.status) << "\"";
+            if (run.wallTime) json << ", \"wall_ms\": " << toMilliseconds(*run.wallTime);
+            if (run.instructions) json << ", \"instructions\": " << *run.instructions;
+            if (!run.error.empty()) json << ", \"error\": \"" << ForthUtils::jsonEscape(run.error) << "\"";
+            if (!run.warnings.empty()) {
+                json << ", \"warnings\": [";
+                for (size_t w = 0; w < run.warnings.size(); w++) {
+                    json << (w ? ", " : "") << "\"" << ForthUtils::jsonEscape(run.warnings[w]) << "\"";
+                }
+                json << "]";
+            }
+            if (run.status == Run::Status::MISMATCH) {
+                json << ", \"output\": \"" << ForthUtils::jsonEscape(run.output) << "\", \"stack\": [";
+                for (size_t s = 0; s < run.stack.size(); s++) json << (s ? ", " : "") << run.stack[s];
+                json << "]";
+            }
+            json << "}";
+        }
+        json << "]}";
+    }
+    json << (results.empty() ? "]\n" : "\n  ]\n");
+    json << "}\n";
+    return json.str();
+}
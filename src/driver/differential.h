@@ -0,0 +1,84 @@
+#ifndef FORTH_DIFFERENTIAL_H
+#define FORTH_DIFFERENTIAL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Differential execution
+// ============================================================================
+//
+// `forth_compiler --differential DIR` runs every program under DIR, plus a
+// corpus from ForthProgramGenerator, in every configuration: the reference
+// interpreter and the C backend at optimization levels 0, 1 and 2, each C
+// build compiled and run on the host. Output and the final data stack of
+// every configuration are compared against the interpreter (against C at
+// level 0 when the interpreter cannot run the program), and each run's
+// wall time and instruction count go into one matrix. Instructions are
+// retired CPU instructions for C builds (from perf_event_open, where the
+// kernel allows it) and executed interpreter instructions otherwise.
+//
+// The C builds use -Wall -Wextra; the host compiler's warnings on the
+// backend's output stay in each build.log and are counted in the report.
+
+class ForthDifferential {
+public:
+    struct Options {
+        std::string compiler = "cc";
+        size_t generated = 20;          // Generated programs, seeds seed .. seed+generated-1
+        uint64_t seed = 1;
+        size_t runRepetitions = 3;      // Wall time is the median
+        uint64_t maxSteps = 100000000;  // Interpreter instructions per run
+        std::filesystem::path workDir = std::filesystem::temp_directory_path() / "forth_differential";
+    };
+
+    struct Configuration {
+        std::string name;       // "interpreter", "c-O0", ...
+        int optimizationLevel;  // -1 for the interpreter
+    };
+
+    struct Run {
+        std::string configuration;
+        enum class Status { OK, MISMATCH, FAILED, UNSUPPORTED } status = Status::FAILED;
+        std::string error;
+        std::string output;
+        std::vector<int32_t> stack;
+        std::optional<std::chrono::nanoseconds> wallTime;
+        std::optional<uint64_t> instructions;
+        std::vector<std::string> warnings;   // Host compiler warnings on the generated C
+    };
+
+    struct ProgramResult {
+        std::string name;
+        std::string reference;   // Configuration the others were compared with
+        std::vector<Run> runs;
+
+        [[nodiscard]] auto agrees() const -> bool;
+    };
+
+    explicit ForthDifferential(Options options);
+
+    [[nodiscard]] static auto configurations() -> const std::vector<Configuration>&;
+
+    // Every *.fth / *.forth file under the directories, then the generated corpus
+    auto run(const std::vector<std::filesystem::path>& directories) -> std::vector<ProgramResult>;
+    auto runProgram(const std::string& name, const std::string& source) -> ProgramResult;
+
+    static auto printReport(std::ostream& out, const std::vector<ProgramResult>& results) -> void;
+    [[nodiscard]] static auto toJson(const std::vector<ProgramResult>& results) -> std::string;
+    [[nodiscard]] static auto statusName(Run::Status status) -> const char*;
+
+private:
+    Options options;
+
+    auto interpret(const std::string& source, Run& run) -> void;
+    auto compileAndRun(const std::string& name, const std::string& source, int level, Run& run) -> void;
+};
+
+#endif // FORTH_DIFFERENTIAL_H
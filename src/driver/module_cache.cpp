@@ -0,0 +1,425 @@
+#include "driver/module_cache.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include "codegen/output_buffer.h"
+#include "common/thread_pool.h"
+#include "common/trace.h"
+#include "common/utils.h"
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string_view>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+auto chainKey(uint64_t seed, uint64_t key) -> uint64_t {
+    return ChunkedBuffer::hashBytes(std::string_view(reinterpret_cast<const char*>(&key), sizeof(key)), seed);
+}
+
+auto resolvePath(const std::string& name, const fs::path& includer) -> fs::path {
+    std::error_code ec;
+    fs::path path(name);
+    if (path.is_relative()) {
+        path = fs::absolute(includer, ec).parent_path() / path;
+    }
+    auto canonical = fs::weakly_canonical(path, ec);
+    return ec ? path.lexically_normal() : canonical;
+}
+
+// Depth first, so every module comes after the ones it includes
+auto isInterface(const fs::path& path) -> bool {
+    return path.extension() == ".fi";
+}
+
+auto collectModules(const std::shared_ptr<const ForthModuleCache::Module>& module,
+                    std::unordered_set<const ForthModuleCache::Module*>& seen,
+                    std::vector<std::shared_ptr<const ForthModuleCache::Module>>& order) -> void {
+    if (!seen.insert(module.get()).second) return;
+    for (const auto& include : module->includes) {
+        collectModules(include, seen, order);
+    }
+    order.push_back(module);
+}
+
+template <typename Map>
+auto insertBounded(Map& map, std::deque<uint64_t>& order, size_t limit, uint64_t key,
+                   typename Map::mapped_type value) -> void {
+    if (limit == 0) return;
+    if (map.insert_or_assign(key, std::move(value)).second) {
+        order.push_back(key);
+    }
+    while (map.size() > limit) {
+        map.erase(order.front());
+        order.pop_front();
+    }
+}
+
+} // namespace
+
+auto ForthModuleCache::Resolution::importDefinitions(ForthDictionary& dictionary) const -> void {
+    for (const auto& module : modules) {
+        dictionary.importDefinitions(*module->definitions);
+    }
+}
+
+auto ForthModuleCache::Resolution::importWordEffects(SemanticAnalyzer& analyzer) const -> void {
+    for (const auto& module : modules) {
+        if (module->interface) {
+            analyzer.importInterface(*module->interface);
+        } else {
+            analyzer.importWordEffects(module->wordEffects);
+        }
+    }
+}
+
+auto ForthModuleCache::Resolution::attach(ProgramNode& program) const -> void {
+    for (const auto& module : modules) {
+        if (module->ast) program.addModule(module->ast);
+    }
+}
+
+auto ForthModuleCache::Resolution::importInterfaces(ForthCCodegen& codegen) const -> void {
+    for (const auto& module : modules) {
+        if (module->interface) codegen.importInterface(module->interface);
+    }
+}
+
+ForthModuleCache::ForthModuleCache(size_t jobs, size_t maxModules) : jobs(jobs), maxModules(maxModules) {}
+
+auto ForthModuleCache::findIncludes(const std::vector<Token>& tokens) -> std::vector<std::string> {
+    std::vector<std::string> includes;
+    bool inDefinition = false;
+    for (size_t i = 0; i + 1 < tokens.size(); i++) {
+        if (tokens[i].type == TokenType::COLON_DEF) {
+            inDefinition = true;
+        } else if (tokens[i].type == TokenType::SEMICOLON) {
+            inDefinition = false;
+        } else if (!inDefinition && tokens[i].type == TokenType::WORD &&
+                   tokens[i + 1].type != TokenType::EOF_TOKEN) {
+            const std::string word = ForthUtils::toUpper(tokens[i].value);
+            if (word == "INCLUDE" || word == "REQUIRE") {
+                includes.push_back(tokens[++i].value);
+            }
+        }
+    }
+    return includes;
+}
+
+auto ForthModuleCache::resolve(const std::vector<std::string>& includes, const fs::path& file) -> Resolution {
+    if (includes.empty()) return {};
+    return load({Program{includes, file}}).front();
+}
+
+auto ForthModuleCache::preload(const std::vector<std::string>& files) -> void {
+    std::vector<Program> programs(files.size());
+    ForthThreadPool::parallelFor(files.size(), jobs, [&](size_t index, size_t) {
+        programs[index].file = files[index];
+        std::ifstream input(files[index]);
+        if (!input) return;   // Reported when the program itself is compiled
+        const std::string source{std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}};
+        try {
+            ForthLexer lexer;
+            programs[index].includes = findIncludes(lexer.tokenize(source));
+        } catch (const std::exception&) {
+            // Likewise
+        }
+    });
+    (void)load(programs);
+}
+
+auto ForthModuleCache::load(const std::vector<Program>& programs) -> std::vector<Resolution> {
+    std::lock_guard lock(mutex);
+
+    // Every file reachable from the programs, once per canonical path
+    struct Node {
+        fs::path path;
+        fs::path includer;   // First file found to include it
+        uint64_t textHash = 0;
+        std::shared_ptr<const Lexed> text;
+        std::vector<size_t> includes;
+        std::string error;   // Own failure: unreadable, unlexable or on a cycle
+        bool failed = false;   // Own failure, or one of its includes failed
+        uint64_t key = 0;
+        std::shared_ptr<const Module> module;
+    };
+    std::vector<Node> nodes;
+    std::unordered_map<std::string, size_t> indexOf;
+    std::vector<size_t> frontier;
+    auto nodeFor = [&](const fs::path& path, fs::path includer) {   // By value: nodes may move
+        auto [it, inserted] = indexOf.try_emplace(path.string(), nodes.size());
+        if (inserted) {
+            nodes.emplace_back();
+            nodes.back().path = path;
+            nodes.back().includer = std::move(includer);
+            frontier.push_back(it->second);
+        }
+        return it->second;
+    };
+
+    std::vector<std::vector<size_t>> roots(programs.size());
+    for (size_t p = 0; p < programs.size(); p++) {
+        for (const auto& name : programs[p].includes) {
+            roots[p].push_back(nodeFor(resolvePath(name, programs[p].file), programs[p].file));
+        }
+    }
+
+    // Discover the include graph a level at a time; files are read, and
+    // texts not seen before lexed, in parallel
+    while (!frontier.empty()) {
+        const std::vector<size_t> wave = std::move(frontier);
+        frontier.clear();
+
+        std::vector<std::string> texts(wave.size());
+        ForthThreadPool::parallelFor(wave.size(), jobs, [&](size_t i, size_t) {
+            Node& node = nodes[wave[i]];
+            std::ifstream input(node.path);
+            if (!input) {
+                node.error =
+                    "Cannot open " + node.path.string() + " (included from " + node.includer.string() + ")";
+                return;
+            }
+            texts[i].assign(std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{});
+            // An interface also stands for the fragment next to it
+            node.textHash = isInterface(node.path)
+                ? ChunkedBuffer::hashBytes(texts[i], ChunkedBuffer::hashBytes(node.path.string()))
+                : ChunkedBuffer::hashBytes(texts[i]);
+        });
+
+        std::vector<size_t> toLex;
+        for (size_t i = 0; i < wave.size(); i++) {
+            Node& node = nodes[wave[i]];
+            if (!node.error.empty()) continue;
+            const auto it = lexed.find(node.textHash);
+            // The hash only selects the entry; the text decides
+            if (it != lexed.end() && it->second->source == texts[i]) {
+                node.text = it->second;
+            } else {
+                toLex.push_back(i);
+            }
+        }
+        ForthThreadPool::parallelFor(toLex.size(), jobs, [&](size_t k, size_t) {
+            const size_t i = toLex[k];
+            Node& node = nodes[wave[i]];
+            try {
+                auto text = std::make_shared<Lexed>();
+                text->source = std::move(texts[i]);
+                if (isInterface(node.path)) {
+                    auto interface = std::make_shared<ForthModuleInterface>(
+                        ForthModuleInterface::loadText(node.path, text->source));
+                    text->includes = interface->dependencies;
+                    text->interface = std::move(interface);
+                } else {
+                    ForthLexer lexer;
+                    text->tokens = lexer.tokenize(text->source);
+                    text->includes = findIncludes(text->tokens);
+                }
+                node.text = std::move(text);
+            } catch (const std::exception& e) {
+                node.error = isInterface(node.path) ? std::string("interface: ") + e.what()
+                                                    : node.path.string() + ": lex: " + e.what();
+            }
+        });
+        for (size_t i : toLex) {
+            const Node& node = nodes[wave[i]];
+            if (node.text) insertBounded(lexed, lexedOrder, maxModules, node.textHash, node.text);
+        }
+
+        for (size_t index : wave) {
+            if (!nodes[index].text) continue;
+            for (const auto& name : nodes[index].text->includes) {
+                const size_t include = nodeFor(resolvePath(name, nodes[index].path), nodes[index].path);
+                nodes[index].includes.push_back(include);
+            }
+        }
+    }
+
+    // Keys bottom-up: a module's text chained with the keys of its includes
+    enum class Visit { NEW, ACTIVE, DONE };
+    std::vector<Visit> state(nodes.size(), Visit::NEW);
+    std::function<void(size_t)> computeKey = [&](size_t index) {
+        state[index] = Visit::ACTIVE;
+        uint64_t key = nodes[index].textHash;
+        for (size_t include : nodes[index].includes) {
+            if (state[include] == Visit::ACTIVE) {
+                nodes[index].error = "Circular include of " + nodes[include].path.string() + " from " +
+                                     nodes[index].path.string();
+                continue;
+            }
+            if (state[include] == Visit::NEW) computeKey(include);
+            key = chainKey(key, nodes[include].key);
+        }
+        nodes[index].key = key;
+        nodes[index].failed = !nodes[index].error.empty();
+        state[index] = Visit::DONE;
+    };
+    for (size_t index = 0; index < nodes.size(); index++) {
+        if (state[index] == Visit::NEW) computeKey(index);
+    }
+
+    std::vector<size_t> pending;
+    for (size_t index = 0; index < nodes.size(); index++) {
+        Node& node = nodes[index];
+        if (node.failed) continue;
+        const auto it = modules.find(node.key);
+        if (it != modules.end() && it->second->source == node.text->source) {
+            node.module = it->second;
+            hits++;
+        } else {
+            pending.push_back(index);
+        }
+    }
+
+    // Parse in waves: every module whose includes are all available
+    while (!pending.empty()) {
+        std::vector<size_t> wave, waiting;
+        for (size_t index : pending) {
+            bool ready = true;
+            for (size_t include : nodes[index].includes) {
+                const Node& dependency = nodes[include];
+                if (dependency.failed || (dependency.module && !dependency.module->errors.empty())) {
+                    nodes[index].failed = true;
+                } else if (!dependency.module) {
+                    ready = false;
+                }
+            }
+            if (nodes[index].failed) continue;
+            (ready ? wave : waiting).push_back(index);
+        }
+        if (wave.empty()) break;
+
+        std::vector<std::shared_ptr<const Module>> parsed(wave.size());
+        ForthThreadPool::parallelFor(wave.size(), jobs, [&](size_t k, size_t) {
+            const Node& node = nodes[wave[k]];
+            std::vector<std::shared_ptr<const Module>> includes;
+            for (size_t include : node.includes) {
+                includes.push_back(nodes[include].module);
+            }
+            parsed[k] = parseModule(node.path, *node.text, node.key, std::move(includes));
+        });
+        for (size_t k = 0; k < wave.size(); k++) {
+            nodes[wave[k]].module = parsed[k];
+            insertBounded(modules, moduleOrder, maxModules, parsed[k]->key, parsed[k]);
+            (parsed[k]->interface ? interfaces : parses)++;
+        }
+        pending = std::move(waiting);
+    }
+
+    // Each program's modules in dependency order, each once
+    std::vector<Resolution> resolutions(programs.size());
+    for (size_t p = 0; p < programs.size(); p++) {
+        Resolution& resolution = resolutions[p];
+        std::vector<bool> seen(nodes.size(), false);
+        std::function<void(size_t)> add = [&](size_t index) {
+            if (seen[index]) return;
+            seen[index] = true;
+            for (size_t include : nodes[index].includes) {
+                add(include);
+            }
+            const Node& node = nodes[index];
+            if (!node.error.empty()) {
+                resolution.errors.push_back("include: " + node.error);
+            }
+            if (!node.module) return;   // Failed itself, or because of an include reported above
+            for (const auto& error : node.module->errors) {
+                resolution.errors.push_back("include: " + node.path.string() + ": " + error);
+            }
+            for (const auto& warning : node.module->warnings) {
+                resolution.warnings.push_back("include: " + node.path.string() + ": " + warning);
+            }
+            resolution.key = resolution.modules.empty() ? node.module->key
+                                                        : chainKey(resolution.key, node.module->key);
+            resolution.modules.push_back(node.module);
+        };
+        for (size_t root : roots[p]) {
+            add(root);
+        }
+    }
+    return resolutions;
+}
+
+auto ForthModuleCache::parseModule(const fs::path& path, const Lexed& text, uint64_t key,
+                                   std::vector<std::shared_ptr<const Module>> includes) const
+    -> std::shared_ptr<const Module> {
+    ForthTrace::Span span("module", path.filename().string(), path.string());
+    auto module = std::make_shared<Module>();
+    module->path = path;
+    module->source = text.source;
+    module->key = key;
+    module->tokens = text.tokens.empty() ? 0 : text.tokens.size() - 1;
+    module->includes = std::move(includes);
+    module->definitions = DictionaryFactory::createOverlay();
+    
+    // Already compiled: its interface holds all an importer needs
+    if (text.interface) {
+        module->interface = text.interface;
+        module->interface->importDefinitions(*module->definitions);
+        module->wordEffects = module->interface->getWordEffects();
+        return module;
+    }
+
+    // Parsed against everything its own includes bring in
+    Resolution closure;
+    std::unordered_set<const Module*> seen;
+    for (const auto& include : module->includes) {
+        collectModules(include, seen, closure.modules);
+    }
+
+    try {
+        ForthParser parser(DictionaryFactory::createOverlay());
+        closure.importDefinitions(parser.getDictionary());
+        module->ast = parser.parseProgram(text.tokens);
+        for (const auto& error : parser.getErrors()) {
+            module->errors.push_back("parse: " + error);
+        }
+        if (!module->errors.empty()) {
+            return module;
+        }
+
+        SemanticAnalyzer analyzer(&parser.getDictionary());
+        closure.importWordEffects(analyzer);
+        analyzer.analyze(*module->ast);
+        for (const auto& error : analyzer.getErrors()) {
+            module->warnings.push_back("semantic: " + error);
+        }
+        for (const auto& warning : analyzer.getWarnings()) {
+            module->warnings.push_back("semantic: " + warning);
+        }
+
+        // Only the names this module defines itself are exported
+        const auto& effects = analyzer.getWordEffects();
+        for (const auto& child : module->ast->getChildren()) {
+            if (const auto* word = dynamic_cast<const WordDefinitionNode*>(child.get())) {
+                module->definitions->defineWord(word->getWordName(), std::make_unique<ProgramNode>());
+                if (const auto effect = effects.find(word->getWordName()); effect != effects.end()) {
+                    module->wordEffects[word->getWordName()] = effect->second;
+                }
+            } else if (const auto* declaration = dynamic_cast<const VariableDeclarationNode*>(child.get())) {
+                if (declaration->isConst()) {
+                    module->definitions->defineConstant(declaration->getVarName(), nullptr);
+                } else {
+                    module->definitions->defineVariable(declaration->getVarName());
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        module->errors.push_back(std::string("internal: ") + e.what());
+    }
+    return module;
+}
+
+auto ForthModuleCache::clear() -> void {
+    std::lock_guard lock(mutex);
+    lexed.clear();
+    modules.clear();
+    lexedOrder.clear();
+    moduleOrder.clear();
+    parses = interfaces = hits = 0;
+}
+
+auto ForthModuleCache::getModuleCount() const -> size_t {
+    std::lock_guard lock(mutex);
+    return modules.size();
+}
@@ -0,0 +1,121 @@
+#ifndef FORTH_MODULE_CACHE_H
+#define FORTH_MODULE_CACHE_H
+
+#include "common/types.h"
+#include "parser/ast.h"
+#include "dictionary/dictionary.h"
+#include "semantic/analyzer.h"
+#include "semantic/module_interface.h"
+#include "codegen/c_backend.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// Included modules
+// ============================================================================
+//
+// `INCLUDE file` and `REQUIRE file` at the top level of a program make the
+// file's words, variables and constants available to it. Both are
+// include-once: a module reached through several paths is loaded a single
+// time per program. Names are resolved relative to the including file.
+//
+// Each module is parsed and analyzed on its own, against the definitions of
+// the modules it includes itself, and the result - AST, dictionary delta and
+// word stack effects - is cached under a key made of its text and the keys
+// of its includes. Every program that includes it shares that one AST and
+// only imports the delta and the effects, so a library included by 100
+// programs is parsed and analyzed once. Modules that do not depend on each
+// other are parsed in parallel.
+//
+// A name ending in ".fi" is the interface of a separately compiled module
+// (forth_compiler -c). It is read instead of parsed, and the program calls
+// into the module's C fragment rather than compiling its words again.
+
+class ForthModuleCache {
+public:
+    struct Module {
+        std::filesystem::path path;   // Where the text was first loaded from
+        std::string source;
+        uint64_t key = 0;             // Text hash chained with the keys of its includes
+        size_t tokens = 0;
+        std::vector<std::shared_ptr<const Module>> includes;   // Direct includes, in source order
+        std::shared_ptr<ProgramNode> ast;                      // Shared by every includer; never modified
+        std::shared_ptr<const ForthModuleInterface> interface; // Instead of the AST for a ".fi"
+        std::unique_ptr<ForthDictionary> definitions;          // Overlay holding only this module's names
+        std::unordered_map<std::string, TypedStackEffect> wordEffects;   // Of this module's words
+        std::vector<std::string> errors;                       // "phase: message"
+        std::vector<std::string> warnings;
+    };
+
+    // Everything one program includes
+    struct Resolution {
+        std::vector<std::shared_ptr<const Module>> modules;   // Dependency order, each once
+        std::vector<std::string> errors;                      // "include: message"
+        std::vector<std::string> warnings;
+        uint64_t key = 0;   // Keys of all modules chained; 0 without includes
+
+        // Make the definitions visible before parsing the program...
+        auto importDefinitions(ForthDictionary& dictionary) const -> void;
+        // ...and the effects before analyzing it; attach() shares the ASTs
+        auto importWordEffects(SemanticAnalyzer& analyzer) const -> void;
+        auto attach(ProgramNode& program) const -> void;
+        // Separately compiled modules resolve in code generation
+        auto importInterfaces(ForthCCodegen& codegen) const -> void;
+    };
+
+    explicit ForthModuleCache(size_t jobs = 0, size_t maxModules = 1024);
+
+    // File names named by top-level INCLUDE/REQUIRE directives, in order
+    [[nodiscard]] static auto findIncludes(const std::vector<Token>& tokens) -> std::vector<std::string>;
+
+    // Load, or find, the modules `file` includes. Thread-safe; the cache is
+    // locked while modules are parsed.
+    [[nodiscard]] auto resolve(const std::vector<std::string>& includes, const std::filesystem::path& file)
+        -> Resolution;
+    // Load the modules of many programs at once, so that modules shared by
+    // several of them are parsed in the same parallel waves
+    auto preload(const std::vector<std::string>& files) -> void;
+
+    auto clear() -> void;
+    [[nodiscard]] auto getModuleCount() const -> size_t;
+    [[nodiscard]] auto getParses() const -> size_t { return parses; }   // Modules parsed and analyzed
+    [[nodiscard]] auto getInterfaces() const -> size_t { return interfaces; }   // Interfaces read
+    [[nodiscard]] auto getHits() const -> size_t { return hits; }       // Modules found already parsed
+
+private:
+    struct Lexed {
+        std::string source;
+        std::vector<Token> tokens;
+        std::vector<std::string> includes;
+        std::shared_ptr<const ForthModuleInterface> interface;   // Read instead of lexed
+    };
+    struct Program {
+        std::vector<std::string> includes;
+        std::filesystem::path file;
+    };
+
+    size_t jobs;
+    size_t maxModules;
+    mutable std::mutex mutex;
+    std::unordered_map<uint64_t, std::shared_ptr<const Lexed>> lexed;    // By text hash
+    std::unordered_map<uint64_t, std::shared_ptr<const Module>> modules;   // By module key
+    std::deque<uint64_t> lexedOrder;
+    std::deque<uint64_t> moduleOrder;
+    size_t parses = 0;
+    size_t interfaces = 0;
+    size_t hits = 0;
+
+    auto load(const std::vector<Program>& programs) -> std::vector<Resolution>;
+    [[nodiscard]] auto parseModule(const std::filesystem::path& path, const Lexed& text, uint64_t key,
+                                   std::vector<std::shared_ptr<const Module>> includes) const
+        -> std::shared_ptr<const Module>;
+};
+
+#endif // FORTH_MODULE_CACHE_H
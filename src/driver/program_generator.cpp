@@ -0,0 +1,168 @@
+#include "driver/program_generator.h"
+#include <sstream>
+
+ForthProgramGenerator::ForthProgramGenerator(Options opts) : options(opts), state(opts.seed) {}
+
+// splitmix64: the same sequence on every platform and standard library
+auto ForthProgramGenerator::next() -> uint64_t {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+auto ForthProgramGenerator::below(uint64_t bound) -> size_t {
+    return bound ? static_cast<size_t>(next() % bound) : 0;
+}
+
+auto ForthProgramGenerator::literal(int low, int high) -> int {
+    return low + static_cast<int>(below(static_cast<uint64_t>(high - low + 1)));
+}
+
+auto ForthProgramGenerator::call(std::ostream& out) -> void {
+    static const char* binary[] = {"+", "-"};
+    const size_t self = words.size();
+    const size_t level = self % (options.callDepth + 1);
+    if (level == 0) {
+        out << literal(1, 9) << " " << binary[below(2)];
+        return;
+    }
+    // The previous `level` words sit one to `level` levels below
+    const Word& callee = words[self - 1 - below(level)];
+    if (callee.inputs == 0) {
+        out << callee.name << " +";
+    } else if (callee.inputs == 1) {
+        out << callee.name;
+    } else {
+        out << literal(-9, 9) << " " << callee.name;
+    }
+}
+
+auto ForthProgramGenerator::transform(std::ostream& out, size_t depth) -> void {
+    static const char* binary[] = {"+", "-"};
+    static const char* compare[] = {"=", "<>", "<", ">", "<=", ">="};
+    const bool nest = depth < options.nesting;
+
+    const size_t roll = below(100);
+    if (roll < options.literalDensity) {
+        switch (below(4)) {
+            case 0: out << literal(-20, 20) << " +"; break;
+            case 1: out << literal(-20, 20) << " -"; break;
+            case 2: out << literal(-9, 9) << " * 1000 MOD"; break;
+            default: out << literal(-10, 10) << " " << compare[below(6)]; break;
+        }
+        return;
+    }
+    if (roll < options.literalDensity + options.stringDensity) {
+        out << ".\" s" << below(1000) << "\"";
+        return;
+    }
+
+    switch (below(nest ? 8 : 6)) {
+        case 0: {
+            // Mostly non-zero divisors, now and then the runtime's x/0 = 0
+            const int d = below(8) == 0 ? 0 : literal(1, 9) * (below(2) ? 1 : -1);
+            out << d << (below(2) ? " /" : " MOD");
+            break;
+        }
+        case 1: out << (below(2) ? "NEGATE" : "ABS"); break;
+        case 2: out << (below(2) ? "DUP + 1000 MOD" : "DUP * 1000 MOD"); break;
+        case 3: {
+            // Stack shuffles that leave one cell
+            switch (below(4)) {
+                case 0: out << literal(0, 9) << " SWAP -"; break;
+                case 1: out << literal(0, 9) << " OVER + +"; break;
+                case 2: out << literal(0, 9) << " " << literal(0, 9) << " ROT + +"; break;
+                default: out << "DUP DROP " << literal(0, 9) << " " << binary[below(2)]; break;
+            }
+            break;
+        }
+        case 4:
+            if (options.variables > 0) {
+                const size_t v = below(options.variables);
+                if (below(2)) {
+                    out << "DUP G" << v << " !";
+                } else {
+                    out << "G" << v << " @ +";
+                }
+            } else {
+                out << "1 +";
+            }
+            break;
+        case 5: call(out); break;
+        case 6:
+            out << "DUP " << literal(-10, 10) << " > IF ";
+            transform(out, depth + 1);
+            out << " ELSE ";
+            transform(out, depth + 1);
+            out << " THEN";
+            break;
+        default:
+            // Counted loop over the cell below the counter
+            out << literal(1, 4) << " BEGIN SWAP ";
+            transform(out, depth + 1);
+            out << " SWAP 1 - DUP 0 = UNTIL DROP";
+            break;
+    }
+}
+
+auto ForthProgramGenerator::generate() -> std::string {
+    std::ostringstream program;
+    program << "\\ Generated program, seed " << options.seed << "\n";
+    for (size_t v = 0; v < options.variables; v++) {
+        program << "VARIABLE G" << v << "\n";
+    }
+
+    words.clear();
+    for (size_t i = 0; i < options.words; i++) {
+        Word word{"W", static_cast<int>(below(3))};
+        word.name += std::to_string(i);
+        program << ": " << word.name;
+        if (below(100) < options.recursion) {
+            // Sums the argument, reduced to 0..6, down to a base case
+            word.inputs = 1;
+            program << " 7 MOD ABS DUP 0 > IF DUP 1 - " << word.name << " + ELSE ";
+            transform(program, options.nesting);
+            program << " THEN";
+        } else if (word.inputs == 0) {
+            program << " " << literal(-50, 50);
+        } else if (word.inputs == 2) {
+            program << (below(2) ? " +" : " - 1000 MOD");
+        }
+        for (size_t s = 0; s < options.statements; s++) {
+            program << " ";
+            transform(program, 0);
+        }
+        program << " ;\n";
+        words.push_back(std::move(word));
+    }
+
+    program << ": MAIN\n";
+    for (size_t v = 0; v < options.variables; v++) {
+        program << "  " << literal(-30, 30) << " G" << v << " !\n";
+    }
+    for (size_t c = 0; c < options.calls; c++) {
+        program << " ";
+        if (!words.empty()) {
+            const Word& callee = words[below(words.size())];
+            for (int a = 0; a < callee.inputs; a++) {
+                if (options.variables > 0 && below(3) == 0) {
+                    program << " G" << below(options.variables) << " @";
+                } else {
+                    program << " " << literal(-100, 100);
+                }
+            }
+            program << " " << callee.name;
+        } else {
+            program << " " << literal(-100, 100);
+        }
+        // The last calls leave their results for the stack comparison
+        if (c + 2 < options.calls) {
+            program << (options.variables > 0 && below(4) == 0 ? " DUP G0 ! ." : " .");
+        }
+        if (below(5) == 0) program << " .\" |\"";
+        program << "\n";
+    }
+    program << "  " << literal(65, 90) << " EMIT CR ;\n";
+    return program.str();
+}
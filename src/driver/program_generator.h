@@ -0,0 +1,64 @@
+#ifndef FORTH_PROGRAM_GENERATOR_H
+#define FORTH_PROGRAM_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Random program generator
+// ============================================================================
+//
+// Produces valid, terminating FORTH programs from a seed: words that take
+// zero to two cells and leave one, built from arithmetic, comparisons,
+// stack shuffles, variables, strings, IF/ELSE and counted BEGIN/UNTIL
+// loops, calling only words defined before them or, for recursive words,
+// themselves with a bounded argument. MAIN calls them with literal and
+// variable arguments, prints most results and leaves a few on the stack.
+// Values are kept small, so every backend computes the same output; the
+// same seed always gives the same program. Generation is linear in the
+// size, so programs of 10^5-10^6 words can drive scaling benchmarks.
+
+class ForthProgramGenerator {
+public:
+    struct Options {
+        uint64_t seed = 1;
+        size_t words = 8;          // Besides MAIN
+        size_t statements = 5;     // Per word body
+        size_t variables = 2;
+        size_t calls = 8;          // Calls made by MAIN
+        size_t nesting = 2;        // IF and loop nesting inside a body
+        size_t callDepth = 4;      // Longest chain of calls between words
+        unsigned recursion = 0;        // Percent of words that call themselves
+        unsigned literalDensity = 30;  // Percent of statements that are literal arithmetic
+        unsigned stringDensity = 5;    // Percent of statements that print a string
+    };
+
+    explicit ForthProgramGenerator(Options options);
+
+    [[nodiscard]] auto generate() -> std::string;
+
+private:
+    struct Word {
+        std::string name;
+        int inputs;
+    };
+
+    Options options;
+    uint64_t state;
+    std::vector<Word> words;
+
+    auto next() -> uint64_t;
+    auto below(uint64_t bound) -> size_t;
+    auto literal(int low, int high) -> int;
+
+    // One statement that maps the top cell to a new top cell
+    auto transform(std::ostream& out, size_t depth) -> void;
+    // A call from the word being generated to one at a lower level; word i
+    // sits at level i % (callDepth + 1), and level 0 calls nothing
+    auto call(std::ostream& out) -> void;
+};
+
+#endif // FORTH_PROGRAM_GENERATOR_H
@@ -0,0 +1,394 @@
+#include "driver/runtime_bench.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include "dictionary/dictionary.h"
+#include "semantic/analyzer.h"
+#include "codegen/c_backend.h"
+#include "common/utils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Uses every primitive the harness calls, so the runtime files define them
+constexpr const char* FIXTURE = R"(\ Runtime micro-benchmark fixture
+VARIABLE V
+: MAIN
+  V @ DUP DROP 1 SWAP OVER ROT + - 2 * 3 / 4 MOD NEGATE ABS
+  1 = 1 <> 1 < 1 > 1 <= 1 >= V ! V C@ V C! ;
+)";
+
+// Functions the harness links against, by runtime file
+const std::vector<std::pair<std::string, std::vector<std::string>>> REQUIRED = {
+    {"forth_stack.c", {"forth_push", "forth_pop", "forth_dup", "forth_drop", "forth_swap", "forth_over",
+                       "forth_rot"}},
+    {"forth_math.c", {"forth_add", "forth_sub", "forth_mul", "forth_div", "forth_mod", "forth_negate",
+                      "forth_abs"}},
+    {"forth_compare.c", {"forth_equal", "forth_not_equal", "forth_less_than", "forth_greater_than",
+                         "forth_less_equal", "forth_greater_equal", "forth_zero_equal", "forth_zero_less"}},
+    {"forth_memory.c", {"forth_fetch", "forth_store", "forth_byte_fetch", "forth_byte_store"}},
+};
+
+constexpr const char* HARNESS_PROLOGUE = R"(#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "forth_runtime.h"
+
+void forth_zero_equal(void);
+void forth_zero_less(void);
+void forth_fetch(void);
+void forth_store(void);
+void forth_byte_fetch(void);
+void forth_byte_store(void);
+
+static volatile forth_cell_t sink;
+
+// Memory rows: a cell holding its own address at an aligned and at an
+// unaligned location, so a chain of @ keeps the address on the stack
+static forth_cell_t memory_cells[4];
+static forth_cell_t aligned, unaligned, byte_address;
+static int memory_ok;
+
+static void bench_reset_memory(void) {
+    aligned = (forth_cell_t)(intptr_t)&memory_cells[0];
+    unaligned = (forth_cell_t)(intptr_t)((forth_byte_t*)&memory_cells[1] + 1);
+    byte_address = (forth_cell_t)(intptr_t)&memory_cells[3];
+    memory_cells[0] = aligned;
+    memcpy((forth_byte_t*)&memory_cells[1] + 1, &unaligned, sizeof(unaligned));
+    memory_ok = (intptr_t)aligned == (intptr_t)&memory_cells[0];
+}
+
+static long long now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+static long long bench_empty(long iterations) {
+    long long start = now();
+    for (long i = 0; i < iterations; i++) {
+        sink = (forth_cell_t)i;
+    }
+    return now() - start;
+}
+)";
+
+auto binary(const std::string& group, const std::string& name, const std::string& function,
+            std::vector<ForthRuntimeBenchmark::Primitive>& table) -> void {
+    table.push_back({group, name, "call", "",
+                     "forth_push((forth_cell_t)(i & 15) + 7); forth_push(3); " + function +
+                         "(); sink = forth_pop();"});
+    table.push_back({group, name, "loop", "forth_push(1000);",
+                     "forth_push((forth_cell_t)(i & 1) + 3); " + function + "();"});
+}
+
+auto unary(const std::string& group, const std::string& name, const std::string& function,
+           std::vector<ForthRuntimeBenchmark::Primitive>& table) -> void {
+    table.push_back({group, name, "call", "",
+                     "forth_push((forth_cell_t)(i & 15) - 8); " + function + "(); sink = forth_pop();"});
+    table.push_back({group, name, "loop", "forth_push(-5);", function + "();"});
+}
+
+auto median(std::vector<double> samples) -> double {
+    std::sort(samples.begin(), samples.end());
+    return samples.empty() ? 0.0 : samples[samples.size() / 2];
+}
+
+} // namespace
+
+ForthRuntimeBenchmark::ForthRuntimeBenchmark(Options options) : options(std::move(options)) {}
+
+auto ForthRuntimeBenchmark::primitives() -> const std::vector<Primitive>& {
+    static const std::vector<Primitive> table = [] {
+        std::vector<Primitive> rows;
+        rows.push_back({"stack", "push pop", "call", "", "forth_push((forth_cell_t)i); sink = forth_pop();"});
+        rows.push_back({"stack", "DUP DROP", "loop", "forth_push(1);", "forth_dup(); forth_drop();"});
+        rows.push_back({"stack", "SWAP", "loop", "forth_push(1); forth_push(2);", "forth_swap();"});
+        rows.push_back({"stack", "OVER DROP", "loop", "forth_push(1); forth_push(2);", "forth_over(); forth_drop();"});
+        rows.push_back({"stack", "ROT", "loop", "forth_push(1); forth_push(2); forth_push(3);", "forth_rot();"});
+
+        binary("math", "+", "forth_add", rows);
+        binary("math", "-", "forth_sub", rows);
+        binary("math", "*", "forth_mul", rows);
+        binary("math", "/", "forth_div", rows);
+        binary("math", "MOD", "forth_mod", rows);
+        unary("math", "NEGATE", "forth_negate", rows);
+        unary("math", "ABS", "forth_abs", rows);
+
+        binary("compare", "=", "forth_equal", rows);
+        binary("compare", "<>", "forth_not_equal", rows);
+        binary("compare", "<", "forth_less_than", rows);
+        binary("compare", ">", "forth_greater_than", rows);
+        binary("compare", "<=", "forth_less_equal", rows);
+        binary("compare", ">=", "forth_greater_equal", rows);
+        unary("compare", "0=", "forth_zero_equal", rows);
+        unary("compare", "0<", "forth_zero_less", rows);
+
+        for (const std::string alignment : {"aligned", "unaligned"}) {
+            rows.push_back({"memory", "@ " + alignment, "call", "bench_reset_memory();",
+                            "forth_push(" + alignment + "); forth_fetch(); sink = forth_pop();"});
+            rows.push_back({"memory", "@ " + alignment, "loop",
+                            "bench_reset_memory(); forth_push(" + alignment + ");", "forth_fetch();"});
+            rows.push_back({"memory", "! " + alignment, "call", "bench_reset_memory();",
+                            "forth_push((forth_cell_t)i); forth_push(" + alignment + "); forth_store();"});
+            rows.push_back({"memory", "! " + alignment, "loop",
+                            "bench_reset_memory(); forth_push(" + alignment + ");",
+                            "forth_dup(); forth_dup(); forth_store();"});
+        }
+        rows.push_back({"memory", "C@", "call", "bench_reset_memory();",
+                        "forth_push(byte_address); forth_byte_fetch(); sink = forth_pop();"});
+        rows.push_back({"memory", "C!", "call", "bench_reset_memory();",
+                        "forth_push((forth_cell_t)i); forth_push(byte_address); forth_byte_store();"});
+        return rows;
+    }();
+    return table;
+}
+
+auto ForthRuntimeBenchmark::harness() -> std::string {
+    const auto& table = primitives();
+    std::ostringstream c;
+    c << HARNESS_PROLOGUE;
+    for (size_t index = 0; index < table.size(); index++) {
+        const auto& primitive = table[index];
+        c << "\n// " << primitive.group << ": " << primitive.name << " (" << primitive.mode << ")\n"
+          << "static long long bench_" << index << "(long iterations) {\n"
+          << "    forth_data_stack.ptr = 0;\n"
+          << "    " << primitive.setup << "\n"
+          << "    long long start = now();\n"
+          << "    for (long i = 0; i < iterations; i++) {\n"
+          << "        " << primitive.body << "\n"
+          << "    }\n"
+          << "    long long elapsed = now() - start;\n"
+          << "    forth_data_stack.ptr = 0;\n"
+          << "    return elapsed;\n"
+          << "}\n";
+    }
+
+    // argv: result file, iterations, repetitions. Each line of the result
+    // is "<row> <ns>", the empty loop being row -1 and skipped rows -1 ns.
+    c << "\nstatic long long (*const benches[])(long) = {";
+    for (size_t index = 0; index < table.size(); index++) {
+        c << (index % 6 == 0 ? "\n    " : " ") << "bench_" << index << ",";
+    }
+    c << "\n};\nstatic const int needs_memory[] = {";
+    for (size_t index = 0; index < table.size(); index++) {
+        c << (index % 16 == 0 ? "\n    " : " ") << (table[index].group == "memory" ? 1 : 0) << ",";
+    }
+    c << R"(
+};
+
+int main(int argc, char** argv) {
+    if (argc < 4) return 1;
+    FILE* out = fopen(argv[1], "w");
+    if (!out) return 1;
+    long iterations = atol(argv[2]);
+    int repetitions = atoi(argv[3]);
+    forth_init();
+    bench_reset_memory();
+    for (int r = 0; r < repetitions; r++) {
+        fprintf(out, "-1 %lld\n", bench_empty(iterations));
+        for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+            fprintf(out, "%zu %lld\n", b, needs_memory[b] && !memory_ok ? -1LL : benches[b](iterations));
+        }
+    }
+    fclose(out);
+    return 0;
+}
+)";
+    return c.str();
+}
+
+auto ForthRuntimeBenchmark::generateRuntime(Report& report) -> bool {
+    ForthLexer lexer;
+    ForthParser parser(DictionaryFactory::createOverlay());
+    auto ast = parser.parseProgram(lexer.tokenize(FIXTURE));
+    if (parser.hasErrors()) {
+        report.error = "parse: " + parser.getErrors().front();
+        return false;
+    }
+    SemanticAnalyzer analyzer(&parser.getDictionary());
+    analyzer.analyze(*ast);
+
+    auto generator = ForthCodegenFactory::create(ForthCodegenFactory::TargetType::NATIVE_LINUX);
+    generator->setSemanticAnalyzer(&analyzer);
+    generator->setDictionary(&parser.getDictionary());
+    // Keep every primitive as a call; the runtime files are what is measured
+    generator->setOptimizationLevel(0);
+    if (!generator->generateCode(*ast) || generator->hasErrors()) {
+        report.error = "codegen: " + (generator->getErrors().empty() ? std::string("failed")
+                                                                     : generator->getErrors().front());
+        return false;
+    }
+
+    std::error_code ignored;
+    fs::remove_all(options.workDir, ignored);
+    if (!generator->writeToFiles(options.workDir.string())) {
+        report.error = "Cannot write " + options.workDir.string();
+        return false;
+    }
+    for (const auto& [file, functions] : REQUIRED) {
+        std::ifstream in(options.workDir / file);
+        const std::string code{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+        for (const auto& function : functions) {
+            if (code.find(" " + function + "(void)") == std::string::npos &&
+                code.find(" " + function + "(forth_cell_t") == std::string::npos) {
+                report.error = function + " is not defined in " + file;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+auto ForthRuntimeBenchmark::run() -> Report {
+    Report report;
+    report.compiler = options.compiler;
+    report.flags = options.flags;
+    report.iterations = std::max<size_t>(1, options.iterations);
+    if (!generateRuntime(report)) return report;
+
+    const fs::path& dir = options.workDir;
+    std::ofstream(dir / "runtime_bench_main.c") << harness();
+
+    // main.c is the ESP-IDF entry point; the harness replaces it
+    std::string sources;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        const std::string file = entry.path().filename().string();
+        if (file.starts_with("forth_") && file.ends_with(".c")) {
+            sources += ' ';
+            sources += ForthUtils::shellQuote(entry.path().string());
+        }
+    }
+    const fs::path binary = dir / "runtime_bench";
+    const fs::path log = dir / "build.log";
+    const std::string build = options.compiler + " " + options.flags + " -no-pie -w -I" +
+                              ForthUtils::shellQuote(dir.string()) + sources + " " +
+                              ForthUtils::shellQuote((dir / "runtime_bench_main.c").string()) + " -o " +
+                              ForthUtils::shellQuote(binary.string()) + " > " +
+                              ForthUtils::shellQuote(log.string()) + " 2>&1";
+    if (std::system(build.c_str()) != 0) {
+        report.error = "Failed to build with " + options.compiler + " (see " + log.string() + ")";
+        return report;
+    }
+
+    const fs::path results = dir / "results.txt";
+    const std::string command = ForthUtils::shellQuote(binary.string()) + " " +
+                                ForthUtils::shellQuote(results.string()) + " " +
+                                std::to_string(report.iterations) + " " +
+                                std::to_string(std::max<size_t>(1, options.repetitions)) + " > /dev/null 2>&1";
+    if (std::system(command.c_str()) != 0) {
+        report.error = "Harness failed: " + binary.string();
+        return report;
+    }
+
+    const auto& table = primitives();
+    std::vector<std::vector<double>> samples(table.size());
+    std::vector<double> overhead;
+    std::vector<bool> skipped(table.size(), false);
+    std::ifstream in(results);
+    long long row = 0, nanos = 0;
+    while (in >> row >> nanos) {
+        const double perOp = static_cast<double>(nanos) / static_cast<double>(report.iterations);
+        if (row < 0) {
+            overhead.push_back(perOp);
+        } else if (static_cast<size_t>(row) < table.size()) {
+            if (nanos < 0) {
+                skipped[row] = true;
+            } else {
+                samples[row].push_back(perOp);
+            }
+        }
+    }
+
+    report.loopOverhead = median(overhead);
+    for (size_t index = 0; index < table.size(); index++) {
+        Measurement measurement{table[index], std::nullopt, samples[index]};
+        if (!skipped[index] && !samples[index].empty()) {
+            measurement.nsPerOp = median(samples[index]);
+        }
+        report.measurements.push_back(std::move(measurement));
+    }
+    report.success = true;
+    return report;
+}
+
+auto ForthRuntimeBenchmark::printReport(std::ostream& out, const Report& report) -> void {
+    out << "\n" << std::string(60, '=') << "\n";
+    out << "RUNTIME PRIMITIVES (ns/op, NATIVE_LINUX, " << report.compiler << " " << report.flags << ")\n";
+    out << std::string(60, '=') << "\n";
+    if (!report.success) {
+        out << "❌ " << report.error << "\n";
+        return;
+    }
+
+    // One line per primitive with its call and loop columns
+    std::vector<std::pair<std::string, std::string>> order;
+    std::map<std::pair<std::string, std::string>, std::map<std::string, std::optional<double>>> cells;
+    for (const auto& measurement : report.measurements) {
+        const auto key = std::make_pair(measurement.primitive.group, measurement.primitive.name);
+        if (!cells.contains(key)) order.push_back(key);
+        cells[key][measurement.primitive.mode] = measurement.nsPerOp;
+    }
+
+    auto cell = [](const std::map<std::string, std::optional<double>>& modes, const char* mode) -> std::string {
+        auto found = modes.find(mode);
+        if (found == modes.end()) return "";
+        if (!found->second) return "skipped";
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(2) << *found->second;
+        return text.str();
+    };
+
+    out << std::left << std::setw(10) << "Group" << std::setw(16) << "Primitive" << std::right
+        << std::setw(12) << "call" << std::setw(12) << "loop" << "\n";
+    out << std::string(50, '-') << "\n";
+    for (const auto& key : order) {
+        const auto& modes = cells[key];
+        out << std::left << std::setw(10) << key.first << std::setw(16) << key.second << std::right
+            << std::setw(12) << cell(modes, "call") << std::setw(12) << cell(modes, "loop") << "\n";
+    }
+    out << std::string(50, '-') << "\n";
+    out << std::fixed << std::setprecision(2) << "Empty loop: " << report.loopOverhead << " ns/op, "
+        << report.iterations << " iterations per measurement\n";
+}
+
+auto ForthRuntimeBenchmark::toJson(const Report& report) -> std::string {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n";
+    json << "  \"compiler\": \"" << ForthUtils::jsonEscape(report.compiler) << "\", \"flags\": \""
+         << ForthUtils::jsonEscape(report.flags) << "\", \"success\": " << (report.success ? "true" : "false");
+    if (!report.success) {
+        json << ", \"error\": \"" << ForthUtils::jsonEscape(report.error) << "\"\n}\n";
+        return json.str();
+    }
+    json << ", \"iterations\": " << report.iterations << ", \"loop_overhead_ns\": " << report.loopOverhead
+         << ",\n  \"primitives\": [";
+    for (size_t i = 0; i < report.measurements.size(); i++) {
+        const auto& measurement = report.measurements[i];
+        json << (i ? ",\n" : "\n") << "    {\"group\": \"" << measurement.primitive.group
+             << "\", \"name\": \"" << ForthUtils::jsonEscape(measurement.primitive.name)
+             << "\", \"mode\": \"" << measurement.primitive.mode << "\"";
+        if (measurement.nsPerOp) {
+            json << ", \"ns_per_op\": " << *measurement.nsPerOp << ", \"samples\": [";
+            for (size_t s = 0; s < measurement.samples.size(); s++) {
+                json << (s ? ", " : "") << measurement.samples[s];
+            }
+            json << "]";
+        } else {
+            json << ", \"skipped\": true";
+        }
+        json << "}";
+    }
+    json << "\n  ]\n}\n";
+    return json.str();
+}
@@ -0,0 +1,80 @@
+#ifndef FORTH_RUNTIME_BENCH_H
+#define FORTH_RUNTIME_BENCH_H
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Runtime primitive micro-benchmarks
+// ============================================================================
+//
+// `forth_compiler --runtime-bench` generates the C runtime for the
+// NATIVE_LINUX target (forth_stack.c, forth_math.c, forth_compare.c,
+// forth_memory.c), links it with a harness built from the table below and
+// reports ns/op for every primitive. Each primitive is measured two ways:
+//
+//   call  operands pushed, the primitive, the result popped - the cost a
+//         compiled word pays for one isolated use
+//   loop  the primitive alone in a tight loop on cells left on the stack,
+//         chained through its result where it has one
+//
+// @ and ! run on aligned and unaligned addresses. The harness is linked
+// without PIE so data addresses fit in a 32-bit cell as on the ESP32;
+// where they do not, the memory rows are reported as unsupported.
+
+class ForthRuntimeBenchmark {
+public:
+    struct Options {
+        std::string compiler = "cc";
+        std::string flags = "-O2";          // Also e.g. "-O3 -flto" to see cross-file inlining
+        size_t iterations = 10000000;       // Per measurement
+        size_t repetitions = 5;             // ns/op is the median
+        std::filesystem::path workDir = std::filesystem::temp_directory_path() / "forth_runtime_bench";
+    };
+
+    struct Primitive {
+        std::string group;    // "stack", "math", "compare", "memory"
+        std::string name;     // FORTH name, "@ unaligned", ...
+        std::string mode;     // "call" or "loop"
+        std::string setup;    // C run once before the timed loop
+        std::string body;     // C run per iteration, with `i` the iteration
+    };
+
+    struct Measurement {
+        Primitive primitive;
+        std::optional<double> nsPerOp;      // Unset when the harness skipped it
+        std::vector<double> samples;        // ns/op of each repetition
+    };
+
+    struct Report {
+        bool success = false;
+        std::string error;
+        std::string compiler;
+        std::string flags;
+        size_t iterations = 0;
+        double loopOverhead = 0.0;          // ns/op of the empty loop, included in every row
+        std::vector<Measurement> measurements;
+    };
+
+    explicit ForthRuntimeBenchmark(Options options);
+
+    [[nodiscard]] static auto primitives() -> const std::vector<Primitive>&;
+    // C source of the harness: one timed function per primitive
+    [[nodiscard]] static auto harness() -> std::string;
+
+    auto run() -> Report;
+
+    static auto printReport(std::ostream& out, const Report& report) -> void;
+    [[nodiscard]] static auto toJson(const Report& report) -> std::string;
+
+private:
+    Options options;
+
+    auto generateRuntime(Report& report) -> bool;
+};
+
+#endif // FORTH_RUNTIME_BENCH_H
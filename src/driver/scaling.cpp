@@ -0,0 +1,193 @@
+#include "driver/scaling.h"
+#include "common/utils.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+using namespace std::chrono;
+
+namespace {
+
+constexpr const char* PHASES[] = {"lex", "parse", "semantic", "codegen"};
+constexpr size_t PLOT_WIDTH = 30;
+
+auto toMilliseconds(nanoseconds duration) -> double {
+    return duration_cast<microseconds>(duration).count() / 1000.0;
+}
+
+auto phaseTime(const ForthBenchmark::ProgramResult& result, const std::string& phase) -> nanoseconds {
+    if (phase == "lex") return result.lex;
+    if (phase == "parse") return result.parse;
+    if (phase == "semantic") return result.semantic;
+    if (phase == "codegen") return result.codegen;
+    return result.total();
+}
+
+auto phaseMemory(const ForthBenchmark::ProgramResult& result, const std::string& phase) -> uint64_t {
+    auto peak = result.phasePeakBytes.find(phase);
+    return peak != result.phasePeakBytes.end() ? peak->second : result.peakHeapBytes;
+}
+
+} // namespace
+
+ForthScaling::ForthScaling(Options options) : options(std::move(options)) {}
+
+auto ForthScaling::program(size_t size) const -> std::string {
+    ForthProgramGenerator::Options shape = options.program;
+    shape.words = size;
+    shape.calls = std::max<size_t>(8, size / 8);
+    return ForthProgramGenerator(shape).generate();
+}
+
+auto ForthScaling::runSize(size_t size) -> Point {
+    ForthBenchmark::Options benchmarkOptions;
+    benchmarkOptions.minRepetitions = options.repetitions;
+    benchmarkOptions.minTime = milliseconds{0};
+    ForthBenchmark benchmark(benchmarkOptions);
+
+    Point point;
+    point.size = size;
+    point.result = benchmark.runProgram("generated/" + std::to_string(size), "scaling", program(size));
+    return point;
+}
+
+auto ForthScaling::run() -> std::vector<Point> {
+    std::vector<Point> points;
+    for (size_t size : options.sizes) {
+        points.push_back(runSize(size));
+    }
+    return points;
+}
+
+auto ForthScaling::fitExponent(const std::vector<double>& x, const std::vector<double>& y) -> double {
+    std::vector<std::pair<double, double>> logs;
+    for (size_t i = 0; i < std::min(x.size(), y.size()); i++) {
+        if (x[i] > 0 && y[i] > 0) logs.emplace_back(std::log(x[i]), std::log(y[i]));
+    }
+    if (logs.size() < 2) return 0.0;
+
+    double meanX = 0, meanY = 0;
+    for (const auto& [lx, ly] : logs) {
+        meanX += lx;
+        meanY += ly;
+    }
+    meanX /= logs.size();
+    meanY /= logs.size();
+    double covariance = 0, variance = 0;
+    for (const auto& [lx, ly] : logs) {
+        covariance += (lx - meanX) * (ly - meanY);
+        variance += (lx - meanX) * (lx - meanX);
+    }
+    return variance > 0 ? covariance / variance : 0.0;
+}
+
+auto ForthScaling::growth(const std::vector<Point>& points) -> std::vector<Growth> {
+    std::vector<double> sizes;
+    for (const auto& point : points) {
+        if (point.result.success) sizes.push_back(static_cast<double>(point.size));
+    }
+
+    std::vector<Growth> growths;
+    std::vector<std::string> phases(std::begin(PHASES), std::end(PHASES));
+    phases.emplace_back("total");
+    for (const auto& phase : phases) {
+        std::vector<double> times, memory;
+        for (const auto& point : points) {
+            if (!point.result.success) continue;
+            times.push_back(static_cast<double>(phaseTime(point.result, phase).count()));
+            memory.push_back(static_cast<double>(phaseMemory(point.result, phase)));
+        }
+        growths.push_back({phase, fitExponent(sizes, times), fitExponent(sizes, memory)});
+    }
+    return growths;
+}
+
+auto ForthScaling::printReport(std::ostream& out, const std::vector<Point>& points) const -> void {
+    out << "\n" << std::string(60, '=') << "\n";
+    out << "COMPILER SCALING (ms, peak heap MB per phase)\n";
+    out << std::string(60, '=') << "\n";
+    out << std::left << std::setw(9) << "Words" << std::right << std::setw(10) << "Source KB";
+    for (const char* phase : PHASES) {
+        out << std::setw(11) << phase << std::setw(8) << "MB";
+    }
+    out << std::setw(11) << "total" << "  Total time\n";
+    out << std::string(151, '-') << "\n";
+
+    nanoseconds slowest{1};
+    for (const auto& point : points) {
+        if (point.result.success) slowest = std::max(slowest, point.result.total());
+    }
+
+    for (const auto& point : points) {
+        const auto& result = point.result;
+        out << std::left << std::setw(9) << point.size << std::right;
+        if (!result.success) {
+            out << "  " << result.error << "\n";
+            continue;
+        }
+        out << std::fixed << std::setprecision(1) << std::setw(10) << result.sourceBytes / 1024.0;
+        for (const char* phase : PHASES) {
+            out << std::setprecision(2) << std::setw(11) << toMilliseconds(phaseTime(result, phase))
+                << std::setprecision(1) << std::setw(8) << phaseMemory(result, phase) / (1024.0 * 1024.0);
+        }
+        // Bars on a linear scale, so superlinear growth shows as a curve
+        const auto bar = static_cast<size_t>(PLOT_WIDTH * result.total().count() / slowest.count());
+        out << std::setprecision(2) << std::setw(11) << toMilliseconds(result.total()) << "  "
+            << std::string(std::max<size_t>(bar, 1), '#') << "\n";
+    }
+
+    out << std::string(151, '-') << "\n";
+    out << "Growth exponents (cost ~ words^k):\n";
+    for (const auto& phase : growth(points)) {
+        out << "  " << std::left << std::setw(10) << phase.phase << std::right << std::setprecision(2)
+            << "time " << std::setw(5) << phase.timeExponent << "   memory " << std::setw(5)
+            << phase.memoryExponent;
+        if (phase.timeExponent > options.superlinear || phase.memoryExponent > options.superlinear) {
+            out << "   superlinear";
+        }
+        out << "\n";
+    }
+}
+
+auto ForthScaling::toJson(const std::vector<Point>& points) const -> std::string {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n";
+    json << "  \"seed\": " << options.program.seed
+         << ", \"call_depth\": " << options.program.callDepth
+         << ", \"recursion\": " << options.program.recursion
+         << ", \"nesting\": " << options.program.nesting
+         << ", \"literal_density\": " << options.program.literalDensity
+         << ", \"string_density\": " << options.program.stringDensity << ",\n";
+    json << "  \"points\": [";
+    for (size_t i = 0; i < points.size(); i++) {
+        const auto& [size, result] = points[i];
+        json << (i ? ",\n" : "\n") << "    {\"words\": " << size
+             << ", \"success\": " << (result.success ? "true" : "false");
+        if (!result.success) {
+            json << ", \"error\": \"" << ForthUtils::jsonEscape(result.error) << "\"}";
+            continue;
+        }
+        json << ", \"source_bytes\": " << result.sourceBytes
+             << ", \"tokens\": " << result.tokens
+             << ", \"nodes\": " << result.nodes
+             << ", \"lines_of_c\": " << result.linesOfC;
+        for (const char* phase : PHASES) {
+            json << ", \"" << phase << "_ms\": " << toMilliseconds(phaseTime(result, phase))
+                 << ", \"" << phase << "_peak_bytes\": " << phaseMemory(result, phase);
+        }
+        json << ", \"total_ms\": " << toMilliseconds(result.total())
+             << ", \"peak_heap_bytes\": " << result.peakHeapBytes << "}";
+    }
+    json << "\n  ],\n";
+    json << "  \"growth\": [";
+    const auto growths = growth(points);
+    for (size_t i = 0; i < growths.size(); i++) {
+        json << (i ? ",\n" : "\n") << "    {\"phase\": \"" << growths[i].phase
+             << "\", \"time_exponent\": " << growths[i].timeExponent
+             << ", \"memory_exponent\": " << growths[i].memoryExponent << "}";
+    }
+    json << "\n  ]\n}\n";
+    return json.str();
+}
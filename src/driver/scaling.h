@@ -0,0 +1,63 @@
+#ifndef FORTH_SCALING_H
+#define FORTH_SCALING_H
+
+#include "driver/benchmark.h"
+#include "driver/program_generator.h"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Compiler scaling benchmark
+// ============================================================================
+//
+// `forth_compiler --scaling` compiles ForthProgramGenerator programs of
+// growing size (words besides MAIN) and reports the time and heap
+// high-water mark of every phase at each size. A least-squares fit of
+// log(cost) against log(size) gives each phase's growth exponent: about 1
+// for linear work, noticeably above it for passes that rescan the program
+// per word, which the report marks as superlinear.
+
+class ForthScaling {
+public:
+    struct Options {
+        std::vector<size_t> sizes{1000, 3000, 10000, 30000, 100000};
+        ForthProgramGenerator::Options program;   // words and calls are set per size
+        size_t repetitions = 1;                   // Phase times are the median
+        double superlinear = 1.2;                 // Exponent the report flags
+    };
+
+    struct Point {
+        size_t size = 0;
+        ForthBenchmark::ProgramResult result;
+    };
+
+    // Growth of one phase across the sweep
+    struct Growth {
+        std::string phase;
+        double timeExponent = 0.0;
+        double memoryExponent = 0.0;
+    };
+
+    explicit ForthScaling(Options options);
+
+    auto run() -> std::vector<Point>;
+    auto runSize(size_t size) -> Point;
+
+    // Program of `size` words with the configured shape
+    [[nodiscard]] auto program(size_t size) const -> std::string;
+
+    // Slope of the least-squares line through (log x, log y), skipping
+    // points with a zero coordinate; 0 with fewer than two usable points
+    [[nodiscard]] static auto fitExponent(const std::vector<double>& x, const std::vector<double>& y) -> double;
+    [[nodiscard]] static auto growth(const std::vector<Point>& points) -> std::vector<Growth>;
+
+    auto printReport(std::ostream& out, const std::vector<Point>& points) const -> void;
+    [[nodiscard]] auto toJson(const std::vector<Point>& points) const -> std::string;
+
+private:
+    Options options;
+};
+
+#endif // FORTH_SCALING_H
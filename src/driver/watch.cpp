@@ -0,0 +1,277 @@
+#include "driver/watch.h"
+#include "codegen/output_buffer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace std::chrono;
+
+namespace {
+
+constexpr uint32_t DIRECTORY_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE |
+                                      IN_ONLYDIR;
+
+auto toMilliseconds(nanoseconds duration) -> double {
+    return duration_cast<microseconds>(duration).count() / 1000.0;
+}
+
+} // namespace
+
+ForthWatcher::ForthWatcher(Options options) : options(std::move(options)) {
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        error = std::string("inotify_init1: ") + std::strerror(errno);
+    }
+    if (pipe2(stopPipe, O_NONBLOCK | O_CLOEXEC) != 0) {
+        error = std::string("pipe2: ") + std::strerror(errno);
+    }
+}
+
+ForthWatcher::~ForthWatcher() {
+    if (inotifyFd >= 0) ::close(inotifyFd);
+    for (int fd : stopPipe) {
+        if (fd >= 0) ::close(fd);
+    }
+}
+
+auto ForthWatcher::watch(const fs::path& path) -> bool {
+    if (!error.empty()) return false;
+    std::error_code ec;
+    root = fs::absolute(path, ec).lexically_normal();
+    if (fs::is_regular_file(root, ec)) {
+        rootIsFile = true;
+        return addDirectory(root.parent_path());
+    }
+    if (!fs::is_directory(root, ec)) {
+        error = "No such file or directory: " + path.string();
+        return false;
+    }
+
+    if (!addDirectory(root)) return false;
+    for (auto it = fs::recursive_directory_iterator(root, ec); !ec && it != fs::recursive_directory_iterator();
+         it.increment(ec)) {
+        if (it->is_directory() && !addDirectory(it->path())) return false;
+    }
+    return true;
+}
+
+auto ForthWatcher::addDirectory(const fs::path& dir) -> bool {
+    const int wd = inotify_add_watch(inotifyFd, dir.c_str(), DIRECTORY_EVENTS);
+    if (wd < 0) {
+        error = "inotify_add_watch " + dir.string() + ": " + std::strerror(errno);
+        return false;
+    }
+    watchedDirs[wd] = dir;
+    return true;
+}
+
+auto ForthWatcher::isProgram(const fs::path& path) const -> bool {
+    if (rootIsFile) return path == root;
+    const auto extension = path.extension();
+    return extension == ".fth" || extension == ".forth";
+}
+
+auto ForthWatcher::isSource(const fs::path& path) const -> bool {
+    return isProgram(path) || dependents.contains(path);
+}
+
+auto ForthWatcher::getSources() const -> std::vector<fs::path> {
+    if (rootIsFile) return {root};
+    std::vector<fs::path> sources;
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(root, ec); !ec && it != fs::recursive_directory_iterator();
+         it.increment(ec)) {
+        if (it->is_regular_file() && isProgram(it->path())) {
+            sources.push_back(it->path());
+        }
+    }
+    std::sort(sources.begin(), sources.end());
+    return sources;
+}
+
+auto ForthWatcher::getOutputDir(const fs::path& source) const -> fs::path {
+    if (rootIsFile) return options.batch.outputRoot;
+    // outputRoot/<path below the root, without extension>, stable as files come and go
+    return options.batch.outputRoot / fs::relative(source, root).replace_extension();
+}
+
+auto ForthWatcher::readEvents(std::set<fs::path>& changed) -> bool {
+    alignas(inotify_event) char buffer[16384];
+    for (;;) {
+        const ssize_t length = ::read(inotifyFd, buffer, sizeof(buffer));
+        if (length < 0 && errno == EINTR) continue;
+        if (length < 0 && errno == EAGAIN) return true;
+        if (length <= 0) {
+            error = std::string("inotify read: ") + std::strerror(errno);
+            return false;
+        }
+
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // Events were dropped; treat everything as changed
+                for (const auto& source : getSources()) changed.insert(source);
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                watchedDirs.erase(event->wd);
+                continue;
+            }
+            const auto dir = watchedDirs.find(event->wd);
+            if (dir == watchedDirs.end() || event->len == 0) continue;
+            const fs::path path = dir->second / event->name;
+
+            if (event->mask & IN_ISDIR) {
+                // A new subdirectory may already hold sources by the time it is watched
+                if (!rootIsFile && (event->mask & (IN_CREATE | IN_MOVED_TO)) && addDirectory(path)) {
+                    std::error_code ec;
+                    for (auto it = fs::recursive_directory_iterator(path, ec);
+                         !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+                        if (it->is_directory()) {
+                            addDirectory(it->path());
+                        } else if (isSource(it->path())) {
+                            changed.insert(it->path());
+                        }
+                    }
+                }
+                continue;
+            }
+            // Creation alone is followed by IN_CLOSE_WRITE once the file is written
+            if (!(event->mask & IN_CREATE) && isSource(path)) {
+                changed.insert(path);
+            }
+        }
+    }
+}
+
+auto ForthWatcher::waitForChanges(milliseconds timeout) -> std::vector<fs::path> {
+    const bool forever = timeout.count() < 0;
+    const auto deadline = steady_clock::now() + (forever ? milliseconds(0) : timeout);
+    std::set<fs::path> changed;
+
+    pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {stopPipe[0], POLLIN, 0}};
+    for (;;) {
+        int wait = static_cast<int>(options.debounce.count());
+        if (changed.empty()) {
+            wait = forever ? -1 : static_cast<int>(std::max<int64_t>(
+                0, duration_cast<milliseconds>(deadline - steady_clock::now()).count()));
+        }
+        const int ready = ::poll(fds, 2, wait);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready < 0) {
+            error = std::string("poll: ") + std::strerror(errno);
+            return {};
+        }
+        if (fds[1].revents) return {};   // stop(); the pipe stays readable
+        if (ready == 0) {
+            if (!changed.empty() || !forever) break;   // Quiet, or timed out
+            continue;
+        }
+        if (!readEvents(changed)) return {};
+    }
+    return {changed.begin(), changed.end()};
+}
+
+auto ForthWatcher::rebuild(const std::vector<fs::path>& sources) -> std::vector<ForthBatchCompiler::Result> {
+    // Programs including a changed file are rebuilt even though their own
+    // text is the same
+    std::vector<fs::path> queue = sources;
+    std::set<fs::path> forced;
+    for (const auto& source : sources) {
+        const auto users = dependents.find(source);
+        if (users == dependents.end()) continue;
+        for (const auto& user : users->second) {
+            if (forced.insert(user).second && std::find(queue.begin(), queue.end(), user) == queue.end()) {
+                queue.push_back(user);
+            }
+        }
+    }
+
+    std::vector<ForthBatchCompiler::Result> results;
+    for (const auto& source : queue) {
+        if (!isProgram(source)) continue;
+        std::ifstream input(source);
+        if (!input) {
+            // Deleted or renamed away; its output is left in place
+            if (builtHashes.erase(source) && options.log) {
+                *options.log << "➖ " << source.string() << " removed\n";
+            }
+            continue;
+        }
+        const std::string text{std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}};
+        const uint64_t hash = ChunkedBuffer::hashBytes(text);
+        const auto built = builtHashes.find(source);
+        if (built != builtHashes.end() && built->second == hash && !forced.contains(source)) {
+            continue;   // Saved without changes
+        }
+
+        auto result = ForthBatchCompiler::compileFile(source.string(), getOutputDir(source), options.batch, &cache);
+        builtHashes[source] = hash;
+        trackModules(result, source);
+        logResult(result);
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+auto ForthWatcher::trackModules(const ForthBatchCompiler::Result& result, const fs::path& source) -> void {
+    for (const auto& module : result.modules) {
+        dependents[module].insert(source);
+        // Libraries outside the watched tree need their directory watched too
+        const fs::path dir = module.parent_path();
+        const bool watched = std::any_of(watchedDirs.begin(), watchedDirs.end(),
+                                         [&dir](const auto& entry) { return entry.second == dir; });
+        if (!watched) {
+            addDirectory(dir);
+        }
+    }
+}
+
+auto ForthWatcher::run() -> void {
+    rebuild(getSources());
+    if (options.log) {
+        *options.log << "Watching " << root.string() << " (" << watchedDirs.size()
+                     << (watchedDirs.size() == 1 ? " directory" : " directories") << ")" << std::endl;
+    }
+    for (;;) {
+        const auto changed = waitForChanges(milliseconds(-1));
+        if (changed.empty()) break;
+        rebuild(changed);
+    }
+}
+
+auto ForthWatcher::stop() -> void {
+    // Async-signal-safe
+    const char byte = 1;
+    [[maybe_unused]] const ssize_t written = ::write(stopPipe[1], &byte, 1);
+}
+
+auto ForthWatcher::logResult(const ForthBatchCompiler::Result& result) -> void {
+    if (!options.log) return;
+    auto& out = *options.log;
+    if (!result.success) {
+        out << "❌ " << result.file << "\n";
+        for (const auto& message : result.errors) {
+            out << "  • " << message << "\n";
+        }
+        out << std::flush;
+        return;
+    }
+    out << "✅ " << result.file << " -> " << result.outputDir.string() << " (" << result.linesGenerated
+        << " lines";
+    if (result.wordsFromCache > 0) out << ", " << result.wordsFromCache << " words reused";
+    if (!result.warnings.empty()) out << ", " << result.warnings.size() << " warnings";
+    out << ", " << (result.filesGenerated - result.filesUnchanged) << " of " << result.filesGenerated
+        << " files rewritten) in " << std::fixed << std::setprecision(1) << toMilliseconds(result.total())
+        << " ms" << std::endl;
+}
@@ -0,0 +1,84 @@
+#ifndef FORTH_WATCH_H
+#define FORTH_WATCH_H
+
+#include "driver/batch.h"
+#include "driver/compile_cache.h"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Watch mode
+// ============================================================================
+//
+// `forth_compiler --watch <file|dir>` compiles the program (or every *.fth /
+// *.forth file below the directory) and then recompiles each source as it
+// changes, as reported by inotify. Everything is kept in one
+// ForthCompileCache between rebuilds: unchanged programs keep their front
+// end, unchanged word definitions are copied from the previous output, and
+// writeToFiles() leaves files whose content did not change untouched.
+// Directories are watched rather than files, so editors that save by
+// renaming a temporary file are seen too. Files a program INCLUDEs are
+// watched as well, wherever they are, and a change to one rebuilds every
+// program that includes it.
+
+class ForthWatcher {
+public:
+    struct Options {
+        ForthBatchCompiler::Options batch;   // Target, shards and output root
+        std::chrono::milliseconds debounce{20};   // Quiet time that ends a burst of events
+        std::ostream* log = nullptr;             // One line per rebuilt program
+    };
+
+    explicit ForthWatcher(Options options);
+    ~ForthWatcher();
+    ForthWatcher(const ForthWatcher&) = delete;
+    ForthWatcher& operator=(const ForthWatcher&) = delete;
+
+    // Start watching a source file or a directory tree
+    [[nodiscard]] auto watch(const std::filesystem::path& path) -> bool;
+
+    // Build everything once, then rebuild on every change until stop()
+    auto run() -> void;
+
+    // Sources that changed, after the first event and a quiet debounce
+    // period; empty on timeout or stop()
+    [[nodiscard]] auto waitForChanges(std::chrono::milliseconds timeout) -> std::vector<std::filesystem::path>;
+    // Recompile the given sources, and the programs that include them; ones
+    // whose text is unchanged since their last build are skipped
+    auto rebuild(const std::vector<std::filesystem::path>& sources) -> std::vector<ForthBatchCompiler::Result>;
+
+    // Callable from a signal handler or another thread
+    auto stop() -> void;
+
+    [[nodiscard]] auto getSources() const -> std::vector<std::filesystem::path>;
+    [[nodiscard]] auto getOutputDir(const std::filesystem::path& source) const -> std::filesystem::path;
+    [[nodiscard]] auto getError() const -> const std::string& { return error; }
+    [[nodiscard]] auto getCache() -> ForthCompileCache& { return cache; }
+
+private:
+    Options options;
+    ForthCompileCache cache;
+    std::filesystem::path root;
+    bool rootIsFile = false;
+    int inotifyFd = -1;
+    int stopPipe[2] = {-1, -1};
+    std::map<int, std::filesystem::path> watchedDirs;     // Watch descriptor -> directory
+    std::map<std::filesystem::path, uint64_t> builtHashes;   // Source -> hash of the text last built
+    std::map<std::filesystem::path, std::set<std::filesystem::path>> dependents;   // Included file -> programs
+    std::string error;
+
+    auto addDirectory(const std::filesystem::path& dir) -> bool;
+    auto readEvents(std::set<std::filesystem::path>& changed) -> bool;
+    [[nodiscard]] auto isProgram(const std::filesystem::path& path) const -> bool;
+    [[nodiscard]] auto isSource(const std::filesystem::path& path) const -> bool;   // Program or included file
+    auto trackModules(const ForthBatchCompiler::Result& result, const std::filesystem::path& source) -> void;
+    auto logResult(const ForthBatchCompiler::Result& result) -> void;
+};
+
+#endif // FORTH_WATCH_H
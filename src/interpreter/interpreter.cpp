@@ -0,0 +1,610 @@
+#include "interpreter/interpreter.h"
+#include "common/utils.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// Data space addresses are byte offsets from 0, as FORTH_DATA_ADDR in the
+// C runtime, so printed addresses agree; the string pool sits far above
+constexpr int64_t DATA_BASE = 0;
+constexpr int64_t STRING_BASE = 0x40000000;
+constexpr ForthInterpreter::Cell CELL_SIZE = sizeof(ForthInterpreter::Cell);
+
+enum class Builtin : uint8_t {
+    ADD, SUB, MUL, DIV, MOD, NEGATE, ABS, MIN, MAX, ONE_PLUS, ONE_MINUS,
+    EQUAL, NOT_EQUAL, LESS, GREATER, LESS_EQUAL, GREATER_EQUAL, ZERO_EQUAL, ZERO_LESS, ZERO_GREATER,
+    DUP, DROP, SWAP, OVER, ROT, NIP, TUCK,
+    AND, OR, XOR, NOT, LSHIFT, RSHIFT, TRUE, FALSE, DEPTH, CLEAR,
+    STORE, FETCH, BYTE_STORE, BYTE_FETCH, HERE, ALLOT, COMMA, CELLS, CELL_PLUS,
+    MOVE, CMOVE, CMOVE_UP, FILL, ERASE,
+    SUM, DOT_PRODUCT, MIN_REDUCE, MAX_REDUCE, MAP_ADD, SCALE,
+    DOT, EMIT, TYPE, CR, SPACE, SPACES, FLUSH,
+};
+
+const std::unordered_map<std::string, Builtin>& builtinTable() {
+    static const std::unordered_map<std::string, Builtin> table = {
+        {"+", Builtin::ADD}, {"-", Builtin::SUB}, {"*", Builtin::MUL}, {"/", Builtin::DIV},
+        {"MOD", Builtin::MOD}, {"NEGATE", Builtin::NEGATE}, {"ABS", Builtin::ABS},
+        {"MIN", Builtin::MIN}, {"MAX", Builtin::MAX}, {"1+", Builtin::ONE_PLUS}, {"1-", Builtin::ONE_MINUS},
+        {"=", Builtin::EQUAL}, {"<>", Builtin::NOT_EQUAL}, {"<", Builtin::LESS}, {">", Builtin::GREATER},
+        {"<=", Builtin::LESS_EQUAL}, {">=", Builtin::GREATER_EQUAL}, {"0=", Builtin::ZERO_EQUAL},
+        {"0<", Builtin::ZERO_LESS}, {"0>", Builtin::ZERO_GREATER},
+        {"DUP", Builtin::DUP}, {"DROP", Builtin::DROP}, {"SWAP", Builtin::SWAP}, {"OVER", Builtin::OVER},
+        {"ROT", Builtin::ROT}, {"NIP", Builtin::NIP}, {"TUCK", Builtin::TUCK},
+        {"AND", Builtin::AND}, {"OR", Builtin::OR}, {"XOR", Builtin::XOR}, {"NOT", Builtin::NOT},
+        {"LSHIFT", Builtin::LSHIFT}, {"RSHIFT", Builtin::RSHIFT}, {"TRUE", Builtin::TRUE},
+        {"FALSE", Builtin::FALSE}, {"DEPTH", Builtin::DEPTH}, {"CLEAR", Builtin::CLEAR},
+        {"!", Builtin::STORE}, {"@", Builtin::FETCH}, {"C!", Builtin::BYTE_STORE}, {"C@", Builtin::BYTE_FETCH},
+        {"HERE", Builtin::HERE}, {"ALLOT", Builtin::ALLOT}, {",", Builtin::COMMA},
+        {"CELLS", Builtin::CELLS}, {"CELL+", Builtin::CELL_PLUS},
+        {"MOVE", Builtin::MOVE}, {"CMOVE", Builtin::CMOVE}, {"CMOVE>", Builtin::CMOVE_UP},
+        {"FILL", Builtin::FILL}, {"ERASE", Builtin::ERASE},
+        {"SUM", Builtin::SUM}, {"DOT", Builtin::DOT_PRODUCT}, {"MIN-REDUCE", Builtin::MIN_REDUCE},
+        {"MAX-REDUCE", Builtin::MAX_REDUCE}, {"MAP+", Builtin::MAP_ADD}, {"SCALE", Builtin::SCALE},
+        {".", Builtin::DOT}, {"EMIT", Builtin::EMIT}, {"TYPE", Builtin::TYPE}, {"CR", Builtin::CR},
+        {"SPACE", Builtin::SPACE}, {"SPACES", Builtin::SPACES}, {"FLUSH", Builtin::FLUSH},
+    };
+    return table;
+}
+
+// Two's complement wraparound, as the 32-bit target computes it
+ForthInterpreter::Cell wrap(int64_t value) {
+    return static_cast<ForthInterpreter::Cell>(static_cast<uint32_t>(value));
+}
+
+ForthInterpreter::Cell flag(bool value) {
+    return value ? -1 : 0;
+}
+
+} // namespace
+
+ForthInterpreter::ForthInterpreter() : ForthInterpreter(Options{}) {}
+
+ForthInterpreter::ForthInterpreter(const Options& opts) : options(opts) {
+    stack.reserve(options.stackSize);
+    dataSpace.assign(options.dataSpaceSize, 0);
+}
+
+// ============================================================================
+// Definitions
+// ============================================================================
+
+auto ForthInterpreter::load(const ProgramNode& program) -> void {
+    for (const auto* statements : program.getStatementLists()) {
+        for (const auto& child : *statements) {
+            if (child->getType() == ASTNode::NodeType::WORD_DEFINITION) {
+                defineWord(static_cast<const WordDefinitionNode&>(*child).getWordName(), *child);
+            } else if (child->getType() == ASTNode::NodeType::VARIABLE_DECLARATION ||
+                       child->getType() == ASTNode::NodeType::CONSTANT_DECLARATION) {
+                const auto& declaration = static_cast<const VariableDeclarationNode&>(*child);
+                if (!declaration.isTask() && !declaration.isChannel()) {
+                    const std::string name = ForthUtils::toUpper(declaration.getVarName());
+                    if (!valueIndex.contains(name)) {
+                        valueIndex[name] = values.size();
+                        values.push_back(0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+auto ForthInterpreter::defineWord(const std::string& name, const ASTNode& body) -> void {
+    Word word;
+    word.name = ForthUtils::toUpper(name);
+    word.body = &body;
+    auto existing = wordIndex.find(word.name);
+    if (existing != wordIndex.end()) {
+        // The last definition wins, as in the generated code
+        words[existing->second] = std::move(word);
+        return;
+    }
+    wordIndex[word.name] = words.size();
+    words.push_back(std::move(word));
+}
+
+auto ForthInterpreter::defineConstant(const std::string& name, Cell value) -> void {
+    const std::string upper = ForthUtils::toUpper(name);
+    auto existing = valueIndex.find(upper);
+    if (existing != valueIndex.end()) {
+        values[existing->second] = value;
+        return;
+    }
+    valueIndex[upper] = values.size();
+    values.push_back(value);
+}
+
+// ============================================================================
+// Compilation
+// ============================================================================
+
+auto ForthInterpreter::compile(Word& word) -> void {
+    // Calls are compiled to word indices, so recursion needs no special case
+    std::vector<Instruction> code;
+    for (const auto& child : word.body->getChildren()) {
+        compileNode(*child, code);
+    }
+    word.code = std::move(code);
+    word.compiled = true;
+}
+
+auto ForthInterpreter::compileNode(const ASTNode& node, std::vector<Instruction>& code) -> void {
+    switch (node.getType()) {
+        case ASTNode::NodeType::NUMBER_LITERAL: {
+            const auto& number = static_cast<const NumberLiteralNode&>(node);
+            const std::string& text = number.getValue();
+            int64_t value = 0;
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (number.isFloatingPoint() || ec != std::errc() || end != text.data() + text.size()) {
+                throw Unsupported("Number not supported by the interpreter: " + text);
+            }
+            code.push_back({Op::PUSH, wrap(value)});
+            break;
+        }
+        case ASTNode::NodeType::STRING_LITERAL: {
+            const auto& string = static_cast<const StringLiteralNode&>(node);
+            code.push_back({string.isPrint() ? Op::PRINT : Op::PUSH_STRING, internString(string.getValue())});
+            break;
+        }
+        case ASTNode::NodeType::MATH_OPERATION:
+            compileName(static_cast<const MathOperationNode&>(node).getOperation(), code);
+            break;
+        case ASTNode::NodeType::WORD_CALL: {
+            const auto& call = static_cast<const WordCallNode&>(node);
+            if (!call.getParsedName().empty()) {
+                throw Unsupported("Word not supported by the interpreter: " + call.getWordName());
+            }
+            compileName(call.getWordName(), code);
+            break;
+        }
+        case ASTNode::NodeType::IF_STATEMENT: {
+            const auto& branch = static_cast<const IfStatementNode&>(node);
+            const size_t test = code.size();
+            code.push_back({Op::BRANCH_ZERO, 0});
+            if (branch.getThenBranch()) {
+                for (const auto& child : branch.getThenBranch()->getChildren()) compileNode(*child, code);
+            }
+            if (branch.getElseBranch()) {
+                const size_t skip = code.size();
+                code.push_back({Op::JUMP, 0});
+                code[test].operand = static_cast<int64_t>(code.size());
+                for (const auto& child : branch.getElseBranch()->getChildren()) compileNode(*child, code);
+                code[skip].operand = static_cast<int64_t>(code.size());
+            } else {
+                code[test].operand = static_cast<int64_t>(code.size());
+            }
+            break;
+        }
+        case ASTNode::NodeType::BEGIN_UNTIL_LOOP: {
+            const auto& loop = static_cast<const BeginUntilLoopNode&>(node);
+            const size_t start = code.size();
+            if (loop.getBody()) {
+                for (const auto& child : loop.getBody()->getChildren()) compileNode(*child, code);
+            }
+            code.push_back({Op::BRANCH_ZERO, static_cast<int64_t>(start)});
+            break;
+        }
+        case ASTNode::NodeType::VARIABLE_DECLARATION:
+        case ASTNode::NodeType::CONSTANT_DECLARATION:
+            declarations.push_back(static_cast<const VariableDeclarationNode*>(&node));
+            code.push_back({Op::DECLARE, static_cast<int64_t>(declarations.size() - 1)});
+            break;
+        case ASTNode::NodeType::WORD_DEFINITION:
+            break;  // Defined by load()
+        default:
+            throw Unsupported("Statement not supported by the interpreter: " + node.toString());
+    }
+}
+
+auto ForthInterpreter::compileName(const std::string& name, std::vector<Instruction>& code) -> void {
+    const std::string upper = ForthUtils::toUpper(name);
+    if (auto word = wordIndex.find(upper); word != wordIndex.end()) {
+        code.push_back({Op::CALL, static_cast<int64_t>(word->second)});
+    } else if (auto value = valueIndex.find(upper); value != valueIndex.end()) {
+        code.push_back({Op::VALUE, static_cast<int64_t>(value->second)});
+    } else if (auto builtin = builtinTable().find(upper); builtin != builtinTable().end()) {
+        code.push_back({Op::BUILTIN, static_cast<int64_t>(builtin->second)});
+    } else {
+        throw Unsupported("Word not supported by the interpreter: " + upper);
+    }
+}
+
+auto ForthInterpreter::internString(const std::string& text) -> int64_t {
+    auto existing = std::find(strings.begin(), strings.end(), text);
+    if (existing != strings.end()) return existing - strings.begin();
+    strings.push_back(text);
+    stringAddresses.push_back(static_cast<Cell>(STRING_BASE + stringSpace.size()));
+    stringSpace.insert(stringSpace.end(), text.begin(), text.end());
+    return static_cast<int64_t>(strings.size() - 1);
+}
+
+// ============================================================================
+// Execution
+// ============================================================================
+
+auto ForthInterpreter::run(const ProgramNode& program) -> void {
+    load(program);
+    const bool hasMain = wordIndex.contains("MAIN");
+    for (const auto* statements : program.getStatementLists()) {
+        std::vector<Instruction> code;
+        for (const auto& child : *statements) {
+            const auto* call = dynamic_cast<const WordCallNode*>(child.get());
+            if (hasMain && call && ForthUtils::toUpper(call->getWordName()) == "MAIN") continue;
+            compileNode(*child, code);
+        }
+        runCode(code);
+    }
+    if (hasMain) {
+        call("MAIN");
+    }
+}
+
+auto ForthInterpreter::execute(const ASTNode& node) -> void {
+    std::vector<Instruction> code;
+    compileNode(node, code);
+    runCode(code);
+}
+
+auto ForthInterpreter::call(const std::string& name) -> void {
+    auto word = wordIndex.find(ForthUtils::toUpper(name));
+    if (word == wordIndex.end()) {
+        throw Error("Undefined word: " + name);
+    }
+    invoke(word->second);
+}
+
+auto ForthInterpreter::invoke(size_t index) -> void {
+    if (callDepth >= options.maxCallDepth) {
+        throw Error("Return stack overflow in " + words[index].name);
+    }
+    if (!words[index].compiled) {
+        compile(words[index]);
+    }
+    callDepth++;
+    try {
+        runCode(words[index].code);
+    } catch (...) {
+        callDepth--;
+        throw;
+    }
+    callDepth--;
+}
+
+auto ForthInterpreter::runCode(const std::vector<Instruction>& code) -> void {
+    for (size_t pc = 0; pc < code.size();) {
+        if (options.maxSteps && ++steps > options.maxSteps) {
+            throw Error("Step limit of " + std::to_string(options.maxSteps) + " exceeded");
+        }
+        const Instruction& instruction = code[pc++];
+        switch (instruction.op) {
+            case Op::PUSH:
+                push(static_cast<Cell>(instruction.operand));
+                break;
+            case Op::VALUE:
+                push(values[instruction.operand]);
+                break;
+            case Op::CALL:
+                invoke(static_cast<size_t>(instruction.operand));
+                break;
+            case Op::BUILTIN:
+                builtin(instruction.operand);
+                break;
+            case Op::BRANCH_ZERO:
+                if (pop() == 0) pc = static_cast<size_t>(instruction.operand);
+                break;
+            case Op::JUMP:
+                pc = static_cast<size_t>(instruction.operand);
+                break;
+            case Op::PRINT:
+                output += strings[instruction.operand];
+                break;
+            case Op::PUSH_STRING:
+                push(stringAddresses[instruction.operand]);
+                push(static_cast<Cell>(strings[instruction.operand].size()));
+                break;
+            case Op::DECLARE:
+                declare(*declarations[instruction.operand]);
+                break;
+        }
+    }
+}
+
+auto ForthInterpreter::declare(const VariableDeclarationNode& node) -> void {
+    const std::string name = ForthUtils::toUpper(node.getVarName());
+    if (node.isTask() || node.isChannel()) {
+        throw Unsupported(std::string(node.isTask() ? "TASK" : "CHANNEL") + " is not supported by the interpreter: " + name);
+    }
+    auto slot = valueIndex.find(name);
+    if (slot == valueIndex.end()) {
+        slot = valueIndex.emplace(name, values.size()).first;
+        values.push_back(0);
+    }
+    if (node.isConst()) {
+        values[slot->second] = pop();
+        return;
+    }
+    here = (here + CELL_SIZE - 1) / CELL_SIZE * CELL_SIZE;
+    const Cell address = static_cast<Cell>(DATA_BASE + here);
+    values[slot->second] = address;
+    if (!node.isCreate()) {
+        allot(CELL_SIZE);
+        std::memset(cellAt(address), 0, CELL_SIZE);
+    }
+}
+
+auto ForthInterpreter::push(Cell value) -> void {
+    if (stack.size() >= options.stackSize) {
+        throw Error("Stack overflow");
+    }
+    stack.push_back(value);
+}
+
+auto ForthInterpreter::pop() -> Cell {
+    if (stack.empty()) {
+        throw Error("Stack underflow");
+    }
+    Cell value = stack.back();
+    stack.pop_back();
+    return value;
+}
+
+auto ForthInterpreter::byteAt(Cell address) -> uint8_t* {
+    const int64_t offset = static_cast<int64_t>(address) - DATA_BASE;
+    if (offset < 0 || offset >= static_cast<int64_t>(dataSpace.size())) {
+        throw Error("Address outside the data space: " + std::to_string(address));
+    }
+    return dataSpace.data() + offset;
+}
+
+auto ForthInterpreter::cellAt(Cell address) -> uint8_t* {
+    const int64_t offset = static_cast<int64_t>(address) - DATA_BASE;
+    if (offset < 0 || offset + CELL_SIZE > static_cast<int64_t>(dataSpace.size())) {
+        throw Error("Address outside the data space: " + std::to_string(address));
+    }
+    return dataSpace.data() + offset;
+}
+
+auto ForthInterpreter::readByte(Cell address) const -> uint8_t {
+    const int64_t string = static_cast<int64_t>(address) - STRING_BASE;
+    if (string >= 0 && string < static_cast<int64_t>(stringSpace.size())) {
+        return static_cast<uint8_t>(stringSpace[string]);
+    }
+    const int64_t offset = static_cast<int64_t>(address) - DATA_BASE;
+    if (offset < 0 || offset >= static_cast<int64_t>(dataSpace.size())) {
+        throw Error("Address outside the data space: " + std::to_string(address));
+    }
+    return dataSpace[offset];
+}
+
+auto ForthInterpreter::allot(Cell bytes) -> void {
+    const int64_t next = static_cast<int64_t>(here) + bytes;
+    if (next < 0 || next > static_cast<int64_t>(dataSpace.size())) {
+        throw Error("ALLOT outside data space");
+    }
+    here = static_cast<Cell>(next);
+}
+
+auto ForthInterpreter::print(Cell value) -> void {
+    output += std::to_string(value);
+    output += ' ';
+}
+
+auto ForthInterpreter::builtin(int64_t which) -> void {
+    auto binary = [this](auto operation) {
+        Cell b = pop();
+        Cell a = pop();
+        push(operation(a, b));
+    };
+    auto unary = [this](auto operation) {
+        push(operation(pop()));
+    };
+
+    switch (static_cast<Builtin>(which)) {
+        case Builtin::ADD: binary([](Cell a, Cell b) { return wrap(int64_t{a} + b); }); break;
+        case Builtin::SUB: binary([](Cell a, Cell b) { return wrap(int64_t{a} - b); }); break;
+        case Builtin::MUL: binary([](Cell a, Cell b) { return wrap(int64_t{a} * b); }); break;
+        case Builtin::DIV: binary([](Cell a, Cell b) { return b == 0 ? 0 : wrap(int64_t{a} / b); }); break;
+        case Builtin::MOD: binary([](Cell a, Cell b) { return b == 0 ? 0 : wrap(int64_t{a} % b); }); break;
+        case Builtin::NEGATE: unary([](Cell a) { return wrap(-int64_t{a}); }); break;
+        case Builtin::ABS: unary([](Cell a) { return wrap(a < 0 ? -int64_t{a} : a); }); break;
+        case Builtin::MIN: binary([](Cell a, Cell b) { return std::min(a, b); }); break;
+        case Builtin::MAX: binary([](Cell a, Cell b) { return std::max(a, b); }); break;
+        case Builtin::ONE_PLUS: unary([](Cell a) { return wrap(int64_t{a} + 1); }); break;
+        case Builtin::ONE_MINUS: unary([](Cell a) { return wrap(int64_t{a} - 1); }); break;
+
+        case Builtin::EQUAL: binary([](Cell a, Cell b) { return flag(a == b); }); break;
+        case Builtin::NOT_EQUAL: binary([](Cell a, Cell b) { return flag(a != b); }); break;
+        case Builtin::LESS: binary([](Cell a, Cell b) { return flag(a < b); }); break;
+        case Builtin::GREATER: binary([](Cell a, Cell b) { return flag(a > b); }); break;
+        case Builtin::LESS_EQUAL: binary([](Cell a, Cell b) { return flag(a <= b); }); break;
+        case Builtin::GREATER_EQUAL: binary([](Cell a, Cell b) { return flag(a >= b); }); break;
+        case Builtin::ZERO_EQUAL: unary([](Cell a) { return flag(a == 0); }); break;
+        case Builtin::ZERO_LESS: unary([](Cell a) { return flag(a < 0); }); break;
+        case Builtin::ZERO_GREATER: unary([](Cell a) { return flag(a > 0); }); break;
+
+        case Builtin::DUP: {
+            Cell a = pop();
+            push(a);
+            push(a);
+            break;
+        }
+        case Builtin::DROP: pop(); break;
+        case Builtin::SWAP: {
+            Cell b = pop();
+            Cell a = pop();
+            push(b);
+            push(a);
+            break;
+        }
+        case Builtin::OVER:
+        case Builtin::ROT: {
+            // The runtime leaves a shallow stack alone
+            const size_t needed = static_cast<Builtin>(which) == Builtin::OVER ? 2 : 3;
+            if (stack.size() < needed) {
+                if (options.strictStack) throw Error("Stack underflow");
+                break;
+            }
+            if (needed == 2) {
+                push(stack[stack.size() - 2]);
+            } else {
+                std::rotate(stack.end() - 3, stack.end() - 2, stack.end());
+            }
+            break;
+        }
+        case Builtin::NIP: {
+            Cell b = pop();
+            pop();
+            push(b);
+            break;
+        }
+        case Builtin::TUCK: {
+            Cell b = pop();
+            Cell a = pop();
+            push(b);
+            push(a);
+            push(b);
+            break;
+        }
+
+        case Builtin::AND: binary([](Cell a, Cell b) { return a & b; }); break;
+        case Builtin::OR: binary([](Cell a, Cell b) { return a | b; }); break;
+        case Builtin::XOR: binary([](Cell a, Cell b) { return a ^ b; }); break;
+        case Builtin::NOT: unary([](Cell a) { return ~a; }); break;
+        case Builtin::LSHIFT:
+            binary([](Cell a, Cell b) {
+                return static_cast<uint32_t>(b) >= 32 ? 0 : wrap(static_cast<uint32_t>(a) << b);
+            });
+            break;
+        case Builtin::RSHIFT:
+            binary([](Cell a, Cell b) {
+                return static_cast<uint32_t>(b) >= 32 ? 0 : wrap(static_cast<uint32_t>(a) >> b);
+            });
+            break;
+        case Builtin::TRUE: push(-1); break;
+        case Builtin::FALSE: push(0); break;
+        case Builtin::DEPTH: push(static_cast<Cell>(stack.size())); break;
+        case Builtin::CLEAR: stack.clear(); break;
+
+        case Builtin::STORE: {
+            Cell address = pop();
+            Cell value = pop();
+            std::memcpy(cellAt(address), &value, sizeof(value));
+            break;
+        }
+        case Builtin::FETCH: {
+            Cell value = 0;
+            std::memcpy(&value, cellAt(pop()), sizeof(value));
+            push(value);
+            break;
+        }
+        case Builtin::BYTE_STORE: {
+            Cell address = pop();
+            *byteAt(address) = static_cast<uint8_t>(pop());
+            break;
+        }
+        case Builtin::BYTE_FETCH: push(readByte(pop())); break;
+        case Builtin::HERE: push(static_cast<Cell>(DATA_BASE + here)); break;
+        case Builtin::ALLOT: allot(pop()); break;
+        case Builtin::COMMA: {
+            Cell value = pop();
+            here = (here + CELL_SIZE - 1) / CELL_SIZE * CELL_SIZE;
+            allot(CELL_SIZE);
+            std::memcpy(cellAt(static_cast<Cell>(DATA_BASE + here - CELL_SIZE)), &value, sizeof(value));
+            break;
+        }
+        case Builtin::CELLS: unary([](Cell a) { return wrap(int64_t{a} * CELL_SIZE); }); break;
+        case Builtin::CELL_PLUS: unary([](Cell a) { return wrap(int64_t{a} + CELL_SIZE); }); break;
+
+        case Builtin::MOVE:
+        case Builtin::CMOVE:
+        case Builtin::CMOVE_UP: {
+            Cell count = pop();
+            Cell to = pop();
+            Cell from = pop();
+            if (count <= 0) break;
+            // MOVE copies as if through a buffer; CMOVE goes up from the
+            // lowest address and CMOVE> down from the highest, byte by byte
+            const auto kind = static_cast<Builtin>(which);
+            const bool downward = kind == Builtin::CMOVE_UP || (kind == Builtin::MOVE && to > from);
+            for (Cell i = 0; i < count; i++) {
+                const Cell k = downward ? count - 1 - i : i;
+                *byteAt(to + k) = readByte(from + k);
+            }
+            break;
+        }
+        case Builtin::FILL:
+        case Builtin::ERASE: {
+            const Cell value = static_cast<Builtin>(which) == Builtin::FILL ? pop() : 0;
+            Cell count = pop();
+            Cell address = pop();
+            for (Cell i = 0; i < count; i++) *byteAt(address + i) = static_cast<uint8_t>(value);
+            break;
+        }
+
+        // Array words over n cells; sums wrap as the 32-bit target's do
+        case Builtin::SUM:
+        case Builtin::MIN_REDUCE:
+        case Builtin::MAX_REDUCE: {
+            Cell count = pop();
+            Cell address = pop();
+            const auto kind = static_cast<Builtin>(which);
+            int64_t result = kind == Builtin::SUM ? 0 : kind == Builtin::MIN_REDUCE ? INT32_MAX : INT32_MIN;
+            for (Cell i = 0; i < count; i++) {
+                Cell value = 0;
+                std::memcpy(&value, cellAt(address + i * CELL_SIZE), sizeof(value));
+                if (kind == Builtin::SUM) result = wrap(result + value);
+                else if (kind == Builtin::MIN_REDUCE) result = std::min<int64_t>(result, value);
+                else result = std::max<int64_t>(result, value);
+            }
+            push(static_cast<Cell>(result));
+            break;
+        }
+        case Builtin::DOT_PRODUCT: {
+            Cell count = pop();
+            Cell second = pop();
+            Cell first = pop();
+            Cell result = 0;
+            for (Cell i = 0; i < count; i++) {
+                Cell a = 0, b = 0;
+                std::memcpy(&a, cellAt(first + i * CELL_SIZE), sizeof(a));
+                std::memcpy(&b, cellAt(second + i * CELL_SIZE), sizeof(b));
+                result = wrap(int64_t{result} + int64_t{a} * b);
+            }
+            push(result);
+            break;
+        }
+        case Builtin::MAP_ADD:
+        case Builtin::SCALE: {
+            Cell operand = pop();
+            Cell count = pop();
+            Cell address = pop();
+            for (Cell i = 0; i < count; i++) {
+                Cell value = 0;
+                std::memcpy(&value, cellAt(address + i * CELL_SIZE), sizeof(value));
+                value = static_cast<Builtin>(which) == Builtin::MAP_ADD ? wrap(int64_t{value} + operand)
+                                                                        : wrap(int64_t{value} * operand);
+                std::memcpy(cellAt(address + i * CELL_SIZE), &value, sizeof(value));
+            }
+            break;
+        }
+
+        case Builtin::DOT: print(pop()); break;
+        case Builtin::EMIT: output += static_cast<char>(pop()); break;
+        case Builtin::TYPE: {
+            Cell length = pop();
+            Cell address = pop();
+            for (Cell i = 0; i < length; i++) output += static_cast<char>(readByte(address + i));
+            break;
+        }
+        case Builtin::CR: output += '\n'; break;
+        case Builtin::SPACE: output += ' '; break;
+        case Builtin::SPACES: {
+            Cell count = pop();
+            if (count > 0) output.append(static_cast<size_t>(count), ' ');
+            break;
+        }
+        case Builtin::FLUSH: break;
+    }
+}
@@ -0,0 +1,140 @@
+#ifndef FORTH_INTERPRETER_H
+#define FORTH_INTERPRETER_H
+
+#include "parser/ast.h"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// Reference interpreter
+// ============================================================================
+//
+// Executes the AST inside the compiler with the semantics of the generated C
+// runtime: 32-bit cells that wrap on overflow, 0 for division by zero,
+// -1/0 flags, "." printing the number and a space, OVER/ROT doing nothing on
+// a shallow stack. Each word body is compiled to a flat instruction list the
+// first time it is called.
+//
+// The code generator uses it to evaluate pure words on literal arguments at
+// compile time; it also serves as a quick reference executor to check the
+// output of the backends against. Anything it cannot model exactly - tasks,
+// channels, floats - throws Unsupported instead of guessing; stack
+// underflow, a full stack and running out of steps throw Error.
+
+class ForthInterpreter {
+public:
+    using Cell = int32_t;
+
+    struct Options {
+        size_t stackSize = 1024;              // Cells, as FORTH_STACK_SIZE
+        size_t dataSpaceSize = 64 * 1024;     // Bytes for VARIABLE, CREATE, "," and ALLOT
+        uint64_t maxSteps = 0;                // Instructions before giving up (0 = no limit)
+        size_t maxCallDepth = 256;
+        // OVER and ROT on a shallow stack underflow instead of doing
+        // nothing; for code whose stack below it is unknown
+        bool strictStack = false;
+    };
+
+    class Error : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+    // A word or construct the interpreter does not implement, as opposed to
+    // a program that fails at run time
+    class Unsupported : public Error {
+    public:
+        using Error::Error;
+    };
+
+    ForthInterpreter();
+    explicit ForthInterpreter(const Options& options);
+
+    // Define the words of a program and its modules without running anything
+    auto load(const ProgramNode& program) -> void;
+    // A word whose body is the children of `body` (a definition or a parsed
+    // inline body). The node must outlive the interpreter.
+    auto defineWord(const std::string& name, const ASTNode& body) -> void;
+    auto defineConstant(const std::string& name, Cell value) -> void;
+
+    // Run a program the way forth_program_main() does: the top-level code
+    // in order, then MAIN if it is defined. Top-level calls of MAIN are
+    // skipped when it is, so it runs once.
+    auto run(const ProgramNode& program) -> void;
+    // Execute one statement against the current state
+    auto execute(const ASTNode& node) -> void;
+    auto call(const std::string& name) -> void;
+
+    auto push(Cell value) -> void;
+    auto pop() -> Cell;
+    [[nodiscard]] auto getStack() const -> const std::vector<Cell>& { return stack; }
+    auto clearStack() -> void { stack.clear(); }
+
+    [[nodiscard]] auto getOutput() const -> const std::string& { return output; }
+    auto clearOutput() -> void { output.clear(); }
+
+    // Instructions executed; the step limit applies to this count
+    [[nodiscard]] auto getSteps() const -> uint64_t { return steps; }
+    auto resetSteps() -> void { steps = 0; }
+
+private:
+    enum class Op : uint8_t {
+        PUSH,           // operand: value
+        CALL,           // operand: word index
+        BUILTIN,        // operand: Builtin
+        BRANCH_ZERO,    // operand: target; pops the flag
+        JUMP,           // operand: target
+        PRINT,          // operand: string index
+        PUSH_STRING,    // operand: string index; pushes address and length
+        VALUE,          // operand: value index; a constant or a data word's address
+        DECLARE,        // operand: declaration index; runs a top-level declaration
+    };
+
+    struct Instruction {
+        Op op;
+        int64_t operand;
+    };
+
+    struct Word {
+        std::string name;
+        const ASTNode* body = nullptr;
+        std::vector<Instruction> code;
+        bool compiled = false;
+    };
+
+    std::vector<Word> words;
+    std::unordered_map<std::string, size_t> wordIndex;
+    std::unordered_map<std::string, size_t> valueIndex;
+    std::vector<Cell> values;                                 // CONSTANT values, VARIABLE/CREATE addresses
+    std::vector<const VariableDeclarationNode*> declarations; // Referenced by DECLARE
+    std::vector<std::string> strings;
+    std::vector<Cell> stringAddresses;
+    std::string stringSpace;                                  // Read-only, like the string pool
+
+    Options options;
+    std::vector<Cell> stack;
+    std::vector<uint8_t> dataSpace;
+    Cell here = 0;
+    std::string output;
+    uint64_t steps = 0;
+    size_t callDepth = 0;
+
+    auto compile(Word& word) -> void;
+    auto compileNode(const ASTNode& node, std::vector<Instruction>& code) -> void;
+    auto compileName(const std::string& name, std::vector<Instruction>& code) -> void;
+    auto internString(const std::string& text) -> int64_t;
+    auto runCode(const std::vector<Instruction>& code) -> void;
+    auto invoke(size_t index) -> void;
+    auto builtin(int64_t which) -> void;
+    auto declare(const VariableDeclarationNode& node) -> void;
+
+    auto cellAt(Cell address) -> uint8_t*;
+    auto byteAt(Cell address) -> uint8_t*;
+    [[nodiscard]] auto readByte(Cell address) const -> uint8_t;
+    auto allot(Cell bytes) -> void;
+    auto print(Cell value) -> void;
+};
+
+#endif // FORTH_INTERPRETER_H
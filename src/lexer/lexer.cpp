@@ -11,7 +11,8 @@ ForthLexer::ForthLexer()
     // Initialize control words
     controlWords = {
         ":", ";", "IF", "THEN", "ELSE", "BEGIN", "UNTIL", 
-        "DO", "LOOP", "WHILE", "REPEAT", "VARIABLE", "CONSTANT"
+        "DO", "LOOP", "WHILE", "REPEAT", "VARIABLE", "CONSTANT", "CREATE",
+        "TASK", "START", "CHANNEL"
     };
     
     // Initialize math words for detection
@@ -4,6 +4,10 @@
 #include <filesystem>
 #include <chrono>
 #include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+#include <string_view>
+#include <csignal>
 
 #include "lexer/lexer.h"
 #include "parser/parser.h"
@@ -11,6 +15,18 @@
 #include "dictionary/dictionary.h"
 #include "semantic/analyzer.h"
 #include "codegen/c_backend.h"  // Updated from llvm_backend.h
+#include "codegen/size_report.h"
+#include "driver/baseline.h"
+#include "driver/batch.h"
+#include "driver/benchmark.h"
+#include "driver/differential.h"
+#include "driver/runtime_bench.h"
+#include "driver/scaling.h"
+#include "driver/daemon.h"
+#include "driver/module_cache.h"
+#include "driver/watch.h"
+#include "common/thread_pool.h"
+#include "common/trace.h"
 #include "common/utils.h"
 #include "functional"
 
@@ -161,7 +177,8 @@ public:
     
     void visit(VariableDeclarationNode& node) override {
         printIndent();
-        std::cout << (node.isConst() ? "Constant: " : "Variable: ") 
+        std::cout << (node.isConst() ? "Constant: " : node.isCreate() ? "Create: " :
+                      node.isTask() ? "Task: " : node.isChannel() ? "Channel: " : "Variable: ") 
                   << node.getVarName() << "\n";
     }
 };
@@ -359,12 +376,499 @@ auto printStatistics(const std::vector<Token>& tokens,
               << (100.0 * codegenMs.count() / totalMs.count()) << "%\n";
 }
 
+// Enables tracing for its lifetime and writes the trace when the compile
+// finishes, however it finishes
+class TraceOutput {
+public:
+    explicit TraceOutput(std::string path) : path(std::move(path)) {
+        if (!this->path.empty()) ForthTrace::enable();
+    }
+    ~TraceOutput() {
+        if (path.empty()) return;
+        ForthTrace::disable();
+        const bool written = ForthTrace::write(path);
+        std::cout << (written ? "✅ Trace written to " : "❌ Failed to write trace ") << path << "\n";
+    }
+    TraceOutput(const TraceOutput&) = delete;
+    TraceOutput& operator=(const TraceOutput&) = delete;
+
+private:
+    std::string path;
+};
+
+// forth_compiler --batch [options] files... | @list
+auto runBatch(int argc, char* argv[]) -> int {
+    ForthBatchCompiler::Options options;
+    std::vector<std::string> inputs;
+    std::string traceFile;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+            options.outputRoot = argv[++i];
+        } else if ((arg == "-j" || arg == "--jobs") && i + 1 < argc) {
+            options.jobs = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--target" && i + 1 < argc) {
+            options.target = argv[++i];
+        } else if (arg == "--shards" && i + 1 < argc) {
+            options.shards = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--trace" && i + 1 < argc) {
+            traceFile = argv[++i];
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    
+    std::vector<std::string> files;
+    try {
+        files = ForthBatchCompiler::expandResponseFiles(inputs);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ " << e.what() << "\n";
+        return 1;
+    }
+    if (files.empty()) {
+        std::cerr << "Usage: " << argv[0] << " --batch [-o DIR] [-j N] [--target T] files... | @list\n";
+        return 1;
+    }
+    
+    const size_t threads = std::min(files.size(), options.jobs > 0 ? options.jobs
+                                                                   : ForthThreadPool::defaultThreadCount());
+    std::cout << "Batch: " << files.size() << " files on " << threads << " threads -> "
+              << options.outputRoot.string() << "\n";
+    
+    ForthBatchCompiler batch(options);
+    std::vector<ForthBatchCompiler::Result> results;
+    {
+        TraceOutput trace(traceFile);
+        results = batch.compile(files);
+    }
+    ForthBatchCompiler::printReport(std::cout, results, batch.getWallTime());
+    
+    fs::create_directories(options.outputRoot);
+    const fs::path jsonPath = options.outputRoot / "batch_report.json";
+    std::ofstream json(jsonPath);
+    json << ForthBatchCompiler::toJson(results, batch.getWallTime());
+    std::cout << (json ? "✅ JSON report written to " : "❌ Failed to write ") << jsonPath << "\n";
+    
+    const bool allCompiled = std::all_of(results.begin(), results.end(),
+                                         [](const auto& result) { return result.success; });
+    return allCompiled ? 0 : 1;
+}
+
+// forth_compiler -c <library> [-o DIR] [--target T]
+auto runCompileModule(int argc, char* argv[]) -> int {
+    ForthBatchCompiler::Options options;
+    fs::path file, outputDir;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+            outputDir = argv[++i];
+        } else if (arg == "--target" && i + 1 < argc) {
+            options.target = argv[++i];
+        } else if (file.empty() && !arg.starts_with("-")) {
+            file = arg;
+        } else {
+            file.clear();
+            break;
+        }
+    }
+    if (file.empty()) {
+        std::cerr << "Usage: " << argv[0] << " -c <library> [-o DIR] [--target T]\n";
+        return 1;
+    }
+    if (outputDir.empty()) {
+        outputDir = fs::absolute(file).parent_path();
+    }
+    
+    const auto result = ForthBatchCompiler::compileModule(file.string(), outputDir, options);
+    for (const auto& warning : result.warnings) {
+        std::cout << "  ⚠️  " << warning << "\n";
+    }
+    if (!result.success) {
+        std::cout << "❌ Module compilation failed:\n";
+        for (const auto& error : result.errors) {
+            std::cout << "  • " << error << "\n";
+        }
+        return 1;
+    }
+    
+    const auto interface = ForthModuleInterface::load(result.interface);
+    const auto inlinable = std::count_if(interface.words.begin(), interface.words.end(),
+                                         [](const auto& word) { return !word.inlineSource.empty(); });
+    std::cout << "✅ Module " << interface.module << ": " << interface.words.size() << " words ("
+              << inlinable << " inlinable), " << interface.constants.size() << " constants\n";
+    std::cout << "   " << (outputDir / interface.fragment).string() << "\n";
+    std::cout << "   " << result.interface.string() << "\n";
+    return 0;
+}
+
+// forth_compiler --benchmark [options] DIR
+auto runBenchmark(int argc, char* argv[]) -> int {
+    ForthBenchmark::Options options;
+    if (const char* cc = std::getenv("CC"); cc && *cc) {
+        options.compiler = cc;
+    }
+    ForthBenchmarkBaseline::Options compareOptions;
+    fs::path corpus;
+    fs::path jsonPath = "benchmark_report.json";
+    fs::path baselinePath, saveBaselinePath;
+    bool repetitionsGiven = false;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (arg == "--run") {
+            options.runGenerated = true;
+        } else if (arg == "--cc" && i + 1 < argc) {
+            options.compiler = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            options.minTime = milliseconds(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            options.minRepetitions = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+            options.runRepetitions = options.minRepetitions;
+            repetitionsGiven = true;
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (arg == "--save-baseline" && i + 1 < argc) {
+            saveBaselinePath = argv[++i];
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            compareOptions.threshold = std::max(0.0, std::atof(argv[++i]) / 100.0);
+        } else if (arg == "--alpha" && i + 1 < argc) {
+            compareOptions.alpha = std::atof(argv[++i]);
+        } else if (corpus.empty() && !arg.starts_with("-")) {
+            corpus = arg;
+        } else {
+            corpus.clear();
+            break;
+        }
+    }
+    if (corpus.empty() || !fs::is_directory(corpus)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " --benchmark [-o report.json] [--run] [--cc CC] [--min-time MS] [--repetitions N]\n"
+                  << "       [--save-baseline FILE] [--baseline FILE [--threshold PCT] [--alpha P]] DIR\n";
+        return 1;
+    }
+    
+    ForthBenchmarkBaseline::Programs baseline;
+    if (!baselinePath.empty()) {
+        try {
+            baseline = ForthBenchmarkBaseline::load(baselinePath);
+        } catch (const std::exception& e) {
+            std::cerr << "❌ " << e.what() << "\n";
+            return 1;
+        }
+    }
+    // The rank test needs enough repetitions on both sides to reach significance
+    if ((!baselinePath.empty() || !saveBaselinePath.empty()) && !repetitionsGiven) {
+        options.minRepetitions = std::max<size_t>(options.minRepetitions, 10);
+        options.runRepetitions = std::max<size_t>(options.runRepetitions, 10);
+    }
+    
+    std::cout << "Benchmark: " << corpus.string() << (options.runGenerated ? " (running generated code with "
+                                                                              + options.compiler + ")" : "")
+              << "\n";
+    ForthBenchmark benchmark(options);
+    const auto results = benchmark.run(corpus);
+    ForthBenchmark::printReport(std::cout, results);
+    
+    std::ofstream json(jsonPath);
+    json << ForthBenchmark::toJson(results);
+    std::cout << (json ? "✅ JSON report written to " : "❌ Failed to write ") << jsonPath << "\n";
+    
+    const bool allCompiled = std::all_of(results.begin(), results.end(),
+                                         [](const auto& result) { return result.success; });
+    const auto current = ForthBenchmarkBaseline::fromResults(results);
+    if (!saveBaselinePath.empty()) {
+        const bool saved = ForthBenchmarkBaseline::save(saveBaselinePath, current);
+        std::cout << (saved ? "✅ Baseline written to " : "❌ Failed to write ") << saveBaselinePath << "\n";
+        if (!saved) return 1;
+    }
+    if (!baselinePath.empty()) {
+        const auto comparison = ForthBenchmarkBaseline::compare(baseline, current, compareOptions);
+        ForthBenchmarkBaseline::printComparison(std::cout, comparison, compareOptions);
+        if (comparison.hasRegression()) {
+            std::cout << "❌ Slower than " << baselinePath << "\n";
+            return 3;
+        }
+    }
+    return allCompiled && !results.empty() ? 0 : 1;
+}
+
+// forth_compiler --differential [options] [DIR...]
+auto runDifferential(int argc, char* argv[]) -> int {
+    ForthDifferential::Options options;
+    if (const char* cc = std::getenv("CC"); cc && *cc) {
+        options.compiler = cc;
+    }
+    std::vector<fs::path> directories;
+    fs::path jsonPath = "differential_report.json";
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (arg == "--cc" && i + 1 < argc) {
+            options.compiler = argv[++i];
+        } else if (arg == "--generated" && i + 1 < argc) {
+            options.generated = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            options.runRepetitions = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (!arg.starts_with("-") && fs::is_directory(arg)) {
+            directories.emplace_back(arg);
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " --differential [-o report.json] [--cc CC] [--generated N] [--seed S]\n"
+                      << "       [--repetitions N] [DIR...]\n";
+            return 1;
+        }
+    }
+    
+    std::cout << "Differential execution: " << directories.size() << " director"
+              << (directories.size() == 1 ? "y" : "ies") << " + " << options.generated
+              << " generated programs (C built with " << options.compiler << ")\n";
+    ForthDifferential differential(options);
+    const auto results = differential.run(directories);
+    ForthDifferential::printReport(std::cout, results);
+    
+    std::ofstream json(jsonPath);
+    json << ForthDifferential::toJson(results);
+    std::cout << (json ? "✅ JSON report written to " : "❌ Failed to write ") << jsonPath << "\n";
+    
+    const bool agree = std::all_of(results.begin(), results.end(),
+                                   [](const auto& result) { return result.agrees(); });
+    if (!agree) {
+        std::cout << "❌ Configurations disagree\n";
+    }
+    return agree ? 0 : 1;
+}
+
+// Comma-separated sizes ("1000,10000,100000")
+auto parseSizes(const std::string& text) -> std::vector<size_t> {
+    std::vector<size_t> sizes;
+    std::istringstream fields(text);
+    std::string field;
+    while (std::getline(fields, field, ',')) {
+        if (const auto size = std::strtoull(field.c_str(), nullptr, 10); size > 0) {
+            sizes.push_back(static_cast<size_t>(size));
+        }
+    }
+    return sizes;
+}
+
+// forth_compiler --scaling [options]
+auto runScaling(int argc, char* argv[]) -> int {
+    ForthScaling::Options options;
+    fs::path jsonPath = "scaling_report.json";
+    bool valid = true;
+    for (int i = 2; i < argc && valid; ++i) {
+        const std::string arg{argv[i]};
+        const bool hasValue = i + 1 < argc;
+        auto number = [&]() { return static_cast<unsigned>(std::max(0, std::atoi(argv[++i]))); };
+        if ((arg == "-o" || arg == "--output") && hasValue) {
+            jsonPath = argv[++i];
+        } else if (arg == "--sizes" && hasValue) {
+            options.sizes = parseSizes(argv[++i]);
+            valid = !options.sizes.empty();
+        } else if (arg == "--seed" && hasValue) {
+            options.program.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--call-depth" && hasValue) {
+            options.program.callDepth = number();
+        } else if (arg == "--recursion" && hasValue) {
+            options.program.recursion = std::min(number(), 100u);
+        } else if (arg == "--nesting" && hasValue) {
+            options.program.nesting = number();
+        } else if (arg == "--literals" && hasValue) {
+            options.program.literalDensity = std::min(number(), 100u);
+        } else if (arg == "--strings" && hasValue) {
+            options.program.stringDensity = std::min(number(), 100u);
+        } else if (arg == "--repetitions" && hasValue) {
+            options.repetitions = std::max(1u, number());
+        } else {
+            valid = false;
+        }
+    }
+    if (!valid) {
+        std::cerr << "Usage: " << argv[0]
+                  << " --scaling [-o report.json] [--sizes N,N,...] [--seed S] [--call-depth D]\n"
+                  << "       [--recursion PCT] [--nesting N] [--literals PCT] [--strings PCT] [--repetitions N]\n";
+        return 1;
+    }
+    
+    std::cout << "Scaling: " << options.sizes.size() << " sizes up to " 
+              << *std::max_element(options.sizes.begin(), options.sizes.end()) << " words\n";
+    ForthScaling scaling(options);
+    const auto points = scaling.run();
+    scaling.printReport(std::cout, points);
+    
+    std::ofstream json(jsonPath);
+    json << scaling.toJson(points);
+    std::cout << (json ? "✅ JSON report written to " : "❌ Failed to write ") << jsonPath << "\n";
+    return std::all_of(points.begin(), points.end(), [](const auto& point) { return point.result.success; }) ? 0 : 1;
+}
+
+// forth_compiler --runtime-bench [options]
+auto runRuntimeBench(int argc, char* argv[]) -> int {
+    ForthRuntimeBenchmark::Options options;
+    if (const char* cc = std::getenv("CC"); cc && *cc) {
+        options.compiler = cc;
+    }
+    fs::path jsonPath = "runtime_bench_report.json";
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (arg == "--cc" && i + 1 < argc) {
+            options.compiler = argv[++i];
+        } else if (arg == "--cflags" && i + 1 < argc) {
+            options.flags = argv[++i];
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            options.iterations = static_cast<size_t>(std::max(1LL, std::atoll(argv[++i])));
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            options.repetitions = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " --runtime-bench [-o report.json] [--cc CC] [--cflags FLAGS] [--iterations N]"
+                      << " [--repetitions N]\n";
+            return 1;
+        }
+    }
+    
+    ForthRuntimeBenchmark benchmark(options);
+    const auto report = benchmark.run();
+    ForthRuntimeBenchmark::printReport(std::cout, report);
+    
+    std::ofstream json(jsonPath);
+    json << ForthRuntimeBenchmark::toJson(report);
+    std::cout << (json ? "✅ JSON report written to " : "❌ Failed to write ") << jsonPath << "\n";
+    return report.success ? 0 : 1;
+}
+
+// Set while --watch runs, for the signal handler
+ForthWatcher* activeWatcher = nullptr;
+
+// forth_compiler --watch <file|dir> [-o DIR] [--target T] [--shards N]
+auto runWatch(int argc, char* argv[]) -> int {
+    ForthWatcher::Options options;
+    options.batch.outputRoot = "forth_output";
+    options.log = &std::cout;
+    fs::path path;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+            options.batch.outputRoot = argv[++i];
+        } else if (arg == "--target" && i + 1 < argc) {
+            options.batch.target = argv[++i];
+        } else if (arg == "--shards" && i + 1 < argc) {
+            options.batch.shards = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (path.empty() && !arg.starts_with("-")) {
+            path = arg;
+        } else {
+            path.clear();
+            break;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "Usage: " << argv[0] << " --watch <file|dir> [-o DIR] [--target T] [--shards N]\n";
+        return 1;
+    }
+    
+    ForthWatcher watcher(options);
+    if (!watcher.watch(path)) {
+        std::cerr << "❌ " << watcher.getError() << "\n";
+        return 1;
+    }
+    // Build the builtins once, before the first compile is timed
+    (void)DictionaryFactory::sharedBuiltins();
+    
+    activeWatcher = &watcher;
+    auto onSignal = [](int) { if (activeWatcher) activeWatcher->stop(); };
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    watcher.run();
+    activeWatcher = nullptr;
+    
+    if (!watcher.getError().empty()) {
+        std::cerr << "❌ " << watcher.getError() << "\n";
+        return 1;
+    }
+    std::cout << "\nStopped watching " << path.string() << "\n";
+    return 0;
+}
+
+// forth_compiler --daemon [--socket PATH]
+auto runDaemon(int argc, char* argv[]) -> int {
+    ForthCompileServer::Options options;
+    options.log = &std::cout;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if (arg == "--socket" && i + 1 < argc) {
+            options.socketPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " --daemon [--socket PATH]\n";
+            return 1;
+        }
+    }
+    
+    ForthCompileServer server(options);
+    if (!server.listen()) {
+        std::cerr << "❌ " << server.getError() << "\n";
+        return 1;
+    }
+    // Build the builtins now so the first request is already warm
+    (void)DictionaryFactory::sharedBuiltins();
+    std::cout << "Compile daemon listening on " << options.socketPath.string() << std::endl;
+    
+    server.serve();
+    if (!server.getError().empty()) {
+        std::cerr << "❌ " << server.getError() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// forth_compiler --client [--socket PATH] <--batch options> files... | --status | --shutdown
+auto runClient(int argc, char* argv[]) -> int {
+    fs::path socketPath = ForthCompileServer::defaultSocketPath();
+    std::vector<std::string> args;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if (arg == "--socket" && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else {
+            args.push_back(arg);
+        }
+    }
+    
+    const int status = ForthCompileServer::runClient(socketPath, args, std::cout, std::cerr);
+    if (status < 0) {
+        std::cerr << "❌ No compile daemon on " << socketPath.string()
+                  << " (start one with " << argv[0] << " --daemon)\n";
+        return 2;
+    }
+    return status;
+}
+
 auto main(int argc, char* argv[]) -> int {
+    // The client only relays the daemon's output
+    if (argc > 1 && std::string_view(argv[1]) == "--client") {
+        return runClient(argc, argv);
+    }
+    
     std::cout << "FORTH-ESP32 Compiler v0.3.0\n";
     std::cout << "Phase 4: Semantic Analysis & C Code Generation\n\n";  // Updated
     
     if (argc < 2) {
         std::cerr << "Usage: " << argv[0] << " <forth_file> [options]\n";
+        std::cerr << "       " << argv[0] << " -c <library> [-o DIR] [--target T]\n";
+        std::cerr << "       " << argv[0] << " --batch [-o DIR] [-j N] [--target T] files... | @list\n";
+        std::cerr << "       " << argv[0] << " --benchmark [-o report.json] [--run] [--cc CC] DIR\n";
+        std::cerr << "       " << argv[0] << " --benchmark [--save-baseline FILE] [--baseline FILE] [--threshold PCT] DIR\n";
+        std::cerr << "       " << argv[0] << " --differential [-o report.json] [--generated N] [--seed S] [DIR...]\n";
+        std::cerr << "       " << argv[0] << " --scaling [-o report.json] [--sizes N,N,...] [--call-depth D] ...\n";
+        std::cerr << "       " << argv[0] << " --runtime-bench [-o report.json] [--cflags FLAGS] [--iterations N]\n";
+        std::cerr << "       " << argv[0] << " --watch <file|dir> [-o DIR] [--target T]\n";
+        std::cerr << "       " << argv[0] << " --daemon [--socket PATH]\n";
+        std::cerr << "       " << argv[0] << " --client [--socket PATH] [-o DIR] files... | --status | --shutdown\n";
         std::cerr << "Options:\n";
         std::cerr << "  -v, --verbose      Show detailed information\n";
         std::cerr << "  -t, --tokens       Show tokenization results\n";
@@ -377,14 +881,66 @@ auto main(int argc, char* argv[]) -> int {
         std::cerr << "  -o, --output       Output file for generated code\n";
         std::cerr << "  --target           Target architecture (default: esp32)\n";
         std::cerr << "  --create-esp32     Create ESP-IDF project\n";  // New option
+        std::cerr << "  -j, --jobs N       Generate word definitions on N threads (0 = all cores)\n";
+        std::cerr << "  --shards N         Split user words into N translation units\n";
+        std::cerr << "  --size-report      Compile the output and report measured sizes per word\n";
+        std::cerr << "  --cc COMPILER      C compiler for --size-report (default: $CC or cc)\n";
+        std::cerr << "  --iram-budget N    Fail when measured IRAM use exceeds N bytes\n";
+        std::cerr << "  --trace FILE       Write per-pass spans with allocations as a Chrome trace\n";
+        std::cerr << "  -c <library>       (first) Compile a library on its own into a C fragment and\n";
+        std::cerr << "                     an interface (.fi) that programs REQUIRE instead of the source\n";
+        std::cerr << "  --batch            Compile many files in one process, each into DIR/<name>\n";
+        std::cerr << "  --benchmark        Report per-phase compile throughput over a corpus\n";
+        std::cerr << "  --differential     Run programs on the interpreter and each C optimization level\n";
+        std::cerr << "                     and compare output, final stack, time and instructions\n";
+        std::cerr << "  --scaling          Compile generated programs of growing size and report\n";
+        std::cerr << "                     time, peak heap and growth exponent per phase\n";
+        std::cerr << "  --runtime-bench    Measure ns/op of the generated runtime primitives on the host\n";
+        std::cerr << "  --watch            Recompile sources as they change (inotify)\n";
+        std::cerr << "  --daemon           Serve compiles from warm caches on a Unix socket\n";
+        std::cerr << "  --client           Send a --batch style request to the daemon\n";
         return 1;
     }
     
+    if (std::string_view(argv[1]) == "-c" || std::string_view(argv[1]) == "--compile-module") {
+        return runCompileModule(argc, argv);
+    }
+    if (std::string_view(argv[1]) == "--batch") {
+        return runBatch(argc, argv);
+    }
+    if (std::string_view(argv[1]) == "--benchmark") {
+        return runBenchmark(argc, argv);
+    }
+    if (std::string_view(argv[1]) == "--differential") {
+        return runDifferential(argc, argv);
+    }
+    if (std::string_view(argv[1]) == "--scaling") {
+        return runScaling(argc, argv);
+    }
+    if (std::string_view(argv[1]) == "--runtime-bench") {
+        return runRuntimeBench(argc, argv);
+    }
+    if (std::string_view(argv[1]) == "--watch") {
+        return runWatch(argc, argv);
+    }
+    if (std::string_view(argv[1]) == "--daemon") {
+        return runDaemon(argc, argv);
+    }
+    
     const std::string filename{argv[1]};
     bool verbose = false, showTokens = false, showAST = false, showSemantic = false;
     bool showCodegen = false, showCode = false, showDict = false, showStats = false;
     bool createESP32Project = false;  // New flag
     std::string outputFile, target = "esp32";  // Updated default
+    std::string traceFile;
+    int jobs = 1;
+    int shards = 1;
+    bool sizeReport = false;
+    bool sizeReportFailed = false;  // Not measured, or over the IRAM budget
+    ForthSizeReport::Options sizeOptions;
+    if (const char* cc = std::getenv("CC"); cc && *cc) {
+        sizeOptions.compiler = cc;
+    }
     
     // Parse command line options
     for (int i = 2; i < argc; ++i) {
@@ -415,9 +971,32 @@ auto main(int argc, char* argv[]) -> int {
             if (i + 1 < argc) {
                 target = argv[++i];
             }
+        } else if (arg == "-j" || arg == "--jobs") {
+            if (i + 1 < argc) {
+                jobs = std::max(0, std::atoi(argv[++i]));
+            }
+        } else if (arg == "--shards") {
+            if (i + 1 < argc) {
+                shards = std::max(1, std::atoi(argv[++i]));
+            }
+        } else if (arg == "--size-report") {
+            sizeReport = true;
+        } else if (arg == "--cc") {
+            if (i + 1 < argc) {
+                sizeOptions.compiler = argv[++i];
+            }
+        } else if (arg == "--iram-budget") {
+            if (i + 1 < argc) {
+                sizeOptions.iramBudget = std::strtoull(argv[++i], nullptr, 10);
+            }
+        } else if (arg == "--trace") {
+            if (i + 1 < argc) {
+                traceFile = argv[++i];
+            }
         }
     }
     
+    TraceOutput trace(traceFile);
     try {
         // Read source file
         std::cout << "Reading file: " << filename << "\n";
@@ -434,7 +1013,9 @@ auto main(int argc, char* argv[]) -> int {
         // Phase 1: Lexical Analysis
         ForthLexer lexer;
         const auto lexStartTime = high_resolution_clock::now();
+        ForthTrace::Span lexSpan("pass", "lex");
         const auto tokens = lexer.tokenize(source);
+        lexSpan.end();
         const auto lexEndTime = high_resolution_clock::now();
         const auto lexDuration = lexEndTime - lexStartTime;
         
@@ -444,10 +1025,23 @@ auto main(int argc, char* argv[]) -> int {
             printTokenizationResults(tokens, true);
         }
         
-        // Phase 2: Parsing
+        // Phase 2: Parsing, after the modules the program includes
         ForthParser parser;
         const auto parseStartTime = high_resolution_clock::now();
+        ForthTrace::Span parseSpan("pass", "parse");
+        ForthModuleCache moduleCache(static_cast<size_t>(jobs));
+        const auto modules = moduleCache.resolve(ForthModuleCache::findIncludes(tokens), filename);
+        if (!modules.errors.empty()) {
+            std::cout << "\n❌ Include errors found:\n";
+            for (const auto& error : modules.errors) {
+                std::cout << "  • " << error << "\n";
+            }
+            return 1;
+        }
+        modules.importDefinitions(parser.getDictionary());
         auto ast = parser.parseProgram(tokens);
+        modules.attach(*ast);
+        parseSpan.end();
         const auto parseEndTime = high_resolution_clock::now();
         const auto parseDuration = parseEndTime - parseStartTime;
         
@@ -461,6 +1055,13 @@ auto main(int argc, char* argv[]) -> int {
         }
         
         std::cout << "✅ Parsing completed: " << ast->getChildCount() << " top-level statements\n";
+        if (!modules.modules.empty()) {
+            std::cout << "   Included " << modules.modules.size() << " module"
+                      << (modules.modules.size() == 1 ? "" : "s") << "\n";
+            for (const auto& warning : modules.warnings) {
+                std::cout << "  • " << warning << "\n";
+            }
+        }
         
         if (showAST || verbose) {
             printParseResults(*ast, showAST || verbose);
@@ -468,8 +1069,11 @@ auto main(int argc, char* argv[]) -> int {
         
         // Phase 3: Semantic Analysis
         SemanticAnalyzer analyzer(&parser.getDictionary());
+        modules.importWordEffects(analyzer);
         const auto semanticStartTime = high_resolution_clock::now();
+        ForthTrace::Span semanticSpan("pass", "semantic");
         const bool semanticSuccess = analyzer.analyze(*ast);
+        semanticSpan.end();
         const auto semanticEndTime = high_resolution_clock::now();
         const auto semanticDuration = semanticEndTime - semanticStartTime;
         
@@ -492,14 +1096,25 @@ auto main(int argc, char* argv[]) -> int {
         
         codegen->setSemanticAnalyzer(&analyzer);
         codegen->setDictionary(&parser.getDictionary());
+        modules.importInterfaces(*codegen);
+        codegen->setParallelEmission(jobs != 1, static_cast<size_t>(jobs));
+        codegen->setShardCount(static_cast<size_t>(shards));
         
         const auto codegenStartTime = high_resolution_clock::now();
+        ForthTrace::Span codegenSpan("pass", "codegen");
         bool codegenSuccess = codegen->generateCode(*ast);
+        codegenSpan.end();
         const auto codegenEndTime = high_resolution_clock::now();
         const auto codegenDuration = codegenEndTime - codegenStartTime;
         
         if (codegenSuccess && !codegen->hasErrors()) {
             std::cout << "✅ C code generation completed successfully\n";
+            const auto shardStats = codegen->getStatistics();
+            if (shardStats.shardsGenerated > 0) {
+                std::cout << "   Words split into " << shardStats.shardsGenerated
+                          << " translation units (" << shardStats.crossShardCalls
+                          << " cross-shard calls)\n";
+            }
         } else {
             std::cout << "❌ C code generation failed\n";
         }
@@ -531,12 +1146,40 @@ auto main(int argc, char* argv[]) -> int {
 		baseName = baseName.substr(0, baseName.find_last_of('.'));
 	    }
 	    
-	    if (codegen->writeToFiles(baseName)) {
+	    ForthTrace::Span writeSpan("pass", "write files");
+	    const bool written = codegen->writeToFiles(baseName);
+	    writeSpan.end();
+	    if (written) {
 		std::cout << "✅ C files written to directory: " << baseName << "\n";
+		const auto writeStats = codegen->getStatistics();
+		if (writeStats.filesUnchanged > 0) {
+		    std::cout << "   " << writeStats.filesUnchanged << " of " << writeStats.filesGenerated
+		              << " files unchanged (left untouched)\n";
+		}
 	    } else {
 		std::cout << "❌ Failed to write C files\n";
 	    }
 	}
+        // Measured size report from real object files
+        if (sizeReport && codegenSuccess && !codegen->hasErrors()) {
+            const fs::path reportDir = outputFile.empty()
+                ? fs::temp_directory_path() / "forth_size_report"
+                : fs::path(outputFile).replace_extension() / "size_report";
+            
+            sizeOptions.jobs = static_cast<size_t>(jobs);
+            ForthSizeReport report(sizeOptions);
+            std::cout << "\nMeasuring code size with " << sizeOptions.compiler << " in " << reportDir << "\n";
+            ForthTrace::Span sizeSpan("pass", "size report");
+            sizeReportFailed = !report.measure(*codegen, reportDir) || report.overIRAMBudget();
+            sizeSpan.end();
+            report.printTable(std::cout);
+            
+            const fs::path jsonPath = reportDir / "size_report.json";
+            std::ofstream json(jsonPath);
+            json << report.toJson();
+            std::cout << (json ? "✅ JSON report written to " : "❌ Failed to write ") << jsonPath << "\n";
+        }
+        
         // Create ESP-IDF project if requested
         if (createESP32Project && codegenSuccess && !codegen->hasErrors()) {
             std::string projectPath = fs::current_path() / "esp32_project";
@@ -650,5 +1293,5 @@ auto main(int argc, char* argv[]) -> int {
         return 1;
     }
     
-    return 0;
+    return sizeReportFailed ? 1 : 0;
 }
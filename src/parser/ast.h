@@ -86,9 +86,37 @@ public:
 
 // Program node - root of the AST
 class ProgramNode : public ASTNode {
+private:
+    // Modules pulled in by INCLUDE/REQUIRE, in dependency order. Their ASTs
+    // are shared with every other program that includes them and are never
+    // modified.
+    std::vector<std::shared_ptr<ProgramNode>> modules;
+
 public:
+    using StatementList = std::vector<std::unique_ptr<ASTNode>>;
+
     ProgramNode() : ASTNode(NodeType::PROGRAM) {}
-    
+
+    auto addModule(std::shared_ptr<ProgramNode> module) -> void {
+        modules.push_back(std::move(module));
+    }
+
+    [[nodiscard]] auto getModules() const -> const std::vector<std::shared_ptr<ProgramNode>>& {
+        return modules;
+    }
+
+    // Top-level statements in the order they run: each module's, then this
+    // program's own children
+    [[nodiscard]] auto getStatementLists() const -> std::vector<const StatementList*> {
+        std::vector<const StatementList*> lists;
+        lists.reserve(modules.size() + 1);
+        for (const auto& module : modules) {
+            lists.push_back(&module->getChildren());
+        }
+        lists.push_back(&children);
+        return lists;
+    }
+
     auto accept(ASTVisitor& visitor) -> void override;
     auto toString() const -> std::string override {
         return "Program[" + std::to_string(children.size()) + " statements]";
@@ -121,16 +149,22 @@ public:
 class WordCallNode : public ASTNode {
 private:
     std::string wordName;
+    std::string parsedName;  // Name read from the source by a parsing word (START name)
     
 public:
     WordCallNode(const std::string& name, int line, int column)
         : ASTNode(NodeType::WORD_CALL, line, column), wordName(name) {}
     
     [[nodiscard]] auto getWordName() const -> const std::string& { return wordName; }
+    [[nodiscard]] auto getParsedName() const -> const std::string& { return parsedName; }
+    
+    auto setParsedName(const std::string& name) -> void {
+        parsedName = name;
+    }
     
     auto accept(ASTVisitor& visitor) -> void override;
     auto toString() const -> std::string override {
-        return "WordCall[" + wordName + "]";
+        return "WordCall[" + wordName + (parsedName.empty() ? "" : " " + parsedName) + "]";
     }
     
     auto getStackEffect() const -> StackEffect override {
@@ -305,21 +339,39 @@ public:
     }
 };
 
-// Variable/Constant declarations
+// Variable/Constant declarations. CREATE names the current data-space
+// address without allocating, so it is modelled as a kind of variable.
 class VariableDeclarationNode : public ASTNode {
+public:
+    enum class Kind {
+        VARIABLE,   // VARIABLE name - one aligned cell
+        CONSTANT,   // value CONSTANT name
+        CREATE,     // CREATE name - address of the following , / ALLOT data
+        TASK,       // TASK name - handle of a cooperative task
+        CHANNEL     // capacity CHANNEL name - handle of a bounded message ring
+    };
+    
 private:
     std::string varName;
     std::unique_ptr<ASTNode> initialValue; // For CONSTANT, nullptr for VARIABLE
-    bool isConstant;
+    Kind kind;
     
 public:
     VariableDeclarationNode(const std::string& name, bool constant, int line, int column)
-        : ASTNode(constant ? NodeType::CONSTANT_DECLARATION : NodeType::VARIABLE_DECLARATION, 
-                 line, column), 
-          varName(name), isConstant(constant) {}
+        : VariableDeclarationNode(name, constant ? Kind::CONSTANT : Kind::VARIABLE, line, column) {}
+    
+    VariableDeclarationNode(const std::string& name, Kind declarationKind, int line, int column)
+        : ASTNode(declarationKind == Kind::CONSTANT ? NodeType::CONSTANT_DECLARATION
+                                                    : NodeType::VARIABLE_DECLARATION,
+                 line, column),
+          varName(name), kind(declarationKind) {}
     
     [[nodiscard]] auto getVarName() const -> const std::string& { return varName; }
-    [[nodiscard]] auto isConst() const -> bool { return isConstant; }
+    [[nodiscard]] auto getKind() const -> Kind { return kind; }
+    [[nodiscard]] auto isConst() const -> bool { return kind == Kind::CONSTANT; }
+    [[nodiscard]] auto isCreate() const -> bool { return kind == Kind::CREATE; }
+    [[nodiscard]] auto isTask() const -> bool { return kind == Kind::TASK; }
+    [[nodiscard]] auto isChannel() const -> bool { return kind == Kind::CHANNEL; }
     [[nodiscard]] auto getInitialValue() const -> ASTNode* { return initialValue.get(); }
     
     auto setInitialValue(std::unique_ptr<ASTNode> value) -> void {
@@ -328,14 +380,20 @@ public:
     
     auto accept(ASTVisitor& visitor) -> void override;
     auto toString() const -> std::string override {
-        return (isConstant ? "Constant[" : "Variable[") + varName + "]";
+        switch (kind) {
+            case Kind::CONSTANT: return "Constant[" + varName + "]";
+            case Kind::CREATE:   return "Create[" + varName + "]";
+            case Kind::TASK:     return "Task[" + varName + "]";
+            case Kind::CHANNEL:  return "Channel[" + varName + "]";
+            default:             return "Variable[" + varName + "]";
+        }
     }
     
     auto getStackEffect() const -> StackEffect override {
-        if (isConstant) {
-            return {1, 0, true}; // CONSTANT consumes initial value from stack
+        if (isConst() || isChannel()) {
+            return {1, 0, true}; // CONSTANT and CHANNEL consume a value from the stack
         } else {
-            return {0, 0, true}; // VARIABLE doesn't affect stack during declaration
+            return {0, 0, true}; // VARIABLE/CREATE/TASK don't affect stack during declaration
         }
     }
 };
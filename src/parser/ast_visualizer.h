@@ -135,7 +135,8 @@ public:
     
     void visit(VariableDeclarationNode& node) override {
         printPrefix();
-        std::cout << (node.isConst() ? "Constant: " : "Variable: ") 
+        std::cout << (node.isConst() ? "Constant: " : node.isCreate() ? "Create: " :
+                      node.isTask() ? "Task: " : node.isChannel() ? "Channel: " : "Variable: ") 
                   << node.getVarName() << "\n";
     }
 };
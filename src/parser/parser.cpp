@@ -33,6 +33,7 @@ ForthParser::ForthParser(std::unique_ptr<ForthDictionary> dict)
             }
         } catch (const std::exception& e) {
             addError("Parse error: " + std::string(e.what()), currentToken());
+            inDefinition = false;
             // Skip to next statement boundary
             while (!isAtEnd() && currentToken().type != TokenType::SEMICOLON && 
                    currentToken().type != TokenType::EOF_TOKEN) {
@@ -90,6 +91,22 @@ auto ForthParser::parseStatement() -> std::unique_ptr<ASTNode> {
             if (wordName == "CONSTANT") {
                 return parseConstantDeclaration();
             }
+            if (wordName == "CREATE") {
+                return parseNamedDeclaration(VariableDeclarationNode::Kind::CREATE);
+            }
+            if (wordName == "TASK") {
+                return parseNamedDeclaration(VariableDeclarationNode::Kind::TASK);
+            }
+            if (wordName == "START") {
+                return parseTaskStart();
+            }
+            if (wordName == "CHANNEL") {
+                return parseNamedDeclaration(VariableDeclarationNode::Kind::CHANNEL);
+            }
+            if (wordName == "INCLUDE" || wordName == "REQUIRE") {
+                parseIncludeDirective();
+                return nullptr;
+            }
             
             // Regular word call
             analyzeWordUsage(wordName);
@@ -121,12 +138,14 @@ auto ForthParser::parseWordDefinition() -> std::unique_ptr<WordDefinitionNode> {
     auto definition = std::make_unique<WordDefinitionNode>(wordName, line, column);
     
     // Parse word body until semicolon
+    inDefinition = true;
     while (!isAtEnd() && currentToken().type != TokenType::SEMICOLON) {
         auto statement = parseStatement();
         if (statement) {
             definition->addChild(std::move(statement));
         }
     }
+    inDefinition = false;
     
     consume(TokenType::SEMICOLON, "Expected ';' at end of word definition");
     
@@ -246,6 +265,65 @@ auto ForthParser::parseConstantDeclaration() -> std::unique_ptr<VariableDeclarat
     return constNode;
 }
 
+auto ForthParser::parseNamedDeclaration(VariableDeclarationNode::Kind kind) -> std::unique_ptr<VariableDeclarationNode> {
+    const std::string keyword = ForthUtils::toUpper(currentToken().value);
+    consume(TokenType::WORD, "Expected '" + keyword + "'"); // Consume CREATE / TASK / CHANNEL
+    
+    if (currentToken().type != TokenType::WORD) {
+        addError("Expected name after '" + keyword + "'", currentToken());
+        return nullptr;
+    }
+    
+    const std::string name = ForthUtils::toUpper(currentToken().value);
+    const int line = currentToken().line;
+    const int column = currentToken().column;
+    advance();
+    
+    auto node = std::make_unique<VariableDeclarationNode>(name, kind, line, column);
+    
+    // The name pushes its data-space address, task handle or channel handle,
+    // just like a variable; a channel's capacity comes from the stack
+    dictionary->defineVariable(name);
+    
+    return node;
+}
+
+auto ForthParser::parseTaskStart() -> std::unique_ptr<WordCallNode> {
+    const int line = currentToken().line;
+    const int column = currentToken().column;
+    consume(TokenType::WORD, "Expected 'START'"); // Consume START token
+    
+    // task START name - the word the task runs is parsed, not executed
+    if (currentToken().type != TokenType::WORD) {
+        addError("Expected word name after 'START'", currentToken());
+        return nullptr;
+    }
+    
+    const std::string entryName = ForthUtils::toUpper(currentToken().value);
+    analyzeWordUsage(entryName);
+    advance();
+    
+    auto startNode = std::make_unique<WordCallNode>("START", line, column);
+    startNode->setParsedName(entryName);
+    return startNode;
+}
+
+auto ForthParser::parseIncludeDirective() -> void {
+    const Token directive = currentToken();
+    advance(); // Consume INCLUDE / REQUIRE
+    
+    // The file itself is loaded by the driver (ForthModuleCache) before
+    // parsing starts, so its definitions are already in the dictionary
+    if (currentToken().type == TokenType::EOF_TOKEN) {
+        addError("Expected file name after '" + ForthUtils::toUpper(directive.value) + "'", directive);
+        return;
+    }
+    if (inDefinition) {
+        addError(ForthUtils::toUpper(directive.value) + " is only allowed outside word definitions", directive);
+    }
+    advance();
+}
+
 auto ForthParser::parsePrimaryExpression() -> std::unique_ptr<ASTNode> {
     const auto& token = currentToken();
     
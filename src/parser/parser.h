@@ -20,6 +20,7 @@ private:
     
     // Control flow tracking
     std::stack<TokenType> controlStack;
+    bool inDefinition = false;
     
 public:
     ForthParser();
@@ -72,6 +73,10 @@ private:
     auto parseBeginUntilLoop() -> std::unique_ptr<BeginUntilLoopNode>;
     auto parseVariableDeclaration() -> std::unique_ptr<VariableDeclarationNode>;
     auto parseConstantDeclaration() -> std::unique_ptr<VariableDeclarationNode>;
+    // CREATE, TASK and CHANNEL: the keyword followed by the name it defines
+    auto parseNamedDeclaration(VariableDeclarationNode::Kind kind) -> std::unique_ptr<VariableDeclarationNode>;
+    auto parseTaskStart() -> std::unique_ptr<WordCallNode>;
+    auto parseIncludeDirective() -> void;
     
     // Expression parsing
     auto parseExpression() -> std::unique_ptr<ASTNode>;
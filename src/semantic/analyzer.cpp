@@ -1,7 +1,9 @@
 #include "semantic/analyzer.h"
+#include "semantic/module_interface.h"
 #include "dictionary/dictionary.h"
 #include "common/utils.h"
 #include <algorithm>
+#include <functional>
 #include <sstream>
 #include <stdexcept>
 
@@ -21,6 +23,10 @@ auto SemanticAnalyzer::analyze(ProgramNode& program) -> bool {
     currentStack.reset();
     analyzedWords.clear();
     wordEffects.clear();
+    for (const auto& [wordName, effect] : importedEffects) {
+        wordEffects[wordName] = effect;
+        analyzedWords[wordName] = true;
+    }
     
     // Pass 1: Collect all word definitions and give them placeholder effects
     for (const auto& child : program.getChildren()) {
@@ -84,6 +90,86 @@ auto SemanticAnalyzer::analyze(ProgramNode& program) -> bool {
     return !hasErrors();
 }
 
+auto SemanticAnalyzer::importInterface(const ForthModuleInterface& interface) -> void {
+    importWordEffects(interface.getWordEffects());
+    for (const auto& word : interface.words) {
+        if (word.pure) importedPureWords.insert(word.name);
+    }
+}
+
+auto SemanticAnalyzer::isPureBuiltin(const std::string& wordName) -> bool {
+    static const std::unordered_set<std::string> pureBuiltins = {
+        "+", "-", "*", "/", "MOD", "NEGATE", "ABS", "1+", "1-",
+        "DUP", "DROP", "SWAP", "OVER", "ROT",
+        "=", "<>", "<", ">", "<=", ">=", "0=", "0<", "0>",
+    };
+    return pureBuiltins.contains(wordName);
+}
+
+auto SemanticAnalyzer::findPureWords(const ProgramNode& program) const -> std::set<std::string> {
+    std::unordered_map<std::string, const WordDefinitionNode*> definitions;
+    for (const auto* statements : program.getStatementLists()) {
+        for (const auto& child : *statements) {
+            if (const auto* word = dynamic_cast<const WordDefinitionNode*>(child.get())) {
+                definitions[word->getWordName()] = word;
+            }
+        }
+    }
+    
+    // Start from every word and drop the ones that touch anything else until
+    // nothing changes, so mutually recursive pure words stay pure
+    std::set<std::string> pure;
+    for (const auto& [name, word] : definitions) {
+        pure.insert(name);
+    }
+    std::function<bool(const ASTNode*)> isPure = [&](const ASTNode* node) -> bool {
+        if (!node) return true;
+        switch (node->getType()) {
+            case ASTNode::NodeType::NUMBER_LITERAL:
+            case ASTNode::NodeType::MATH_OPERATION:
+                return true;
+            case ASTNode::NodeType::WORD_CALL: {
+                const std::string name = ForthUtils::toUpper(static_cast<const WordCallNode*>(node)->getWordName());
+                if (definitions.contains(name)) return pure.contains(name);
+                if (importedPureWords.contains(name) || isPureBuiltin(name)) return true;
+                return dictionary && dictionary->isConstant(name);
+            }
+            case ASTNode::NodeType::IF_STATEMENT: {
+                const auto* statement = static_cast<const IfStatementNode*>(node);
+                return isPure(statement->getCondition()) && isPure(statement->getThenBranch()) &&
+                       isPure(statement->getElseBranch());
+            }
+            case ASTNode::NodeType::BEGIN_UNTIL_LOOP: {
+                const auto* loop = static_cast<const BeginUntilLoopNode*>(node);
+                return isPure(loop->getBody()) && isPure(loop->getCondition());
+            }
+            case ASTNode::NodeType::PROGRAM:
+                break;
+            default:
+                return false;
+        }
+        return std::all_of(node->getChildren().begin(), node->getChildren().end(),
+                           [&](const auto& child) { return isPure(child.get()); });
+    };
+    
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto it = pure.begin(); it != pure.end();) {
+            const auto* word = definitions.at(*it);
+            const bool bodyPure = std::all_of(word->getChildren().begin(), word->getChildren().end(),
+                                              [&](const auto& child) { return isPure(child.get()); });
+            if (bodyPure) {
+                ++it;
+            } else {
+                it = pure.erase(it);
+                changed = true;
+            }
+        }
+    }
+    return pure;
+}
+
 void SemanticAnalyzer::visit(ProgramNode& node) {
     for (const auto& child : node.getChildren()) {
         child->accept(*this);
@@ -120,13 +206,14 @@ auto SemanticAnalyzer::analyzeWordDefinition(WordDefinitionNode& node) -> TypedS
     // Give it plenty of stack to work with, track how much it actually needs
     const int ASSUMED_STACK_START = 10;
     currentStack.depth = ASSUMED_STACK_START;
+    currentStack.minDepth = ASSUMED_STACK_START;
     
-    // Track the minimum depth reached
+    // Track the minimum depth reached, including inside each word called
     int minDepthReached = ASSUMED_STACK_START;
     
     for (const auto& child : node.getChildren()) {
         child->accept(*this);
-        minDepthReached = std::min(minDepthReached, currentStack.depth);
+        minDepthReached = std::min({minDepthReached, currentStack.depth, currentStack.minDepth});
     }
     
     // Calculate the actual stack effect
@@ -165,10 +252,11 @@ void SemanticAnalyzer::visit(WordCallNode& node) {
         // In word definition, allow negative depth tracking
         int oldDepth = currentStack.depth;
         currentStack.depth -= effect.effect.consumed;
-        currentStack.depth += effect.effect.produced;
         
-        // Track minimum depth reached (this can be negative)
+        // Track minimum depth reached (this can be negative), before the
+        // word's results are pushed
         currentStack.minDepth = std::min(currentStack.minDepth, currentStack.depth);
+        currentStack.depth += effect.effect.produced;
         currentStack.maxDepth = std::max(currentStack.maxDepth, currentStack.depth);
         
         // Don't mark as invalid just because we went negative in word definition
@@ -295,8 +383,14 @@ void SemanticAnalyzer::visit(VariableDeclarationNode& node) {
             addError("Stack underflow in constant declaration: " + varName, node);
         }
         constantTypes[varName] = ForthValueType::CELL; // Will be refined later
+    } else if (node.isChannel()) {
+        // Channels consume their capacity
+        if (!popStack(1)) {
+            addError("Stack underflow in channel declaration: " + varName, node);
+        }
+        variableTypes[varName] = ForthValueType::CELL;
     } else {
-        // Variables don't affect stack during declaration
+        // Variables, CREATEd words and tasks don't affect stack during declaration
         variableTypes[varName] = ForthValueType::ADDRESS;
     }
 }
@@ -309,6 +403,16 @@ auto SemanticAnalyzer::calculateWordEffect(const std::string& wordName) -> Typed
         return it->second;
     }
     
+    // User definitions shadow built-ins of the same name
+    if (dictionary) {
+        auto entry = dictionary->lookupWord(wordName);
+        if (entry && entry->type != WordEntry::WordType::BUILTIN) {
+            TypedStackEffect effect(dictionary->getStackEffect(wordName));
+            wordEffects[wordName] = effect;
+            return effect;
+        }
+    }
+    
     // Check if it's a built-in word
     auto builtinEffect = getBuiltinStackEffect(wordName);
     if (builtinEffect.effect.isKnown) {
@@ -374,7 +478,7 @@ auto SemanticAnalyzer::getBuiltinStackEffect(const std::string& wordName) -> Typ
     if (wordName == "EMIT") {
         return TypedStackEffect(ASTNode::StackEffect{1, 0, true});
     }
-    if (wordName == "CR" || wordName == "SPACE") {
+    if (wordName == "CR" || wordName == "SPACE" || wordName == "FLUSH") {
         return TypedStackEffect(ASTNode::StackEffect{0, 0, true});
     }
     
@@ -386,6 +490,55 @@ auto SemanticAnalyzer::getBuiltinStackEffect(const std::string& wordName) -> Typ
         return TypedStackEffect(ASTNode::StackEffect{2, 0, true});
     }
     
+    // Data space
+    if (wordName == "HERE") {
+        return TypedStackEffect(ASTNode::StackEffect{0, 1, true});
+    }
+    if (wordName == "ALLOT" || wordName == ",") {
+        return TypedStackEffect(ASTNode::StackEffect{1, 0, true});
+    }
+    if (wordName == "CELLS" || wordName == "CELL+") {
+        return TypedStackEffect(ASTNode::StackEffect{1, 1, true});
+    }
+    
+    // Block memory operations
+    if (wordName == "MOVE" || wordName == "CMOVE" || wordName == "CMOVE>" || wordName == "FILL") {
+        return TypedStackEffect(ASTNode::StackEffect{3, 0, true});
+    }
+    if (wordName == "ERASE") {
+        return TypedStackEffect(ASTNode::StackEffect{2, 0, true});
+    }
+    
+    // Array operations over cells
+    if (wordName == "SUM" || wordName == "MIN-REDUCE" || wordName == "MAX-REDUCE") {
+        return TypedStackEffect(ASTNode::StackEffect{2, 1, true});
+    }
+    if (wordName == "DOT") {
+        return TypedStackEffect(ASTNode::StackEffect{3, 1, true});
+    }
+    if (wordName == "MAP+" || wordName == "SCALE") {
+        return TypedStackEffect(ASTNode::StackEffect{3, 0, true});
+    }
+    
+    // Cooperative tasks
+    if (wordName == "START") {
+        return TypedStackEffect(ASTNode::StackEffect{1, 0, true});
+    }
+    if (wordName == "PAUSE" || wordName == "STOP") {
+        return TypedStackEffect(ASTNode::StackEffect{0, 0, true});
+    }
+    
+    // Channels
+    if (wordName == "SEND") {
+        return TypedStackEffect(ASTNode::StackEffect{2, 0, true});
+    }
+    if (wordName == "RECV") {
+        return TypedStackEffect(ASTNode::StackEffect{1, 1, true});
+    }
+    if (wordName == "TRY-RECV") {
+        return TypedStackEffect(ASTNode::StackEffect{1, 2, true});
+    }
+    
     // Unknown built-in
     return TypedStackEffect(ASTNode::StackEffect{0, 0, false});
 }
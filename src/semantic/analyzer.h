@@ -2,8 +2,10 @@
 #define FORTH_SEMANTIC_ANALYZER_H
 
 #include <vector>
+#include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <stack>
 #include "parser/ast.h"
@@ -68,6 +70,8 @@ struct TypedStackEffect {
     TypedStackEffect(const ASTNode::StackEffect& e) : effect(e) {}
 };
 
+class ForthModuleInterface;
+
 // Semantic analyzer for FORTH programs
 class SemanticAnalyzer : public ASTVisitor {
 private:
@@ -81,6 +85,8 @@ private:
     // Word analysis results
     std::unordered_map<std::string, TypedStackEffect> wordEffects;
     std::unordered_map<std::string, bool> analyzedWords;
+    std::unordered_map<std::string, TypedStackEffect> importedEffects;   // Words of included modules
+    std::unordered_set<std::string> importedPureWords;                   // From module interfaces
     
     // Type tracking
     std::unordered_map<std::string, ForthValueType> variableTypes;
@@ -99,6 +105,23 @@ public:
     // Main analysis entry point
     auto analyze(ProgramNode& program) -> bool;
     
+    // Effects of words defined by included modules, already analyzed there.
+    // They survive analyze() and are never re-analyzed.
+    auto importWordEffects(const std::unordered_map<std::string, TypedStackEffect>& effects) -> void {
+        for (const auto& [wordName, effect] : effects) {
+            importedEffects[wordName] = effect;
+        }
+    }
+    
+    // Effects and purity of the words of a separately compiled module
+    auto importInterface(const ForthModuleInterface& interface) -> void;
+    
+    // Words whose result depends only on their stack arguments: their bodies
+    // use nothing but literals, constants, stack, arithmetic and comparison
+    // builtins, and other pure words (recursion included)
+    [[nodiscard]] auto findPureWords(const ProgramNode& program) const -> std::set<std::string>;
+    [[nodiscard]] static auto isPureBuiltin(const std::string& wordName) -> bool;
+    
     // Dictionary management - ADDED THIS MISSING METHOD
     auto setDictionary(const ForthDictionary* dict) -> void { dictionary = dict; }
     
@@ -0,0 +1,237 @@
+#include "semantic/module_interface.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include "common/utils.h"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::array<ForthValueType, 8> VALUE_TYPES = {
+    ForthValueType::UNKNOWN, ForthValueType::INTEGER, ForthValueType::FLOAT, ForthValueType::BOOLEAN,
+    ForthValueType::ADDRESS, ForthValueType::STRING_ADDR, ForthValueType::STRING_LENGTH, ForthValueType::CELL,
+};
+
+auto writeTypes(std::ostream& out, const std::vector<ForthValueType>& types) -> void {
+    if (types.empty()) {
+        out << '-';
+        return;
+    }
+    for (size_t i = 0; i < types.size(); i++) {
+        out << (i ? "," : "") << ForthModuleInterface::typeName(types[i]);
+    }
+}
+
+auto readTypes(const std::string& field) -> std::vector<ForthValueType> {
+    std::vector<ForthValueType> types;
+    if (field == "-") return types;
+    std::istringstream in(field);
+    std::string name;
+    while (std::getline(in, name, ',')) {
+        bool found = false;
+        for (ForthValueType type : VALUE_TYPES) {
+            if (name == ForthModuleInterface::typeName(type)) {
+                types.push_back(type);
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            throw std::runtime_error("unknown value type '" + name + "'");
+        }
+    }
+    return types;
+}
+
+auto readFile(const fs::path& path) -> std::string {
+    std::ifstream input(path);
+    if (!input) {
+        throw std::runtime_error("Cannot open " + path.string());
+    }
+    return {std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}};
+}
+
+} // namespace
+
+auto ForthModuleInterface::typeName(ForthValueType type) -> const char* {
+    switch (type) {
+        case ForthValueType::INTEGER: return "INTEGER";
+        case ForthValueType::FLOAT: return "FLOAT";
+        case ForthValueType::BOOLEAN: return "BOOLEAN";
+        case ForthValueType::ADDRESS: return "ADDRESS";
+        case ForthValueType::STRING_ADDR: return "STRING_ADDR";
+        case ForthValueType::STRING_LENGTH: return "STRING_LENGTH";
+        case ForthValueType::CELL: return "CELL";
+        case ForthValueType::UNKNOWN: break;
+    }
+    return "UNKNOWN";
+}
+
+auto ForthModuleInterface::findWord(const std::string& name) const -> const Word* {
+    for (const auto& word : words) {
+        if (word.name == name) return &word;
+    }
+    return nullptr;
+}
+
+auto ForthModuleInterface::toText() const -> std::string {
+    std::ostringstream out;
+    out << "forth-interface " << VERSION << "\n";
+    out << "module " << module << "\n";
+    out << "fragment " << fragment << "\n";
+    out << "source " << std::hex << sourceHash << std::dec << "\n";
+    for (const auto& dependency : dependencies) out << "require " << dependency << "\n";
+    for (const auto& feature : features) out << "feature " << feature << "\n";
+    for (const auto& builtin : builtins) out << "builtin " << builtin << "\n";
+    for (const auto& [name, value] : constants) out << "constant " << name << " " << value << "\n";
+    for (const auto& word : words) {
+        out << "word " << word.name << " " << word.function << " " << word.effect.effect.consumed << " "
+            << word.effect.effect.produced << " " << (word.effect.effect.isKnown ? 1 : 0) << " "
+            << (word.pure ? "pure" : "impure") << " ";
+        writeTypes(out, word.effect.consumedTypes);
+        out << " ";
+        writeTypes(out, word.effect.producedTypes);
+        out << "\n";
+    }
+    for (const auto& word : words) {
+        if (!word.inlineSource.empty()) out << "inline " << word.name << " " << word.inlineSource << "\n";
+    }
+    return out.str();
+}
+
+auto ForthModuleInterface::parse(const std::string& text) -> ForthModuleInterface {
+    ForthModuleInterface interface;
+    std::istringstream lines(text);
+    std::string line;
+    size_t number = 0;
+    bool sawHeader = false;
+
+    while (std::getline(lines, line)) {
+        number++;
+        std::istringstream fields(line);
+        std::string record;
+        if (!(fields >> record)) continue;
+        auto fail = [&](const std::string& message) {
+            return std::runtime_error("line " + std::to_string(number) + ": " + message);
+        };
+
+        if (!sawHeader) {
+            int version = 0;
+            if (record != "forth-interface" || !(fields >> version)) {
+                throw fail("not a FORTH module interface");
+            }
+            if (version != VERSION) {
+                throw fail("unsupported interface version " + std::to_string(version));
+            }
+            sawHeader = true;
+        } else if (record == "module") {
+            fields >> interface.module;
+        } else if (record == "fragment") {
+            fields >> interface.fragment;
+        } else if (record == "source") {
+            fields >> std::hex >> interface.sourceHash >> std::dec;
+        } else if (record == "require") {
+            std::string dependency;
+            if (fields >> dependency) interface.dependencies.push_back(dependency);
+        } else if (record == "feature" || record == "builtin") {
+            std::string name;
+            if (!(fields >> name)) throw fail("missing name");
+            (record == "feature" ? interface.features : interface.builtins).insert(name);
+        } else if (record == "constant") {
+            std::string name;
+            int32_t value = 0;
+            if (!(fields >> name >> value)) throw fail("malformed constant");
+            interface.constants.emplace_back(name, value);
+        } else if (record == "word") {
+            Word word;
+            int known = 0;
+            std::string purity, in, out;
+            if (!(fields >> word.name >> word.function >> word.effect.effect.consumed >>
+                  word.effect.effect.produced >> known >> purity >> in >> out)) {
+                throw fail("malformed word");
+            }
+            word.effect.effect.isKnown = known != 0;
+            word.pure = purity == "pure";
+            try {
+                word.effect.consumedTypes = readTypes(in);
+                word.effect.producedTypes = readTypes(out);
+            } catch (const std::runtime_error& e) {
+                throw fail(e.what());
+            }
+            interface.words.push_back(std::move(word));
+        } else if (record == "inline") {
+            std::string name;
+            fields >> name;
+            auto word = std::find_if(interface.words.begin(), interface.words.end(),
+                                     [&name](const Word& w) { return w.name == name; });
+            if (word == interface.words.end()) throw fail("inline body of unknown word '" + name + "'");
+            std::getline(fields >> std::ws, word->inlineSource);
+        } else {
+            throw fail("unknown record '" + record + "'");
+        }
+    }
+    if (!sawHeader) {
+        throw std::runtime_error("not a FORTH module interface");
+    }
+    if (interface.module.empty() || interface.fragment.empty()) {
+        throw std::runtime_error("interface names no module or fragment");
+    }
+
+    // Inline bodies only name builtins and this module's own words
+    for (auto& word : interface.words) {
+        if (word.inlineSource.empty()) continue;
+        ForthParser parser(DictionaryFactory::createOverlay());
+        interface.importDefinitions(parser.getDictionary());
+        ForthLexer lexer;
+        word.inlineBody = parser.parseProgram(lexer.tokenize(word.inlineSource));
+        if (parser.hasErrors()) {
+            throw std::runtime_error("inline body of " + word.name + ": " + parser.getErrors().front());
+        }
+    }
+    return interface;
+}
+
+auto ForthModuleInterface::loadText(const fs::path& path, const std::string& text) -> ForthModuleInterface {
+    ForthModuleInterface interface;
+    try {
+        interface = parse(text);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(path.string() + ": " + e.what());
+    }
+    interface.path = path;
+    interface.fragmentSource = readFile(path.parent_path() / interface.fragment);
+    return interface;
+}
+
+auto ForthModuleInterface::load(const fs::path& path) -> ForthModuleInterface {
+    return loadText(path, readFile(path));
+}
+
+auto ForthModuleInterface::save(const fs::path& path) const -> bool {
+    std::ofstream output(path);
+    output << toText();
+    return static_cast<bool>(output);
+}
+
+auto ForthModuleInterface::importDefinitions(ForthDictionary& dictionary) const -> void {
+    for (const auto& word : words) {
+        dictionary.defineWord(word.name, std::make_unique<ProgramNode>());
+    }
+    for (const auto& [name, value] : constants) {
+        dictionary.defineConstant(name, nullptr);
+    }
+}
+
+auto ForthModuleInterface::getWordEffects() const -> std::unordered_map<std::string, TypedStackEffect> {
+    std::unordered_map<std::string, TypedStackEffect> effects;
+    for (const auto& word : words) {
+        effects[word.name] = word.effect;
+    }
+    return effects;
+}
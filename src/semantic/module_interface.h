@@ -0,0 +1,88 @@
+#ifndef FORTH_MODULE_INTERFACE_H
+#define FORTH_MODULE_INTERFACE_H
+
+#include "parser/ast.h"
+#include "dictionary/dictionary.h"
+#include "semantic/analyzer.h"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// Module interface files
+// ============================================================================
+//
+// `forth_compiler -c lib.fth` compiles a library on its own into a C fragment
+// (forth_module_<name>.c) and this interface (<name>.fi). A program that
+// says `REQUIRE lib.fi` imports only the interface: the exported words with
+// their stack effects and types, folded constants and the runtime features
+// the fragment needs. The library is never parsed or analyzed again, except
+// for the few tokens of the inline bodies of its small pure words.
+//
+// The file is line based, one record per line:
+//
+//     forth-interface 1
+//     module math
+//     fragment forth_module_math.c
+//     source 9f1c0d6e4b2a7c31
+//     require util.fi
+//     feature MATH
+//     builtin *
+//     constant TEN 10
+//     word SQUARE forth_math_square 1 1 1 pure CELL CELL
+//     inline SQUARE DUP *
+//
+// A word record holds consumed, produced and known of its stack effect, then
+// its consumed and produced types, comma separated or "-" when empty.
+
+class ForthModuleInterface {
+public:
+    static constexpr int VERSION = 1;
+
+    struct Word {
+        std::string name;
+        std::string function;   // C symbol defined by the fragment
+        TypedStackEffect effect;
+        bool pure = false;      // Reads and changes nothing but the data stack
+        std::string inlineSource;             // Body of a small word, or empty
+        std::shared_ptr<ProgramNode> inlineBody;   // Parsed from inlineSource by parse()
+    };
+
+    std::string module;
+    std::string fragment;            // File name of the C fragment, next to the interface
+    uint64_t sourceHash = 0;         // Of the library text it was compiled from
+    std::vector<std::string> dependencies;   // Interfaces the fragment calls into ("require")
+    std::set<std::string> features;
+    std::set<std::string> builtins;
+    std::vector<std::pair<std::string, int32_t>> constants;
+    std::vector<Word> words;
+
+    // Filled in by load(): where the interface lives and the fragment's text
+    std::filesystem::path path;
+    std::string fragmentSource;
+
+    [[nodiscard]] auto findWord(const std::string& name) const -> const Word*;
+
+    [[nodiscard]] auto toText() const -> std::string;
+    // Throws std::runtime_error for a malformed interface
+    [[nodiscard]] static auto parse(const std::string& text) -> ForthModuleInterface;
+    // parse() plus the fragment next to it. Throws std::runtime_error for a
+    // missing or malformed file.
+    [[nodiscard]] static auto load(const std::filesystem::path& path) -> ForthModuleInterface;
+    [[nodiscard]] static auto loadText(const std::filesystem::path& path, const std::string& text)
+        -> ForthModuleInterface;
+    auto save(const std::filesystem::path& path) const -> bool;
+
+    // Words and constants as dictionary entries, for parsing importers
+    auto importDefinitions(ForthDictionary& dictionary) const -> void;
+    [[nodiscard]] auto getWordEffects() const -> std::unordered_map<std::string, TypedStackEffect>;
+
+    [[nodiscard]] static auto typeName(ForthValueType type) -> const char*;
+};
+
+#endif // FORTH_MODULE_INTERFACE_H
@@ -0,0 +1,68 @@
+#include "../test_framework.h"
+#include "codegen/c_backend.h"
+#include "codegen/size_report.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include <cstdlib>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+class SizeReportTestFixture {
+public:
+    ForthSizeReport report{ForthSizeReport::Options{}};
+
+    // Builds a program with two words and measures its objects
+    auto measure() -> bool {
+        ForthLexer lexer;
+        ForthParser parser;
+        auto ast = parser.parseProgram(lexer.tokenize(": SQUARE DUP * ; : CUBE DUP SQUARE * ; 3 CUBE ."));
+        if (parser.hasErrors()) return false;
+
+        ForthCCodegen codegen("size_test");
+        codegen.setDictionary(&parser.getDictionary());
+        if (!codegen.generateCode(*ast) || codegen.hasErrors()) return false;
+
+        const fs::path workDir = fs::temp_directory_path() / "forth_size_report_test";
+        const bool measured = report.measure(codegen, workDir);
+        fs::remove_all(workDir);
+        return measured;
+    }
+};
+
+// Needs a host C compiler; the C backend output is plain C99
+auto haveHostCompiler() -> bool {
+    return std::system("cc --version > /dev/null 2>&1") == 0;
+}
+
+auto registerSizeReportTests(TestRunner& runner) -> void {
+
+    runner.addTest("Size Report Attributes Word Symbols", []() -> bool {
+        if (!haveHostCompiler()) return true;
+        SizeReportTestFixture fixture;
+        if (!fixture.measure()) return false;
+
+        bool foundWord = false;
+        for (const auto& entry : fixture.report.getEntries()) {
+            foundWord |= entry.kind == "word" && entry.owner == "SQUARE" && entry.size > 0;
+        }
+        return foundWord && fixture.report.regionTotal(ForthSizeReport::Region::FLASH_CODE) > 0;
+    });
+
+    runner.addTest("Size Report Lists Runtime Symbols", []() -> bool {
+        if (!haveHostCompiler()) return true;
+        SizeReportTestFixture fixture;
+        if (!fixture.measure()) return false;
+
+        for (const auto& entry : fixture.report.getEntries()) {
+            if (entry.kind == "runtime" && entry.symbol == "forth_push") return true;
+        }
+        return false;
+    });
+
+    runner.addTest("Size Report JSON Names Each Owner", []() -> bool {
+        if (!haveHostCompiler()) return true;
+        SizeReportTestFixture fixture;
+        return fixture.measure() && fixture.report.toJson().find("\"owner\": \"CUBE\"") != std::string::npos;
+    });
+}
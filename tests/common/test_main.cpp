@@ -0,0 +1,17 @@
+#include "../test_framework.h"
+
+// Test registration functions
+extern auto registerTraceTests(TestRunner& runner) -> void;
+
+auto main() -> int
+{
+    std::cout << "FORTH-ESP32 Compiler Test Suite\n";
+    std::cout << "Common Infrastructure Tests\n";
+
+    TestRunner runner;
+
+    std::cout << "Registering trace tests...\n";
+    registerTraceTests(runner);
+
+    return runner.runAll();
+}
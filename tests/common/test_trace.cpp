@@ -0,0 +1,66 @@
+#include "../test_framework.h"
+#include "common/trace.h"
+#include "driver/batch.h"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+class TraceTestFixture {
+public:
+    bool success = false;
+    std::vector<ForthTrace::Event> events;
+
+    // Compiles a small program with tracing on and keeps its events
+    TraceTestFixture() {
+        const fs::path tempDir = fs::temp_directory_path() / "forth_trace_test";
+        fs::remove_all(tempDir);
+        fs::create_directories(tempDir);
+        std::ofstream(tempDir / "prog.fth") << ": CUBE DUP DUP * * ;\n3 CUBE .";
+
+        ForthTrace::enable();
+        success = ForthBatchCompiler::compileFile((tempDir / "prog.fth").string(), tempDir / "out",
+                                                  ForthBatchCompiler::Options{}).success;
+        ForthTrace::disable();
+        events = ForthTrace::getEvents();
+        fs::remove_all(tempDir);
+    }
+
+    auto find(const std::string& category, const std::string& name) const -> const ForthTrace::Event* {
+        for (const auto& event : events) {
+            if (event.category == category && event.name == name) return &event;
+        }
+        return nullptr;
+    }
+};
+
+auto registerTraceTests(TestRunner& runner) -> void {
+
+    runner.addTest("Trace Records A Span Per Pass", []() -> bool {
+        TraceTestFixture trace;
+        return trace.success && trace.find("pass", "lex") && trace.find("pass", "parse") &&
+               trace.find("pass", "codegen") && trace.find("codegen", "feature analysis") &&
+               trace.find("optimize", "unused functions") && trace.find("runtime", "forth_stack.c") &&
+               trace.find("write", "forth_program.c");
+    });
+
+    runner.addTest("Trace Nests Spans Inside Their Parent", []() -> bool {
+        TraceTestFixture trace;
+        const auto* codegen = trace.find("pass", "codegen");
+        const auto* runtime = trace.find("codegen", "runtime generation");
+        if (!codegen || !runtime) return false;
+
+        // Allocations are inclusive, so a child never counts more
+        return runtime->start >= codegen->start &&
+               runtime->start + runtime->duration <= codegen->start + codegen->duration &&
+               runtime->allocations.bytes <= codegen->allocations.bytes;
+    });
+
+    runner.addTest("Trace Counts Allocations Per Word", []() -> bool {
+        TraceTestFixture trace;
+        const auto* word = trace.find("word", "CUBE");
+        return word && word->allocations.count > 0 &&
+               ForthTrace::toJson().find("\"name\": \"CUBE\", \"cat\": \"word\", \"ph\": \"X\"") !=
+                   std::string::npos;
+    });
+}
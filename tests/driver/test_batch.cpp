@@ -0,0 +1,75 @@
+#include "../test_framework.h"
+#include "dictionary/dictionary.h"
+#include "driver/batch.h"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+class BatchTestFixture {
+public:
+    fs::path tempDir = fs::temp_directory_path() / "forth_batch_test";
+    std::vector<std::string> files;
+    std::vector<ForthBatchCompiler::Result> results;
+    std::string json;
+
+    // Two programs share a stem; one redefines the builtin DUP, the other
+    // names a variable SWAP; one more fails to parse
+    BatchTestFixture() {
+        fs::remove_all(tempDir);
+        fs::create_directories(tempDir / "a");
+        fs::create_directories(tempDir / "b");
+        std::ofstream(tempDir / "a" / "prog.fth") << ": DUP 7 ; DUP .";
+        std::ofstream(tempDir / "b" / "prog.fth") << "VARIABLE SWAP 5 SWAP ! 1 2 + .";
+        std::ofstream(tempDir / "bad.fth") << ": BROKEN 1 IF ;";
+        std::ofstream(tempDir / "list.rsp") << "# programs\na/prog.fth\n\nb/prog.fth\nbad.fth\n";
+
+        files = ForthBatchCompiler::expandResponseFiles({"@" + (tempDir / "list.rsp").string()});
+
+        ForthBatchCompiler::Options options;
+        options.outputRoot = tempDir / "out";
+        options.jobs = 3;
+        ForthBatchCompiler batch(options);
+        results = batch.compile(files);
+        json = ForthBatchCompiler::toJson(results, batch.getWallTime());
+    }
+
+    ~BatchTestFixture() {
+        fs::remove_all(tempDir);
+    }
+};
+
+auto registerBatchTests(TestRunner& runner) -> void {
+
+    runner.addTest("Batch Response Files Skip Comments And Blank Lines", []() -> bool {
+        BatchTestFixture batch;
+        return batch.files.size() == 3 && batch.files[2].ends_with("bad.fth");
+    });
+
+    runner.addTest("Batch Compiles Files Concurrently", []() -> bool {
+        BatchTestFixture batch;
+        return batch.results.size() == 3 && batch.results[0].success && batch.results[1].success &&
+               !batch.results[2].success && !batch.results[2].errors.empty() &&
+               batch.results[2].errors[0].starts_with("parse: ");
+    });
+
+    runner.addTest("Batch Gives Programs With One Stem Separate Outputs", []() -> bool {
+        BatchTestFixture batch;
+        return fs::exists(batch.tempDir / "out" / "prog" / "forth_program.c") &&
+               fs::exists(batch.tempDir / "out" / "prog_2" / "forth_program.c");
+    });
+
+    runner.addTest("Batch Overlays Leave The Shared Builtins Alone", []() -> bool {
+        BatchTestFixture batch;
+        const auto builtins = DictionaryFactory::sharedBuiltins();
+        const WordEntry* dup = builtins->lookupWord("DUP");
+        const WordEntry* swap = builtins->lookupWord("SWAP");
+        return dup && dup->type == WordEntry::WordType::BUILTIN &&
+               swap && swap->type == WordEntry::WordType::BUILTIN;
+    });
+
+    runner.addTest("Batch JSON Reports Failed Files", []() -> bool {
+        BatchTestFixture batch;
+        return batch.json.find("\"success\": false") != std::string::npos;
+    });
+}
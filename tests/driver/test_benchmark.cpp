@@ -0,0 +1,210 @@
+#include "../test_framework.h"
+#include "driver/baseline.h"
+#include "driver/benchmark.h"
+#include "driver/program_generator.h"
+#include "driver/runtime_bench.h"
+#include "driver/scaling.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+class BenchmarkTestFixture {
+public:
+    fs::path tempDir = fs::temp_directory_path() / "forth_benchmark_test";
+    std::vector<ForthBenchmark::ProgramResult> results;
+
+    // A small file and a generated one in two groups
+    BenchmarkTestFixture() {
+        fs::remove_all(tempDir);
+        fs::create_directories(tempDir / "small");
+        fs::create_directories(tempDir / "huge");
+        std::ofstream(tempDir / "small" / "cube.fth") << ": CUBE DUP DUP * * ;\n3 CUBE .";
+        std::ofstream(tempDir / "huge" / "wide.gen") << "\\ generated\nwide 200\n";
+
+        ForthBenchmark::Options options;
+        options.minRepetitions = 2;
+        options.minTime = std::chrono::milliseconds(0);
+        ForthBenchmark benchmark(options);
+        results = benchmark.run(tempDir);
+    }
+
+    ~BenchmarkTestFixture() {
+        fs::remove_all(tempDir);
+    }
+};
+
+// Twelve parse and codegen samples for one program
+auto baselineTestResult() -> ForthBenchmark::ProgramResult {
+    ForthBenchmark::ProgramResult result;
+    result.name = "small/cube.fth";
+    result.success = true;
+    for (int i = 0; i < 12; i++) {
+        result.samples["parse"].push_back(std::chrono::microseconds(100 + i));
+        result.samples["codegen"].push_back(std::chrono::microseconds(500 + i));
+    }
+    return result;
+}
+
+auto haveBenchmarkCompiler() -> bool {
+    return std::system("cc --version > /dev/null 2>&1") == 0;
+}
+
+auto registerBenchmarkTests(TestRunner& runner) -> void {
+
+    runner.addTest("Benchmark Sorts Programs By Path And Groups By Directory", []() -> bool {
+        BenchmarkTestFixture fixture;
+        const auto& results = fixture.results;
+        return results.size() == 2 && results[0].name == "huge/wide.gen" && results[0].group == "huge" &&
+               results[1].name == "small/cube.fth" && results[1].group == "small";
+    });
+
+    runner.addTest("Benchmark Measures Every Phase", []() -> bool {
+        BenchmarkTestFixture fixture;
+        if (fixture.results.size() != 2) return false;
+        for (const auto& result : fixture.results) {
+            if (!result.success || result.repetitions < 2 || result.tokens == 0 ||
+                result.nodes < result.tokens / 2 || result.linesOfC == 0 || result.allocations == 0 ||
+                result.codegen.count() == 0) {
+                return false;
+            }
+        }
+        const auto& huge = fixture.results[0];
+        const auto& small = fixture.results[1];
+        bool ok = huge.tokens > 200 * small.tokens / 2 && huge.nodes > small.nodes;
+#if defined(__GLIBC__)
+        ok = ok && huge.peakHeapBytes > small.peakHeapBytes;
+#endif
+        return ok;
+    });
+
+    runner.addTest("Benchmark JSON Reports Phase Throughput", []() -> bool {
+        BenchmarkTestFixture fixture;
+        const std::string json = ForthBenchmark::toJson(fixture.results);
+        return json.find("\"tokens_per_s\"") != std::string::npos &&
+               json.find("\"c_lines_per_s\"") != std::string::npos &&
+               json.find("\"peak_heap_bytes\"") != std::string::npos;
+    });
+
+    runner.addTest("Benchmark Generators Are Deterministic And Named", []() -> bool {
+        bool rejected = false;
+        try {
+            (void)ForthBenchmark::synthesize("sideways", 10);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        return rejected && ForthBenchmark::synthesize("control", 20) == ForthBenchmark::synthesize("control", 20);
+    });
+
+    runner.addTest("Baseline Mann-Whitney Gives Exact P-Values", []() -> bool {
+        // Fully separated samples of five: exact two-sided p = 2 / C(10, 5)
+        const std::vector<double> fast{1, 2, 3, 4, 5}, slow{6, 7, 8, 9, 10};
+        return std::abs(ForthBenchmarkBaseline::mannWhitney(fast, slow) - 2.0 / 252.0) < 1e-9 &&
+               ForthBenchmarkBaseline::mannWhitney(fast, fast) > 0.99;
+    });
+
+    runner.addTest("Baseline Round Trips Through Its JSON Store", []() -> bool {
+        const fs::path file = fs::temp_directory_path() / "forth_baseline_test.json";
+        ForthBenchmarkBaseline::save(file, ForthBenchmarkBaseline::fromResults({baselineTestResult()}));
+        const auto loaded = ForthBenchmarkBaseline::load(file);
+        fs::remove(file);
+        const auto& parse = loaded.at("small/cube.fth").at("parse");
+        return parse.samples.size() == 12 && std::abs(parse.median - 0.1055) < 1e-9 && parse.variance > 0.0;
+    });
+
+    runner.addTest("Baseline Comparison Flags Significant Slowdowns", []() -> bool {
+        auto result = baselineTestResult();
+        const auto baseline = ForthBenchmarkBaseline::fromResults({result});
+
+        // Parsing 30% slower, codegen 1% faster: only the first counts
+        for (auto& sample : result.samples["parse"]) sample = sample * 13 / 10;
+        for (auto& sample : result.samples["codegen"]) sample = sample * 99 / 100;
+        const ForthBenchmarkBaseline::Options options;
+        const auto comparison = ForthBenchmarkBaseline::compare(baseline, ForthBenchmarkBaseline::fromResults({result}),
+                                                               options);
+        using Verdict = ForthBenchmarkBaseline::Change::Verdict;
+        bool ok = comparison.changes.size() == 2 && comparison.hasRegression() &&
+                  comparison.count(Verdict::SLOWER) == 1 && comparison.count(Verdict::UNCHANGED) == 1;
+        for (const auto& change : comparison.changes) {
+            ok = ok && (change.phase == "parse") == (change.verdict == Verdict::SLOWER);
+        }
+        return ok;
+    });
+
+    runner.addTest("Baseline Rejects A Malformed Store", []() -> bool {
+        const fs::path file = fs::temp_directory_path() / "forth_baseline_test.json";
+        std::ofstream(file) << "{\"programs\": [1, 2";
+        bool rejected = false;
+        try {
+            (void)ForthBenchmarkBaseline::load(file);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        fs::remove(file);
+        return rejected;
+    });
+
+    runner.addTest("Program Generator Shape Knobs", []() -> bool {
+        // No calls between words at depth 0, every word recursive at 100%,
+        // no literal statements at 0%
+        const auto flat = ForthProgramGenerator({.words = 30, .callDepth = 0, .literalDensity = 0,
+                                                 .stringDensity = 50}).generate();
+        const auto recursive = ForthProgramGenerator({.words = 30, .recursion = 100}).generate();
+        const std::string words = flat.substr(0, flat.find(": MAIN"));
+        size_t names = 0;
+        for (size_t at = words.find(" W"); at != std::string::npos; at = words.find(" W", at + 1)) names++;
+        return names == 30 && flat.find(".\" s") != std::string::npos &&
+               recursive.find(": W7 7 MOD ABS DUP 0 > IF DUP 1 - W7 + ELSE") != std::string::npos;
+    });
+
+    runner.addTest("Scaling Fits Growth Exponents", []() -> bool {
+        const std::vector<double> sizes{10, 100, 1000};
+        return std::abs(ForthScaling::fitExponent(sizes, {5, 50, 500}) - 1.0) < 1e-9 &&
+               std::abs(ForthScaling::fitExponent(sizes, {1, 100, 10000}) - 2.0) < 1e-9 &&
+               ForthScaling::fitExponent({10}, {3}) == 0.0;
+    });
+
+    runner.addTest("Scaling Sweep Measures Every Phase", []() -> bool {
+        ForthScaling scaling({.sizes = {50, 200}, .program = {.recursion = 10}});
+        const auto points = scaling.run();
+        bool ok = points.size() == 2;
+        for (const auto& point : points) {
+            ok = ok && point.result.success && point.result.phasePeakBytes.size() == 4 &&
+                 point.result.linesOfC > point.size;
+        }
+        const auto growth = ForthScaling::growth(points);
+        return ok && growth.size() == 5 && growth.back().phase == "total" && growth.back().timeExponent > 0.0;
+    });
+
+    runner.addTest("Runtime Primitives Table Covers Call And Loop Forms", []() -> bool {
+        // Every arithmetic and comparison primitive has both measurements
+        const auto& table = ForthRuntimeBenchmark::primitives();
+        auto has = [&table](const char* name, const char* mode) {
+            return std::any_of(table.begin(), table.end(), [&](const auto& primitive) {
+                return primitive.name == name && primitive.mode == mode;
+            });
+        };
+        return has("+", "call") && has("MOD", "loop") && has("<=", "loop") && has("0<", "call") &&
+               has("@ unaligned", "loop") && has("! aligned", "call") &&
+               ForthRuntimeBenchmark::harness().find("static long long bench_" +
+                                                     std::to_string(table.size() - 1)) != std::string::npos;
+    });
+
+    runner.addTest("Runtime Primitives Are Timed On The Host", []() -> bool {
+        if (!haveBenchmarkCompiler()) return true;
+        const auto& table = ForthRuntimeBenchmark::primitives();
+        const fs::path workDir = fs::temp_directory_path() / "forth_runtime_bench_test";
+        ForthRuntimeBenchmark benchmark({.iterations = 1000, .repetitions = 1, .workDir = workDir});
+        const auto report = benchmark.run();
+        fs::remove_all(workDir);
+        bool ok = report.success && report.measurements.size() == table.size();
+        for (const auto& measurement : report.measurements) {
+            // Memory rows are skipped where addresses do not fit in a cell
+            ok = ok && (measurement.nsPerOp || measurement.primitive.group == "memory");
+        }
+        return ok;
+    });
+}
@@ -0,0 +1,133 @@
+#include "../test_framework.h"
+#include "driver/batch.h"
+#include "driver/daemon.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+class DaemonTestFixture {
+public:
+    fs::path tempDir = fs::temp_directory_path() / "forth_daemon_test";
+    fs::path program = tempDir / "prog.fth";
+    ForthCompileServer::Options options;
+    std::unique_ptr<ForthCompileServer> server;
+    std::thread serving;
+
+    DaemonTestFixture() {
+        fs::remove_all(tempDir);
+        fs::create_directories(tempDir);
+        write(": SQUARE DUP * ;\n: TWICE 2 * ;\n5 SQUARE TWICE .");
+        options.socketPath = tempDir / "daemon.sock";
+        server = std::make_unique<ForthCompileServer>(options);
+    }
+
+    ~DaemonTestFixture() {
+        if (serving.joinable()) {
+            shutdown();
+        }
+        fs::remove_all(tempDir);
+    }
+
+    auto write(const std::string& source) -> void {
+        std::ofstream(program) << source;
+    }
+
+    auto start() -> bool {
+        if (!server->listen()) return false;
+        serving = std::thread([this] { server->serve(); });
+        return true;
+    }
+
+    auto shutdown() -> void {
+        std::string stopped;
+        request({"--shutdown"}, stopped);
+        serving.join();
+    }
+
+    auto request(const std::vector<std::string>& args, std::string& output) -> int {
+        std::ostringstream out, err;
+        const int status = ForthCompileServer::runClient(options.socketPath, args, out, err);
+        output = out.str();
+        return status;
+    }
+
+    auto compile(std::string& output) -> int {
+        return request({"-o", (tempDir / "out").string(), program.string()}, output);
+    }
+};
+
+auto readDaemonTestFile(const fs::path& path) -> std::string {
+    std::ifstream in(path);
+    return std::string{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+auto registerDaemonTests(TestRunner& runner) -> void {
+
+    runner.addTest("Daemon Serves Warm Compiles From Its Caches", []() -> bool {
+        DaemonTestFixture daemon;
+        if (!daemon.start()) return false;
+        std::string cold, warm;
+        return daemon.compile(cold) == 0 && daemon.compile(warm) == 0 &&
+               cold.find("cached") == std::string::npos &&
+               warm.find("front end cached, 2 words cached") != std::string::npos;
+    });
+
+    runner.addTest("Daemon Generates Only The Edited Word Again", []() -> bool {
+        DaemonTestFixture daemon;
+        if (!daemon.start()) return false;
+        std::string cold, edited;
+        const int coldStatus = daemon.compile(cold);
+        daemon.write(": SQUARE DUP * ;\n: TWICE 3 * ;\n5 SQUARE TWICE .");
+        return coldStatus == 0 && daemon.compile(edited) == 0 &&
+               edited.find("front end cached") == std::string::npos &&
+               edited.find("1 words cached") != std::string::npos;
+    });
+
+    runner.addTest("Daemon Output Matches An Uncached Compile", []() -> bool {
+        DaemonTestFixture daemon;
+        if (!daemon.start()) return false;
+        std::string cold, warm;
+        if (daemon.compile(cold) != 0 || daemon.compile(warm) != 0) return false;
+
+        ForthBatchCompiler::Options fresh;
+        const auto reference = ForthBatchCompiler::compileFile(daemon.program.string(), daemon.tempDir / "ref", fresh);
+        return reference.success &&
+               readDaemonTestFile(daemon.tempDir / "out" / "prog" / "forth_program.c") ==
+                   readDaemonTestFile(daemon.tempDir / "ref" / "forth_program.c");
+    });
+
+    runner.addTest("Daemon Stops On Shutdown", []() -> bool {
+        DaemonTestFixture daemon;
+        if (!daemon.start()) return false;
+        daemon.shutdown();
+        std::string status;
+        return daemon.request({"--status"}, status) == -1;
+    });
+
+    runner.addTest("Daemon Refuses -j", []() -> bool {
+        // Files are compiled one at a time, so -j is refused rather than ignored
+        DaemonTestFixture daemon;
+        std::string refused;
+        const int status = daemon.server->handleRequest({"-j", "4", daemon.program.string()}, daemon.tempDir,
+                                                        [&refused](char, std::string_view text) { refused += text; });
+        return status == 2 && refused.find("-j is not supported") != std::string::npos;
+    });
+
+    runner.addTest("Daemon Refuses Sockets In Shared Directories", []() -> bool {
+        // Anyone could replace a socket in a directory everyone can write to
+        DaemonTestFixture daemon;
+        fs::create_directories(daemon.tempDir / "open");
+        fs::permissions(daemon.tempDir / "open", fs::perms::all);
+        ForthCompileServer::Options exposed;
+        exposed.socketPath = daemon.tempDir / "open" / "daemon.sock";
+        ForthCompileServer refused(exposed);
+        std::ostringstream out, err;
+        return !refused.listen() &&
+               ForthCompileServer::runClient(exposed.socketPath, {"--status"}, out, err) == -1 &&
+               err.str().find("not private") != std::string::npos;
+    });
+}
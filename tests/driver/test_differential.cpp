@@ -0,0 +1,154 @@
+#include "../test_framework.h"
+#include "driver/differential.h"
+#include "driver/program_generator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+// Needs a host C compiler; without one the C runs fail and are not compared
+auto haveDifferentialCompiler() -> bool {
+    return std::system("cc --version > /dev/null 2>&1") == 0;
+}
+
+// Every configuration ran, or only the interpreter when there is no compiler
+auto allRan(const ForthDifferential::ProgramResult& result) -> bool {
+    const bool haveCompiler = haveDifferentialCompiler();
+    return std::all_of(result.runs.begin(), result.runs.end(), [haveCompiler](const auto& run) {
+        using Status = ForthDifferential::Run::Status;
+        return run.status == (haveCompiler || run.configuration == "interpreter" ? Status::OK : Status::FAILED);
+    });
+}
+
+class DifferentialTestFixture {
+public:
+    fs::path workDir;
+    ForthDifferential differential;
+
+    explicit DifferentialTestFixture(const std::string& name = "forth_differential_test")
+        : workDir(fs::temp_directory_path() / name),
+          differential({.generated = 0, .runRepetitions = 1, .workDir = workDir}) {}
+
+    ~DifferentialTestFixture() {
+        fs::remove_all(workDir);
+    }
+};
+
+// Each program exercises a transform that changes what the C code does;
+// the C builds at every level must match the interpreter
+struct TransformedProgram {
+    const char* name;
+    const char* source;
+    const char* marker;  // In the -O2 output when the transform applied
+};
+
+auto transformedPrograms() -> const std::vector<TransformedProgram>& {
+    static const std::vector<TransformedProgram> programs = {
+        {"data_space",
+         "VARIABLE COUNT\nCREATE TABLE 10 , 20 , 30 ,\nCREATE BUF 4 CELLS ALLOT\nCREATE BYTES 8 ALLOT\n"
+         ": FILL-BUF 4 0 BEGIN DUP DUP * OVER CELLS BUF + ! 1 + OVER OVER = UNTIL DROP DROP ;\n"
+         ": MAIN HERE BUF - . FILL-BUF BUF 3 CELLS + @ . TABLE CELL+ @ .\n"
+         "  7 COUNT ! COUNT @ 1 + COUNT ! COUNT @ .\n"
+         "  65 BYTES C! 66 BYTES 1 + C! BYTES C@ . BYTES 1 + C@ . BYTES C@ EMIT BYTES 1 + C@ EMIT CR ;",
+         "forth_data_space["},
+        {"block_memory",
+         "CREATE SRC 1 , 2 , 3 , 4 ,\nCREATE DST 4 CELLS ALLOT\nCREATE TXT 8 ALLOT\n"
+         ": SHOW 0 BEGIN OVER OVER CELLS + @ . 1 + DUP 4 = UNTIL DROP DROP ;\n"
+         ": MAIN SRC DST 4 CELLS MOVE DST SHOW DST 4 CELLS ERASE DST SHOW\n"
+         "  TXT 8 42 FILL TXT C@ EMIT TXT 7 + C@ EMIT CR\n"
+         "  SRC SRC 4 + 12 CMOVE> SRC SHOW SRC 4 + SRC 12 CMOVE SRC SHOW DST 4 CELLS 255 FILL DST @ . ;",
+         "memset((forth_byte_t*)forth_data_space"},
+        {"array_words",
+         "CREATE XS 3 , -1 , 4 , 1 , -5 , 9 , 2 , 6 , 5 ,\nCREATE WS 1 , 2 , 1 , 2 , 1 , 2 , 1 , 2 , 1 ,\n"
+         ": MAIN XS 9 SUM . XS WS 9 DOT . XS 9 MIN-REDUCE . XS 9 MAX-REDUCE .\n"
+         "  XS 9 10 MAP+ XS 9 -3 SCALE XS 9 SUM . XS @ . XS 0 MIN-REDUCE . XS 0 MAX-REDUCE . ;",
+         "forth_cells_dot("},
+        {"shadowed_builtins",
+         "CREATE XS 1 , 5 , 3 ,\nCREATE BUF 8 ALLOT\nVARIABLE V\n: SUM DROP DROP 99 ;\n"
+         ": MAX-REDUCE DROP DROP 1234 ;\n: FILL DROP DROP DROP 7 . ;\n: @ DROP 55 ;\n"
+         ": MAIN XS 3 SUM . XS 3 MAX-REDUCE . BUF 8 0 FILL 3 V ! V @ . XS 1 CELLS + @ . ;",
+         "forth_word_sum"},
+        {"strength_reduction",
+         ": SHOW DUP 8 * . DUP 4 / . DUP 16 MOD . DUP 10 / . DUP 7 MOD . DUP -4 / . DUP 3 * . ;\n"
+         ": MAIN 100 SHOW -100 SHOW 7 SHOW -7 SHOW -2147483648 SHOW 2147483647 SHOW 0 SHOW DROP DROP DROP ;",
+         "<< 3)"},
+        {"compile_time_evaluation",
+         "10 CONSTANT TEN\n: SQ DUP * ;\n: POLY DUP SQ SWAP 3 * + 1 + ;\n"
+         ": CLAMP DUP 0 < IF DROP 0 THEN DUP TEN > IF DROP TEN THEN ;\n"
+         ": FACT DUP 1 > IF DUP 1 - FACT * ELSE DROP 1 THEN ;\n"
+         ": MAIN 4 POLY . 25 CLAMP . -3 CLAMP . 10 FACT . 3 SQ SQ . 7 POLY CLAMP . ;",
+         "(evaluated at compile time)"},
+        {"specialization",
+         "VARIABLE LED\nCREATE PINS 4 CELLS ALLOT\n: BLINK DUP LED ! 2 * . ;\n"
+         ": LIMIT DUP 0 > IF 2 * ELSE DROP 1 THEN .\" x\" . ;\n: PIN! CELLS PINS + ! ;\n"
+         ": MAIN 13 BLINK 5 7 LIMIT 9 -1 LIMIT 5 7 LIMIT LED @ .\n"
+         "  1 0 PIN! 2 3 PIN! PINS @ . PINS 3 CELLS + @ . 0 BEGIN 2 BLINK 1 + DUP 3 = UNTIL . CR ;",
+         "forth_word_blink__k13();"},
+        {"specialization_shadowed_store",
+         "VARIABLE V\n: ! DROP DROP 66 EMIT ;\n: PUT V ! ;\n: MAIN 7 PUT V @ . ;",
+         "    forth_word_put();"},
+        {"specialization_seam",
+         "VARIABLE BUF\n: SCALED 2 * BUF @ + ;\n: SHIFTED DROP 8 / ;\n"
+         ": MAIN 40 BUF ! 3 SCALED . BUF @ 5 SHIFTED . -20 BUF ! 3 SCALED . BUF @ 5 SHIFTED . ;",
+         "forth_word_shifted__k5();"},
+    };
+    return programs;
+}
+
+auto registerDifferentialTests(TestRunner& runner) -> void {
+
+    runner.addTest("Program Generator Is Deterministic Per Seed", []() -> bool {
+        const auto program = ForthProgramGenerator({.seed = 7, .words = 4}).generate();
+        return program == ForthProgramGenerator({.seed = 7, .words = 4}).generate() &&
+               program != ForthProgramGenerator({.seed = 8, .words = 4}).generate() &&
+               program.find(": MAIN") != std::string::npos;
+    });
+
+    runner.addTest("Differential Runs Agree Across Configurations", []() -> bool {
+        DifferentialTestFixture fixture;
+        const auto result = fixture.differential.runProgram("abs", ": MAIN -7 ABS . 5 NEGATE 3 4 ;");
+        return result.agrees() && allRan(result) && result.reference == "interpreter" &&
+               result.runs.size() == ForthDifferential::configurations().size() &&
+               result.runs[0].output == "7 " && result.runs[0].stack == std::vector<int32_t>{-5, 3, 4};
+    });
+
+    runner.addTest("Differential C Builds Are Warning Free", []() -> bool {
+        // Built with -Wall -Wextra; any warning is recorded on the run
+        DifferentialTestFixture fixture;
+        const auto result = fixture.differential.runProgram("abs", ": MAIN -7 ABS . 5 NEGATE 3 4 ;");
+        return std::all_of(result.runs.begin(), result.runs.end(),
+                           [](const auto& run) { return run.warnings.empty(); });
+    });
+
+    runner.addTest("Differential Addresses Are Data-Space Offsets", []() -> bool {
+        DifferentialTestFixture fixture;
+        const auto here = fixture.differential.runProgram(
+            "here", "VARIABLE A VARIABLE B\n: MAIN HERE . A . B . 8 ALLOT HERE . ;");
+        return here.agrees() && allRan(here) && here.runs[0].output == "8 0 4 16 ";
+    });
+
+    runner.addTest("Differential Runs Agree On A Generated Program", []() -> bool {
+        if (!haveDifferentialCompiler()) return true;
+        DifferentialTestFixture fixture;
+        const auto program = ForthProgramGenerator({.seed = 7, .words = 4}).generate();
+        const auto generated = fixture.differential.runProgram("generated", program);
+        return generated.agrees() && allRan(generated);
+    });
+
+    for (const auto& program : transformedPrograms()) {
+        runner.addTest(std::string("Transformed Program Runs Like The Interpreter: ") + program.name,
+                       [&program]() -> bool {
+            DifferentialTestFixture fixture("forth_transform_test");
+            const auto result = fixture.differential.runProgram(program.name, program.source);
+            if (!result.agrees() || !allRan(result) || result.reference != "interpreter") return false;
+            if (!haveDifferentialCompiler()) return true;
+
+            std::ifstream file(fixture.workDir / program.name / "c-O2" / "forth_program.c");
+            const std::string code{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+            return code.find(program.marker) != std::string::npos;
+        });
+    }
+}
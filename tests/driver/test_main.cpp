@@ -0,0 +1,37 @@
+#include "../test_framework.h"
+
+// Test registration functions
+extern auto registerBatchTests(TestRunner& runner) -> void;
+extern auto registerModuleTests(TestRunner& runner) -> void;
+extern auto registerDaemonTests(TestRunner& runner) -> void;
+extern auto registerWatchTests(TestRunner& runner) -> void;
+extern auto registerBenchmarkTests(TestRunner& runner) -> void;
+extern auto registerDifferentialTests(TestRunner& runner) -> void;
+
+auto main() -> int
+{
+    std::cout << "FORTH-ESP32 Compiler Test Suite\n";
+    std::cout << "Driver Tests\n";
+
+    TestRunner runner;
+
+    std::cout << "Registering batch tests...\n";
+    registerBatchTests(runner);
+
+    std::cout << "Registering module tests...\n";
+    registerModuleTests(runner);
+
+    std::cout << "Registering daemon tests...\n";
+    registerDaemonTests(runner);
+
+    std::cout << "Registering watch tests...\n";
+    registerWatchTests(runner);
+
+    std::cout << "Registering benchmark tests...\n";
+    registerBenchmarkTests(runner);
+
+    std::cout << "Registering differential tests...\n";
+    registerDifferentialTests(runner);
+
+    return runner.runAll();
+}
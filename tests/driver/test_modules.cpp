@@ -0,0 +1,147 @@
+#include "../test_framework.h"
+#include "driver/batch.h"
+#include "driver/module_cache.h"
+#include "semantic/module_interface.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+auto readModuleTestFile(const fs::path& path) -> std::string {
+    std::ifstream in(path);
+    return std::string{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+class IncludeTestFixture {
+public:
+    fs::path tempDir = fs::temp_directory_path() / "forth_include_test";
+    std::vector<std::string> files;
+    ForthModuleCache modules;
+
+    // Eight programs reach lib/base.fth directly and through lib/math.fth
+    IncludeTestFixture() {
+        fs::remove_all(tempDir);
+        fs::create_directories(tempDir / "lib");
+        std::ofstream(tempDir / "lib" / "base.fth") << ": TWICE 2 * ;\n10 CONSTANT TEN";
+        std::ofstream(tempDir / "lib" / "math.fth") << "REQUIRE base.fth\n: SQ DUP * ;\n: QUAD SQ TWICE ;";
+        for (int i = 0; i < 8; i++) {
+            const fs::path file = tempDir / ("p" + std::to_string(i) + ".fth");
+            std::ofstream(file) << "INCLUDE lib/math.fth\nREQUIRE lib/base.fth\n: MAIN " << i << " QUAD TEN + . ;";
+            files.push_back(file.string());
+        }
+        modules.preload(files);
+    }
+
+    ~IncludeTestFixture() {
+        fs::remove_all(tempDir);
+    }
+
+    auto compileAll() -> bool {
+        ForthBatchCompiler::Options options;
+        bool ok = true;
+        for (size_t i = 0; i < files.size(); i++) {
+            const auto result = ForthBatchCompiler::compileFile(files[i], tempDir / "out" / std::to_string(i),
+                                                                options, nullptr, &modules);
+            ok = ok && result.success && result.modules.size() == 2;
+        }
+        return ok;
+    }
+};
+
+class InterfaceTestFixture {
+public:
+    fs::path tempDir = fs::temp_directory_path() / "forth_interface_test";
+    ForthBatchCompiler::Options options;
+
+    InterfaceTestFixture() {
+        fs::remove_all(tempDir);
+        fs::create_directories(tempDir / "lib");
+        std::ofstream(tempDir / "lib" / "math.fth")
+            << ": SQ DUP * ;\n7 CONSTANT SEVEN\n: CUBE DUP SQ * ;\n: SHOW .\" x\" ;";
+        std::ofstream(tempDir / "lib" / "bad.fth") << "VARIABLE X\n: F X @ ;";
+    }
+
+    ~InterfaceTestFixture() {
+        fs::remove_all(tempDir);
+    }
+
+    auto compileLibrary(const std::string& name) -> ForthBatchCompiler::Result {
+        return ForthBatchCompiler::compileModule((tempDir / "lib" / name).string(), tempDir / "lib", options);
+    }
+};
+
+auto registerModuleTests(TestRunner& runner) -> void {
+
+    runner.addTest("Included Modules Are Parsed Once Per Batch", []() -> bool {
+        IncludeTestFixture fixture;
+        const bool preloaded = fixture.modules.getParses() == 2;
+        return preloaded && fixture.compileAll() && fixture.modules.getParses() == 2 &&
+               fixture.modules.getHits() == 2 * fixture.files.size();
+    });
+
+    runner.addTest("Include-Once Keeps A Single Copy Of A Module", []() -> bool {
+        IncludeTestFixture fixture;
+        if (!fixture.compileAll()) return false;
+
+        const std::string code = readModuleTestFile(fixture.tempDir / "out" / "0" / "forth_program.c");
+        size_t copies = 0;
+        for (size_t at = code.find("// FORTH word: TWICE"); at != std::string::npos;
+             at = code.find("// FORTH word: TWICE", at + 1)) {
+            copies++;
+        }
+        return copies == 1;
+    });
+
+    runner.addTest("Editing A Module Re-Parses Only What Includes It", []() -> bool {
+        IncludeTestFixture fixture;
+        std::ofstream(fixture.tempDir / "lib" / "base.fth") << ": TWICE 2 * ;\n20 CONSTANT TEN";
+        const auto edited = fixture.modules.resolve({"lib/math.fth"}, fixture.files[0]);
+        return edited.errors.empty() && fixture.modules.getParses() == 4;
+    });
+
+    runner.addTest("Module Cycles And Missing Files Are Reported", []() -> bool {
+        IncludeTestFixture fixture;
+        std::ofstream(fixture.tempDir / "lib" / "base.fth") << "REQUIRE math.fth\n: TWICE 2 * ;";
+        const auto cycle = fixture.modules.resolve({"lib/math.fth", "lib/none.fth"}, fixture.files[0]);
+        return cycle.errors.size() == 2 && cycle.modules.empty();
+    });
+
+    runner.addTest("Module Interfaces Describe Exported Words", []() -> bool {
+        InterfaceTestFixture fixture;
+        const auto library = fixture.compileLibrary("math.fth");
+        if (!library.success || !fs::exists(fixture.tempDir / "lib" / "forth_module_math.c")) return false;
+
+        const auto interface = ForthModuleInterface::load(fixture.tempDir / "lib" / "math.fi");
+        const auto* sq = interface.findWord("SQ");
+        const auto* cube = interface.findWord("CUBE");
+        const auto* show = interface.findWord("SHOW");
+        return sq && cube && show && sq->function == "forth_math_sq" && sq->pure &&
+               sq->inlineSource == "DUP *" && sq->effect.effect.consumed == 1 && sq->effect.effect.produced == 1 &&
+               cube->pure && cube->inlineSource.empty() && !show->pure && interface.constants.size() == 1 &&
+               interface.constants[0].second == 7;
+    });
+
+    runner.addTest("Programs Import Modules Through Their Interface", []() -> bool {
+        InterfaceTestFixture fixture;
+        if (!fixture.compileLibrary("math.fth").success) return false;
+
+        // The program reads the interface only; SQ is expanded in place
+        const fs::path file = fixture.tempDir / "p.fth";
+        std::ofstream(file) << "REQUIRE lib/math.fi\n: SHOW-CUBES SQ CUBE . ;\n: MAIN SEVEN SHOW-CUBES ;";
+        ForthModuleCache modules;
+        const auto result = ForthBatchCompiler::compileFile(file.string(), fixture.tempDir / "out",
+                                                            fixture.options, nullptr, &modules);
+        const std::string code = readModuleTestFile(fixture.tempDir / "out" / "forth_program.c");
+        auto has = [&code](const char* text) { return code.find(text) != std::string::npos; };
+        return result.success && modules.getParses() == 0 && modules.getInterfaces() == 1 &&
+               has("forth_push(7);") && has("// SQ (inlined)") && has("forth_math_cube();") &&
+               !has("FORTH word: CUBE") && fs::exists(fixture.tempDir / "out" / "forth_module_math.c");
+    });
+
+    runner.addTest("Modules With Data Space Are Rejected", []() -> bool {
+        // Data space belongs to programs
+        InterfaceTestFixture fixture;
+        return !fixture.compileLibrary("bad.fth").success && !fs::exists(fixture.tempDir / "lib" / "bad.fi");
+    });
+}
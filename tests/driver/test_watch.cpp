@@ -0,0 +1,72 @@
+#include "../test_framework.h"
+#include "driver/watch.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+class WatchTestFixture {
+public:
+    fs::path tempDir = fs::temp_directory_path() / "forth_watch_test";
+    std::unique_ptr<ForthWatcher> watcher;
+    std::vector<ForthBatchCompiler::Result> initial;
+
+    // Watches two programs and builds them once
+    WatchTestFixture() {
+        fs::remove_all(tempDir);
+        fs::create_directories(tempDir / "src");
+        std::ofstream(tempDir / "src" / "a.fth") << ": SQ DUP * ;\n: CUBE DUP SQ * ;\n: INC 1 + ;\n3 CUBE INC .";
+        std::ofstream(tempDir / "src" / "b.fth") << ": TWICE 2 * ;\n4 TWICE .";
+
+        ForthWatcher::Options options;
+        options.batch.outputRoot = tempDir / "out";
+        watcher = std::make_unique<ForthWatcher>(options);
+        if (watcher->watch(tempDir / "src")) {
+            initial = watcher->rebuild(watcher->getSources());
+        }
+    }
+
+    ~WatchTestFixture() {
+        fs::remove_all(tempDir);
+    }
+};
+
+auto registerWatchTests(TestRunner& runner) -> void {
+
+    runner.addTest("Watch Builds Every Program First", []() -> bool {
+        WatchTestFixture fixture;
+        return fixture.initial.size() == 2 && fixture.initial[0].success && fixture.initial[1].success &&
+               fs::exists(fixture.tempDir / "out" / "a" / "forth_program.c") &&
+               fs::exists(fixture.tempDir / "out" / "b") && fixture.watcher->getError().empty();
+    });
+
+    runner.addTest("Watch Rebuilds Only What Changed", []() -> bool {
+        // Edit one word: the others are reused and untouched files stay as they are
+        WatchTestFixture fixture;
+        std::ofstream(fixture.tempDir / "src" / "a.fth") << ": SQ DUP * ;\n: CUBE DUP SQ * ;\n: INC 2 + ;\n3 CUBE INC .";
+        const auto changed = fixture.watcher->waitForChanges(std::chrono::milliseconds(5000));
+        const auto edited = fixture.watcher->rebuild(changed);
+        return changed.size() == 1 && changed[0].filename() == "a.fth" && edited.size() == 1 &&
+               edited[0].success && edited[0].wordsFromCache == 2 && edited[0].filesUnchanged > 0 &&
+               edited[0].filesUnchanged < edited[0].filesGenerated;
+    });
+
+    runner.addTest("Watch Skips Saves Without Changes", []() -> bool {
+        // Saving without changes is noticed but costs no compile
+        WatchTestFixture fixture;
+        std::ofstream(fixture.tempDir / "src" / "b.fth") << ": TWICE 2 * ;\n4 TWICE .";
+        const auto saved = fixture.watcher->waitForChanges(std::chrono::milliseconds(5000));
+        return saved.size() == 1 && fixture.watcher->rebuild(saved).empty();
+    });
+
+    runner.addTest("Watch Stop Ends A Wait At Once", []() -> bool {
+        WatchTestFixture fixture;
+        std::thread stopper([&fixture]() { fixture.watcher->stop(); });
+        const auto start = std::chrono::steady_clock::now();
+        const bool ended = fixture.watcher->waitForChanges(std::chrono::milliseconds(-1)).empty() &&
+                           std::chrono::steady_clock::now() - start < std::chrono::seconds(5);
+        stopper.join();
+        return ended && fixture.watcher->getError().empty();
+    });
+}
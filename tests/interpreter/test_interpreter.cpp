@@ -0,0 +1,77 @@
+#include "../test_framework.h"
+#include "interpreter/interpreter.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include <memory>
+
+class InterpreterTestFixture {
+public:
+    ForthLexer lexer;
+    ForthParser parser;
+    std::unique_ptr<ProgramNode> ast;
+
+    auto parse(const std::string& code) -> const ProgramNode& {
+        ast = parser.parseProgram(lexer.tokenize(code));
+        if (parser.hasErrors()) {
+            throw std::runtime_error("Parser errors: " +
+                (parser.getErrors().empty() ? "unknown" : parser.getErrors()[0]));
+        }
+        return *ast;
+    }
+
+    // Output of running the program, or "error" if the interpreter gave up
+    auto run(const std::string& code, ForthInterpreter& interpreter) -> std::string {
+        try {
+            interpreter.run(parse(code));
+        } catch (const ForthInterpreter::Error&) {
+            return "error";
+        }
+        return interpreter.getOutput();
+    }
+};
+
+auto registerInterpreterTests(TestRunner& runner) -> void {
+
+    runner.addTest("Interpreter Runs Words And Recursion", []() -> bool {
+        InterpreterTestFixture fixture;
+        ForthInterpreter interpreter;
+        return fixture.run(": SQ DUP * ;\n: FACT DUP 1 > IF DUP 1 - FACT * ELSE DROP 1 THEN ;\n"
+                           ": MAIN 7 SQ . 10 FACT . ;", interpreter) == "49 3628800 " &&
+               interpreter.getStack().empty();
+    });
+
+    runner.addTest("Interpreter Arithmetic Follows The Runtime", []() -> bool {
+        // Cells wrap, division by zero gives 0, MOD keeps C's sign
+        InterpreterTestFixture fixture;
+        ForthInterpreter interpreter;
+        return fixture.run(": MAIN 2147483647 1 + . 7 0 / . -7 2 MOD . ;", interpreter) ==
+               "-2147483648 0 -1 ";
+    });
+
+    runner.addTest("Interpreter Data Space Holds Variables", []() -> bool {
+        InterpreterTestFixture fixture;
+        ForthInterpreter interpreter;
+        return fixture.run("VARIABLE V\n: SQ DUP * ;\n: SHOW V @ SQ . ;\n: MAIN 3 V ! SHOW ;", interpreter) == "9 ";
+    });
+
+    runner.addTest("Interpreter Ignores ROT On A Shallow Stack", []() -> bool {
+        InterpreterTestFixture fixture;
+        ForthInterpreter interpreter;
+        ForthInterpreter strict({.strictStack = true});
+        return fixture.run(": MAIN 5 ROT . ;", interpreter) == "5 " &&
+               fixture.run(": MAIN 5 ROT . ;", strict) == "error";
+    });
+
+    runner.addTest("Interpreter Gives Up After Its Step Limit", []() -> bool {
+        InterpreterTestFixture fixture;
+        ForthInterpreter strict({.maxSteps = 1000});
+        strict.load(fixture.parse(": FACT DUP 1 > IF DUP 1 - FACT * ELSE DROP 1 THEN ;"));
+        strict.push(100000);
+        try {
+            strict.call("FACT");
+        } catch (const ForthInterpreter::Error&) {
+            return true;  // Out of steps (or return stack) long before the end
+        }
+        return false;
+    });
+}
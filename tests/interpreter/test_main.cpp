@@ -0,0 +1,17 @@
+#include "../test_framework.h"
+
+// Test registration functions
+extern auto registerInterpreterTests(TestRunner& runner) -> void;
+
+auto main() -> int
+{
+    std::cout << "FORTH-ESP32 Compiler Test Suite\n";
+    std::cout << "Reference Interpreter Tests\n";
+
+    TestRunner runner;
+
+    std::cout << "Registering interpreter tests...\n";
+    registerInterpreterTests(runner);
+
+    return runner.runAll();
+}
@@ -159,6 +159,22 @@ auto registerParserTests(TestRunner& runner) -> void {
         return true;
     });
     
+    runner.addTest("Create Declaration", []() {
+        auto [ast, errors] = parseCode("CREATE TABLE 1 , 2 , 4 CELLS ALLOT");
+        
+        assert(errors.empty());
+        assert(ast != nullptr);
+        assert(ast->getChild(0)->getType() == ASTNode::NodeType::VARIABLE_DECLARATION);
+        
+        auto createNode = dynamic_cast<VariableDeclarationNode*>(ast->getChild(0));
+        assert(createNode != nullptr);
+        assert(createNode->getVarName() == "TABLE");
+        assert(createNode->isCreate());
+        assert(!createNode->isConst());
+        
+        return true;
+    });
+    
     runner.addTest("Constant Declaration", []() {
         auto [ast, errors] = parseCode("3.14159 CONSTANT PI");
         
@@ -5,6 +5,7 @@ extern auto registerLexerTests(TestRunner& runner) -> void;
 extern auto registerParserTests(TestRunner& runner) -> void;
 extern auto registerSemanticTests(TestRunner& runner) -> void;
 extern auto registerCCodegenTests(TestRunner& runner) -> void;  // Updated from LLVM to C
+extern auto registerSizeReportTests(TestRunner& runner) -> void;
 
 auto main() -> int 
 {
@@ -26,6 +27,9 @@ auto main() -> int
     std::cout << "Registering C code generation tests...\n";
     registerCCodegenTests(runner);  // Updated from LLVM
 
+    std::cout << "Registering size report tests...\n";
+    registerSizeReportTests(runner);
+
     const int failures = runner.runAll();
     
     if (failures == 0) 